@@ -0,0 +1,120 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/arena.h"
+
+#include "base/debug.h"
+#include "base/memory.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace base {
+
+static char* align_ptr(char* p, const size_t alignment)
+{
+  const uintptr_t u = reinterpret_cast<uintptr_t>(p);
+  return p + ((alignment - (u & (alignment - 1))) & (alignment - 1));
+}
+
+arena::arena(const size_t blockSize) : m_blockSize(blockSize)
+{
+  ASSERT(blockSize > 0);
+}
+
+arena::~arena()
+{
+  release();
+}
+
+void arena::rewind(const marker& m)
+{
+  ASSERT(m.block < m_blocks.size() || (m.block == 0 && m.offset == 0));
+  ASSERT(m.block < m_current || (m.block == m_current && m.offset <= m_offset));
+  m_current = m.block;
+  m_offset = m.offset;
+}
+
+void arena::release()
+{
+  for (const block& b : m_blocks)
+    base_free(b.data);
+  m_blocks.clear();
+  m_current = 0;
+  m_offset = 0;
+}
+
+size_t arena::used() const
+{
+  size_t n = m_offset;
+  for (size_t i = 0; i < m_current && i < m_blocks.size(); ++i)
+    n += m_blocks[i].size;
+  return n;
+}
+
+size_t arena::capacity() const
+{
+  size_t n = 0;
+  for (const block& b : m_blocks)
+    n += b.size;
+  return n;
+}
+
+void* arena::do_allocate(const size_t bytes, const size_t alignment)
+{
+  // The alignment must be a power of two
+  ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+  if (m_current < m_blocks.size()) {
+    const block& b = m_blocks[m_current];
+    char* p = align_ptr(b.data + m_offset, alignment);
+    if (p + bytes <= b.data + b.size) {
+      m_offset = (p - b.data) + bytes;
+      return p;
+    }
+  }
+  return allocate_in_next_block(bytes, alignment);
+}
+
+void arena::do_deallocate(void*, size_t, size_t)
+{
+  // Do nothing, the memory is recycled with reset()/rewind()
+}
+
+bool arena::do_is_equal(const memory_resource& other) const noexcept
+{
+  return (this == &other);
+}
+
+void* arena::allocate_in_next_block(const size_t bytes, const size_t alignment)
+{
+  // Bytes needed in the worst case (the block address is aligned to
+  // the fundamental alignment).
+  const size_t needed = bytes + (alignment > alignof(std::max_align_t) ? alignment : 0);
+
+  const size_t next = (m_blocks.empty() ? 0 : m_current + 1);
+  if (next >= m_blocks.size() || m_blocks[next].size < needed) {
+    // Create a new block (big allocations get their own block, which
+    // is reused after reset() too)
+    const size_t size = std::max(m_blockSize, needed);
+    char* data = static_cast<char*>(base_malloc(size));
+    if (!data)
+      throw std::bad_alloc();
+    m_blocks.insert(m_blocks.begin() + next, block{ data, size });
+  }
+
+  m_current = next;
+  const block& b = m_blocks[m_current];
+  char* p = align_ptr(b.data, alignment);
+  m_offset = (p - b.data) + bytes;
+  return p;
+}
+
+} // namespace base
@@ -0,0 +1,95 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_ARENA_H_INCLUDED
+#define BASE_ARENA_H_INCLUDED
+#pragma once
+
+#include "base/disable_copying.h"
+#include "base/memory_resource.h"
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace base {
+
+// Bump allocator for transient objects (e.g. objects that live only
+// during one frame). Allocating memory is just incrementing an
+// offset in the current block, deallocate() does nothing, and all
+// the memory is recycled at once with reset() or rewind(). Blocks
+// are kept for reuse until the arena is destroyed (or release() is
+// called), so a per-frame arena stops allocating memory from the
+// heap after the first frames.
+//
+// It can be used with std::pmr containers, e.g.
+//
+//   base::arena arena;
+//   std::pmr::vector<gfx::Rect> rects(&arena);
+//   ...
+//   arena.reset(); // At the end of the frame
+//
+// It's not thread-safe.
+class arena : public memory_resource {
+public:
+  // Position in the arena returned by mark() to rewind() to it.
+  struct marker {
+    size_t block = 0;
+    size_t offset = 0;
+  };
+
+  explicit arena(size_t blockSize = 64 * 1024);
+  ~arena();
+
+  // Creates an object in the arena. Its destructor is never called.
+  template<typename T, typename... Args>
+  T* make(Args&&... args)
+  {
+    return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  // Current position to free all objects allocated after it with
+  // rewind().
+  marker mark() const { return { m_current, m_offset }; }
+  void rewind(const marker& m);
+
+  // Recycles all the memory allocated from the arena (without
+  // returning the blocks to the heap).
+  void reset() { rewind(marker()); }
+
+  // Returns all blocks to the heap.
+  void release();
+
+  // Bytes allocated from the arena (including alignment padding).
+  size_t used() const;
+
+  // Total size of the allocated blocks.
+  size_t capacity() const;
+
+private:
+  struct block {
+    char* data;
+    size_t size;
+  };
+
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const memory_resource& other) const noexcept override;
+
+  void* allocate_in_next_block(size_t bytes, size_t alignment);
+
+  const size_t m_blockSize;
+  std::vector<block> m_blocks;
+  size_t m_current = 0; // Index of the current block in m_blocks
+  size_t m_offset = 0;  // Offset in the current block
+
+  DISABLE_COPYING(arena);
+};
+
+} // namespace base
+
+#endif
@@ -0,0 +1,109 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/arena.h"
+
+#include <cstdint>
+#include <string>
+
+#if HAVE_MEMORY_RESOURCE
+  #include <vector>
+#endif
+
+using namespace base;
+
+static bool is_aligned(const void* p, const size_t alignment)
+{
+  return (reinterpret_cast<uintptr_t>(p) & (alignment - 1)) == 0;
+}
+
+TEST(Arena, Allocate)
+{
+  arena a(1024);
+  EXPECT_EQ(0, a.used());
+  EXPECT_EQ(0, a.capacity());
+
+  void* p = a.allocate(10, 1);
+  void* q = a.allocate(16, 16);
+  EXPECT_NE(p, q);
+  EXPECT_TRUE(is_aligned(q, 16));
+  EXPECT_EQ(1024, a.capacity());
+  EXPECT_EQ(32, a.used());
+
+  // Big allocations get their own block
+  void* big = a.allocate(4000, 64);
+  EXPECT_TRUE(is_aligned(big, 64));
+  EXPECT_LE(1024 + 4000, a.capacity());
+
+  int* i = a.make<int>(5);
+  EXPECT_EQ(5, *i);
+}
+
+TEST(Arena, ResetReusesBlocks)
+{
+  arena a(256);
+  for (int i = 0; i < 100; ++i)
+    EXPECT_TRUE(a.allocate(32, 8));
+  const size_t capacity = a.capacity();
+  EXPECT_LE(3200, capacity);
+
+  void* first = nullptr;
+  for (int frame = 0; frame < 10; ++frame) {
+    a.reset();
+    EXPECT_EQ(0, a.used());
+    void* p = a.allocate(32, 8);
+    if (!first)
+      first = p;
+    EXPECT_EQ(first, p);
+    for (int i = 1; i < 100; ++i)
+      EXPECT_TRUE(a.allocate(32, 8));
+    EXPECT_EQ(capacity, a.capacity());
+  }
+
+  a.release();
+  EXPECT_EQ(0, a.capacity());
+}
+
+TEST(Arena, MarkRewind)
+{
+  arena a(128);
+  EXPECT_TRUE(a.allocate(50, 1));
+  const arena::marker m = a.mark();
+  const size_t used = a.used();
+  void* p = a.allocate(10, 1);
+  for (int i = 0; i < 10; ++i)
+    EXPECT_TRUE(a.allocate(100, 1));
+  a.rewind(m);
+  EXPECT_EQ(used, a.used());
+  EXPECT_EQ(p, a.allocate(10, 1));
+}
+
+#if HAVE_MEMORY_RESOURCE
+TEST(Arena, PmrContainers)
+{
+  arena a;
+  {
+    std::pmr::vector<int> v(&a);
+    for (int i = 0; i < 1000; ++i)
+      v.push_back(i);
+    EXPECT_EQ(999, v.back());
+
+    std::pmr::string s("a string that doesn't fit in the small buffer", &a);
+    EXPECT_EQ('a', s[0]);
+  }
+  EXPECT_LT(1000 * sizeof(int), a.used());
+  a.reset();
+  EXPECT_EQ(0, a.used());
+}
+#endif
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
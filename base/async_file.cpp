@@ -0,0 +1,603 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/async_file.h"
+
+#include "base/debug.h"
+#include "base/file_handle.h"
+#include "base/task.h"
+#include "base/thread.h"
+#include "base/thread_pool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if LAF_WINDOWS
+  #include <windows.h>
+
+  #include <io.h>
+  #include <sys/stat.h>
+#else
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#if LAF_LINUX && HAVE_LINUX_IO_URING_H
+  #define USE_IO_URING 1
+  #include <linux/io_uring.h>
+  #include <sys/mman.h>
+  #include <sys/syscall.h>
+  #include <sys/uio.h>
+#endif
+
+namespace base {
+
+// Max number of bytes read/written in one system call (Linux doesn't
+// transfer more than 0x7ffff000 bytes, and Windows uses DWORD sizes)
+static constexpr size_t kMaxChunk = 0x40000000;
+
+struct async_io::file {
+  int fd;
+
+  explicit file(const int fd) : fd(fd) {}
+  ~file()
+  {
+#if LAF_WINDOWS
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+  }
+};
+
+struct async_io::request {
+  std::shared_ptr<file> f;
+  bool write;
+  uint64_t offset;
+  uint8_t* buf;
+  size_t size;
+  callback_t callback;
+  const task_token* token;
+  size_t done = 0; // Bytes already transferred
+#if USE_IO_URING
+  bool canceled = false;
+  iovec iov;
+#endif
+
+  bool is_canceled() const { return (token && token->canceled()); }
+
+  // Executes the request in the current thread (blocking).
+  async_result execute()
+  {
+    if (is_canceled())
+      return async_result{ 0, ECANCELED };
+
+    while (done < size) {
+      const size_t chunk = std::min(size - done, kMaxChunk);
+      const uint64_t pos = offset + done;
+
+#if LAF_WINDOWS
+      HANDLE handle = (HANDLE)_get_osfhandle(f->fd);
+      OVERLAPPED ov = {};
+      ov.Offset = DWORD(pos);
+      ov.OffsetHigh = DWORD(pos >> 32);
+      DWORD n = 0;
+      const BOOL res = (write ? WriteFile(handle, buf + done, DWORD(chunk), &n, &ov) :
+                                ReadFile(handle, buf + done, DWORD(chunk), &n, &ov));
+      if (!res) {
+        if (GetLastError() == ERROR_HANDLE_EOF)
+          break;
+        return async_result{ int64_t(done), EIO };
+      }
+#else
+      const ssize_t n = (write ? ::pwrite(f->fd, buf + done, chunk, off_t(pos)) :
+                                 ::pread(f->fd, buf + done, chunk, off_t(pos)));
+      if (n < 0) {
+        if (errno == EINTR)
+          continue;
+        return async_result{ int64_t(done), errno };
+      }
+#endif
+      if (n == 0) // End of file
+        break;
+      done += size_t(n);
+    }
+    return async_result{ int64_t(done), 0 };
+  }
+};
+
+class async_io::impl {
+public:
+  virtual ~impl() {}
+  virtual bool uses_thread_pool() const = 0;
+
+  void submit(std::unique_ptr<request>&& req)
+  {
+    const std::lock_guard lock(m_mutex);
+    ++m_pending;
+    m_queue.push_back(req.release());
+    if (m_batches == 0)
+      flush_locked();
+  }
+
+  void begin_batch()
+  {
+    const std::lock_guard lock(m_mutex);
+    ++m_batches;
+  }
+
+  void end_batch()
+  {
+    const std::lock_guard lock(m_mutex);
+    ASSERT(m_batches > 0);
+    if (--m_batches == 0)
+      flush_locked();
+  }
+
+  void wait_all()
+  {
+    std::unique_lock lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_pending == 0; });
+  }
+
+  size_t pending() const
+  {
+    const std::lock_guard lock(m_mutex);
+    return m_pending;
+  }
+
+protected:
+  // Sends the requests in m_queue to be executed.
+  virtual void flush_locked() = 0;
+
+  // Calls the callback of the given completed requests (must be
+  // called without locking m_mutex).
+  void finished(request* req, const async_result& result)
+  {
+    if (req->callback)
+      req->callback(result);
+    delete req;
+
+    const std::lock_guard lock(m_mutex);
+    ASSERT(m_pending > 0);
+    if (--m_pending == 0)
+      m_cv.notify_all();
+  }
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<request*> m_queue; // Requests waiting to be executed
+  size_t m_pending = 0;         // Requests not completed yet
+  int m_batches = 0;            // Number of alive async_io::batch
+};
+
+// Executes each request with a blocking call in a thread pool.
+class async_io::pool_impl : public async_io::impl {
+public:
+  explicit pool_impl(thread_pool* pool) : m_pool(pool)
+  {
+    if (!m_pool) {
+      // Threads are waiting the disk most of the time, so we can use
+      // more threads than CPUs
+      m_ownPool = std::make_unique<thread_pool>(4);
+      m_pool = m_ownPool.get();
+    }
+  }
+
+  bool uses_thread_pool() const override { return true; }
+
+private:
+  void flush_locked() override
+  {
+    for (request* req : m_queue)
+      m_pool->execute([this, req] { finished(req, req->execute()); });
+    m_queue.clear();
+  }
+
+  thread_pool* m_pool;
+  std::unique_ptr<thread_pool> m_ownPool;
+};
+
+#if USE_IO_URING
+
+static int io_uring_setup(const unsigned entries, io_uring_params* params)
+{
+  return int(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int io_uring_enter(const int fd,
+                          const unsigned toSubmit,
+                          const unsigned minComplete,
+                          const unsigned flags)
+{
+  return int(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+// Submits the requests to the kernel through the io_uring submission
+// queue, and a background thread waits the completion queue to call
+// the callbacks.
+class async_io::uring_impl : public async_io::impl {
+public:
+  ~uring_impl()
+  {
+    if (m_thread.joinable()) {
+      // A nullptr request is a NOP that stops the completion thread
+      {
+        const std::lock_guard lock(m_mutex);
+        m_queue.push_back(nullptr);
+        flush_locked();
+      }
+      m_thread.join();
+    }
+
+    if (m_sqes)
+      munmap(m_sqes, m_sqesSize);
+    if (m_cqRing && m_cqRing != m_sqRing)
+      munmap(m_cqRing, m_cqRingSize);
+    if (m_sqRing)
+      munmap(m_sqRing, m_sqRingSize);
+    if (m_fd >= 0)
+      ::close(m_fd);
+  }
+
+  bool uses_thread_pool() const override { return false; }
+
+  // Returns false if io_uring is not available (e.g. old kernel,
+  // or disabled with the kernel.io_uring_disabled sysctl).
+  bool init(const unsigned queueDepth)
+  {
+    io_uring_params p;
+    std::memset(&p, 0, sizeof(p));
+    m_fd = io_uring_setup(std::max(queueDepth, 1u), &p);
+    if (m_fd < 0)
+      return false;
+
+    m_sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    m_cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMmap = (p.features & IORING_FEAT_SINGLE_MMAP);
+    if (singleMmap)
+      m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+
+    m_sqRing = map(m_sqRingSize, IORING_OFF_SQ_RING);
+    if (!m_sqRing)
+      return false;
+    m_cqRing = (singleMmap ? m_sqRing : map(m_cqRingSize, IORING_OFF_CQ_RING));
+    if (!m_cqRing)
+      return false;
+    m_sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+    m_sqes = (io_uring_sqe*)map(m_sqesSize, IORING_OFF_SQES);
+    if (!m_sqes)
+      return false;
+
+    auto sq = (uint8_t*)m_sqRing;
+    m_sqHead = (unsigned*)(sq + p.sq_off.head);
+    m_sqTail = (unsigned*)(sq + p.sq_off.tail);
+    m_sqMask = *(unsigned*)(sq + p.sq_off.ring_mask);
+    m_sqArray = (unsigned*)(sq + p.sq_off.array);
+    m_sqTailLocal = *m_sqTail;
+
+    auto cq = (uint8_t*)m_cqRing;
+    m_cqHead = (unsigned*)(cq + p.cq_off.head);
+    m_cqTail = (unsigned*)(cq + p.cq_off.tail);
+    m_cqMask = *(unsigned*)(cq + p.cq_off.ring_mask);
+    m_cqes = (io_uring_cqe*)(cq + p.cq_off.cqes);
+
+    // The completion queue has (at least) twice the entries of the
+    // submission queue, so limiting the requests in flight to the
+    // submission queue size, the completion queue cannot overflow.
+    m_capacity = p.sq_entries;
+
+    m_thread = std::thread([this] { completion_thread(); });
+    return true;
+  }
+
+private:
+  void* map(const size_t size, const off_t offset)
+  {
+    void* ptr =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, offset);
+    return (ptr != MAP_FAILED ? ptr : nullptr);
+  }
+
+  void flush_locked() override
+  {
+    while (!m_queue.empty() && m_inflight < m_capacity) {
+      request* req = m_queue.front();
+      m_queue.pop_front();
+
+      const unsigned index = m_sqTailLocal & m_sqMask;
+      io_uring_sqe* sqe = &m_sqes[index];
+      std::memset(sqe, 0, sizeof(*sqe));
+      if (req && !req->is_canceled()) {
+        req->iov.iov_base = req->buf + req->done;
+        req->iov.iov_len = std::min(req->size - req->done, kMaxChunk);
+        sqe->opcode = (req->write ? IORING_OP_WRITEV : IORING_OP_READV);
+        sqe->fd = req->f->fd;
+        sqe->off = req->offset + req->done;
+        sqe->addr = (uint64_t)&req->iov;
+        sqe->len = 1;
+      }
+      else {
+        // Canceled requests are completed as NOPs in the completion
+        // thread, so all callbacks are called from the same place
+        if (req)
+          req->canceled = true;
+        sqe->opcode = IORING_OP_NOP;
+      }
+      sqe->user_data = (uint64_t)req;
+      m_sqArray[index] = index;
+
+      ++m_sqTailLocal;
+      ++m_inflight;
+    }
+
+    // Make the new entries visible to the kernel
+    __atomic_store_n(m_sqTail, m_sqTailLocal, __ATOMIC_RELEASE);
+
+    // Submit all entries that the kernel didn't consume yet (this
+    // includes entries that couldn't be submitted in a previous call).
+    const unsigned toSubmit = m_sqTailLocal - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+    if (toSubmit > 0) {
+      int res;
+      do {
+        res = io_uring_enter(m_fd, toSubmit, 0, 0);
+      } while (res < 0 && errno == EINTR);
+      // Other errors (EAGAIN/EBUSY) are temporary, entries remain in
+      // the queue and are submitted in the next flush.
+    }
+  }
+
+  void completion_thread()
+  {
+    this_thread::set_name("async_io");
+
+    struct completed {
+      request* req;
+      async_result result;
+    };
+    struct entry {
+      request* req;
+      int res;
+    };
+    std::vector<entry> entries;
+    std::vector<completed> completedReqs;
+    bool stop = false;
+
+    while (!stop) {
+      if (io_uring_enter(m_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+        // Unexpected error, try to submit pending entries again
+        const std::lock_guard lock(m_mutex);
+        flush_locked();
+      }
+
+      // Take the completion entries (requests are accessed later with
+      // m_mutex locked, because they were filled with the mutex locked
+      // in other thread and the kernel doesn't synchronize them for us)
+      entries.clear();
+      unsigned head = *m_cqHead;
+      const unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+      for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+        entries.push_back({ (request*)cqe.user_data, cqe.res });
+      }
+      __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+      if (entries.empty())
+        continue;
+
+      completedReqs.clear();
+      {
+        const std::lock_guard lock(m_mutex);
+        m_inflight -= unsigned(entries.size());
+
+        size_t partials = 0;
+        for (const entry& e : entries) {
+          request* req = e.req;
+          if (!req)
+            stop = true;
+          else if (req->canceled)
+            completedReqs.push_back({ req, async_result{ 0, ECANCELED } });
+          else if (e.res < 0)
+            completedReqs.push_back({ req, async_result{ int64_t(req->done), -e.res } });
+          else {
+            req->done += size_t(e.res);
+            // Continue short reads/writes (if it's not the end of file)
+            if (e.res > 0 && req->done < req->size)
+              m_queue.insert(m_queue.begin() + partials++, req);
+            else
+              completedReqs.push_back({ req, async_result{ int64_t(req->done), 0 } });
+          }
+        }
+
+        if (m_batches == 0 || partials > 0)
+          flush_locked();
+      }
+
+      for (const completed& c : completedReqs)
+        finished(c.req, c.result);
+    }
+  }
+
+  int m_fd = -1;
+  void* m_sqRing = nullptr;
+  void* m_cqRing = nullptr;
+  size_t m_sqRingSize = 0;
+  size_t m_cqRingSize = 0;
+  size_t m_sqesSize = 0;
+
+  // Submission queue (protected by m_mutex)
+  io_uring_sqe* m_sqes = nullptr;
+  unsigned* m_sqHead = nullptr;
+  unsigned* m_sqTail = nullptr;
+  unsigned* m_sqArray = nullptr;
+  unsigned m_sqMask = 0;
+  unsigned m_sqTailLocal = 0;
+  unsigned m_capacity = 0;
+  unsigned m_inflight = 0; // Entries in the submission queue or in the kernel
+
+  // Completion queue (used only from the completion thread)
+  io_uring_cqe* m_cqes = nullptr;
+  unsigned* m_cqHead = nullptr;
+  unsigned* m_cqTail = nullptr;
+  unsigned m_cqMask = 0;
+
+  std::thread m_thread;
+};
+
+#endif // USE_IO_URING
+
+async_io::batch::batch(async_io& io) : m_io(io)
+{
+  m_io.m_impl->begin_batch();
+}
+
+async_io::batch::~batch()
+{
+  m_io.m_impl->end_batch();
+}
+
+async_io::async_io(thread_pool* pool, const bool useThreadPool, const unsigned queueDepth)
+{
+#if USE_IO_URING
+  if (!useThreadPool) {
+    auto uring = std::make_unique<uring_impl>();
+    if (uring->init(queueDepth))
+      m_impl = std::move(uring);
+  }
+#else
+  (void)useThreadPool;
+  (void)queueDepth;
+#endif
+  if (!m_impl)
+    m_impl = std::make_unique<pool_impl>(pool);
+}
+
+async_io::~async_io()
+{
+  wait_all();
+}
+
+void async_io::wait_all()
+{
+  m_impl->wait_all();
+}
+
+size_t async_io::pending() const
+{
+  return m_impl->pending();
+}
+
+bool async_io::uses_thread_pool() const
+{
+  return m_impl->uses_thread_pool();
+}
+
+void async_io::submit(std::unique_ptr<request>&& req)
+{
+  m_impl->submit(std::move(req));
+}
+
+async_file::async_file(async_io& io, const std::string& filename, const std::string& mode)
+  : m_io(io)
+  , m_file(std::make_shared<async_io::file>(open_file_descriptor_with_exception(filename, mode)))
+{
+}
+
+async_file::~async_file()
+{
+}
+
+uint64_t async_file::size() const
+{
+#if LAF_WINDOWS
+  struct _stat64 sts;
+  return (_fstat64(m_file->fd, &sts) == 0 ? uint64_t(sts.st_size) : 0);
+#else
+  struct stat sts;
+  return (fstat(m_file->fd, &sts) == 0 ? uint64_t(sts.st_size) : 0);
+#endif
+}
+
+void async_file::read(const uint64_t offset,
+                      void* buf,
+                      const size_t size,
+                      callback_t&& callback,
+                      const task_token* token)
+{
+  submit(false, offset, buf, size, std::move(callback), token);
+}
+
+void async_file::write(const uint64_t offset,
+                       const void* buf,
+                       const size_t size,
+                       callback_t&& callback,
+                       const task_token* token)
+{
+  submit(true, offset, const_cast<void*>(buf), size, std::move(callback), token);
+}
+
+std::future<async_result> async_file::read(const uint64_t offset,
+                                           void* buf,
+                                           const size_t size,
+                                           const task_token* token)
+{
+  auto promise = std::make_shared<std::promise<async_result>>();
+  auto future = promise->get_future();
+  submit(
+    false,
+    offset,
+    buf,
+    size,
+    [promise](const async_result& result) { promise->set_value(result); },
+    token);
+  return future;
+}
+
+std::future<async_result> async_file::write(const uint64_t offset,
+                                            const void* buf,
+                                            const size_t size,
+                                            const task_token* token)
+{
+  auto promise = std::make_shared<std::promise<async_result>>();
+  auto future = promise->get_future();
+  submit(
+    true,
+    offset,
+    const_cast<void*>(buf),
+    size,
+    [promise](const async_result& result) { promise->set_value(result); },
+    token);
+  return future;
+}
+
+void async_file::submit(const bool write,
+                        const uint64_t offset,
+                        void* buf,
+                        const size_t size,
+                        callback_t&& callback,
+                        const task_token* token)
+{
+  auto req = std::make_unique<async_io::request>();
+  req->f = m_file;
+  req->write = write;
+  req->offset = offset;
+  req->buf = (uint8_t*)buf;
+  req->size = size;
+  req->callback = std::move(callback);
+  req->token = token;
+  m_io.submit(std::move(req));
+}
+
+} // namespace base
@@ -0,0 +1,171 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_ASYNC_FILE_H_INCLUDED
+#define BASE_ASYNC_FILE_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+
+namespace base {
+
+class async_file;
+class task_token;
+class thread_pool;
+
+struct async_result {
+  // Number of bytes read/written (can be less than the requested
+  // size when reading at the end of the file)
+  int64_t bytes = 0;
+  // errno value, 0 if the operation succeeded or ECANCELED if the
+  // task_token was canceled before the operation started.
+  int error = 0;
+
+  bool ok() const { return error == 0; }
+};
+
+// Executes asynchronous read/write requests of async_files. On Linux
+// it uses io_uring (requests are submitted to the kernel and
+// completed in a background thread without blocking any thread per
+// request), on other platforms (or if io_uring cannot be used) each
+// request is a blocking pread()/pwrite() executed in a thread_pool.
+//
+//   base::async_io io;
+//   base::async_file file(io, "sprite.png");
+//   std::vector<uint8_t> buf(file.size());
+//   file.read(0, buf.data(), buf.size(), [&](const base::async_result& r) {
+//     ...decode buf...
+//   });
+//   io.wait_all();
+//
+// Completion callbacks are called from a background thread (the
+// io_uring completion thread or a worker of the thread pool), so
+// they should be short (e.g. enqueue the decoding of the data in
+// other thread_pool).
+class async_io {
+public:
+  using callback_t = std::function<void(const async_result&)>;
+
+  // Requests made while a batch object is alive are submitted
+  // together (with just one system call in io_uring) when the last
+  // batch is destroyed.
+  class batch {
+  public:
+    explicit batch(async_io& io);
+    ~batch();
+
+    batch(const batch&) = delete;
+    batch& operator=(const batch&) = delete;
+
+  private:
+    async_io& m_io;
+  };
+
+  // "pool" is the thread pool used when io_uring is not available
+  // (or if "useThreadPool" is true), if it's nullptr a pool is created
+  // for this async_io. "queueDepth" is the max number of requests
+  // submitted to the kernel at the same time, other requests wait in
+  // a queue until the previous ones are completed.
+  explicit async_io(thread_pool* pool = nullptr,
+                    bool useThreadPool = false,
+                    unsigned queueDepth = 64);
+
+  // Waits all pending requests.
+  ~async_io();
+
+  async_io(const async_io&) = delete;
+  async_io& operator=(const async_io&) = delete;
+
+  // Waits until all requests are completed (and their callbacks are
+  // called).
+  void wait_all();
+
+  // Number of requests not completed yet.
+  size_t pending() const;
+
+  // Returns true if requests are executed in a thread pool instead of
+  // using io_uring.
+  bool uses_thread_pool() const;
+
+private:
+  friend class async_file;
+  struct file;
+  struct request;
+  class impl;
+  class pool_impl;
+  class uring_impl;
+
+  void submit(std::unique_ptr<request>&& req);
+
+  std::unique_ptr<impl> m_impl;
+};
+
+// A file opened to be read/written with asynchronous requests. The
+// buffers given to read()/write() must be valid until the request is
+// completed. The async_file can be destroyed with pending requests
+// (the file is closed when they are completed).
+class async_file {
+public:
+  using callback_t = async_io::callback_t;
+
+  // Opens the file with the given mode ("rb" or "wb", see
+  // open_file_descriptor_with_exception()). Throws an exception if the
+  // file cannot be opened.
+  async_file(async_io& io, const std::string& filename, const std::string& mode = "rb");
+  ~async_file();
+
+  async_file(const async_file&) = delete;
+  async_file& operator=(const async_file&) = delete;
+
+  // Current size of the file.
+  uint64_t size() const;
+
+  // Reads/writes "size" bytes at the given "offset" of the file and
+  // calls "callback" when the operation is completed. If the "token"
+  // is canceled before the request is started, the callback receives
+  // ECANCELED (requests that are already running are not
+  // interrupted).
+  void read(uint64_t offset,
+            void* buf,
+            size_t size,
+            callback_t&& callback,
+            const task_token* token = nullptr);
+  void write(uint64_t offset,
+             const void* buf,
+             size_t size,
+             callback_t&& callback,
+             const task_token* token = nullptr);
+
+  // Same as above, but the result is received through a future.
+  std::future<async_result> read(uint64_t offset,
+                                 void* buf,
+                                 size_t size,
+                                 const task_token* token = nullptr);
+  std::future<async_result> write(uint64_t offset,
+                                  const void* buf,
+                                  size_t size,
+                                  const task_token* token = nullptr);
+
+private:
+  void submit(bool write,
+              uint64_t offset,
+              void* buf,
+              size_t size,
+              callback_t&& callback,
+              const task_token* token);
+
+  async_io& m_io;
+  std::shared_ptr<async_io::file> m_file;
+};
+
+} // namespace base
+
+#endif
@@ -0,0 +1,95 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/async_file.h"
+#include "base/chrono.h"
+#include "base/file_content.h"
+#include "base/fs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace base;
+
+static std::vector<uint8_t> make_data(const size_t size, const int seed)
+{
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i)
+    data[i] = uint8_t(i * 31 + seed);
+  return data;
+}
+
+TEST(AsyncFile, Benchmark)
+{
+  // Read N files with blocking reads vs all requests in flight at the
+  // same time (files are in the disk cache, so the difference is the
+  // overhead per request)
+  const int n = 200;
+  const size_t size = 64 * 1024;
+  std::vector<std::string> files;
+  make_directory("_test_async_bench_");
+  for (int i = 0; i < n; ++i) {
+    files.push_back(join_path("_test_async_bench_", std::to_string(i) + ".bin"));
+    const std::vector<uint8_t> data = make_data(size, i);
+    write_file_content(files.back(), data.data(), data.size());
+  }
+
+  std::vector<uint8_t> buf(n * size);
+  {
+    // Open all files once to grow the table of file descriptors (it's
+    // slow the first time in a process with several threads)
+    async_io io;
+    std::vector<std::unique_ptr<async_file>> handles;
+    for (int i = 0; i < n; ++i)
+      handles.push_back(std::make_unique<async_file>(io, files[i]));
+  }
+
+  Chrono chrono;
+  for (int i = 0; i < n; ++i) {
+    const buffer data = read_file_content(files[i]);
+    std::copy(data.begin(), data.end(), buf.begin() + i * size);
+  }
+  const double t1 = chrono.elapsed();
+
+  for (const bool useThreadPool : { false, true }) {
+    async_io io(nullptr, useThreadPool, 256);
+    std::atomic<size_t> total = 0;
+    chrono.reset();
+    {
+      std::vector<std::unique_ptr<async_file>> handles;
+      async_io::batch batch(io);
+      for (int i = 0; i < n; ++i) {
+        handles.push_back(std::make_unique<async_file>(io, files[i]));
+        handles.back()->read(0, buf.data() + i * size, size, [&](const async_result& r) {
+          total += r.bytes;
+        });
+      }
+    }
+    io.wait_all();
+    const double t2 = chrono.elapsed();
+    EXPECT_EQ(n * size, total);
+    std::printf("%-20s %.2f ms\n",
+                (io.uses_thread_pool() ? "async (thread pool)" : "async (io_uring)"),
+                t2 * 1000.0);
+  }
+  std::printf("%-20s %.2f ms\n", "read_file_content", t1 * 1000.0);
+
+  for (const std::string& fn : files)
+    delete_file(fn);
+  remove_directory("_test_async_bench_");
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
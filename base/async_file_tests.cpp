@@ -0,0 +1,147 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/async_file.h"
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/task.h"
+#include "base/thread_pool.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <vector>
+
+using namespace base;
+
+static std::vector<uint8_t> make_data(const size_t size, const int seed)
+{
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i)
+    data[i] = uint8_t(i * 31 + seed);
+  return data;
+}
+
+static void test_read_write(async_io& io)
+{
+  const std::string fn = "_test_async_file_.bin";
+  const std::vector<uint8_t> data = make_data(300000, 1);
+
+  {
+    async_file file(io, fn, "wb");
+    // Write the file in 3 parts
+    std::atomic<int64_t> written = 0;
+    {
+      async_io::batch batch(io);
+      for (size_t i = 0; i < 3; ++i) {
+        file.write(i * 100000, data.data() + i * 100000, 100000, [&](const async_result& r) {
+          EXPECT_TRUE(r.ok());
+          written += r.bytes;
+        });
+      }
+    }
+    io.wait_all();
+    EXPECT_EQ(0, io.pending());
+    EXPECT_EQ(300000, written);
+    EXPECT_EQ(300000, file.size());
+  }
+  EXPECT_EQ(data, read_file_content(fn));
+
+  {
+    async_file file(io, fn);
+    std::vector<uint8_t> buf(file.size());
+    auto a = file.read(0, buf.data(), 1000);
+    auto b = file.read(1000, buf.data() + 1000, buf.size() - 1000);
+    EXPECT_EQ(1000, a.get().bytes);
+    EXPECT_EQ(buf.size() - 1000, b.get().bytes);
+    EXPECT_EQ(data, buf);
+
+    // Read at the end of the file
+    uint8_t tail[100];
+    async_result r = file.read(data.size() - 10, tail, sizeof(tail)).get();
+    EXPECT_TRUE(r.ok());
+    EXPECT_EQ(10, r.bytes);
+    EXPECT_EQ(0, std::memcmp(tail, data.data() + data.size() - 10, 10));
+    r = file.read(data.size() + 10, tail, sizeof(tail)).get();
+    EXPECT_TRUE(r.ok());
+    EXPECT_EQ(0, r.bytes);
+
+    // Canceled requests
+    task_token token;
+    token.cancel();
+    r = file.read(0, buf.data(), buf.size(), &token).get();
+    EXPECT_EQ(ECANCELED, r.error);
+    EXPECT_EQ(0, r.bytes);
+  }
+
+  // Read/write errors
+  {
+    async_file file(io, fn, "rb");
+    const async_result r = file.write(0, data.data(), data.size()).get();
+    EXPECT_FALSE(r.ok());
+  }
+
+  EXPECT_THROW(async_file(io, "non-existent-file.bin"), std::exception);
+  delete_file(fn);
+}
+
+TEST(AsyncFile, IoUring)
+{
+  async_io io;
+#if LAF_LINUX
+  if (io.uses_thread_pool())
+    std::printf("io_uring is not available\n");
+#else
+  EXPECT_TRUE(io.uses_thread_pool());
+#endif
+  test_read_write(io);
+}
+
+TEST(AsyncFile, ThreadPool)
+{
+  async_io io(nullptr, true);
+  EXPECT_TRUE(io.uses_thread_pool());
+  test_read_write(io);
+
+  thread_pool pool(2);
+  async_io io2(&pool, true);
+  test_read_write(io2);
+}
+
+TEST(AsyncFile, QueueDepth)
+{
+  // More requests than the queue depth
+  const std::string fn = "_test_async_file_.bin";
+  const std::vector<uint8_t> data = make_data(4096 * 64, 2);
+  write_file_content(fn, data.data(), data.size());
+
+  async_io io(nullptr, false, 4);
+  async_file file(io, fn);
+  std::vector<uint8_t> buf(data.size());
+  std::atomic<int> count = 0;
+  {
+    async_io::batch batch(io);
+    for (size_t i = 0; i < 64; ++i)
+      file.read(i * 4096, buf.data() + i * 4096, 4096, [&](const async_result& r) {
+        if (r.bytes == 4096)
+          ++count;
+      });
+    EXPECT_EQ(64, io.pending());
+  }
+  io.wait_all();
+  EXPECT_EQ(64, count);
+  EXPECT_EQ(data, buf);
+
+  delete_file(fn);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2022 Igara Studio S.A.
+// Copyright (c) 2022-2026 Igara Studio S.A.
 // Copyright (c) 2015-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -10,10 +10,12 @@
 #endif
 
 #include "base/base64.h"
+#include "base/cpu_features.h"
 #include "base/debug.h"
 #include "base/ints.h"
 
-#include <cmath>
+#include <algorithm>
+#include <atomic>
 
 namespace base {
 
@@ -49,85 +51,387 @@ static inline char base64Char(int index)
 static inline int base64Inv(int asciiChar)
 {
   asciiChar -= 32;
-  if (asciiChar >= 0 && asciiChar < sizeof(invBase64Table))
+  if (asciiChar >= 0 && asciiChar < int(sizeof(invBase64Table) / sizeof(invBase64Table[0])))
     return invBase64Table[asciiChar];
   return 0;
 }
 
-void encode_base64(const char* input, size_t n, std::string& output)
+//////////////////////////////////////////////////////////////////////
+// Kernels
+//
+// Encode kernels convert groups of 3 bytes into 4 chars, and decode
+// kernels groups of 4 chars into 3 bytes. They return the number of
+// input bytes/chars that were processed (always complete groups).
+// Decode kernels stop before the first group with a padding char or
+// an invalid char (which are handled by the scalar decoder).
+
+static size_t encode_scalar(const uint8_t* input, const size_t n, char* output)
 {
-  const size_t size = 4 * int(std::ceil(n / 3.0)); // Estimate encoded string size
-  output.resize(size);
+  size_t i = 0;
+  for (; i + 3 <= n; i += 3, input += 3, output += 4) {
+    const uint32_t v = (uint32_t(input[0]) << 16) | (uint32_t(input[1]) << 8) | input[2];
+    output[0] = base64Table[(v >> 18) & 63];
+    output[1] = base64Table[(v >> 12) & 63];
+    output[2] = base64Table[(v >> 6) & 63];
+    output[3] = base64Table[v & 63];
+  }
+  return i;
+}
 
-  auto outIt = output.begin();
-  auto outEnd = output.end();
-  uint8_t next = 0;
+// Decodes groups of 4 chars until the end of the input or until a
+// padding char '=' is found (returning "ended=true"). Invalid chars
+// are decoded as 0 (e.g. 'A').
+static size_t decode_scalar(const char* input,
+                            const size_t n,
+                            uint8_t* output,
+                            size_t& outputSize,
+                            bool& ended)
+{
   size_t i = 0;
-  size_t j = 0;
-  for (; i < n; ++i, ++input) {
-    auto inputValue = *input;
-    switch (j) {
-      case 0:
-        *outIt = base64Char((inputValue & 0b11111100) >> 2);
-        ++outIt;
-        next |= (inputValue & 0b00000011) << 4;
-        ++j;
-        break;
-      case 1:
-        *outIt = base64Char(((inputValue & 0b11110000) >> 4) | next);
-        ++outIt;
-        next = (inputValue & 0b00001111) << 2;
-        ++j;
-        break;
-      case 2:
-        *outIt = base64Char(((inputValue & 0b11000000) >> 6) | next);
-        ++outIt;
-        *outIt = base64Char(inputValue & 0b00111111);
-        ++outIt;
-        next = 0;
-        j = 0;
-        break;
+  outputSize = 0;
+  ended = false;
+  for (; i + 3 < n; i += 4, input += 4) {
+    const int a = base64Inv(input[0]);
+    const int b = base64Inv(input[1]);
+    output[outputSize++] = ((a << 2) | ((b & 0b110000) >> 4));
+
+    if (input[2] == '=') {
+      ended = true;
+      return i + 4;
     }
-  }
+    const int c = base64Inv(input[2]);
+    output[outputSize++] = (((b & 0b001111) << 4) | ((c & 0b111100) >> 2));
 
-  if (outIt != outEnd) {
-    if (next) {
-      *outIt = base64Char(next);
-      ++outIt;
+    if (input[3] == '=') {
+      ended = true;
+      return i + 4;
     }
-    for (; outIt != outEnd; ++outIt)
-      *outIt = '='; // Padding
+    const int d = base64Inv(input[3]);
+    output[outputSize++] = (((c & 0b000011) << 6) | d);
   }
+  return i;
 }
 
-void decode_base64(const char* input, size_t n, buffer& output)
+#if LAF_X86
+
+// SIMD algorithms from Wojciech Muła and Daniel Lemire, "Faster
+// Base64 Encoding and Decoding Using AVX2 Instructions" (ACM TWEB,
+// 2018) and http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html
+
+LAF_TARGET("ssse3")
+static size_t encode_ssse3(const uint8_t* input, const size_t n, char* output)
 {
-  size_t size = 3 * int(std::ceil(n / 4.0)); // Estimate decoded buffer size
-  output.resize(size);
+  const __m128i shuf = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+  const __m128i shiftLut = _mm_setr_epi8('a' - 26,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '+' - 62,
+                                         '/' - 63,
+                                         'A',
+                                         0,
+                                         0);
+  size_t i = 0;
+  // Each iteration reads 16 bytes (but uses only 12)
+  for (; i + 16 <= n; i += 12, output += 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+
+    // Split 3 bytes into 4 indexes of 6 bits (one per byte)
+    in = _mm_shuffle_epi8(in, shuf);
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i indexes = _mm_or_si128(t1, t3);
+
+    // Convert indexes to ASCII adding an offset for each range
+    __m128i r = _mm_subs_epu8(indexes, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indexes);
+    r = _mm_or_si128(r, _mm_and_si128(less, _mm_set1_epi8(13)));
+    r = _mm_add_epi8(_mm_shuffle_epi8(shiftLut, r), indexes);
 
-  auto outIt = output.begin();
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output), r);
+  }
+  return i + encode_scalar(input + i, n - i, output);
+}
+
+LAF_TARGET("avx2")
+static size_t encode_avx2(const uint8_t* input, const size_t n, char* output)
+{
+  const __m256i shuf = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                       10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+  const __m256i shiftLut = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                            '/' - 63, 'A', 0, 0,
+                                            'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                            '/' - 63, 'A', 0, 0);
   size_t i = 0;
-  for (; i + 3 < n; i += 4, input += 4) {
-    *outIt = (((base64Inv(input[0])) << 2) | ((base64Inv(input[1]) & 0b110000) >> 4));
-    ++outIt;
+  // Each iteration reads 28 bytes (but uses only 24)
+  for (; i + 28 <= n; i += 24, output += 32) {
+    const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+    const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 12));
+    __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
 
-    if (input[2] == '=') {
-      size -= 2;
-      break;
-    }
+    in = _mm256_shuffle_epi8(in, shuf);
+    const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    const __m256i indexes = _mm256_or_si256(t1, t3);
 
-    *outIt = (((base64Inv(input[1]) & 0b001111) << 4) | ((base64Inv(input[2]) & 0b111100) >> 2));
-    ++outIt;
+    __m256i r = _mm256_subs_epu8(indexes, _mm256_set1_epi8(51));
+    const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indexes);
+    r = _mm256_or_si256(r, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+    r = _mm256_add_epi8(_mm256_shuffle_epi8(shiftLut, r), indexes);
 
-    if (input[3] == '=') {
-      --size;
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), r);
+  }
+  return i + encode_ssse3(input + i, n - i, output);
+}
+
+// Lookup tables indexed by the high nibble of each char to validate
+// and convert ASCII chars to 6-bit values. '/' is a special case (the
+// only valid char with high nibble = 2 is '+').
+alignas(16) static const int8_t decodeLowerLut[16] = {
+  1, 1, 0x2b, 0x30, 0x41, 0x50, 0x61, 0x70, 1, 1, 1, 1, 1, 1, 1, 1
+};
+alignas(16) static const int8_t decodeUpperLut[16] = {
+  0, 0, 0x2b, 0x39, 0x4f, 0x5a, 0x6f, 0x7a, 0, 0, 0, 0, 0, 0, 0, 0
+};
+alignas(16) static const int8_t decodeShiftLut[16] = {
+  0, 0, 0x3e - 0x2b, 0x34 - 0x30, 0x00 - 0x41, 0x0f - 0x50, 0x1a - 0x61, 0x29 - 0x70,
+  0, 0, 0,           0,           0,           0,           0,           0
+};
+
+LAF_TARGET("ssse3")
+static size_t decode_ssse3(const char* input, const size_t n, uint8_t* output)
+{
+  const __m128i lowerLut = _mm_load_si128(reinterpret_cast<const __m128i*>(decodeLowerLut));
+  const __m128i upperLut = _mm_load_si128(reinterpret_cast<const __m128i*>(decodeUpperLut));
+  const __m128i shiftLut = _mm_load_si128(reinterpret_cast<const __m128i*>(decodeShiftLut));
+  const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+  size_t i = 0;
+  // Each iteration writes 16 bytes (but only 12 are valid), so we
+  // keep 8 chars of margin (6 bytes in the output).
+  for (; i + 24 <= n; i += 16, output += 12) {
+    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+
+    // Validate chars
+    const __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0f));
+    const __m128i below = _mm_cmplt_epi8(in, _mm_shuffle_epi8(lowerLut, hiNibbles));
+    const __m128i above = _mm_cmpgt_epi8(in, _mm_shuffle_epi8(upperLut, hiNibbles));
+    const __m128i eq2f = _mm_cmpeq_epi8(in, _mm_set1_epi8(0x2f));
+    const __m128i outside = _mm_andnot_si128(eq2f, _mm_or_si128(above, below));
+    if (_mm_movemask_epi8(outside))
+      break; // Padding or invalid chars
+
+    // Convert chars to 6-bit values
+    __m128i values = _mm_add_epi8(in, _mm_shuffle_epi8(shiftLut, hiNibbles));
+    values = _mm_add_epi8(values, _mm_and_si128(eq2f, _mm_set1_epi8(-3)));
+
+    // Pack 4 values of 6 bits into 3 bytes
+    const __m128i ab = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    __m128i out = _mm_madd_epi16(ab, _mm_set1_epi32(0x00011000));
+    out = _mm_shuffle_epi8(out, pack);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output), out);
+  }
+  return i;
+}
+
+LAF_TARGET("avx2")
+static size_t decode_avx2(const char* input, const size_t n, uint8_t* output)
+{
+  const __m256i lowerLut = _mm256_broadcastsi128_si256(
+    _mm_load_si128(reinterpret_cast<const __m128i*>(decodeLowerLut)));
+  const __m256i upperLut = _mm256_broadcastsi128_si256(
+    _mm_load_si128(reinterpret_cast<const __m128i*>(decodeUpperLut)));
+  const __m256i shiftLut = _mm256_broadcastsi128_si256(
+    _mm_load_si128(reinterpret_cast<const __m128i*>(decodeShiftLut)));
+  const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  const __m256i perm = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+  size_t i = 0;
+  // Each iteration writes 32 bytes (but only 24 are valid)
+  for (; i + 48 <= n; i += 32, output += 24) {
+    const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+
+    const __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), _mm256_set1_epi8(0x0f));
+    const __m256i below = _mm256_cmpgt_epi8(_mm256_shuffle_epi8(lowerLut, hiNibbles), in);
+    const __m256i above = _mm256_cmpgt_epi8(in, _mm256_shuffle_epi8(upperLut, hiNibbles));
+    const __m256i eq2f = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(0x2f));
+    const __m256i outside = _mm256_andnot_si256(eq2f, _mm256_or_si256(above, below));
+    if (_mm256_movemask_epi8(outside))
       break;
-    }
 
-    *outIt = (((base64Inv(input[2]) & 0b000011) << 6) | ((base64Inv(input[3]))));
-    ++outIt;
+    __m256i values = _mm256_add_epi8(in, _mm256_shuffle_epi8(shiftLut, hiNibbles));
+    values = _mm256_add_epi8(values, _mm256_and_si256(eq2f, _mm256_set1_epi8(-3)));
+
+    const __m256i ab = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    __m256i out = _mm256_madd_epi16(ab, _mm256_set1_epi32(0x00011000));
+    out = _mm256_shuffle_epi8(out, pack);
+    out = _mm256_permutevar8x32_epi32(out, perm);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), out);
   }
+  return i + decode_ssse3(input + i, n - i, output);
+}
+
+using details::base64_kernel;
+
+static bool cpu_supports(const base64_kernel kernel)
+{
+  const cpu_features& cpu = get_cpu_features();
+  if (kernel == base64_kernel::SSSE3)
+    return cpu.ssse3;
+  return cpu.avx2;
+}
+
+#endif // LAF_X86
+
+struct kernels {
+  base64_kernel kernel;
+  size_t (*encode)(const uint8_t* input, size_t n, char* output);
+  size_t (*decode)(const char* input, size_t n, uint8_t* output);
+};
 
+static size_t decode_none(const char*, size_t, uint8_t*)
+{
+  return 0;
+}
+
+static const kernels* find_kernels(const base64_kernel kernel)
+{
+  static const kernels all[] = {
+    { base64_kernel::Scalar, encode_scalar, decode_none },
+#if LAF_X86
+    { base64_kernel::SSSE3, encode_ssse3, decode_ssse3 },
+    { base64_kernel::AVX2, encode_avx2, decode_avx2 },
+#endif
+  };
+  for (const kernels& k : all) {
+    if (k.kernel == kernel)
+      return &k;
+  }
+  return &all[0];
+}
+
+// The kernels can be changed from tests with set_base64_kernel()
+// while other threads are using them.
+static std::atomic<const kernels*>& kernels_ptr()
+{
+  static std::atomic<const kernels*> k = find_kernels(
+#if LAF_X86
+    cpu_supports(base64_kernel::AVX2)  ? base64_kernel::AVX2 :
+    cpu_supports(base64_kernel::SSSE3) ? base64_kernel::SSSE3 :
+#endif
+                                         base64_kernel::Scalar);
+  return k;
+}
+
+static const kernels& current_kernels()
+{
+  return *kernels_ptr().load(std::memory_order_relaxed);
+}
+
+base64_kernel details::get_base64_kernel()
+{
+  return current_kernels().kernel;
+}
+
+bool details::set_base64_kernel(const base64_kernel kernel)
+{
+#if LAF_X86
+  if (kernel != base64_kernel::Scalar && !cpu_supports(kernel))
+    return false;
+#else
+  if (kernel != base64_kernel::Scalar)
+    return false;
+#endif
+  kernels_ptr().store(find_kernels(kernel), std::memory_order_relaxed);
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Encoder/decoder
+
+// Encodes the last 1 or 2 bytes of the input (with padding).
+static void encode_tail(const uint8_t* input, const size_t n, char* output)
+{
+  ASSERT(n == 1 || n == 2);
+  output[0] = base64Char(input[0] >> 2);
+  if (n == 1) {
+    output[1] = base64Char((input[0] & 0b11) << 4);
+    output[2] = '=';
+  }
+  else {
+    output[1] = base64Char(((input[0] & 0b11) << 4) | (input[1] >> 4));
+    output[2] = base64Char((input[1] & 0b1111) << 2);
+  }
+  output[3] = '=';
+}
+
+// Decodes the input appending the bytes to the output from
+// "outputPos". Returns the number of processed chars.
+static size_t decode_chunk(const char* input,
+                           const size_t n,
+                           buffer& output,
+                           size_t& outputPos,
+                           bool& ended)
+{
+  output.resize(std::max(output.size(), outputPos + 3 * (n / 4)));
+
+  const size_t simd = current_kernels().decode(input, n, &output[outputPos]);
+  outputPos += 3 * (simd / 4);
+
+  size_t scalarSize = 0;
+  const size_t scalar = decode_scalar(input + simd,
+                                      n - simd,
+                                      output.data() + outputPos,
+                                      scalarSize,
+                                      ended);
+  outputPos += scalarSize;
+  return simd + scalar;
+}
+
+void encode_base64(const char* input, size_t n, std::string& output)
+{
+  output.resize(4 * ((n + 2) / 3));
+  if (n == 0)
+    return;
+
+  auto in = reinterpret_cast<const uint8_t*>(input);
+  const size_t done = current_kernels().encode(in, n, &output[0]);
+  if (done < n)
+    encode_tail(in + done, n - done, &output[4 * (done / 3)]);
+}
+
+void decode_base64(const char* input, size_t n, buffer& output)
+{
+  // Estimate decoded buffer size (incomplete groups of chars at the
+  // end are decoded as zeros)
+  size_t size = 3 * ((n + 3) / 4);
+  output.resize(size);
+  if (n == 0)
+    return;
+
+  size_t pos = 0;
+  bool ended;
+  decode_chunk(input, n, output, pos, ended);
+  if (ended)
+    size = pos;
+  else
+    std::fill(output.begin() + pos, output.begin() + size, 0);
   if (output.size() > size)
     output.resize(size);
 }
@@ -139,4 +443,84 @@ void decode_base64(const char* input, size_t n, std::string& output)
   output = std::string((const char*)tmp.data(), tmp.size());
 }
 
+void base64_encoder::encode(const uint8_t* input, size_t n, std::string& output)
+{
+  // Complete the pending group of 3 bytes
+  while (m_pending > 0 && m_pending < 3 && n > 0) {
+    m_buf[m_pending++] = *input++;
+    --n;
+  }
+  if (m_pending == 3) {
+    const size_t pos = output.size();
+    output.resize(pos + 4);
+    encode_scalar(m_buf, 3, &output[pos]);
+    m_pending = 0;
+  }
+
+  const size_t groups = n / 3;
+  if (groups > 0) {
+    const size_t pos = output.size();
+    output.resize(pos + 4 * groups);
+    current_kernels().encode(input, 3 * groups, &output[pos]);
+    input += 3 * groups;
+    n -= 3 * groups;
+  }
+
+  // Keep the remaining bytes for the next call
+  for (; n > 0; --n)
+    m_buf[m_pending++] = *input++;
+}
+
+void base64_encoder::finish(std::string& output)
+{
+  if (m_pending > 0) {
+    const size_t pos = output.size();
+    output.resize(pos + 4);
+    encode_tail(m_buf, m_pending, &output[pos]);
+    m_pending = 0;
+  }
+}
+
+void base64_decoder::decode(const char* input, size_t n, buffer& output)
+{
+  if (m_ended)
+    return;
+
+  size_t pos = output.size();
+
+  // Complete the pending group of 4 chars
+  while (m_pending > 0 && m_pending < 4 && n > 0) {
+    m_buf[m_pending++] = *input++;
+    --n;
+  }
+  if (m_pending == 4) {
+    m_pending = 0;
+    decode_chunk(m_buf, 4, output, pos, m_ended);
+    if (m_ended) {
+      output.resize(pos);
+      return;
+    }
+  }
+
+  const size_t done = decode_chunk(input, n - (n % 4), output, pos, m_ended);
+  output.resize(pos);
+  if (m_ended)
+    return;
+
+  input += done;
+  n -= done;
+  for (; n > 0; --n)
+    m_buf[m_pending++] = *input++;
+}
+
+void base64_decoder::finish(buffer& output)
+{
+  // Incomplete group of chars at the end are decoded as zeros (like
+  // decode_base64() does)
+  if (!m_ended && m_pending > 0)
+    output.resize(output.size() + 3);
+  m_pending = 0;
+  m_ended = false;
+}
+
 } // namespace base
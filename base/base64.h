@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2022 Igara Studio S.A.
+// Copyright (c) 2022-2026 Igara Studio S.A.
 // Copyright (c) 2015-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -15,9 +15,61 @@
 
 namespace base {
 
+namespace details {
+
+// Implementation used to encode/decode base64. By default the fastest
+// one supported by the CPU is selected at runtime.
+enum class base64_kernel {
+  Scalar,
+  SSSE3,
+  AVX2,
+};
+
+base64_kernel get_base64_kernel();
+
+// Only for tests and benchmarks, changes the implementation used by
+// all threads. Returns false if the given kernel is not supported by
+// this CPU.
+bool set_base64_kernel(base64_kernel kernel);
+
+} // namespace details
+
 void encode_base64(const char* input, size_t n, std::string& output);
 void decode_base64(const char* input, size_t n, buffer& output);
 
+// Encodes a stream of data in chunks (e.g. when data is read from a
+// file), appending the encoded chars to the output. The result is
+// the same as calling encode_base64() with all the data at once.
+//
+//   base::base64_encoder encoder;
+//   std::string output;
+//   while (...)
+//     encoder.encode(chunk, chunkSize, output);
+//   encoder.finish(output);
+//
+class base64_encoder {
+public:
+  void encode(const uint8_t* input, size_t n, std::string& output);
+  void finish(std::string& output);
+
+private:
+  uint8_t m_buf[3];
+  size_t m_pending = 0;
+};
+
+// Decodes a stream of base64 chars in chunks, appending the decoded
+// bytes to the output. Data after a padding char '=' is ignored.
+class base64_decoder {
+public:
+  void decode(const char* input, size_t n, buffer& output);
+  void finish(buffer& output);
+
+private:
+  char m_buf[4];
+  size_t m_pending = 0;
+  bool m_ended = false;
+};
+
 inline void encode_base64(const buffer& input, std::string& output)
 {
   if (!input.empty())
@@ -0,0 +1,75 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/base64.h"
+#include "base/chrono.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace base;
+using namespace base::details;
+
+static std::vector<base64_kernel> supported_kernels()
+{
+  std::vector<base64_kernel> kernels;
+  const base64_kernel old = get_base64_kernel();
+  for (auto k : { base64_kernel::Scalar, base64_kernel::SSSE3, base64_kernel::AVX2 }) {
+    if (set_base64_kernel(k))
+      kernels.push_back(k);
+  }
+  set_base64_kernel(old);
+  return kernels;
+}
+
+static buffer random_buffer(std::mt19937& gen, const size_t n)
+{
+  std::uniform_int_distribution<int> dist(0, 255);
+  buffer buf(n);
+  for (auto& b : buf)
+    b = uint8_t(dist(gen));
+  return buf;
+}
+
+TEST(Base64, Benchmark)
+{
+  const base64_kernel old = get_base64_kernel();
+  std::mt19937 gen(3);
+  const buffer input = random_buffer(gen, 4 * 1024 * 1024);
+  const int times = 10;
+
+  for (base64_kernel k : supported_kernels()) {
+    set_base64_kernel(k);
+
+    std::string encoded;
+    Chrono chrono;
+    for (int i = 0; i < times; ++i)
+      encode_base64((const char*)input.data(), input.size(), encoded);
+    const double encodeSecs = chrono.elapsed();
+
+    buffer decoded;
+    chrono.reset();
+    for (int i = 0; i < times; ++i)
+      decode_base64(encoded.c_str(), encoded.size(), decoded);
+    const double decodeSecs = chrono.elapsed();
+
+    EXPECT_EQ(input, decoded);
+    std::printf("Kernel %d: encode %.2f GB/s, decode %.2f GB/s\n",
+                int(k),
+                times * input.size() / encodeSecs / 1e9,
+                times * encoded.size() / decodeSecs / 1e9);
+  }
+  set_base64_kernel(old);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
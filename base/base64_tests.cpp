@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2022 Igara Studio S.A.
+// Copyright (c) 2022-2026 Igara Studio S.A.
 // Copyright (c) 2015-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -10,7 +10,11 @@
 #include "base/base64.h"
 #include "base/string.h"
 
+#include <random>
+#include <vector>
+
 using namespace base;
+using namespace base::details;
 
 TEST(Base64, Encode)
 {
@@ -21,6 +25,11 @@ TEST(Base64, Encode)
   EXPECT_EQ("YWJjZGU=", encode_base64("abcde"));
   EXPECT_EQ("YWJj", encode_base64("abc"));
   EXPECT_EQ("5pel5pys6Kqe", encode_base64("\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E")); // "日本語"
+
+  // Last char with zero bits
+  EXPECT_EQ("QA==", encode_base64("@"));
+  EXPECT_EQ("AAA=", encode_base64(buffer{ 0, 0 }));
+  EXPECT_EQ("AA==", encode_base64(buffer{ 0 }));
 }
 
 TEST(Base64, Decode)
@@ -34,6 +43,110 @@ TEST(Base64, Decode)
   EXPECT_EQ("\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E", decode_base64s("5pel5pys6Kqe")); // "日本語"
 }
 
+static std::vector<base64_kernel> supported_kernels()
+{
+  std::vector<base64_kernel> kernels;
+  const base64_kernel old = get_base64_kernel();
+  for (auto k : { base64_kernel::Scalar, base64_kernel::SSSE3, base64_kernel::AVX2 }) {
+    if (set_base64_kernel(k))
+      kernels.push_back(k);
+  }
+  set_base64_kernel(old);
+  return kernels;
+}
+
+static buffer random_buffer(std::mt19937& gen, const size_t n)
+{
+  std::uniform_int_distribution<int> dist(0, 255);
+  buffer buf(n);
+  for (auto& b : buf)
+    b = uint8_t(dist(gen));
+  return buf;
+}
+
+TEST(Base64, Kernels)
+{
+  const base64_kernel old = get_base64_kernel();
+  std::mt19937 gen(1);
+  for (size_t n = 0; n < 300; ++n) {
+    const buffer input = random_buffer(gen, n);
+
+    ASSERT_TRUE(set_base64_kernel(base64_kernel::Scalar));
+    const std::string expected = encode_base64(input);
+
+    for (base64_kernel k : supported_kernels()) {
+      set_base64_kernel(k);
+      const std::string encoded = encode_base64(input);
+      EXPECT_EQ(expected, encoded) << "Kernel " << int(k) << " size " << n;
+      EXPECT_EQ(input, decode_base64(encoded)) << "Kernel " << int(k) << " size " << n;
+    }
+  }
+  set_base64_kernel(old);
+}
+
+TEST(Base64, InvalidChars)
+{
+  const base64_kernel old = get_base64_kernel();
+  std::string input(200, 'A');
+  for (base64_kernel k : supported_kernels()) {
+    set_base64_kernel(k);
+
+    // Invalid chars are decoded as zero bits
+    for (size_t i = 0; i < input.size(); i += 7) {
+      std::string s = input;
+      s[i] = '*';
+      EXPECT_EQ(buffer(150, 0), decode_base64(s)) << "Kernel " << int(k);
+    }
+
+    // Data after the padding is ignored
+    std::string s = input;
+    s[102] = '=';
+    s[103] = '=';
+    EXPECT_EQ(buffer(76, 0), decode_base64(s)) << "Kernel " << int(k);
+
+    // Incomplete groups of chars are decoded as zeros
+    buffer output = { 1, 2, 3, 4, 5, 6 };
+    decode_base64("QUJD", 4, output);
+    EXPECT_EQ(buffer({ 'A', 'B', 'C' }), output);
+    decode_base64("QUJDRA", 6, output);
+    EXPECT_EQ(buffer({ 'A', 'B', 'C', 0, 0, 0 }), output);
+  }
+  set_base64_kernel(old);
+}
+
+TEST(Base64, Stream)
+{
+  std::mt19937 gen(2);
+  const buffer input = random_buffer(gen, 1000);
+  const std::string expected = encode_base64(input);
+
+  for (size_t chunk : { 1, 2, 3, 4, 5, 7, 64, 100, 999 }) {
+    base64_encoder encoder;
+    std::string encoded;
+    for (size_t i = 0; i < input.size(); i += chunk)
+      encoder.encode(&input[i], std::min(chunk, input.size() - i), encoded);
+    encoder.finish(encoded);
+    EXPECT_EQ(expected, encoded) << "Chunk " << chunk;
+
+    base64_decoder decoder;
+    buffer decoded;
+    for (size_t i = 0; i < encoded.size(); i += chunk)
+      decoder.decode(&encoded[i], std::min(chunk, encoded.size() - i), decoded);
+    decoder.finish(decoded);
+    EXPECT_EQ(input, decoded) << "Chunk " << chunk;
+  }
+
+  // Padding in the middle of the stream
+  base64_decoder decoder;
+  buffer decoded;
+  decoder.decode("YW", 2, decoded);
+  decoder.decode("Jj", 2, decoded);
+  decoder.decode("ZG", 2, decoded);
+  decoder.decode("U=YWJj", 6, decoded);
+  decoder.finish(decoded);
+  EXPECT_EQ(buffer({ 'a', 'b', 'c', 'd', 'e' }), decoded);
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -8,212 +9,108 @@
   #include "config.h"
 #endif
 
-#include <cstdio>
+#include "base/cfile.h"
+
+#include "base/debug.h"
+
+#include <cstring>
+#include <limits>
 
 namespace base {
 
-// Reads a WORD (16 bits) using little-endian byte ordering.
-int fgetw(FILE* file)
-{
-  int b1, b2;
+using namespace serialization;
 
-  b1 = fgetc(file);
-  if (b1 == EOF)
-    return EOF;
+namespace {
 
-  b2 = fgetc(file);
-  if (b2 == EOF)
-    return EOF;
+// Reads/writes a value with just one fread()/fwrite() call (instead
+// of one fgetc()/fputc() call per byte).
 
-  // Little endian.
-  return ((b2 << 8) | b1);
+template<typename T>
+bool read_little_endian(FILE* file, T& v)
+{
+  uint8_t buf[sizeof(T)];
+  if (std::fread(buf, 1, sizeof(T), file) != sizeof(T))
+    return false;
+  v = details::load<T>(buf, endian::little);
+  return true;
 }
 
-// Reads a DWORD (32 bits) using little-endian byte ordering.
-long fgetl(FILE* file)
+template<typename T>
+int write_little_endian(FILE* file, const T v)
 {
-  int b1, b2, b3, b4;
+  uint8_t buf[sizeof(T)];
+  details::store<T>(buf, v, endian::little);
+  return (std::fwrite(buf, 1, sizeof(T), file) == sizeof(T) ? 0 : -1);
+}
 
-  b1 = fgetc(file);
-  if (b1 == EOF)
-    return EOF;
+} // anonymous namespace
 
-  b2 = fgetc(file);
-  if (b2 == EOF)
-    return EOF;
-
-  b3 = fgetc(file);
-  if (b3 == EOF)
+// Reads a WORD (16 bits) using little-endian byte ordering.
+int fgetw(FILE* file)
+{
+  uint16_t v;
+  if (!read_little_endian(file, v))
     return EOF;
+  return v;
+}
 
-  b4 = fgetc(file);
-  if (b4 == EOF)
+// Reads a DWORD (32 bits) using little-endian byte ordering.
+long fgetl(FILE* file)
+{
+  uint32_t v;
+  if (!read_little_endian(file, v))
     return EOF;
-
-  // Little endian.
-  return ((b4 << 24) | (b3 << 16) | (b2 << 8) | b1);
+  return int32_t(v);
 }
 
 // Reads a QWORD (64 bits) using little-endian byte ordering.
 long long fgetq(FILE* file)
 {
-  int b1, b2, b3, b4, b5, b6, b7, b8;
-
-  if ((b1 = fgetc(file)) == EOF)
-    return EOF;
-
-  if ((b2 = fgetc(file)) == EOF)
+  uint64_t v;
+  if (!read_little_endian(file, v))
     return EOF;
-
-  if ((b3 = fgetc(file)) == EOF)
-    return EOF;
-
-  if ((b4 = fgetc(file)) == EOF)
-    return EOF;
-
-  if ((b5 = fgetc(file)) == EOF)
-    return EOF;
-
-  if ((b6 = fgetc(file)) == EOF)
-    return EOF;
-
-  if ((b7 = fgetc(file)) == EOF)
-    return EOF;
-
-  if ((b8 = fgetc(file)) == EOF)
-    return EOF;
-
-  // Little endian.
-  return (((long long)b8 << 56) | ((long long)b7 << 48) | ((long long)b6 << 40) |
-          ((long long)b5 << 32) | ((long long)b4 << 24) | ((long long)b3 << 16) |
-          ((long long)b2 << 8) | (long long)b1);
+  return (long long)v;
 }
 
 // Reads a 32-bit single-precision floating point number using
 // little-endian byte ordering.
 float fgetf(FILE* file)
 {
-  int b1, b2, b3, b4;
-
-  if ((b1 = fgetc(file)) == EOF)
-    return EOF;
-
-  if ((b2 = fgetc(file)) == EOF)
-    return EOF;
-
-  if ((b3 = fgetc(file)) == EOF)
+  float v;
+  if (!read_little_endian(file, v))
     return EOF;
-
-  if ((b4 = fgetc(file)) == EOF)
-    return EOF;
-
-  // Little endian.
-  int v = ((b4 << 24) | (b3 << 16) | (b2 << 8) | b1);
-  return *reinterpret_cast<float*>(&v);
+  return v;
 }
 
 // Reads a 64-bit double-precision floating point number using
 // little-endian byte ordering.
 double fgetd(FILE* file)
 {
-  int b1, b2, b3, b4, b5, b6, b7, b8;
-
-  if ((b1 = fgetc(file)) == EOF)
-    return EOF;
-
-  if ((b2 = fgetc(file)) == EOF)
+  double v;
+  if (!read_little_endian(file, v))
     return EOF;
-
-  if ((b3 = fgetc(file)) == EOF)
-    return EOF;
-
-  if ((b4 = fgetc(file)) == EOF)
-    return EOF;
-
-  if ((b5 = fgetc(file)) == EOF)
-    return EOF;
-
-  if ((b6 = fgetc(file)) == EOF)
-    return EOF;
-
-  if ((b7 = fgetc(file)) == EOF)
-    return EOF;
-
-  if ((b8 = fgetc(file)) == EOF)
-    return EOF;
-
-  // Little endian.
-  long long v = (((long long)b8 << 56) | ((long long)b7 << 48) | ((long long)b6 << 40) |
-                 ((long long)b5 << 32) | ((long long)b4 << 24) | ((long long)b3 << 16) |
-                 ((long long)b2 << 8) | (long long)b1);
-  return *reinterpret_cast<double*>(&v);
+  return v;
 }
 
 // Writes a word using little-endian byte ordering.
 // Returns 0 in success or -1 in error
 int fputw(int w, FILE* file)
 {
-  int b1, b2;
-
-  // Little endian.
-  b2 = (w & 0xFF00) >> 8;
-  b1 = w & 0x00FF;
-
-  if (fputc(b1, file) == b1)
-    if (fputc(b2, file) == b2)
-      return 0;
-
-  return -1;
+  return write_little_endian(file, uint16_t(w));
 }
 
 // Writes DWORD a using little-endian byte ordering.
 // Returns 0 in success or -1 in error
 int fputl(long l, FILE* file)
 {
-  int b1, b2, b3, b4;
-
-  // Little endian.
-  b4 = (int)((l & 0xFF000000L) >> 24);
-  b3 = (int)((l & 0x00FF0000L) >> 16);
-  b2 = (int)((l & 0x0000FF00L) >> 8);
-  b1 = (int)l & 0x00FF;
-
-  if (fputc(b1, file) == b1)
-    if (fputc(b2, file) == b2)
-      if (fputc(b3, file) == b3)
-        if (fputc(b4, file) == b4)
-          return 0;
-
-  return -1;
+  return write_little_endian(file, uint32_t(l));
 }
 
 // Writes a QWORD using little-endian byte ordering.
 // Returns 0 in success or -1 in error
 int fputq(long long l, FILE* file)
 {
-  int b1, b2, b3, b4, b5, b6, b7, b8;
-
-  // Little endian.
-  b8 = (int)((l & 0xFF00000000000000L) >> 56);
-  b7 = (int)((l & 0x00FF000000000000L) >> 48);
-  b6 = (int)((l & 0x0000FF0000000000L) >> 40);
-  b5 = (int)((l & 0x000000FF00000000L) >> 32);
-  b4 = (int)((l & 0x00000000FF000000L) >> 24);
-  b3 = (int)((l & 0x0000000000FF0000L) >> 16);
-  b2 = (int)((l & 0x000000000000FF00L) >> 8);
-  b1 = (int)l & 0x00FF;
-
-  if (fputc(b1, file) == b1)
-    if (fputc(b2, file) == b2)
-      if (fputc(b3, file) == b3)
-        if (fputc(b4, file) == b4)
-          if (fputc(b5, file) == b5)
-            if (fputc(b6, file) == b6)
-              if (fputc(b7, file) == b7)
-                if (fputc(b8, file) == b8)
-                  return 0;
-
-  return -1;
+  return write_little_endian(file, uint64_t(l));
 }
 
 // Writes a 32-bit single-precision floating point number using
@@ -221,22 +118,7 @@ int fputq(long long l, FILE* file)
 // Returns 0 in success or -1 in error
 int fputf(float l, FILE* file)
 {
-  const int b = *(reinterpret_cast<int*>(&l));
-  int b1, b2, b3, b4;
-
-  // Little endian.
-  b4 = (int)((b & 0xFF000000L) >> 24);
-  b3 = (int)((b & 0x00FF0000L) >> 16);
-  b2 = (int)((b & 0x0000FF00L) >> 8);
-  b1 = (int)b & 0x00FF;
-
-  if (fputc(b1, file) == b1)
-    if (fputc(b2, file) == b2)
-      if (fputc(b3, file) == b3)
-        if (fputc(b4, file) == b4)
-          return 0;
-
-  return -1;
+  return write_little_endian(file, l);
 }
 
 // Writes a 64-bit double-precision floating point number using
@@ -244,30 +126,145 @@ int fputf(float l, FILE* file)
 // Returns 0 in success or -1 in error
 int fputd(double l, FILE* file)
 {
-  const long long b = *(reinterpret_cast<long long*>(&l));
-  int b1, b2, b3, b4, b5, b6, b7, b8;
-
-  // Little endian.
-  b8 = (int)((b & 0xFF00000000000000L) >> 56);
-  b7 = (int)((b & 0x00FF000000000000L) >> 48);
-  b6 = (int)((b & 0x0000FF0000000000L) >> 40);
-  b5 = (int)((b & 0x000000FF00000000L) >> 32);
-  b4 = (int)((b & 0x00000000FF000000L) >> 24);
-  b3 = (int)((b & 0x0000000000FF0000L) >> 16);
-  b2 = (int)((b & 0x000000000000FF00L) >> 8);
-  b1 = (int)b & 0x00FF;
-
-  if (fputc(b1, file) == b1)
-    if (fputc(b2, file) == b2)
-      if (fputc(b3, file) == b3)
-        if (fputc(b4, file) == b4)
-          if (fputc(b5, file) == b5)
-            if (fputc(b6, file) == b6)
-              if (fputc(b7, file) == b7)
-                if (fputc(b8, file) == b8)
-                  return 0;
-
-  return -1;
+  return write_little_endian(file, l);
+}
+
+//////////////////////////////////////////////////////////////////////
+// cfile_reader
+
+cfile_reader::cfile_reader(FILE* file, const endian e, const size_t bufferSize)
+  : m_file(file)
+  , m_endian(e)
+  , m_capacity(std::max<size_t>(bufferSize, 16))
+{
+  m_buffer.reset(new uint8_t[m_capacity]);
+  m_ptr = m_end = m_buffer.get();
+}
+
+cfile_reader::~cfile_reader()
+{
+  // Return the unused bytes to the file
+  if (m_ptr != m_end)
+    std::fseek(m_file, -long(m_end - m_ptr), SEEK_CUR);
+}
+
+bool cfile_reader::fill(const size_t n)
+{
+  ASSERT(n <= m_capacity);
+
+  // Move the remaining bytes to the beginning of the buffer
+  const size_t left = m_end - m_ptr;
+  uint8_t* buf = m_buffer.get();
+  if (left > 0 && m_ptr != buf)
+    std::memmove(buf, m_ptr, left);
+  m_ptr = buf;
+  m_end = buf + left;
+
+  const size_t got = std::fread(buf + left, 1, m_capacity - left, m_file);
+  m_end += got;
+  m_position += got;
+  return (left + got >= n);
+}
+
+bool cfile_reader::read_bytes(void* dst, size_t n)
+{
+  auto out = static_cast<uint8_t*>(dst);
+  const size_t avail = m_end - m_ptr;
+  if (n <= avail) {
+    std::memcpy(out, m_ptr, n);
+    m_ptr += n;
+    return true;
+  }
+
+  // Use all the buffered data
+  std::memcpy(out, m_ptr, avail);
+  m_ptr = m_end;
+  out += avail;
+  n -= avail;
+
+  // Big reads go directly to the destination
+  if (n >= m_capacity) {
+    const size_t got = std::fread(out, 1, n, m_file);
+    m_position += got;
+    return (got == n ? true : fail());
+  }
+
+  if (!fill(n)) {
+    m_ptr = m_end;
+    return fail();
+  }
+  std::memcpy(out, m_ptr, n);
+  m_ptr += n;
+  return true;
+}
+
+bool cfile_reader::skip(size_t n)
+{
+  const size_t avail = m_end - m_ptr;
+  if (n <= avail) {
+    m_ptr += n;
+    return true;
+  }
+  m_ptr = m_end;
+  n -= avail;
+
+  if (n <= size_t(std::numeric_limits<long>::max()) && std::fseek(m_file, long(n), SEEK_CUR) == 0) {
+    m_position += n;
+    return true;
+  }
+
+  // Not seekable file
+  while (n > 0) {
+    if (!fill(1))
+      return fail();
+    const size_t k = std::min(n, size_t(m_end - m_ptr));
+    m_ptr += k;
+    n -= k;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// cfile_writer
+
+cfile_writer::cfile_writer(FILE* file, const endian e, const size_t bufferSize)
+  : m_file(file)
+  , m_endian(e)
+  , m_capacity(std::max<size_t>(bufferSize, 16))
+{
+  m_buffer.reset(new uint8_t[m_capacity]);
+}
+
+cfile_writer::~cfile_writer()
+{
+  flush();
+}
+
+bool cfile_writer::flush()
+{
+  if (m_size > 0) {
+    if (std::fwrite(m_buffer.get(), 1, m_size, m_file) != m_size)
+      m_ok = false;
+    m_size = 0;
+  }
+  return m_ok;
+}
+
+void cfile_writer::write_bytes(const void* src, const size_t n)
+{
+  if (n > m_capacity - m_size) {
+    flush();
+    // Big writes go directly to the file
+    if (n >= m_capacity) {
+      if (std::fwrite(src, 1, n, m_file) != n)
+        m_ok = false;
+      return;
+    }
+  }
+  if (n > 0) {
+    std::memcpy(m_buffer.get() + m_size, src, n);
+    m_size += n;
+  }
 }
 
 } // namespace base
@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -8,10 +9,19 @@
 #define BASE_CFILE_H_INCLUDED
 #pragma once
 
+#include "base/disable_copying.h"
+#include "base/ints.h"
+#include "base/serialization.h"
+
+#include <algorithm>
 #include <cstdio>
+#include <memory>
+#include <type_traits>
 
 namespace base {
 
+// Little-endian values (use cfile_reader/cfile_writer to read/write
+// several values, they don't need one C library call per value).
 int fgetw(FILE* file);
 long fgetl(FILE* file);
 long long fgetq(FILE* file);
@@ -23,6 +33,169 @@ int fputq(long long l, FILE* file);
 int fputf(float l, FILE* file);
 int fputd(double l, FILE* file);
 
+// Reads values from a FILE* through a buffer, so each value is
+// decoded from memory instead of calling fgetc() for each byte. It
+// has the same interface as serialization::reader (which can be used
+// to read from memory or a mapped_file). Reading past the end of the
+// file returns zeros and turns ok() into false.
+//
+// The FILE* shouldn't be used while the reader is alive. When the
+// reader is destroyed, the file position is moved back to the first
+// byte that wasn't read (if the file is seekable).
+//
+//   base::cfile_reader r(file, base::serialization::endian::big);
+//   const uint32_t n = r.read32();
+//   std::vector<uint16_t> values(n);
+//   if (!r.read_array(values.data(), n))
+//     return false;
+//
+class cfile_reader {
+public:
+  using endian = serialization::endian;
+  static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+  explicit cfile_reader(FILE* file,
+                        endian e = endian::little,
+                        size_t bufferSize = kDefaultBufferSize);
+  ~cfile_reader();
+
+  bool ok() const { return m_ok; }
+  endian get_endian() const { return m_endian; }
+
+  // Number of bytes read with this reader.
+  uint64_t position() const { return m_position - (m_end - m_ptr); }
+
+  uint8_t read8() { return read_value<uint8_t>(); }
+  uint16_t read16() { return read_value<uint16_t>(); }
+  uint32_t read32() { return read_value<uint32_t>(); }
+  uint64_t read64() { return read_value<uint64_t>(); }
+  float read_float() { return read_value<float>(); }
+  double read_double() { return read_value<double>(); }
+
+  bool read_bytes(void* dst, size_t n);
+
+  // Skips "n" bytes (it doesn't fail if the file is seekable and we
+  // skip past the end of the file).
+  bool skip(size_t n);
+
+  // Reads an array of integers/floats converting all of them from
+  // the reader endianness at once.
+  template<typename T>
+  bool read_array(T* dst, const size_t n)
+  {
+    static_assert(std::is_arithmetic_v<T>);
+    if (n > size_t(-1) / sizeof(T))
+      return fail();
+    if (!read_bytes(dst, n * sizeof(T)))
+      return false;
+    if (sizeof(T) > 1 && m_endian != endian::native)
+      serialization::byteswap_copy(dst, dst, sizeof(T), n);
+    return true;
+  }
+
+private:
+  bool fail()
+  {
+    m_ok = false;
+    return false;
+  }
+
+  // Reads from the file to have at least "n" bytes in the buffer.
+  bool fill(size_t n);
+
+  template<typename T>
+  T read_value()
+  {
+    if (size_t(m_end - m_ptr) < sizeof(T) && !fill(sizeof(T))) {
+      fail();
+      return T(0);
+    }
+    const T v = serialization::details::load<T>(m_ptr, m_endian);
+    m_ptr += sizeof(T);
+    return v;
+  }
+
+  FILE* m_file;
+  endian m_endian;
+  std::unique_ptr<uint8_t[]> m_buffer;
+  size_t m_capacity;
+  const uint8_t* m_ptr;
+  const uint8_t* m_end;
+  uint64_t m_position = 0; // Bytes read from the file
+  bool m_ok = true;
+
+  DISABLE_COPYING(cfile_reader);
+};
+
+// Writes values to a FILE* through a buffer. The buffer is written
+// with fwrite() when it's full, in flush(), or when the writer is
+// destroyed.
+class cfile_writer {
+public:
+  using endian = serialization::endian;
+  static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+  explicit cfile_writer(FILE* file,
+                        endian e = endian::little,
+                        size_t bufferSize = kDefaultBufferSize);
+  ~cfile_writer();
+
+  // Returns false if some fwrite() failed.
+  bool ok() const { return m_ok; }
+  endian get_endian() const { return m_endian; }
+
+  // Writes the buffered data with fwrite() (it doesn't call fflush()).
+  bool flush();
+
+  void write8(const uint8_t v) { write_value(v); }
+  void write16(const uint16_t v) { write_value(v); }
+  void write32(const uint32_t v) { write_value(v); }
+  void write64(const uint64_t v) { write_value(v); }
+  void write_float(const float v) { write_value(v); }
+  void write_double(const double v) { write_value(v); }
+
+  void write_bytes(const void* src, size_t n);
+
+  template<typename T>
+  void write_array(const T* src, size_t n)
+  {
+    static_assert(std::is_arithmetic_v<T>);
+    if (sizeof(T) == 1 || m_endian == endian::native) {
+      write_bytes(src, n * sizeof(T));
+      return;
+    }
+    // Swap bytes directly in our buffer
+    while (n > 0) {
+      if (m_capacity - m_size < sizeof(T))
+        flush();
+      const size_t k = std::min(n, (m_capacity - m_size) / sizeof(T));
+      serialization::byteswap_copy(m_buffer.get() + m_size, src, sizeof(T), k);
+      m_size += k * sizeof(T);
+      src += k;
+      n -= k;
+    }
+  }
+
+private:
+  template<typename T>
+  void write_value(const T v)
+  {
+    if (m_capacity - m_size < sizeof(T))
+      flush();
+    serialization::details::store<T>(m_buffer.get() + m_size, v, m_endian);
+    m_size += sizeof(T);
+  }
+
+  FILE* m_file;
+  endian m_endian;
+  std::unique_ptr<uint8_t[]> m_buffer;
+  size_t m_capacity;
+  size_t m_size = 0;
+  bool m_ok = true;
+
+  DISABLE_COPYING(cfile_writer);
+};
+
 } // namespace base
 
 #endif
@@ -0,0 +1,84 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/cfile.h"
+#include "base/chrono.h"
+#include "base/file_handle.h"
+#include "base/fs.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace base;
+using namespace base::serialization;
+
+static const char* kFn = "_test_cfile_.bin";
+
+TEST(CFile, Benchmark)
+{
+  const size_t n = 1000000;
+  {
+    std::vector<uint32_t> values(n);
+    for (size_t i = 0; i < n; ++i)
+      values[i] = uint32_t(i);
+    FileHandle f = open_file(kFn, "wb");
+    cfile_writer w(f.get(), endian::big);
+    w.write_array(values.data(), n);
+  }
+
+  // Big-endian values read with fgetc() (like old fgetl())
+  uint64_t total1 = 0;
+  Chrono chrono;
+  {
+    FileHandle f = open_file(kFn, "rb");
+    for (size_t i = 0; i < n; ++i) {
+      const int b1 = fgetc(f.get());
+      const int b2 = fgetc(f.get());
+      const int b3 = fgetc(f.get());
+      const int b4 = fgetc(f.get());
+      total1 += uint32_t((b1 << 24) | (b2 << 16) | (b3 << 8) | b4);
+    }
+  }
+  const double t1 = chrono.elapsed();
+
+  uint64_t total2 = 0;
+  chrono.reset();
+  {
+    FileHandle f = open_file(kFn, "rb");
+    cfile_reader r(f.get(), endian::big);
+    for (size_t i = 0; i < n; ++i)
+      total2 += r.read32();
+  }
+  const double t2 = chrono.elapsed();
+
+  uint64_t total3 = 0;
+  std::vector<uint32_t> values(n, 0);
+  chrono.reset();
+  {
+    FileHandle f = open_file(kFn, "rb");
+    cfile_reader r(f.get(), endian::big);
+    r.read_array(values.data(), n);
+    for (const uint32_t v : values)
+      total3 += v;
+  }
+  const double t3 = chrono.elapsed();
+
+  EXPECT_EQ(total1, total2);
+  EXPECT_EQ(total1, total3);
+  delete_file(kFn);
+
+  std::printf("fgetc()                   %.2f ms\n", t1 * 1000.0);
+  std::printf("cfile_reader::read32()    %.2f ms\n", t2 * 1000.0);
+  std::printf("cfile_reader::read_array  %.2f ms\n", t3 * 1000.0);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,142 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/cfile.h"
+#include "base/file_handle.h"
+#include "base/fs.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace base;
+using namespace base::serialization;
+
+static const char* kFn = "_test_cfile_.bin";
+
+TEST(CFile, Helpers)
+{
+  {
+    FileHandle f = open_file(kFn, "wb");
+    EXPECT_EQ(0, fputw(0x1234, f.get()));
+    EXPECT_EQ(0, fputl(0x89abcdefL, f.get()));
+    EXPECT_EQ(0, fputq(-2LL, f.get()));
+    EXPECT_EQ(0, fputf(1.5f, f.get()));
+    EXPECT_EQ(0, fputd(-0.25, f.get()));
+    EXPECT_EQ(0, fputw(0xff, f.get()));
+  }
+  {
+    FileHandle f = open_file(kFn, "rb");
+    EXPECT_EQ(0x34, fgetc(f.get())); // Little-endian
+    EXPECT_EQ(0, fseek(f.get(), 0, SEEK_SET));
+    EXPECT_EQ(0x1234, fgetw(f.get()));
+    EXPECT_EQ(long(int32_t(0x89abcdef)), fgetl(f.get()));
+    EXPECT_EQ(-2LL, fgetq(f.get()));
+    EXPECT_EQ(1.5f, fgetf(f.get()));
+    EXPECT_EQ(-0.25, fgetd(f.get()));
+    EXPECT_EQ(0xff, fgetw(f.get()));
+    EXPECT_EQ(EOF, fgetw(f.get()));
+    EXPECT_EQ(EOF, fgetl(f.get()));
+  }
+  delete_file(kFn);
+}
+
+TEST(CFile, ReaderWriter)
+{
+  for (const endian e : { endian::little, endian::big }) {
+    // Small buffers to test the refill of the buffer
+    for (const size_t bufferSize : { size_t(1), size_t(17), cfile_reader::kDefaultBufferSize }) {
+      std::vector<uint16_t> words(1000);
+      std::vector<uint32_t> dwords(333);
+      for (size_t i = 0; i < words.size(); ++i)
+        words[i] = uint16_t(i * 0x0101 + 1);
+      for (size_t i = 0; i < dwords.size(); ++i)
+        dwords[i] = uint32_t(i * 0x01020304);
+
+      {
+        FileHandle f = open_file(kFn, "wb");
+        cfile_writer w(f.get(), e, bufferSize);
+        w.write8(0x12);
+        w.write16(0x3456);
+        w.write32(0x789abcde);
+        w.write64(0x0102030405060708ULL);
+        w.write_float(2.5f);
+        w.write_double(-1.0);
+        w.write_array(words.data(), words.size());
+        w.write_bytes("abc", 3);
+        w.write_array(dwords.data(), dwords.size());
+        EXPECT_TRUE(w.flush());
+        EXPECT_TRUE(w.ok());
+      }
+
+      FileHandle f = open_file(kFn, "rb");
+      {
+        // Check the endianness of the file
+        const int b1 = fgetc(f.get());
+        const int b2 = fgetc(f.get());
+        EXPECT_EQ(0x12, b1);
+        EXPECT_EQ(e == endian::little ? 0x56 : 0x34, b2);
+        std::rewind(f.get());
+      }
+
+      cfile_reader r(f.get(), e, bufferSize);
+      EXPECT_EQ(0x12, r.read8());
+      EXPECT_EQ(0x3456, r.read16());
+      EXPECT_EQ(0x789abcde, r.read32());
+      EXPECT_EQ(0x0102030405060708ULL, r.read64());
+      EXPECT_EQ(2.5f, r.read_float());
+      EXPECT_EQ(-1.0, r.read_double());
+      EXPECT_EQ(27, r.position());
+
+      std::vector<uint16_t> words2(words.size());
+      EXPECT_TRUE(r.read_array(words2.data(), words2.size()));
+      EXPECT_EQ(words, words2);
+      EXPECT_TRUE(r.skip(3));
+      std::vector<uint32_t> dwords2(dwords.size());
+      EXPECT_TRUE(r.read_array(dwords2.data(), dwords2.size()));
+      EXPECT_EQ(dwords, dwords2);
+      EXPECT_TRUE(r.ok());
+
+      // Read past the end of the file
+      EXPECT_EQ(0, r.read32());
+      EXPECT_FALSE(r.ok());
+    }
+  }
+  delete_file(kFn);
+}
+
+TEST(CFile, ReaderFilePosition)
+{
+  {
+    FileHandle f = open_file(kFn, "wb");
+    for (int i = 0; i < 100; ++i)
+      fputc(i, f.get());
+  }
+  {
+    FileHandle f = open_file(kFn, "rb");
+    {
+      cfile_reader r(f.get());
+      EXPECT_EQ(0x0100, r.read16());
+      EXPECT_TRUE(r.skip(8));
+    }
+    // The file position is just after the read bytes
+    EXPECT_EQ(10, std::ftell(f.get()));
+    EXPECT_EQ(10, fgetc(f.get()));
+
+    cfile_reader r(f.get());
+    uint8_t buf[200];
+    EXPECT_FALSE(r.read_bytes(buf, sizeof(buf)));
+    EXPECT_FALSE(r.ok());
+  }
+  delete_file(kFn);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
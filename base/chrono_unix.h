@@ -1,26 +1,20 @@
 // LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
 
-#include <ctime>
-#include <sys/time.h>
+#include "base/clock.h"
 
 class base::Chrono::ChronoImpl {
 public:
   ChronoImpl() { reset(); }
 
-  void reset() { gettimeofday(&m_point, NULL); }
+  void reset() { m_point = now_ns(); }
 
-  double elapsed() const
-  {
-    struct timeval now;
-    gettimeofday(&now, NULL);
-    return (double)(now.tv_sec + (double)now.tv_usec / 1000000) -
-           (double)(m_point.tv_sec + (double)m_point.tv_usec / 1000000);
-  }
+  double elapsed() const { return double(now_ns() - m_point) / 1.0e9; }
 
 private:
-  struct timeval m_point;
+  uint64_t m_point;
 };
@@ -0,0 +1,246 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/clock.h"
+
+#include "base/cpu_features.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+#if LAF_LINUX
+  #include <time.h>
+#endif
+
+namespace base {
+
+namespace {
+
+uint64_t monotonic_ns()
+{
+#if LAF_LINUX
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+#else
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count());
+#endif
+}
+
+#if LAF_CLOCK_RDTSC
+
+// Time used to measure the TSC frequency. A longer time gives a more
+// precise frequency, but in the meantime we use the slower clock.
+constexpr uint64_t kCalibrationNs = 20000000; // 20 ms
+
+// Converts TSC ticks to nanoseconds using a 32.32 fixed-point
+// multiplier measured against the monotonic clock.
+class tsc_clock {
+public:
+  // An invariant TSC can be used as a wall clock.
+  tsc_clock() : m_invariant(get_cpu_features().invariant_tsc)
+  {
+    sample(m_tsc0, m_ns0);
+    m_tscBase = m_tsc0;
+    m_nsBase = m_ns0;
+  }
+
+  bool is_invariant() const { return m_invariant; }
+  bool is_calibrated() const { return m_calibrated.load(std::memory_order_acquire); }
+
+  // The base TSC is the midpoint of two reads (maybe from another
+  // core), so the current TSC can be a little behind it.
+  uint64_t now() const
+  {
+    const uint64_t tsc = __rdtsc();
+    return m_nsBase + (tsc > m_tscBase ? to_ns(tsc - m_tscBase, m_mult) : 0);
+  }
+
+  // Calibrates the TSC if enough time has passed since the
+  // construction ("ns" is the current monotonic time).
+  void try_calibrate(const uint64_t ns)
+  {
+    if (ns - m_ns0 < kCalibrationNs || m_calibrating.load(std::memory_order_relaxed) ||
+        m_calibrating.exchange(true))
+      return;
+
+    uint64_t tsc, mono;
+    sample(tsc, mono);
+    m_mult = multiplier(tsc - m_tsc0, mono - m_ns0);
+    m_tscBase = tsc;
+    m_nsBase = mono;
+    m_calibrated.store(true, std::memory_order_release);
+  }
+
+  uint64_t cycles_to_ns(const uint64_t cycles) const
+  {
+    if (is_calibrated())
+      return to_ns(cycles, m_mult);
+
+    // Provisional frequency measured from the construction until now
+    uint64_t tsc, mono;
+    sample(tsc, mono);
+    if (mono == m_ns0 || tsc == m_tsc0)
+      return cycles;
+    return to_ns(cycles, multiplier(tsc - m_tsc0, mono - m_ns0));
+  }
+
+private:
+  // Reads the TSC and the monotonic clock at the same time (the TSC
+  // value is the average of a read before and after the clock).
+  static void sample(uint64_t& tsc, uint64_t& ns)
+  {
+    const uint64_t a = __rdtsc();
+    ns = monotonic_ns();
+    const uint64_t b = __rdtsc();
+    tsc = a + (b - a) / 2;
+  }
+
+  static uint64_t multiplier(const uint64_t cycles, const uint64_t ns)
+  {
+    return uint64_t(double(ns) / double(cycles) * 4294967296.0);
+  }
+
+  static uint64_t to_ns(const uint64_t cycles, const uint64_t mult)
+  {
+  #if defined(__SIZEOF_INT128__)
+    return uint64_t((unsigned __int128)cycles * mult >> 32);
+  #else
+    uint64_t hi;
+    const uint64_t lo = _umul128(cycles, mult, &hi);
+    return (hi << 32) | (lo >> 32);
+  #endif
+  }
+
+  const bool m_invariant;
+  uint64_t m_tsc0;
+  uint64_t m_ns0;
+  // Written before m_calibrated is set (release), read after it's
+  // loaded (acquire).
+  uint64_t m_tscBase;
+  uint64_t m_nsBase;
+  uint64_t m_mult = 0;
+  std::atomic<bool> m_calibrating = false;
+  std::atomic<bool> m_calibrated = false;
+};
+
+tsc_clock& get_tsc_clock()
+{
+  static tsc_clock clock;
+  return clock;
+}
+
+#endif // LAF_CLOCK_RDTSC
+
+} // anonymous namespace
+
+uint64_t now_ns()
+{
+#if LAF_CLOCK_RDTSC && LAF_LINUX
+  tsc_clock& tsc = get_tsc_clock();
+  if (tsc.is_invariant()) {
+    if (tsc.is_calibrated())
+      return tsc.now();
+
+    const uint64_t ns = monotonic_ns();
+    tsc.try_calibrate(ns);
+    return ns;
+  }
+  return monotonic_ns();
+#else
+  return monotonic_ns();
+#endif
+}
+
+bool clock_uses_tsc()
+{
+#if LAF_CLOCK_RDTSC && LAF_LINUX
+  return get_tsc_clock().is_invariant();
+#else
+  return false;
+#endif
+}
+
+uint64_t cycles_to_ns(const uint64_t cycles)
+{
+#if LAF_CLOCK_RDTSC
+  tsc_clock& tsc = get_tsc_clock();
+  if (!tsc.is_calibrated())
+    tsc.try_calibrate(monotonic_ns());
+  return tsc.cycles_to_ns(cycles);
+#else
+  // read_cycles() returns nanoseconds in this case
+  return cycles;
+#endif
+}
+
+latency_histogram::latency_histogram()
+{
+  reset();
+}
+
+void latency_histogram::reset()
+{
+  std::memset(m_buckets, 0, sizeof(m_buckets));
+  m_count = 0;
+  m_sum = 0;
+  m_min = std::numeric_limits<uint64_t>::max();
+  m_max = 0;
+}
+
+void latency_histogram::merge(const latency_histogram& other)
+{
+  for (size_t i = 0; i < kBuckets; ++i)
+    m_buckets[i] += other.m_buckets[i];
+  m_count += other.m_count;
+  m_sum += other.m_sum;
+  m_min = std::min(m_min, other.m_min);
+  m_max = std::max(m_max, other.m_max);
+}
+
+uint64_t latency_histogram::percentile(const double p) const
+{
+  if (m_count == 0)
+    return 0;
+
+  // Rank of the value (from 1 to m_count)
+  const double clamped = std::clamp(p, 0.0, 100.0);
+  const uint64_t rank = std::max<uint64_t>(1, uint64_t(clamped / 100.0 * double(m_count) + 0.5));
+  if (rank == 1)
+    return m_min;
+  if (rank >= m_count)
+    return m_max;
+
+  uint64_t accum = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    accum += m_buckets[i];
+    if (accum >= rank)
+      return std::clamp(bucket_value(i), m_min, m_max);
+  }
+  return m_max;
+}
+
+// Returns the middle value of the range of values in the bucket.
+uint64_t latency_histogram::bucket_value(const size_t index)
+{
+  if (index < (2 << kSubBits))
+    return index;
+
+  const int shift = int(index >> kSubBits) - 1;
+  const uint64_t lower = uint64_t((index & ((1 << kSubBits) - 1)) | (1 << kSubBits)) << shift;
+  return lower + ((uint64_t(1) << shift) - 1) / 2;
+}
+
+} // namespace base
@@ -0,0 +1,136 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_CLOCK_H_INCLUDED
+#define BASE_CLOCK_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+
+#include <cstddef>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+  #include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define LAF_CLOCK_RDTSC 1
+  #if !defined(_MSC_VER) || defined(__clang__)
+    #include <x86intrin.h>
+  #endif
+#endif
+
+namespace base {
+
+// Monotonic clock in nanoseconds (the origin is unspecified). On
+// x86-64 Linux with an invariant TSC it reads the time stamp counter
+// (calibrated against CLOCK_MONOTONIC in the first 20 milliseconds)
+// instead of calling clock_gettime(), in other platforms it uses the
+// native monotonic clock.
+uint64_t now_ns();
+
+// Returns true if now_ns() and read_cycles() use the TSC.
+bool clock_uses_tsc();
+
+// Raw cycle counter, cheaper than now_ns() when we need to measure
+// very small intervals. Convert differences to nanoseconds with
+// cycles_to_ns().
+inline uint64_t read_cycles()
+{
+#if LAF_CLOCK_RDTSC
+  return __rdtsc();
+#else
+  return now_ns();
+#endif
+}
+
+uint64_t cycles_to_ns(uint64_t cycles);
+
+// Accumulates latency values (in nanoseconds) to get percentiles. It
+// uses log-linear buckets (32 buckets for each power of two), so the
+// percentiles have a relative error of less than 3%, and min/max
+// values are exact. It's not thread-safe, use one histogram per
+// thread and merge() them.
+class latency_histogram {
+public:
+  latency_histogram();
+
+  void add(uint64_t ns)
+  {
+    ++m_buckets[bucket_index(ns)];
+    ++m_count;
+    m_sum += ns;
+    if (ns < m_min)
+      m_min = ns;
+    if (ns > m_max)
+      m_max = ns;
+  }
+
+  void merge(const latency_histogram& other);
+  void reset();
+
+  uint64_t count() const { return m_count; }
+  uint64_t min() const { return m_count ? m_min : 0; }
+  uint64_t max() const { return m_max; }
+  double mean() const { return m_count ? double(m_sum) / double(m_count) : 0.0; }
+
+  // Returns the value below which the given percentage (from 0 to
+  // 100) of values fall.
+  uint64_t percentile(double p) const;
+  uint64_t p50() const { return percentile(50.0); }
+  uint64_t p99() const { return percentile(99.0); }
+
+private:
+  static constexpr int kSubBits = 5;
+  static constexpr size_t kBuckets = (64 - kSubBits + 1) * (1 << kSubBits);
+
+  static size_t bucket_index(const uint64_t v)
+  {
+    if (v < (2 << kSubBits))
+      return size_t(v);
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long e;
+    _BitScanReverse64(&e, v);
+#else
+    const int e = 63 - __builtin_clzll(v);
+#endif
+    return size_t(e - kSubBits) * (1 << kSubBits) + size_t(v >> (e - kSubBits));
+  }
+
+  static uint64_t bucket_value(size_t index);
+
+  uint64_t m_buckets[kBuckets];
+  uint64_t m_count;
+  uint64_t m_sum;
+  uint64_t m_min;
+  uint64_t m_max;
+};
+
+// Adds the time between its construction and destruction to a
+// histogram using the cycle counter.
+//
+//   static base::latency_histogram hist;
+//   {
+//     base::scope_timer timer(hist);
+//     ...
+//   }
+//
+class scope_timer {
+public:
+  explicit scope_timer(latency_histogram& hist) : m_hist(hist), m_start(read_cycles()) {}
+  ~scope_timer() { m_hist.add(cycles_to_ns(read_cycles() - m_start)); }
+
+  scope_timer(const scope_timer&) = delete;
+  scope_timer& operator=(const scope_timer&) = delete;
+
+private:
+  latency_histogram& m_hist;
+  uint64_t m_start;
+};
+
+} // namespace base
+
+#endif
@@ -0,0 +1,68 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/clock.h"
+#include "base/thread.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace base;
+
+static uint64_t steady_ns()
+{
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count());
+}
+
+TEST(Clock, Benchmark)
+{
+  const int n = 10000000;
+  uint64_t sum = 0;
+  now_ns();
+  this_thread::sleep_for(0.03);
+
+  uint64_t t0 = steady_ns();
+  for (int i = 0; i < n; ++i)
+    sum += now_ns();
+  const double nowNs = double(steady_ns() - t0) / n;
+
+  t0 = steady_ns();
+  for (int i = 0; i < n; ++i)
+    sum += steady_ns();
+  const double steadyNs = double(steady_ns() - t0) / n;
+
+  t0 = steady_ns();
+  for (int i = 0; i < n; ++i)
+    sum += read_cycles();
+  const double cyclesNs = double(steady_ns() - t0) / n;
+
+  latency_histogram hist;
+  t0 = steady_ns();
+  for (int i = 0; i < n; ++i) {
+    scope_timer timer(hist);
+  }
+  const double timerNs = double(steady_ns() - t0) / n;
+
+  EXPECT_NE(0, sum);
+  std::printf("uses TSC            %s\n", clock_uses_tsc() ? "yes" : "no");
+  std::printf("now_ns()            %.2f ns/call\n", nowNs);
+  std::printf("steady_clock::now() %.2f ns/call\n", steadyNs);
+  std::printf("read_cycles()       %.2f ns/call\n", cyclesNs);
+  std::printf("scope_timer         %.2f ns/scope (p50 = %llu ns, p99 = %llu ns)\n",
+              timerNs,
+              (unsigned long long)hist.p50(),
+              (unsigned long long)hist.p99());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,150 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/clock.h"
+#include "base/thread.h"
+#include "base/time.h"
+
+#include <chrono>
+
+using namespace base;
+
+static uint64_t steady_ns()
+{
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count());
+}
+
+TEST(Clock, Monotonic)
+{
+  // Crosses the TSC calibration period
+  uint64_t prev = now_ns();
+  const uint64_t end = prev + 50000000;
+  while (prev < end) {
+    const uint64_t t = now_ns();
+    ASSERT_GE(t, prev);
+    prev = t;
+  }
+}
+
+TEST(Clock, SameRateAsSteadyClock)
+{
+  now_ns();
+  this_thread::sleep_for(0.03); // Wait the calibration
+
+  const uint64_t t0 = now_ns();
+  const uint64_t s0 = steady_ns();
+  const uint64_t c0 = read_cycles();
+  this_thread::sleep_for(0.1);
+  const uint64_t t1 = now_ns();
+  const uint64_t s1 = steady_ns();
+  const uint64_t c1 = read_cycles();
+
+  const double elapsed = double(t1 - t0);
+  const double expected = double(s1 - s0);
+  EXPECT_NEAR(expected, elapsed, expected * 0.01);
+  EXPECT_NEAR(expected, double(cycles_to_ns(c1 - c0)), expected * 0.01);
+}
+
+TEST(Clock, ChronoAndTick)
+{
+  Chrono chrono;
+  const tick_t t0 = current_tick();
+  this_thread::sleep_for(0.05);
+  // Only lower bounds, the sleep can take much longer on a busy machine
+  EXPECT_GE(chrono.elapsed(), 0.045);
+  EXPECT_GE(current_tick() - t0, 45);
+}
+
+TEST(LatencyHistogram, Empty)
+{
+  latency_histogram hist;
+  EXPECT_EQ(0, hist.count());
+  EXPECT_EQ(0, hist.min());
+  EXPECT_EQ(0, hist.max());
+  EXPECT_EQ(0.0, hist.mean());
+  EXPECT_EQ(0, hist.p50());
+}
+
+TEST(LatencyHistogram, SmallValuesAreExact)
+{
+  latency_histogram hist;
+  for (uint64_t i = 1; i <= 50; ++i)
+    hist.add(i);
+  EXPECT_EQ(50, hist.count());
+  EXPECT_EQ(1, hist.min());
+  EXPECT_EQ(50, hist.max());
+  EXPECT_EQ(25.5, hist.mean());
+  EXPECT_EQ(25, hist.p50());
+  EXPECT_EQ(50, hist.p99());
+  EXPECT_EQ(1, hist.percentile(0.0));
+  EXPECT_EQ(50, hist.percentile(100.0));
+}
+
+TEST(LatencyHistogram, RelativeError)
+{
+  latency_histogram hist;
+  for (uint64_t i = 1; i <= 100000; ++i)
+    hist.add(i * 1000);
+
+  EXPECT_EQ(1000, hist.min());
+  EXPECT_EQ(100000000, hist.max());
+  EXPECT_NEAR(50000000.0, double(hist.p50()), 50000000.0 * 0.03);
+  EXPECT_NEAR(99000000.0, double(hist.p99()), 99000000.0 * 0.03);
+  EXPECT_NEAR(10000000.0, double(hist.percentile(10.0)), 10000000.0 * 0.03);
+
+  // Huge values
+  latency_histogram big;
+  big.add(UINT64_MAX);
+  big.add(uint64_t(1) << 63);
+  EXPECT_EQ(uint64_t(1) << 63, big.min());
+  EXPECT_EQ(UINT64_MAX, big.max());
+  EXPECT_EQ(UINT64_MAX, big.percentile(100.0));
+}
+
+TEST(LatencyHistogram, MergeAndReset)
+{
+  latency_histogram a, b;
+  for (int i = 0; i < 90; ++i)
+    a.add(10);
+  for (int i = 0; i < 10; ++i)
+    b.add(5000);
+  a.merge(b);
+
+  EXPECT_EQ(100, a.count());
+  EXPECT_EQ(10, a.min());
+  EXPECT_EQ(5000, a.max());
+  EXPECT_EQ(10, a.p50());
+  EXPECT_NEAR(5000.0, double(a.p99()), 5000.0 * 0.03);
+
+  a.reset();
+  EXPECT_EQ(0, a.count());
+  a.add(7);
+  EXPECT_EQ(7, a.min());
+  EXPECT_EQ(7, a.max());
+}
+
+TEST(LatencyHistogram, ScopeTimer)
+{
+  latency_histogram hist;
+  for (int i = 0; i < 3; ++i) {
+    scope_timer timer(hist);
+    this_thread::sleep_for(0.01);
+  }
+  EXPECT_EQ(3, hist.count());
+  EXPECT_GE(hist.min(), 9000000);
+  EXPECT_GE(hist.max(), hist.min());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,78 @@
+// LAF Base Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/count_bits.h"
+
+#include "base/cpu_features.h"
+
+#include <cstring>
+
+namespace base {
+
+static size_t count_bits_scalar(const uint8_t* p, const size_t size)
+{
+  size_t n = 0;
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t v;
+    std::memcpy(&v, p + i, 8);
+    n += count_bits(v);
+  }
+  for (; i < size; ++i)
+    n += count_bits(p[i]);
+  return n;
+}
+
+#if LAF_X86
+
+// Returns the number of processed bytes (a multiple of 32).
+LAF_TARGET("avx2")
+static size_t count_bits_avx2(const uint8_t* p, const size_t size, size_t& n)
+{
+  // Number of bits of each 4-bit value (pshufb is used as a table
+  // lookup for the low and high nibbles of each byte)
+  const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i lowMask = _mm256_set1_epi8(0x0f);
+  __m256i total = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+    const __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, lowMask));
+    const __m256i hi =
+      _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask));
+    // Sum the counts of each group of 8 bytes into four 64-bit values
+    total =
+      _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+  }
+  alignas(32) uint64_t sums[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(sums), total);
+  n += size_t(sums[0] + sums[1] + sums[2] + sums[3]);
+  return i;
+}
+
+#endif // LAF_X86
+
+size_t count_bits(const void* data, const size_t size)
+{
+  auto p = static_cast<const uint8_t*>(data);
+  size_t n = 0;
+  size_t done = 0;
+
+#if LAF_X86
+  static const bool avx2 = get_cpu_features().avx2;
+  if (avx2)
+    done = count_bits_avx2(p, size, n);
+#endif
+
+  return n + count_bits_scalar(p + done, size - done);
+}
+
+} // namespace base
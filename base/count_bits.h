@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2023 Igara Studio S.A.
+// Copyright (c) 2023-2026 Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -8,22 +8,52 @@
 #define BASE_COUNT_BITS_H_INCLUDED
 #pragma once
 
+#include "base/ints.h"
+
 #include <cstddef>
 #include <limits>
+#include <type_traits>
+
+// GCC calls a libgcc function for __builtin_popcount() when the popcnt
+// instruction cannot be used (slower than the inline SWAR version).
+#if defined(__clang__) || (defined(__GNUC__) && (defined(__POPCNT__) || defined(__aarch64__)))
+  #define BASE_BUILTIN_POPCOUNT 1
+#endif
 
 namespace base {
 
+namespace details {
+
+// Counts bits in parallel in each 2/4/8-bit group.
+constexpr inline size_t popcount_swar(uint64_t v)
+{
+  v = v - ((v >> 1) & 0x5555555555555555ull);
+  v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+  v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0full;
+  return size_t((v * 0x0101010101010101ull) >> 56);
+}
+
+} // namespace details
+
 template<typename T>
 constexpr inline size_t count_bits(const T v)
 {
-  size_t n = 0;
-  for (size_t b = 0; b < sizeof(T) * 8; ++b) {
-    if (v & (T(1) << b))
-      ++n;
-  }
-  return n;
+  static_assert(std::is_integral_v<T> && sizeof(T) <= 8);
+  using U = std::make_unsigned_t<T>;
+#if BASE_BUILTIN_POPCOUNT
+  if constexpr (sizeof(U) <= sizeof(unsigned))
+    return size_t(__builtin_popcount(unsigned(U(v))));
+  else
+    return size_t(__builtin_popcountll((unsigned long long)U(v)));
+#else
+  return details::popcount_swar(uint64_t(U(v)));
+#endif
 }
 
+// Counts the bits in the given array of bytes (uses AVX2 when it's
+// available).
+size_t count_bits(const void* data, size_t size);
+
 } // namespace base
 
 #endif
@@ -0,0 +1,88 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/count_bits.h"
+#include "base/ints.h"
+#include "base/mask_shift.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace base;
+
+// Old implementation (one iteration per bit)
+template<typename T>
+static size_t count_bits_loop(const T v)
+{
+  size_t n = 0;
+  for (size_t b = 0; b < sizeof(T) * 8; ++b) {
+    if (v & (T(1) << b))
+      ++n;
+  }
+  return n;
+}
+
+static std::vector<uint8_t> random_bytes(const size_t size)
+{
+  std::vector<uint8_t> data(size);
+  uint32_t seed = 2463534242;
+  for (uint8_t& b : data) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    b = uint8_t(seed);
+  }
+  return data;
+}
+
+TEST(CountBits, Benchmark)
+{
+  const std::vector<uint8_t> data = random_bytes(1 << 20);
+  const auto words = reinterpret_cast<const uint32_t*>(data.data());
+  const size_t nwords = data.size() / 4;
+
+  size_t total1 = 0;
+  Chrono chrono;
+  for (size_t i = 0; i < nwords; ++i)
+    total1 += count_bits_loop(words[i]);
+  const double t1 = chrono.elapsed();
+
+  size_t total2 = 0;
+  chrono.reset();
+  for (size_t i = 0; i < nwords; ++i)
+    total2 += count_bits(words[i]);
+  const double t2 = chrono.elapsed();
+
+  chrono.reset();
+  const size_t total3 = count_bits(data.data(), data.size());
+  const double t3 = chrono.elapsed();
+
+  // mask_shift() of all the masks of a 32-bit RGBA format
+  const uint32_t masks[] = { 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000 };
+  int total4 = 0;
+  chrono.reset();
+  for (size_t i = 0; i < nwords; ++i)
+    total4 += mask_shift(masks[i & 3] & (words[i] | 0x01010101));
+  const double t4 = chrono.elapsed();
+
+  EXPECT_EQ(total1, total2);
+  EXPECT_EQ(total1, total3);
+  EXPECT_LT(0, total4);
+
+  std::printf("count_bits() per bit     %.3f ms\n", t1 * 1000.0);
+  std::printf("count_bits() per uint32  %.3f ms\n", t2 * 1000.0);
+  std::printf("count_bits() 1MB array   %.3f ms\n", t3 * 1000.0);
+  std::printf("mask_shift() per uint32  %.3f ms\n", t4 * 1000.0);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
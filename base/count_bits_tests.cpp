@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2023  Igara Studio S.A.
+// Copyright (c) 2023-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -9,6 +9,8 @@
 #include "base/count_bits.h"
 #include "base/ints.h"
 
+#include <vector>
+
 using namespace base;
 
 TEST(CountBits, CommonCases)
@@ -38,6 +40,69 @@ TEST(CountBits, Rgb30bpp)
   EXPECT_EQ(10, count_bits<unsigned long>(0x3ff00000));
 }
 
+TEST(CountBits, SmallAndSignedTypes)
+{
+  EXPECT_EQ(8, count_bits<uint8_t>(0xff));
+  EXPECT_EQ(16, count_bits<uint16_t>(0xffff));
+  EXPECT_EQ(8, count_bits<int8_t>(-1));
+  EXPECT_EQ(32, count_bits<int32_t>(-1));
+  EXPECT_EQ(64, count_bits<int64_t>(-1));
+  EXPECT_EQ(1, count_bits<int32_t>(std::numeric_limits<int32_t>::min()));
+}
+
+TEST(CountBits, Constexpr)
+{
+  static_assert(count_bits(0) == 0);
+  static_assert(count_bits(0xf0f0u) == 8);
+  static_assert(count_bits(0x8000000000000001ull) == 2);
+  static_assert(details::popcount_swar(0xffffffffffffffffull) == 64);
+  EXPECT_EQ(33, details::popcount_swar(0x1fffffffful));
+}
+
+// Old implementation (one iteration per bit)
+template<typename T>
+static size_t count_bits_loop(const T v)
+{
+  size_t n = 0;
+  for (size_t b = 0; b < sizeof(T) * 8; ++b) {
+    if (v & (T(1) << b))
+      ++n;
+  }
+  return n;
+}
+
+static std::vector<uint8_t> random_bytes(const size_t size)
+{
+  std::vector<uint8_t> data(size);
+  uint32_t seed = 2463534242;
+  for (uint8_t& b : data) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    b = uint8_t(seed);
+  }
+  return data;
+}
+
+TEST(CountBits, Array)
+{
+  const std::vector<uint8_t> data = random_bytes(1000);
+  EXPECT_EQ(0, count_bits(data.data(), 0));
+
+  // Different offsets/sizes to test the SIMD and scalar parts
+  for (size_t offset = 0; offset < 33; offset += 3) {
+    for (const size_t size : { 1, 7, 8, 31, 32, 33, 64, 100, 511, 960 }) {
+      size_t expected = 0;
+      for (size_t i = 0; i < size; ++i)
+        expected += count_bits_loop(data[offset + i]);
+      EXPECT_EQ(expected, count_bits(data.data() + offset, size));
+    }
+  }
+
+  const std::vector<uint8_t> ones(4096 + 5, 0xff);
+  EXPECT_EQ(ones.size() * 8, count_bits(ones.data(), ones.size()));
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
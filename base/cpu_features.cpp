@@ -0,0 +1,79 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/cpu_features.h"
+
+#include "base/ints.h"
+
+#if LAF_X86 && (!defined(_MSC_VER) || defined(__clang__))
+  #include <cpuid.h>
+#endif
+
+namespace base {
+
+#if LAF_X86
+
+static void cpuid(const unsigned leaf, const unsigned subleaf, int regs[4])
+{
+  #if defined(_MSC_VER) && !defined(__clang__)
+  __cpuidex(regs, int(leaf), int(subleaf));
+  #else
+  __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+  #endif
+}
+
+// Returns the state components enabled by the OS (XCR0), can be
+// called only if CPUID reports OSXSAVE.
+LAF_TARGET("xsave")
+static uint64_t xgetbv0()
+{
+  return _xgetbv(0);
+}
+
+#endif // LAF_X86
+
+static cpu_features detect_cpu_features()
+{
+  cpu_features f;
+#if LAF_X86
+  int regs[4];
+  cpuid(0, 0, regs);
+  const int maxLeaf = regs[0];
+
+  cpuid(1, 0, regs);
+  f.ssse3 = (regs[2] & (1 << 9)) != 0;
+  f.sse41 = (regs[2] & (1 << 19)) != 0;
+
+  // AVX2 needs OS support to save the YMM registers
+  const bool osxsave = (regs[2] & (1 << 27)) != 0;
+  const bool ymm = (osxsave && (xgetbv0() & 6) == 6);
+
+  if (maxLeaf >= 7) {
+    cpuid(7, 0, regs);
+    f.avx2 = ymm && (regs[1] & (1 << 5)) != 0;
+    f.sha = (regs[1] & (1 << 29)) != 0;
+  }
+
+  cpuid(0x80000000, 0, regs);
+  if (unsigned(regs[0]) >= 0x80000007) {
+    cpuid(0x80000007, 0, regs);
+    f.invariant_tsc = (regs[3] & (1 << 8)) != 0;
+  }
+#endif
+  return f;
+}
+
+const cpu_features& get_cpu_features()
+{
+  static const cpu_features features = detect_cpu_features();
+  return features;
+}
+
+} // namespace base
@@ -0,0 +1,43 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_CPU_FEATURES_H_INCLUDED
+#define BASE_CPU_FEATURES_H_INCLUDED
+#pragma once
+
+// LAF_X86 is defined on x86/x86-64, where functions marked with
+// LAF_TARGET("ssse3"), LAF_TARGET("avx2"), etc. can use those
+// instruction sets (MSVC doesn't need the attribute). They must be
+// called only if get_cpu_features() reports the feature.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  #define LAF_X86 1
+  #include <immintrin.h>
+  #if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+    #define LAF_TARGET(t)
+  #else
+    #define LAF_TARGET(t) __attribute__((target(t)))
+  #endif
+#endif
+
+namespace base {
+
+// Instruction set extensions supported by the CPU (and by the OS in
+// the case of AVX2). All of them are false in other architectures.
+struct cpu_features {
+  bool ssse3 = false;
+  bool sse41 = false;
+  bool avx2 = false;
+  bool sha = false;
+  bool invariant_tsc = false; // The TSC runs at a constant rate in all P/C-states
+};
+
+// Returns the features of the current CPU (detected only once).
+const cpu_features& get_cpu_features();
+
+} // namespace base
+
+#endif
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2018-2022  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -19,6 +19,9 @@
 #if LAF_WINDOWS
   #include <fcntl.h>
   #include <io.h>
+  #include <sys/stat.h>
+#else
+  #include <sys/stat.h>
 #endif
 
 namespace base {
@@ -46,9 +49,26 @@ buffer read_file_content(FILE* file)
 buffer read_file_content(const std::string& filename)
 {
   const FileHandle f(open_file(filename, "rb"));
-  if (f)
-    return read_file_content(f.get());
-  return buffer();
+  if (!f)
+    return buffer();
+
+  // Read the whole file with just one allocation (instead of growing
+  // the buffer chunk by chunk) when we know its size.
+#if LAF_WINDOWS
+  struct _stat64 sts;
+  const bool hasSize = (_fstat64(_fileno(f.get()), &sts) == 0 && sts.st_size > 0);
+#else
+  struct stat sts;
+  const bool hasSize = (fstat(fileno(f.get()), &sts) == 0 && sts.st_size > 0);
+#endif
+  if (hasSize) {
+    buffer buf(size_t(sts.st_size));
+    buf.resize(std::fread(buf.data(), 1, buf.size(), f.get()));
+    return buf;
+  }
+
+  // Read special files (e.g. /proc files which have size = 0)
+  return read_file_content(f.get());
 }
 
 void write_file_content(FILE* file, const uint8_t* buf, size_t size)
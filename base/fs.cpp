@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2021-2025 Igara Studio S.A.
+// Copyright (c) 2021-2026 Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,6 +12,7 @@
 #include "base/fs.h"
 #include "base/split_string.h"
 #include "base/string.h"
+#include "base/thread_pool.h"
 #include "base/utf8_decode.h"
 
 #if LAF_WINDOWS
@@ -22,8 +23,11 @@
 
 #include <algorithm>
 #include <cctype>
+#include <condition_variable>
 #include <cstdlib>
+#include <exception>
 #include <iterator>
+#include <mutex>
 
 namespace base {
 
@@ -71,53 +75,17 @@ void make_all_directories(const std::string& path)
 
 std::string get_file_path(const std::string& filename)
 {
-  std::string::const_reverse_iterator rit;
-  std::string res;
-
-  for (rit = filename.rbegin(); rit != filename.rend(); ++rit)
-    if (is_path_separator(*rit))
-      break;
-
-  if (rit != filename.rend()) {
-    ++rit;
-    std::copy(filename.begin(), std::string::const_iterator(rit.base()), std::back_inserter(res));
-  }
-
-  return res;
+  return std::string(get_file_path_view(filename));
 }
 
 std::string get_file_name(const std::string& filename)
 {
-  std::string::const_reverse_iterator rit;
-  std::string result;
-
-  for (rit = filename.rbegin(); rit != filename.rend(); ++rit)
-    if (is_path_separator(*rit))
-      break;
-
-  std::copy(std::string::const_iterator(rit.base()), filename.end(), std::back_inserter(result));
-
-  return result;
+  return std::string(get_file_name_view(filename));
 }
 
 std::string get_file_extension(const std::string& filename)
 {
-  std::string::const_reverse_iterator rit;
-  std::string result;
-
-  // search for the first dot from the end of the string
-  for (rit = filename.rbegin(); rit != filename.rend(); ++rit) {
-    if (is_path_separator(*rit))
-      return result;
-    if (*rit == '.')
-      break;
-  }
-
-  if (rit != filename.rend()) {
-    std::copy(std::string::const_iterator(rit.base()), filename.end(), std::back_inserter(result));
-  }
-
-  return result;
+  return std::string(get_file_extension_view(filename));
 }
 
 std::string replace_extension(const std::string& filename, const std::string& extension)
@@ -157,24 +125,7 @@ std::string replace_extension(const std::string& filename, const std::string& ex
 
 std::string get_file_title(const std::string& filename)
 {
-  std::string::const_reverse_iterator rit;
-  std::string::const_iterator last_dot = filename.end();
-  std::string result;
-
-  for (rit = filename.rbegin(); rit != filename.rend(); ++rit) {
-    if (is_path_separator(*rit))
-      break;
-    if (*rit == '.' && last_dot == filename.end())
-      last_dot = rit.base() - 1;
-  }
-
-  for (std::string::const_iterator it(rit.base()); it != filename.end(); ++it) {
-    if (it == last_dot)
-      break;
-    result.push_back(*it);
-  }
-
-  return result;
+  return std::string(get_file_title_view(filename));
 }
 
 std::string get_file_title_with_path(const std::string& filename)
@@ -196,49 +147,16 @@ std::string get_file_title_with_path(const std::string& filename)
 
 std::string get_relative_path(const std::string& filename, const std::string& base_path)
 {
-  std::vector<std::string> baseDirs;
-  split_string(base_path, baseDirs, path_separators);
-
-  std::vector<std::string> toParts;
-  split_string(filename, toParts, path_separators);
-
-  // Find the common prefix
-  auto itFrom = baseDirs.begin();
-  auto itTo = toParts.begin();
-
-  while (itFrom != baseDirs.end() &&
-         itTo != toParts.end()
-#if LAF_LINUX
-         // The Linux file system is case sensitive
-         && *itFrom == *itTo
-#else
-         && base::string_to_lower(*itFrom) == base::string_to_lower(*itTo)
-#endif
-  ) {
-    ++itFrom;
-    ++itTo;
-  }
-
-  if (itFrom == baseDirs.begin() && itTo == toParts.begin()) {
-    // No common prefix
-    return filename;
-  }
-
-  // Calculate the number of directories to go up from base path
-  std::string relativePath;
-  for (auto it = itFrom; it != baseDirs.end(); ++it)
-    relativePath = base::join_path(relativePath, "..");
-
-  // Append the remaining part of 'toPath'
-  for (auto it = itTo; it != toParts.end(); ++it)
-    relativePath = base::join_path(relativePath, *it);
-
-  return relativePath;
+  path_buffer result;
+  get_relative_path(result, filename, base_path);
+  return result.str();
 }
 
 std::string join_path(const std::string& path, const std::string& file)
 {
-  std::string result(path);
+  std::string result;
+  result.reserve(path.size() + 1 + file.size());
+  result = path;
 
   // Add a separator at the end if it is necessay
   if (!result.empty() && !is_path_separator(*(result.end() - 1)))
@@ -262,92 +180,16 @@ std::string remove_path_separator(const std::string& path)
 
 std::string fix_path_separators(const std::string& filename)
 {
-  std::string result;
-  result.reserve(filename.size());
-
-  size_t i = 0;
-
-#if LAF_WINDOWS
-  // Network paths can start with two backslashes
-  if (filename.size() >= 2 && filename[0] == path_separator && // Check for equality to backslash
-                                                               // (\),
-      filename[1] == path_separator) {                         // no for is_path_separator()
-    result.push_back(path_separator);
-    result.push_back(path_separator);
-    i += 2;
-  }
-#endif
-
-  for (; i < filename.size(); ++i) {
-    const auto chr = filename[i];
-    if (is_path_separator(chr)) {
-      if (result.empty() || !is_path_separator(result.back()))
-        result.push_back(path_separator);
-    }
-    else
-      result.push_back(chr);
-  }
-  return result;
+  path_buffer result;
+  fix_path_separators(result, filename);
+  return result.str();
 }
 
-// It tries to replicate the standard path::lexically_normal()
-// algorithm from https://en.cppreference.com/w/cpp/filesystem/path
-std::string normalize_path(const std::string& _path)
+std::string normalize_path(const std::string& path)
 {
-  // Normal form of an empty path is an empty path.
-  if (_path.empty())
-    return std::string();
-
-  // Replace multiple slashes with a single path_separator.
-  std::string path = fix_path_separators(_path);
-
-  std::vector<std::string> parts;
-  split_string(path, parts, path_separators);
-
-  std::vector<std::string> fn_parts;
-  const bool has_root = (!path.empty() && path[0] == path_separator);
-  const bool last_dot = (parts.back() == ".");
-  const bool last_slash = parts.back().empty();
-  if (last_slash || last_dot)
-    parts.pop_back();
-
-  for (const auto& part : parts) {
-    // Skip each dot part.
-    if (part.empty() || part == ".")
-      continue;
-    if (part == "..") {
-      if (has_root && fn_parts.empty())
-        continue;
-      if (!fn_parts.empty() && fn_parts.back() != "..")
-        fn_parts.pop_back();
-      else
-        fn_parts.push_back(part);
-    }
-    else
-      fn_parts.push_back(part);
-  }
-
-  // Reconstruct the filename 'fn' from 'fn_parts'
-  std::string fn;
-  fn.reserve(path.size());
-
-  if (has_root) {
-    fn.push_back(path_separator);
-#if LAF_WINDOWS
-    // Add the second separator for network paths.
-    if (path.size() >= 2 && path[1] == path_separator) {
-      fn.push_back(path_separator);
-    }
-#endif
-  }
-
-  for (const auto& part : fn_parts)
-    fn = join_path(fn, part);
-
-  if (!fn.empty() && parts.back() != ".." && (last_slash || last_dot))
-    fn.push_back(path_separator);
-
-  return (fn.empty() ? "." : fn);
+  path_buffer result;
+  normalize_path(result, path);
+  return result.str();
 }
 
 bool has_file_extension(const std::string& filename, const base::paths& extensions)
@@ -416,4 +258,361 @@ int compare_filenames(const std::string& a, const std::string& b)
   return 1;
 }
 
+namespace {
+
+// Returns true if "str" points to the memory of "buffer".
+bool is_inside_buffer(const path_buffer& buffer, const std::string_view str)
+{
+  const auto p = reinterpret_cast<uintptr_t>(str.data());
+  const auto b = reinterpret_cast<uintptr_t>(buffer.data());
+  return (p >= b && p <= b + buffer.capacity());
+}
+
+bool same_path_part(const std::string_view a, const std::string_view b)
+{
+#if LAF_LINUX
+  // The Linux file system is case sensitive
+  return a == b;
+#else
+  // Same as comparing string_to_lower() results (only ASCII chars are
+  // converted)
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i]))
+      return false;
+  }
+  return true;
+#endif
+}
+
+} // anonymous namespace
+
+std::string_view get_file_path_view(const std::string_view filename)
+{
+  const size_t pos = filename.find_last_of(path_separators);
+  return (pos != std::string_view::npos ? filename.substr(0, pos) : std::string_view());
+}
+
+std::string_view get_file_name_view(const std::string_view filename)
+{
+  const size_t pos = filename.find_last_of(path_separators);
+  return (pos != std::string_view::npos ? filename.substr(pos + 1) : filename);
+}
+
+std::string_view get_file_extension_view(const std::string_view filename)
+{
+  const std::string_view name = get_file_name_view(filename);
+  const size_t pos = name.rfind('.');
+  return (pos != std::string_view::npos ? name.substr(pos + 1) : std::string_view());
+}
+
+std::string_view get_file_title_view(const std::string_view filename)
+{
+  const std::string_view name = get_file_name_view(filename);
+  return name.substr(0, name.rfind('.'));
+}
+
+void join_path(path_buffer& path, const std::string_view file)
+{
+  if (!path.empty() && !is_path_separator(path.back()))
+    path.push_back(path_separator);
+  path.append(file);
+}
+
+void fix_path_separators(path_buffer& output, const std::string_view filename)
+{
+  if (is_inside_buffer(output, filename)) {
+    const path_buffer copy(filename);
+    fix_path_separators(output, copy);
+    return;
+  }
+
+  output.clear();
+  output.reserve(filename.size());
+
+  size_t i = 0;
+
+#if LAF_WINDOWS
+  // Network paths can start with two backslashes (check for equality
+  // to backslash (\), not for is_path_separator())
+  if (filename.size() >= 2 && filename[0] == path_separator && filename[1] == path_separator) {
+    output.push_back(path_separator);
+    output.push_back(path_separator);
+    i += 2;
+  }
+#endif
+
+  // Copy whole runs of non-separator chars at once
+  while (i < filename.size()) {
+    if (is_path_separator(filename[i])) {
+      if (output.empty() || !is_path_separator(output.back()))
+        output.push_back(path_separator);
+      ++i;
+      continue;
+    }
+    const size_t start = i;
+    while (i < filename.size() && !is_path_separator(filename[i]))
+      ++i;
+    output.append(filename.substr(start, i - start));
+  }
+}
+
+// It tries to replicate the standard path::lexically_normal()
+// algorithm from https://en.cppreference.com/w/cpp/filesystem/path
+void normalize_path(path_buffer& output, const std::string_view input)
+{
+  // Normal form of an empty path is an empty path.
+  if (input.empty()) {
+    output.clear();
+    return;
+  }
+
+  // Replace multiple slashes with a single path_separator.
+  path_buffer path;
+  fix_path_separators(path, input);
+
+  // The last element is ignored if it's "." or empty (trailing slash)
+  std::string_view parts = path;
+  std::string_view lastPart = get_file_name_view(parts);
+  const bool last_dot = (lastPart == ".");
+  const bool last_slash = lastPart.empty();
+  bool noParts = false;
+  if (last_slash || last_dot) {
+    if (lastPart.size() == parts.size())
+      noParts = true;
+    else {
+      parts.remove_suffix(lastPart.size() + 1);
+      lastPart = get_file_name_view(parts);
+    }
+  }
+
+  output.clear();
+  const bool has_root = (path[0] == path_separator);
+  if (has_root) {
+    output.push_back(path_separator);
+#if LAF_WINDOWS
+    // Add the second separator for network paths.
+    if (path.size() >= 2 && path[1] == path_separator) {
+      output.push_back(path_separator);
+    }
+#endif
+  }
+  const size_t rootSize = output.size();
+
+  // Number of elements in "output" and number of ".." elements at the
+  // beginning of it
+  size_t count = 0;
+  size_t dotdots = 0;
+
+  for (const std::string_view part : split_string_view(noParts ? "" : parts, path_separators)) {
+    // Skip each dot part.
+    if (part.empty() || part == ".")
+      continue;
+    if (part == "..") {
+      if (has_root && count == 0)
+        continue;
+      if (count > dotdots) {
+        // Remove the last element
+        const std::string_view prev = get_file_path_view(output.view().substr(rootSize));
+        output.resize(rootSize + prev.size());
+        --count;
+        continue;
+      }
+      ++dotdots;
+    }
+    join_path(output, part);
+    ++count;
+  }
+
+  if (!output.empty() && lastPart != ".." && (last_slash || last_dot))
+    output.push_back(path_separator);
+
+  if (output.empty())
+    output.push_back('.');
+}
+
+void get_relative_path(path_buffer& output,
+                       const std::string_view filename,
+                       const std::string_view base_path)
+{
+  if (is_inside_buffer(output, filename) || is_inside_buffer(output, base_path)) {
+    const path_buffer filenameCopy(filename);
+    const path_buffer basePathCopy(base_path);
+    get_relative_path(output, filenameCopy, basePathCopy);
+    return;
+  }
+
+  auto baseDirs = split_string_view(base_path, path_separators);
+  auto toParts = split_string_view(filename, path_separators);
+
+  // Find the common prefix
+  auto itFrom = baseDirs.begin();
+  auto itTo = toParts.begin();
+  bool commonPrefix = false;
+  while (itFrom != baseDirs.end() && itTo != toParts.end() && same_path_part(*itFrom, *itTo)) {
+    ++itFrom;
+    ++itTo;
+    commonPrefix = true;
+  }
+
+  if (!commonPrefix) {
+    output.assign(filename);
+    return;
+  }
+
+  // Calculate the number of directories to go up from base path
+  output.clear();
+  for (; itFrom != baseDirs.end(); ++itFrom)
+    join_path(output, "..");
+
+  // Append the remaining part of 'toPath'
+  for (; itTo != toParts.end(); ++itTo)
+    join_path(output, *itTo);
+}
+
+std::string dir_entry::path() const
+{
+  return join_path(dir(), name());
+}
+
+const details::dir_listing& dir_entry::load_stats() const
+{
+  details::dir_listing& listing = *m_listing;
+  std::call_once(listing.statsFlag, [&listing] { details::load_dir_stats(listing); });
+  return listing;
+}
+
+namespace {
+
+// Lists a directory tree, each subdirectory can be listed in a
+// different thread and its result goes to its own node, so the final
+// order is the same as a sequential walk.
+class dir_walker {
+public:
+  struct node {
+    dir_entries entries;
+    std::vector<std::unique_ptr<node>> children;
+  };
+
+  dir_walker(const ItemType filter, const std::string& match, thread_pool* pool)
+    : m_filter(filter)
+    , m_match(match)
+    , m_pool(pool)
+  {
+  }
+
+  void walk(const std::string& path, node& root)
+  {
+    if (m_pool) {
+      schedule(path, root);
+
+      std::unique_lock lock(m_mutex);
+      m_cv.wait(lock, [this] { return m_pending == 0; });
+
+      // Rethrow the first error found listing a directory
+      if (m_error)
+        std::rethrow_exception(m_error);
+    }
+    else
+      list(path, root);
+  }
+
+  static void flatten(node& n, dir_entries& output)
+  {
+    std::move(n.entries.begin(), n.entries.end(), std::back_inserter(output));
+    for (auto& child : n.children)
+      flatten(*child, output);
+  }
+
+private:
+  void schedule(const std::string& path, node& n)
+  {
+    {
+      const std::lock_guard lock(m_mutex);
+      ++m_pending;
+    }
+    try {
+      m_pool->execute([this, path, &n] {
+        // m_pending must be decremented even if list() fails,
+        // otherwise walk() waits forever
+        std::exception_ptr error;
+        try {
+          list(path, n);
+        }
+        catch (...) {
+          error = std::current_exception();
+        }
+
+        const std::lock_guard lock(m_mutex);
+        if (error && !m_error)
+          m_error = error;
+        if (--m_pending == 0)
+          m_cv.notify_all();
+      });
+    }
+    catch (...) {
+      const std::lock_guard lock(m_mutex);
+      --m_pending;
+      throw;
+    }
+  }
+
+  void list(const std::string& path, node& n)
+  {
+    // Read the directory just once, all subdirectories are visited
+    // even if they are not returned.
+    dir_entries items = list_dir(path);
+    dir_entries subdirs;
+    n.entries.reserve(items.size());
+    for (dir_entry& item : items) {
+      const bool isDir = item.is_directory();
+      if (isDir)
+        subdirs.push_back(item);
+
+      if ((m_filter == ItemType::Files && isDir) ||
+          (m_filter == ItemType::Directories && !isDir) ||
+          !details::match_dir_item(item.name(), m_match))
+        continue;
+
+      n.entries.push_back(std::move(item));
+    }
+
+    for (const dir_entry& subdir : subdirs) {
+      if (subdir.is_symlink())
+        continue;
+
+      n.children.push_back(std::make_unique<node>());
+      if (m_pool)
+        schedule(subdir.path(), *n.children.back());
+      else
+        list(subdir.path(), *n.children.back());
+    }
+  }
+
+  const ItemType m_filter;
+  const std::string& m_match;
+  thread_pool* m_pool;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  int m_pending = 0;
+  std::exception_ptr m_error;
+};
+
+} // anonymous namespace
+
+dir_entries list_dir_recursive(const std::string& path,
+                               const ItemType filter,
+                               const std::string& match,
+                               thread_pool* pool)
+{
+  dir_walker::node root;
+  dir_walker walker(filter, match, pool);
+  walker.walk(path, root);
+
+  dir_entries entries;
+  dir_walker::flatten(root, entries);
+  return entries;
+}
+
 } // namespace base
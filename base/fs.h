@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2020-2025 Igara Studio S.A.
+// Copyright (c) 2020-2026 Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,13 +9,21 @@
 #define BASE_FS_H_INCLUDED
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include "base/ints.h"
+#include "base/path_buffer.h"
 #include "base/paths.h"
+#include "base/time.h"
 
 namespace base {
 
-class Time;
+class task_token;
+class thread_pool;
 
 // Default path separator (on Windows it is '\' and on Unix-like
 // systems it is '/').
@@ -34,6 +42,23 @@ size_t file_size(const std::string& path);
 
 void move_file(const std::string& src, const std::string& dst);
 void copy_file(const std::string& src, const std::string& dst, bool overwrite);
+
+// Ways to copy the file content. Auto tries each kernel method in
+// order (reflink, copy_file_range(), sendfile()) falling back to the
+// next one if it's not supported, and finally to a buffered
+// read()/write() loop. These are only used on Linux, other platforms
+// always use the native copy function.
+enum class CopyFileMethod { Auto, Reflink, CopyFileRange, Sendfile, Buffered };
+
+// Copies a file reporting its progress and checking for cancellation
+// in the given token (can be nullptr). Returns false if the copy was
+// canceled (the incomplete "dst" file is deleted). Throws an
+// exception on errors, or if the specified method is not supported.
+bool copy_file(const std::string& src,
+               const std::string& dst,
+               bool overwrite,
+               task_token* token,
+               CopyFileMethod method = CopyFileMethod::Auto);
 void delete_file(const std::string& path);
 
 bool has_readonly_attr(const std::string& path);
@@ -77,6 +102,95 @@ paths list_files(const std::string& path,
                  ItemType filter = ItemType::All,
                  const std::string& = "*");
 
+namespace details {
+
+// Items of one list_dir() call, shared by all its dir_entry objects.
+struct dir_listing {
+  enum : uint8_t { kDirectory = 1, kSymlink = 2 };
+
+  std::string path;
+  std::vector<std::string> names;
+  std::vector<uint8_t> flags;
+
+  // Loaded with load_dir_stats() the first time they are needed.
+  std::once_flag statsFlag;
+  std::vector<uint64_t> sizes;
+  std::vector<Time> times;
+  std::vector<uint64_t> timesNs;
+};
+
+// Fills the "sizes", "times", and "timesNs" of all items in the
+// listing.
+void load_dir_stats(dir_listing& listing);
+
+// Returns true if the item name matches the "match" argument of
+// list_dir() (with the same rules used by list_dir() in each
+// platform).
+bool match_dir_item(const std::string& name, const std::string& match);
+
+} // namespace details
+
+// Item returned by list_dir(). The item type comes from the directory
+// listing itself (d_type on Unix-like systems), so is_file() and
+// is_directory() don't need a stat() call. The size and modification
+// time of all items from the same listing are loaded together the
+// first time one of them is requested (one statx() per item relative
+// to the directory, without resolving the whole path each time).
+class dir_entry {
+public:
+  dir_entry(std::shared_ptr<details::dir_listing> listing, const size_t index)
+    : m_listing(std::move(listing))
+    , m_index(index)
+  {
+  }
+
+  // Directory that contains this item.
+  const std::string& dir() const { return m_listing->path; }
+  const std::string& name() const { return m_listing->names[m_index]; }
+  std::string path() const;
+
+  // Symbolic links are followed, is_symlink() returns true in that
+  // case.
+  bool is_directory() const { return (flags() & details::dir_listing::kDirectory); }
+  bool is_file() const { return !is_directory(); }
+  bool is_symlink() const { return (flags() & details::dir_listing::kSymlink); }
+
+  uint64_t size() const { return load_stats().sizes[m_index]; }
+  Time modification_time() const { return load_stats().times[m_index]; }
+
+  // Modification time in nanoseconds since the Unix epoch (with the
+  // precision of the file system), useful to detect changes in the
+  // same second.
+  uint64_t modification_time_ns() const { return load_stats().timesNs[m_index]; }
+
+private:
+  uint8_t flags() const { return m_listing->flags[m_index]; }
+  const details::dir_listing& load_stats() const;
+
+  std::shared_ptr<details::dir_listing> m_listing;
+  size_t m_index;
+};
+
+using dir_entries = std::vector<dir_entry>;
+
+// Like list_files() but returns dir_entry items, so callers don't
+// need extra is_file()/is_directory()/file_size() calls per item.
+dir_entries list_dir(const std::string& path,
+                     ItemType filter = ItemType::All,
+                     const std::string& match = "*");
+
+// Lists the items of "path" and all its subdirectories. "filter" and
+// "match" are applied to the returned items, but all subdirectories
+// are visited (except symbolic links to directories). Items of a
+// directory are followed by the items of each subdirectory.
+//
+// If a thread pool is given, subdirectories are listed in parallel
+// (this function must not be called from a worker of that pool).
+dir_entries list_dir_recursive(const std::string& path,
+                               ItemType filter = ItemType::All,
+                               const std::string& match = "*",
+                               thread_pool* pool = nullptr);
+
 // Returns true if the given character is a valud path separator
 // (any of '\' or '/' characters).
 inline constexpr bool is_path_separator(std::string::value_type chr)
@@ -127,6 +241,22 @@ bool has_file_extension(const std::string& filename, const base::paths& extensio
 
 int compare_filenames(const std::string& a, const std::string& b);
 
+// Versions of the previous functions that don't allocate memory: they
+// return a part of the given string, or write the result in a
+// path_buffer. The input string can be a view of the output buffer
+// itself.
+std::string_view get_file_path_view(std::string_view filename);
+std::string_view get_file_name_view(std::string_view filename);
+std::string_view get_file_extension_view(std::string_view filename);
+std::string_view get_file_title_view(std::string_view filename);
+
+// Appends "file" to "path" with a path-separator (if it's needed).
+void join_path(path_buffer& path, std::string_view file);
+
+void fix_path_separators(path_buffer& output, std::string_view filename);
+void normalize_path(path_buffer& output, std::string_view path);
+void get_relative_path(path_buffer& output, std::string_view filename, std::string_view base_path);
+
 #if LAF_WINDOWS
 class Version;
 Version get_file_version(const std::string& filename);
@@ -0,0 +1,184 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/thread_pool.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace base;
+
+TEST(FS, PathBenchmark)
+{
+  const std::vector<std::string> files = { "data/sprites/player/walk_01.png",
+                                           "data/sprites/../palettes/./default.gpl",
+                                           "/home/user/projects/game/assets/tiles/grass.aseprite",
+                                           "extensions//theme-dark/sheet.png" };
+  const std::string root = "/home/user/projects/game";
+  const int n = 50000;
+  size_t total1 = 0, total2 = 0;
+
+  Chrono chrono;
+  for (int i = 0; i < n; ++i) {
+    for (const std::string& fn : files) {
+      const std::string full = normalize_path(join_path(root, fn));
+      total1 += get_file_name(full).size() + get_file_extension(full).size();
+      total1 += get_relative_path(get_file_path(full), root).size();
+    }
+  }
+  const double t1 = chrono.elapsed();
+
+  chrono.reset();
+  for (int i = 0; i < n; ++i) {
+    for (const std::string& fn : files) {
+      path_buffer full(root);
+      join_path(full, fn);
+      normalize_path(full, full);
+      total2 += get_file_name_view(full).size() + get_file_extension_view(full).size();
+      path_buffer rel;
+      get_relative_path(rel, get_file_path_view(full), root);
+      total2 += rel.size();
+    }
+  }
+  const double t2 = chrono.elapsed();
+  EXPECT_EQ(total1, total2);
+
+  std::printf("std::string functions   %.2f M paths/s\n", n * files.size() / t1 / 1.0e6);
+  std::printf("path_buffer/views       %.2f M paths/s\n", n * files.size() / t2 / 1.0e6);
+}
+
+static const CopyFileMethod all_copy_methods[] = { CopyFileMethod::Auto,
+                                                   CopyFileMethod::Reflink,
+                                                   CopyFileMethod::CopyFileRange,
+                                                   CopyFileMethod::Sendfile,
+                                                   CopyFileMethod::Buffered };
+
+static const char* copy_method_name(const CopyFileMethod method)
+{
+  switch (method) {
+    case CopyFileMethod::Auto:          return "auto";
+    case CopyFileMethod::Reflink:       return "reflink";
+    case CopyFileMethod::CopyFileRange: return "copy_file_range";
+    case CopyFileMethod::Sendfile:      return "sendfile";
+    case CopyFileMethod::Buffered:      return "buffered";
+  }
+  return "";
+}
+
+TEST(FS, CopyFileBenchmark)
+{
+  std::vector<uint8_t> data(64 * 1024 * 1024);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = uint8_t(i);
+
+  std::vector<std::string> dirs = { get_current_path() };
+#if LAF_LINUX
+  if (is_directory("/dev/shm"))
+    dirs.push_back("/dev/shm"); // tmpfs
+#endif
+
+  for (const std::string& dir : dirs) {
+    const std::string src = join_path(dir, "_test_copy_bench_src_.tmp");
+    const std::string dst = join_path(dir, "_test_copy_bench_dst_.tmp");
+    write_file_content(src, data.data(), data.size());
+
+    for (const CopyFileMethod method : all_copy_methods) {
+      Chrono chrono;
+      try {
+        copy_file(src, dst, true, nullptr, method);
+      }
+      catch (const std::exception&) {
+        std::printf("%-16s %-16s not supported\n", dir.c_str(), copy_method_name(method));
+        continue;
+      }
+      const double t = chrono.elapsed();
+      std::printf("%-16s %-16s %8.2f MB/s\n",
+                  dir.c_str(),
+                  copy_method_name(method),
+                  data.size() / t / 1024.0 / 1024.0);
+      delete_file(dst);
+    }
+    delete_file(src);
+  }
+}
+
+// Deletes the items returned by list_dir_recursive() (subdirectories
+// are after their parent, so we delete them in reverse order).
+static void delete_tree(const std::string& path)
+{
+  const dir_entries entries = list_dir_recursive(path);
+  for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+    if (it->is_directory())
+      remove_directory(it->path());
+    else
+      delete_file(it->path());
+  }
+  remove_directory(path);
+}
+
+TEST(FS, ListDirBenchmark)
+{
+  const int nDirs = 20;
+  const int nFiles = 500;
+  for (int i = 0; i < nDirs; ++i) {
+    const std::string dir = join_path("bench", std::to_string(i));
+    make_all_directories(dir);
+    for (int j = 0; j < nFiles; ++j)
+      write_file_content(join_path(dir, std::to_string(j) + ".png"), (uint8_t*)"x", 1);
+  }
+
+  // Old way: names + one stat() per item for each property
+  Chrono chrono;
+  uint64_t total1 = 0;
+  for (const std::string& dir : list_files("bench", ItemType::Directories)) {
+    const std::string path = join_path("bench", dir);
+    for (const std::string& name : list_files(path)) {
+      const std::string fn = join_path(path, name);
+      if (is_file(fn)) {
+        total1 += file_size(fn);
+        get_modification_time(fn);
+      }
+    }
+  }
+  const double t1 = chrono.elapsed();
+
+  chrono.reset();
+  uint64_t total2 = 0;
+  for (const dir_entry& entry : list_dir_recursive("bench", ItemType::Files)) {
+    total2 += entry.size();
+    entry.modification_time();
+  }
+  const double t2 = chrono.elapsed();
+
+  thread_pool pool(4);
+  chrono.reset();
+  uint64_t total3 = 0;
+  for (const dir_entry& entry : list_dir_recursive("bench", ItemType::Files, "*", &pool))
+    total3 += entry.size();
+  const double t3 = chrono.elapsed();
+
+  EXPECT_EQ(uint64_t(nDirs * nFiles), total1);
+  EXPECT_EQ(total1, total2);
+  EXPECT_EQ(total1, total3);
+
+  delete_tree("bench");
+
+  std::printf("list_files + stat()        %.2f ms\n", t1 * 1000.0);
+  std::printf("list_dir_recursive         %.2f ms\n", t2 * 1000.0);
+  std::printf("list_dir_recursive (pool)  %.2f ms\n", t3 * 1000.0);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
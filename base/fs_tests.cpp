@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2024-2025 Igara Studio S.A.
+// Copyright (c) 2024-2026 Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,9 +9,13 @@
 
 #include "base/file_content.h"
 #include "base/fs.h"
+#include "base/task.h"
+#include "base/thread_pool.h"
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <set>
 
 #if !LAF_MACOS
   #define COMPARE_WITH_STD_FS 1
@@ -462,6 +466,170 @@ TEST(FS, CopyFiles)
   EXPECT_EQ(data, read_file_content(dst));
 }
 
+TEST(FS, PathViews)
+{
+  EXPECT_EQ("a/b", get_file_path_view("a/b/c.txt"));
+  EXPECT_EQ("", get_file_path_view("c.txt"));
+  EXPECT_EQ("c.txt", get_file_name_view("a/b/c.txt"));
+  EXPECT_EQ("c.txt", get_file_name_view("c.txt"));
+  EXPECT_EQ("", get_file_name_view("a/b/"));
+  EXPECT_EQ("txt", get_file_extension_view("a/b/c.txt"));
+  EXPECT_EQ("", get_file_extension_view("a.b/c"));
+  EXPECT_EQ("gz", get_file_extension_view("c.tar.gz"));
+  EXPECT_EQ("c.tar", get_file_title_view("a/c.tar.gz"));
+  EXPECT_EQ("c", get_file_title_view("a/c"));
+  EXPECT_EQ("", get_file_title_view(".hidden"));
+
+  // The views point to the original string
+  const std::string fn = "dir/file.png";
+  EXPECT_EQ(fn.data() + 4, get_file_name_view(fn).data());
+}
+
+TEST(FS, PathBuffer)
+{
+  path_buffer buf;
+  EXPECT_TRUE(buf.empty());
+  EXPECT_EQ(size_t(0), std::strlen(buf.c_str()));
+
+  buf = "a";
+  join_path(buf, "b");
+  join_path(buf, "c.txt");
+  EXPECT_EQ(fix_path_separators("a/b/c.txt"), buf.view());
+  EXPECT_EQ(buf.size(), std::strlen(buf.c_str()));
+  EXPECT_FALSE(buf.is_heap());
+
+  // In-place operations
+  path_buffer path("a//b/../c/./d/");
+  normalize_path(path, path);
+  EXPECT_EQ(normalize_path("a//b/../c/./d/"), path.view());
+  fix_path_separators(path, path);
+  EXPECT_EQ(fix_path_separators(normalize_path("a//b/../c/./d/")), path.view());
+  get_relative_path(path, "a/b/c/d", "a/b/x");
+  EXPECT_EQ(fix_path_separators("../c/d"), path.view());
+
+  // Long paths use the heap
+  const std::string longPath(1000, 'x');
+  path_buffer longBuf;
+  for (int i = 0; i < 4; ++i)
+    join_path(longBuf, longPath);
+  EXPECT_TRUE(longBuf.is_heap());
+  EXPECT_EQ(size_t(4 * 1001 - 1), longBuf.size());
+  EXPECT_EQ(longBuf.size(), std::strlen(longBuf.c_str()));
+
+  // Append a part of itself when it must grow
+  path_buffer self(std::string(200, 'y'));
+  self.append(self.view());
+  EXPECT_EQ(std::string(400, 'y'), self.view());
+
+  path_buffer copy(self);
+  EXPECT_EQ(self.view(), copy.view());
+  copy = buf;
+  EXPECT_EQ(buf.view(), copy.view());
+}
+
+static const CopyFileMethod all_copy_methods[] = { CopyFileMethod::Auto,
+                                                   CopyFileMethod::Reflink,
+                                                   CopyFileMethod::CopyFileRange,
+                                                   CopyFileMethod::Sendfile,
+                                                   CopyFileMethod::Buffered };
+
+static const char* copy_method_name(const CopyFileMethod method)
+{
+  switch (method) {
+    case CopyFileMethod::Auto:          return "auto";
+    case CopyFileMethod::Reflink:       return "reflink";
+    case CopyFileMethod::CopyFileRange: return "copy_file_range";
+    case CopyFileMethod::Sendfile:      return "sendfile";
+    case CopyFileMethod::Buffered:      return "buffered";
+  }
+  return "";
+}
+
+TEST(FS, CopyFileMethods)
+{
+  std::vector<uint8_t> data(3 * 1024 * 1024 + 17);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = uint8_t(i * 31);
+
+  const std::string src = "_test_copy_src_.tmp";
+  const std::string dst = "_test_copy_dst_.tmp";
+  write_file_content(src, data.data(), data.size());
+
+  for (const CopyFileMethod method : all_copy_methods) {
+    task_token token;
+    try {
+      EXPECT_TRUE(copy_file(src, dst, true, &token, method));
+    }
+    catch (const std::exception&) {
+      // Method not supported in this file system
+      EXPECT_NE(CopyFileMethod::Auto, method);
+      EXPECT_FALSE(is_file(dst));
+      continue;
+    }
+    EXPECT_EQ(1.0f, token.progress()) << copy_method_name(method);
+    EXPECT_EQ(data, read_file_content(dst)) << copy_method_name(method);
+
+    // Don't overwrite an existing file
+    EXPECT_THROW(copy_file(src, dst, false, nullptr, method), std::exception);
+    EXPECT_EQ(data, read_file_content(dst));
+    delete_file(dst);
+  }
+
+  // Empty file
+  write_file_content(src, nullptr, 0);
+  copy_file(src, dst, true);
+  EXPECT_TRUE(is_file(dst));
+  EXPECT_EQ(size_t(0), file_size(dst));
+  delete_file(dst);
+
+  delete_file(src);
+}
+
+TEST(FS, CopyFileCancel)
+{
+  std::vector<uint8_t> data(4 * 1024 * 1024, 1);
+  const std::string src = "_test_copy_src_.tmp";
+  const std::string dst = "_test_copy_dst_.tmp";
+  write_file_content(src, data.data(), data.size());
+
+  task_token token;
+  token.cancel();
+  EXPECT_FALSE(copy_file(src, dst, true, &token, CopyFileMethod::Buffered));
+  EXPECT_FALSE(is_file(dst));
+  delete_file(src);
+}
+
+#if !LAF_WINDOWS
+// Reading a directory fails after the destination file was created
+TEST(FS, CopyFileError)
+{
+  const std::string src = "_test_copy_dir_";
+  const std::string dst = "_test_copy_dst_.tmp";
+  make_directory(src);
+
+  EXPECT_THROW(copy_file(src, dst, true, nullptr, CopyFileMethod::Buffered), std::exception);
+  EXPECT_FALSE(is_file(dst));
+  remove_directory(src);
+}
+#endif
+
+#if LAF_LINUX
+// Files in /proc report st_size == 0 but have content
+TEST(FS, CopyFileProcfs)
+{
+  const std::string src = "/proc/version";
+  const std::string dst = "_test_copy_dst_.tmp";
+  if (!is_file(src))
+    return;
+
+  const buffer expected = read_file_content(src);
+  ASSERT_FALSE(expected.empty());
+  EXPECT_TRUE(copy_file(src, dst, true, nullptr, CopyFileMethod::Auto));
+  EXPECT_EQ(expected, read_file_content(dst));
+  delete_file(dst);
+}
+#endif
+
 TEST(FS, ListFiles)
 {
   // Prepare files
@@ -521,6 +689,83 @@ TEST(FS, ListFiles)
   remove_directory("a");
 }
 
+static std::set<std::string> entry_names(const dir_entries& entries)
+{
+  std::set<std::string> names;
+  for (const dir_entry& entry : entries)
+    names.insert(get_relative_path(entry.path(), "t"));
+  return names;
+}
+
+// Deletes the items returned by list_dir_recursive() (subdirectories
+// are after their parent, so we delete them in reverse order).
+static void delete_tree(const std::string& path)
+{
+  const dir_entries entries = list_dir_recursive(path);
+  for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+    if (it->is_directory())
+      remove_directory(it->path());
+    else
+      delete_file(it->path());
+  }
+  remove_directory(path);
+}
+
+TEST(FS, ListDir)
+{
+  make_all_directories("t/b/c");
+  write_file_content("t/a.png", (uint8_t*)"12345", 5);
+  write_file_content("t/b/x.png", (uint8_t*)"1", 1);
+  write_file_content("t/b/y.txt", (uint8_t*)"12", 2);
+  write_file_content("t/b/c/z.png", (uint8_t*)"123", 3);
+
+  EXPECT_TRUE(list_dir("non-existent-folder").empty());
+
+  dir_entries entries = list_dir("t");
+  ASSERT_EQ(size_t(2), entries.size());
+  std::sort(entries.begin(), entries.end(), [](const dir_entry& a, const dir_entry& b) {
+    return a.name() < b.name();
+  });
+  EXPECT_EQ("a.png", entries[0].name());
+  EXPECT_EQ(join_path("t", "a.png"), entries[0].path());
+  EXPECT_TRUE(entries[0].is_file());
+  EXPECT_FALSE(entries[0].is_symlink());
+  EXPECT_EQ(uint64_t(5), entries[0].size());
+  EXPECT_EQ(get_modification_time("t/a.png"), entries[0].modification_time());
+  EXPECT_EQ("b", entries[1].name());
+  EXPECT_TRUE(entries[1].is_directory());
+
+  EXPECT_EQ(size_t(1), list_dir("t", ItemType::Files).size());
+  EXPECT_EQ(size_t(1), list_dir("t", ItemType::Directories).size());
+  EXPECT_EQ(size_t(2), list_dir("t/b", ItemType::Files).size());
+  EXPECT_EQ(size_t(1), list_dir("t/b", ItemType::Files, "*.png").size());
+
+  const std::set<std::string> all = { "a.png",
+                                      "b",
+                                      fix_path_separators("b/c"),
+                                      fix_path_separators("b/c/z.png"),
+                                      fix_path_separators("b/x.png"),
+                                      fix_path_separators("b/y.txt") };
+  const std::set<std::string> pngs = { "a.png",
+                                       fix_path_separators("b/c/z.png"),
+                                       fix_path_separators("b/x.png") };
+  thread_pool pool(3);
+  for (thread_pool* p : { (thread_pool*)nullptr, &pool }) {
+    EXPECT_EQ(all, entry_names(list_dir_recursive("t", ItemType::All, "*", p)));
+    EXPECT_EQ(pngs, entry_names(list_dir_recursive("t", ItemType::Files, "*.png", p)));
+    EXPECT_EQ(size_t(2), list_dir_recursive("t", ItemType::Directories, "*", p).size());
+  }
+
+  // Subdirectories go after the items of their parent
+  const dir_entries tree = list_dir_recursive("t", ItemType::All, "*", &pool);
+  ASSERT_EQ(size_t(6), tree.size());
+  EXPECT_EQ("t", tree[0].dir());
+  EXPECT_EQ("t", tree[1].dir());
+
+  delete_tree("t");
+  EXPECT_FALSE(is_directory("t"));
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2021-2025 Igara Studio S.A.
+// Copyright (c) 2021-2026 Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -10,14 +10,17 @@
 #include "base/fs.h"
 #include "base/ints.h"
 #include "base/paths.h"
+#include "base/task.h"
 #include "base/time.h"
 
 #include <dirent.h>
+#include <fcntl.h>
 #include <fnmatch.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <climits>
 #include <cstdio>
@@ -33,6 +36,12 @@
   #include <sys/sysctl.h>
 #endif
 
+#if LAF_LINUX
+  #include <linux/fs.h>
+  #include <sys/ioctl.h>
+  #include <sys/sendfile.h>
+#endif
+
 #define MAXPATHLEN 1024
 
 namespace base {
@@ -70,40 +79,198 @@ void move_file(const std::string& src, const std::string& dst)
     throw std::runtime_error("Error moving file: " + std::string(std::strerror(errno)));
 }
 
+namespace {
+
+// Closes a file descriptor when it goes out of scope.
+class unique_fd {
+public:
+  explicit unique_fd(const int fd) : m_fd(fd) {}
+  ~unique_fd()
+  {
+    if (m_fd >= 0)
+      close(m_fd);
+  }
+  unique_fd(const unique_fd&) = delete;
+  unique_fd& operator=(const unique_fd&) = delete;
+
+  int get() const { return m_fd; }
+  explicit operator bool() const { return m_fd >= 0; }
+
+private:
+  int m_fd;
+};
+
+enum class copy_result { Done, Unsupported, Canceled };
+
+// Copies the file calling copyChunk(maxBytes) until it returns 0
+// (end of file). Progress and cancellation are checked after each
+// chunk. If "emptyIsUnsupported" is true, a file with st_size == 0
+// where nothing can be copied returns Unsupported: files in procfs
+// or sysfs report a zero size and the kernel methods copy nothing
+// from them, but they can be read().
+template<typename Func>
+copy_result copy_chunks(const uint64_t size,
+                        task_token* token,
+                        const size_t chunkSize,
+                        const bool emptyIsUnsupported,
+                        Func copyChunk)
+{
+  uint64_t copied = 0;
+  while (true) {
+    const ssize_t bytes = copyChunk(chunkSize);
+    if (bytes < 0) {
+      if (errno == EINTR)
+        continue;
+
+      // The method is not supported for this kind of file/file system
+      if (copied == 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL ||
+                          errno == EOPNOTSUPP || errno == ENOTSUP || errno == EBADF)) {
+        return copy_result::Unsupported;
+      }
+      throw std::runtime_error("Error copying file: " + std::string(std::strerror(errno)));
+    }
+    if (bytes == 0) {
+      if (copied == 0 && size == 0 && emptyIsUnsupported)
+        return copy_result::Unsupported;
+      return copy_result::Done;
+    }
+
+    copied += bytes;
+    if (token) {
+      if (token->canceled())
+        return copy_result::Canceled;
+      if (size > 0)
+        token->set_progress(float(std::min(1.0, double(copied) / double(size))));
+    }
+  }
+}
+
+copy_result copy_file_content(const int src,
+                              const int dst,
+                              const uint64_t size,
+                              task_token* token,
+                              const CopyFileMethod method)
+{
+  // Kernel methods copy up to 64MB between progress updates
+  constexpr size_t kKernelChunkSize = 64 * 1024 * 1024;
+  copy_result result = copy_result::Unsupported;
+
+#if LAF_LINUX
+  // With the Auto method, empty files are read with the buffered
+  // method too, in case they are special files (like /proc/*).
+  const bool fallback = (method == CopyFileMethod::Auto);
+
+  // Shares the data blocks between both files in copy-on-write file
+  // systems (Btrfs, XFS), the copy is instantaneous.
+  if (method == CopyFileMethod::Auto || method == CopyFileMethod::Reflink) {
+    if (ioctl(dst, FICLONE, src) == 0)
+      return copy_result::Done;
+    if (method != CopyFileMethod::Auto)
+      return copy_result::Unsupported;
+  }
+
+  // Copies in the kernel (without user space buffers), some file
+  // systems (NFS, SMB) can do a server-side copy.
+  if (method == CopyFileMethod::Auto || method == CopyFileMethod::CopyFileRange) {
+    result = copy_chunks(size, token, kKernelChunkSize, fallback, [src, dst](const size_t n) {
+      return copy_file_range(src, nullptr, dst, nullptr, n, 0);
+    });
+    if (result != copy_result::Unsupported || method != CopyFileMethod::Auto)
+      return result;
+  }
+
+  if (method == CopyFileMethod::Auto || method == CopyFileMethod::Sendfile) {
+    result = copy_chunks(size, token, kKernelChunkSize, fallback, [src, dst](const size_t n) {
+      return sendfile(dst, src, nullptr, n);
+    });
+    if (result != copy_result::Unsupported || method != CopyFileMethod::Auto)
+      return result;
+  }
+#endif
+
+  if (method == CopyFileMethod::Auto || method == CopyFileMethod::Buffered) {
+    constexpr size_t kChunkSize = 1024 * 1024;
+    std::vector<uint8_t> buf(kChunkSize);
+    auto copyChunk = [src, dst, &buf](const size_t n) -> ssize_t {
+      const ssize_t bytes = read(src, buf.data(), n);
+      for (ssize_t written = 0; written < bytes;) {
+        const ssize_t w = write(dst, buf.data() + written, bytes - written);
+        if (w < 0) {
+          if (errno == EINTR)
+            continue;
+          return -1;
+        }
+        written += w;
+      }
+      return bytes;
+    };
+    result = copy_chunks(size, token, kChunkSize, false, copyChunk);
+  }
+  return result;
+}
+
+} // anonymous namespace
+
 void copy_file(const std::string& src_fn, const std::string& dst_fn, const bool overwrite)
 {
-  // First copy the file content
-  FileHandle src = open_file(src_fn, "rb");
+  copy_file(src_fn, dst_fn, overwrite, nullptr);
+}
+
+bool copy_file(const std::string& src_fn,
+               const std::string& dst_fn,
+               const bool overwrite,
+               task_token* token,
+               const CopyFileMethod method)
+{
+  unique_fd src(open(src_fn.c_str(), O_RDONLY | O_CLOEXEC));
   if (!src) {
     throw std::runtime_error("Cannot open source file " + std::string(std::strerror(errno)));
   }
 
-  FileHandle dst = open_file(dst_fn, "wb");
+  struct stat sts;
+  if (fstat(src.get(), &sts) != 0) {
+    throw std::runtime_error("Cannot read source file " + std::string(std::strerror(errno)));
+  }
+
+  unique_fd dst(open(dst_fn.c_str(),
+                     O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | (overwrite ? 0 : O_EXCL),
+                     0666));
   if (!dst) {
     throw std::runtime_error("Cannot open destination file " + std::string(std::strerror(errno)));
   }
 
-  // Copy data in 4KB chunks
-  constexpr size_t kChunkSize = 4096;
-  std::vector<uint8_t> buf(kChunkSize);
-  while (size_t bytes = std::fread(buf.data(), 1, buf.size(), src.get())) {
-    std::fwrite(buf.data(), 1, bytes, dst.get());
+  // Don't leave a truncated destination file in case of error
+  copy_result result;
+  try {
+    result = copy_file_content(src.get(), dst.get(), sts.st_size, token, method);
+  }
+  catch (...) {
+    unlink(dst_fn.c_str());
+    throw;
+  }
+  if (result != copy_result::Done) {
+    unlink(dst_fn.c_str());
+    if (result == copy_result::Canceled)
+      return false;
+    throw std::runtime_error("The file system doesn't support the given copy method");
   }
 
   // Now copy file attributes (mode and owner)
-  struct stat sts;
-  stat(src_fn.c_str(), &sts);
-  fchmod(fileno(dst.get()), sts.st_mode);
-  fchown(fileno(dst.get()), sts.st_uid, sts.st_gid);
+  fchmod(dst.get(), sts.st_mode);
+  (void)fchown(dst.get(), sts.st_uid, sts.st_gid);
 
   // Check that the output file has the same mode and owner
 #if _DEBUG
   struct stat sts2;
-  stat(dst_fn.c_str(), &sts2);
+  fstat(dst.get(), &sts2);
   ASSERT(sts.st_mode == sts2.st_mode);
   ASSERT(sts.st_uid == sts2.st_uid);
   ASSERT(sts.st_gid == sts2.st_gid);
 #endif
+
+  if (token)
+    token->set_progress(1.0f);
+  return true;
 }
 
 void delete_file(const std::string& path)
@@ -251,4 +418,116 @@ paths list_files(const std::string& path, ItemType filter, const std::string& ma
   return files;
 }
 
+dir_entries list_dir(const std::string& path, ItemType filter, const std::string& match)
+{
+  dir_entries entries;
+  DIR* handle = opendir(path.c_str());
+  if (!handle)
+    return entries;
+
+  auto listing = std::make_shared<details::dir_listing>();
+  listing->path = path;
+
+  const bool matchAll = (match == "*");
+  dirent* item;
+  while ((item = readdir(handle)) != nullptr) {
+    const char* name = item->d_name;
+    if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0)))
+      continue;
+
+    uint8_t flags = 0;
+    if (item->d_type == DT_DIR) {
+      flags = details::dir_listing::kDirectory;
+    }
+    // Follow symbolic links, and stat() items from file systems that
+    // don't fill d_type.
+    else if (item->d_type == DT_LNK || item->d_type == DT_UNKNOWN) {
+      struct stat sts;
+      bool link = (item->d_type == DT_LNK);
+      if (!link && fstatat(dirfd(handle), name, &sts, AT_SYMLINK_NOFOLLOW) == 0) {
+        if (S_ISDIR(sts.st_mode))
+          flags = details::dir_listing::kDirectory;
+        link = S_ISLNK(sts.st_mode);
+      }
+      if (link) {
+        flags = details::dir_listing::kSymlink;
+        if (fstatat(dirfd(handle), name, &sts, 0) == 0 && S_ISDIR(sts.st_mode))
+          flags |= details::dir_listing::kDirectory;
+      }
+    }
+
+    if ((filter == ItemType::Files && (flags & details::dir_listing::kDirectory)) ||
+        (filter == ItemType::Directories && !(flags & details::dir_listing::kDirectory)))
+      continue;
+
+    if (!matchAll && fnmatch(match.c_str(), name, FNM_CASEFOLD) == FNM_NOMATCH)
+      continue;
+
+    listing->names.push_back(name);
+    listing->flags.push_back(flags);
+  }
+  closedir(handle);
+
+  const size_t n = listing->names.size();
+  entries.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+    entries.emplace_back(listing, i);
+  return entries;
+}
+
+bool details::match_dir_item(const std::string& name, const std::string& match)
+{
+  return (match == "*" || fnmatch(match.c_str(), name.c_str(), FNM_CASEFOLD) != FNM_NOMATCH);
+}
+
+void details::load_dir_stats(dir_listing& listing)
+{
+  const size_t n = listing.names.size();
+  listing.sizes.resize(n, 0);
+  listing.times.resize(n);
+  listing.timesNs.resize(n, 0);
+
+  // Open the directory just one time, so each statx()/fstatat() call
+  // doesn't have to resolve the whole path again.
+  const int dirFd = open(listing.path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dirFd < 0)
+    return;
+
+  for (size_t i = 0; i < n; ++i) {
+    std::time_t mtime;
+#if LAF_LINUX && defined(STATX_SIZE)
+    // Ask only for the fields we need and don't force a sync with
+    // network file systems.
+    struct statx sts;
+    if (statx(dirFd,
+              listing.names[i].c_str(),
+              AT_STATX_DONT_SYNC,
+              STATX_SIZE | STATX_MTIME,
+              &sts) != 0)
+      continue;
+    listing.sizes[i] = sts.stx_size;
+    mtime = sts.stx_mtime.tv_sec;
+    listing.timesNs[i] = uint64_t(sts.stx_mtime.tv_sec) * 1000000000ull + sts.stx_mtime.tv_nsec;
+#else
+    struct stat sts;
+    if (fstatat(dirFd, listing.names[i].c_str(), &sts, 0) != 0)
+      continue;
+    listing.sizes[i] = sts.st_size;
+    mtime = sts.st_mtime;
+  #if LAF_MACOS
+    const struct timespec& ts = sts.st_mtimespec;
+  #else
+    const struct timespec& ts = sts.st_mtim;
+  #endif
+    listing.timesNs[i] = uint64_t(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+#endif
+
+    std::tm t;
+    safe_localtime(mtime, &t);
+    listing.times[i] =
+      Time(t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec);
+  }
+  close(dirFd);
+}
+
 } // namespace base
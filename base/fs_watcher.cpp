@@ -0,0 +1,635 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/fs_watcher.h"
+
+#include "base/clock.h"
+#include "base/fs.h"
+#include "base/thread.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <thread>
+#include <unordered_set>
+
+#if LAF_LINUX
+  #include <poll.h>
+  #include <sys/inotify.h>
+  #include <unistd.h>
+
+  #include <cerrno>
+#endif
+
+namespace base {
+
+namespace {
+
+bool is_inside(const std::string& path, const std::string& dir)
+{
+  return (path.size() > dir.size() && path.compare(0, dir.size(), dir) == 0 &&
+          is_path_separator(path[dir.size()]));
+}
+
+// Merges a new change of a file with its pending changes. Returns 0
+// if the changes cancel each other (e.g. created + deleted).
+uint8_t merge_changes(uint8_t old, uint8_t add)
+{
+  const uint8_t rescan = (old | add) & FS_RESCAN;
+  old &= ~FS_RESCAN;
+  add &= ~FS_RESCAN;
+
+  uint8_t result;
+  if (!old)
+    result = add;
+  else if (!add)
+    result = old;
+  else if (add & FS_DELETED)
+    result = ((old & FS_CREATED) ? 0 : FS_DELETED);
+  else if (add & FS_CREATED)
+    result = ((old & FS_DELETED) ? FS_MODIFIED : FS_CREATED);
+  else
+    result = ((old & FS_CREATED) ? FS_CREATED : FS_MODIFIED);
+  return result | rescan;
+}
+
+} // anonymous namespace
+
+class fs_watcher::impl {
+public:
+  impl(callback_t&& callback, const double latency, const double pollInterval, bool usePolling)
+    : m_callback(std::move(callback))
+    , m_latencyNs(uint64_t(latency * 1.0e9))
+    , m_pollInterval(pollInterval)
+  {
+#if LAF_LINUX
+    if (!usePolling) {
+      m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+      if (m_fd >= 0 && pipe(m_stopPipe) != 0) {
+        close(m_fd);
+        m_fd = -1;
+      }
+    }
+    if (m_fd >= 0) {
+      m_thread = std::thread([this] { inotify_thread(); });
+      return;
+    }
+#endif
+    m_thread = std::thread([this] { polling_thread(); });
+  }
+
+  ~impl()
+  {
+    {
+      const std::lock_guard lock(m_mutex);
+      m_running = false;
+    }
+    m_cv.notify_one();
+#if LAF_LINUX
+    if (m_fd >= 0) {
+      const char c = 0;
+      (void)write(m_stopPipe[1], &c, 1);
+    }
+#endif
+    m_thread.join();
+
+#if LAF_LINUX
+    if (m_fd >= 0) {
+      close(m_fd);
+      close(m_stopPipe[0]);
+      close(m_stopPipe[1]);
+    }
+#endif
+  }
+
+  bool uses_polling() const
+  {
+#if LAF_LINUX
+    return m_fd < 0;
+#else
+    return true;
+#endif
+  }
+
+  bool add_watch(const std::string& dir, const bool recursive)
+  {
+    if (!is_directory(dir))
+      return false;
+
+    const std::lock_guard lock(m_mutex);
+    for (const root& r : m_roots) {
+      if (r.dir == dir)
+        return true;
+    }
+
+#if LAF_LINUX
+    if (m_fd >= 0) {
+      if (!add_inotify_watch_locked(dir, recursive))
+        return false;
+      m_roots.push_back(root{ dir, recursive, {} });
+      return true;
+    }
+#endif
+
+    m_roots.push_back(root{ dir, recursive, scan(dir, recursive) });
+    update_polled_dirs_locked();
+    return true;
+  }
+
+  void remove_watch(const std::string& dir)
+  {
+    const std::lock_guard lock(m_mutex);
+    auto it = std::find_if(m_roots.begin(), m_roots.end(), [&dir](const root& r) {
+      return r.dir == dir;
+    });
+    if (it == m_roots.end())
+      return;
+    m_roots.erase(it);
+
+    for (fs_metadata_cache* cache : m_caches)
+      cache->invalidate(dir);
+
+#if LAF_LINUX
+    if (m_fd >= 0) {
+      remove_inotify_watches_locked(dir);
+      return;
+    }
+#endif
+    update_polled_dirs_locked();
+  }
+
+  bool is_watched(const std::string& path) const
+  {
+    const std::lock_guard lock(m_mutex);
+    return (m_dirs.find(get_file_path(path)) != m_dirs.end());
+  }
+
+  void add_cache(fs_metadata_cache* cache)
+  {
+    const std::lock_guard lock(m_mutex);
+    m_caches.push_back(cache);
+  }
+
+  void remove_cache(fs_metadata_cache* cache)
+  {
+    const std::lock_guard lock(m_mutex);
+    m_caches.erase(std::remove(m_caches.begin(), m_caches.end(), cache), m_caches.end());
+  }
+
+private:
+  struct item {
+    bool directory;
+    uint64_t size;
+    uint64_t timeNs; // Nanoseconds to detect changes in the same second
+
+    bool operator==(const item& o) const
+    {
+      return directory == o.directory && size == o.size && timeNs == o.timeNs;
+    }
+  };
+
+  // Items of a watched directory by path (used in polling mode)
+  using snapshot = std::unordered_map<std::string, item>;
+
+  struct root {
+    std::string dir;
+    bool recursive;
+    snapshot items;
+  };
+
+  // Adds a change to the pending events, and invalidates the caches
+  // right now (so they don't return old data in the meantime).
+  void push_event_locked(const std::string& path, const uint8_t changes)
+  {
+    fs_event ev{ path, changes };
+    for (fs_metadata_cache* cache : m_caches)
+      cache->invalidate(ev);
+
+    if (m_pending.empty())
+      m_firstPendingTime = now_ns();
+
+    auto it = m_pendingIndex.find(path);
+    if (it != m_pendingIndex.end()) {
+      uint8_t& old = m_pending[it->second].changes;
+      old = merge_changes(old, changes);
+    }
+    else {
+      m_pendingIndex[path] = m_pending.size();
+      m_pending.push_back(std::move(ev));
+    }
+  }
+
+  void deliver_events()
+  {
+    fs_events events;
+    {
+      const std::lock_guard lock(m_mutex);
+      std::swap(events, m_pending);
+      m_pendingIndex.clear();
+    }
+    events.erase(std::remove_if(events.begin(),
+                                events.end(),
+                                [](const fs_event& ev) { return ev.changes == 0; }),
+                 events.end());
+    if (!events.empty() && m_callback)
+      m_callback(events);
+  }
+
+  static snapshot scan(const std::string& dir, const bool recursive)
+  {
+    snapshot items;
+    for (const dir_entry& entry : (recursive ? list_dir_recursive(dir) : list_dir(dir))) {
+      items[entry.path()] = item{ entry.is_directory(),
+                                  entry.is_directory() ? 0 : entry.size(),
+                                  entry.modification_time_ns() };
+    }
+    return items;
+  }
+
+  void update_polled_dirs_locked()
+  {
+    m_dirs.clear();
+    for (const root& r : m_roots) {
+      m_dirs.insert(r.dir);
+      if (r.recursive) {
+        for (const auto& kv : r.items) {
+          if (kv.second.directory)
+            m_dirs.insert(kv.first);
+        }
+      }
+    }
+  }
+
+  void polling_thread()
+  {
+    this_thread::set_name("fs_watcher");
+
+    std::unique_lock lock(m_mutex);
+    while (m_running) {
+      m_cv.wait_for(lock, std::chrono::duration<double>(m_pollInterval));
+      if (!m_running)
+        break;
+
+      // Scan the directories without locking the mutex
+      std::vector<std::pair<std::string, bool>> dirs;
+      for (const root& r : m_roots)
+        dirs.emplace_back(r.dir, r.recursive);
+      lock.unlock();
+      std::vector<snapshot> snapshots;
+      for (const auto& dir : dirs)
+        snapshots.push_back(scan(dir.first, dir.second));
+      lock.lock();
+
+      for (size_t i = 0; i < dirs.size(); ++i) {
+        // The root could be removed in the meantime
+        auto it = std::find_if(m_roots.begin(), m_roots.end(), [&dirs, i](const root& r) {
+          return r.dir == dirs[i].first;
+        });
+        if (it == m_roots.end())
+          continue;
+
+        const snapshot& items = snapshots[i];
+        for (const auto& kv : items) {
+          auto old = it->items.find(kv.first);
+          if (old == it->items.end())
+            push_event_locked(kv.first, FS_CREATED);
+          else if (!(old->second == kv.second))
+            push_event_locked(kv.first, FS_MODIFIED);
+        }
+        for (const auto& kv : it->items) {
+          if (items.find(kv.first) == items.end())
+            push_event_locked(kv.first, FS_DELETED);
+        }
+        it->items = std::move(snapshots[i]);
+      }
+      update_polled_dirs_locked();
+
+      lock.unlock();
+      deliver_events();
+      lock.lock();
+    }
+  }
+
+#if LAF_LINUX
+  static constexpr uint32_t kInotifyMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB |
+                                           IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+  struct inotify_dir {
+    std::string dir;
+    bool recursive;
+  };
+
+  bool add_inotify_watch_locked(const std::string& dir, const bool recursive)
+  {
+    const int wd = inotify_add_watch(m_fd, dir.c_str(), kInotifyMask);
+    if (wd < 0)
+      return false;
+
+    m_wds[wd] = inotify_dir{ dir, recursive };
+    m_dirs.insert(dir);
+
+    if (recursive) {
+      for (const dir_entry& subdir : list_dir(dir, ItemType::Directories)) {
+        if (!subdir.is_symlink())
+          add_inotify_watch_locked(subdir.path(), true);
+      }
+    }
+    return true;
+  }
+
+  // Removes the watches of "dir" and its subdirectories.
+  void remove_inotify_watches_locked(const std::string& dir)
+  {
+    for (auto it = m_wds.begin(); it != m_wds.end();) {
+      if (it->second.dir == dir || is_inside(it->second.dir, dir)) {
+        inotify_rm_watch(m_fd, it->first);
+        m_dirs.erase(it->second.dir);
+        it = m_wds.erase(it);
+      }
+      else
+        ++it;
+    }
+  }
+
+  void process_inotify_event(const inotify_event* ev)
+  {
+    const std::lock_guard lock(m_mutex);
+
+    if (ev->mask & IN_Q_OVERFLOW) {
+      for (const root& r : m_roots)
+        push_event_locked(r.dir, FS_RESCAN);
+      return;
+    }
+
+    auto it = m_wds.find(ev->wd);
+    if (it == m_wds.end())
+      return;
+
+    // The directory was deleted or the watch removed
+    if (ev->mask & IN_IGNORED) {
+      m_dirs.erase(it->second.dir);
+      m_wds.erase(it);
+      return;
+    }
+    if (ev->len == 0)
+      return;
+
+    const inotify_dir wdir = it->second;
+    const std::string path = join_path(wdir.dir, ev->name);
+    const bool isDir = (ev->mask & IN_ISDIR);
+
+    if (ev->mask & (IN_CREATE | IN_MOVED_TO)) {
+      push_event_locked(path, FS_CREATED);
+
+      // Watch the new subdirectory, and report its items (they could
+      // be created before we added the watch)
+      if (isDir && wdir.recursive && add_inotify_watch_locked(path, true)) {
+        for (const dir_entry& entry : list_dir_recursive(path))
+          push_event_locked(entry.path(), FS_CREATED);
+      }
+    }
+    else if (ev->mask & (IN_DELETE | IN_MOVED_FROM)) {
+      push_event_locked(path, FS_DELETED);
+      if (isDir)
+        remove_inotify_watches_locked(path);
+    }
+    else if (ev->mask & (IN_MODIFY | IN_ATTRIB)) {
+      push_event_locked(path, FS_MODIFIED);
+    }
+  }
+
+  void inotify_thread()
+  {
+    this_thread::set_name("fs_watcher");
+
+    alignas(inotify_event) char buf[64 * 1024];
+    while (true) {
+      // Wait for new events, or until the pending events must be
+      // delivered.
+      int timeout = -1;
+      {
+        const std::lock_guard lock(m_mutex);
+        if (!m_running)
+          break;
+        if (!m_pending.empty()) {
+          const uint64_t elapsed = now_ns() - m_firstPendingTime;
+          timeout = (elapsed >= m_latencyNs ? 0 : int((m_latencyNs - elapsed) / 1000000 + 1));
+        }
+      }
+
+      pollfd fds[2] = { { m_fd, POLLIN, 0 }, { m_stopPipe[0], POLLIN, 0 } };
+      if (poll(fds, 2, timeout) < 0 && errno != EINTR)
+        break;
+      if (fds[1].revents)
+        break;
+
+      if (fds[0].revents & POLLIN) {
+        ssize_t len;
+        while ((len = read(m_fd, buf, sizeof(buf))) > 0) {
+          for (const char* p = buf; p < buf + len;) {
+            auto ev = reinterpret_cast<const inotify_event*>(p);
+            process_inotify_event(ev);
+            p += sizeof(inotify_event) + ev->len;
+          }
+        }
+      }
+
+      bool deliver;
+      {
+        const std::lock_guard lock(m_mutex);
+        deliver = (!m_pending.empty() && now_ns() - m_firstPendingTime >= m_latencyNs);
+      }
+      if (deliver)
+        deliver_events();
+    }
+  }
+
+  int m_fd = -1;
+  int m_stopPipe[2] = { -1, -1 };
+  std::unordered_map<int, inotify_dir> m_wds;
+#endif
+
+  callback_t m_callback;
+  const uint64_t m_latencyNs;
+  const double m_pollInterval;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_running = true;
+  std::vector<root> m_roots;
+  // All watched directories (including subdirectories of recursive
+  // watches)
+  std::unordered_set<std::string> m_dirs;
+  std::vector<fs_metadata_cache*> m_caches;
+
+  // Coalesced events to be delivered
+  fs_events m_pending;
+  std::unordered_map<std::string, size_t> m_pendingIndex;
+  uint64_t m_firstPendingTime = 0;
+
+  std::thread m_thread;
+};
+
+fs_watcher::fs_watcher(callback_t callback,
+                       const double latency,
+                       const double pollInterval,
+                       const bool usePolling)
+  : m_impl(std::make_unique<impl>(std::move(callback), latency, pollInterval, usePolling))
+{
+}
+
+fs_watcher::~fs_watcher() = default;
+
+bool fs_watcher::add_watch(const std::string& dir, const bool recursive)
+{
+  return m_impl->add_watch(dir, recursive);
+}
+
+void fs_watcher::remove_watch(const std::string& dir)
+{
+  m_impl->remove_watch(dir);
+}
+
+bool fs_watcher::is_watched(const std::string& path) const
+{
+  return m_impl->is_watched(path);
+}
+
+bool fs_watcher::uses_polling() const
+{
+  return m_impl->uses_polling();
+}
+
+void fs_watcher::add_cache(fs_metadata_cache* cache)
+{
+  m_impl->add_cache(cache);
+}
+
+void fs_watcher::remove_cache(fs_metadata_cache* cache)
+{
+  m_impl->remove_cache(cache);
+}
+
+fs_metadata_cache::fs_metadata_cache(fs_watcher& watcher) : m_watcher(watcher)
+{
+  m_watcher.add_cache(this);
+}
+
+fs_metadata_cache::~fs_metadata_cache()
+{
+  m_watcher.remove_cache(this);
+}
+
+fs_metadata fs_metadata_cache::get(const std::string& path)
+{
+  uint64_t generation;
+  {
+    const std::lock_guard lock(m_mutex);
+    auto it = m_entries.find(path);
+    if (it != m_entries.end()) {
+      ++m_hits;
+      return it->second;
+    }
+    generation = m_generation;
+  }
+
+  const bool watched = m_watcher.is_watched(path);
+  if (watched) {
+    const std::lock_guard lock(m_mutex);
+    ++m_misses;
+  }
+
+  fs_metadata md;
+  md.directory = base::is_directory(path);
+  md.exists = (md.directory || base::is_file(path));
+  if (md.exists && !md.directory)
+    md.size = base::file_size(path);
+  if (md.exists)
+    md.modification_time = get_modification_time(path);
+
+  if (watched) {
+    const std::lock_guard lock(m_mutex);
+    if (generation == m_generation)
+      m_entries[path] = md;
+  }
+  return md;
+}
+
+bool fs_metadata_cache::is_file(const std::string& path)
+{
+  const fs_metadata md = get(path);
+  return md.exists && !md.directory;
+}
+
+bool fs_metadata_cache::is_directory(const std::string& path)
+{
+  return get(path).directory;
+}
+
+uint64_t fs_metadata_cache::file_size(const std::string& path)
+{
+  return get(path).size;
+}
+
+Time fs_metadata_cache::modification_time(const std::string& path)
+{
+  return get(path).modification_time;
+}
+
+void fs_metadata_cache::invalidate(const std::string& path)
+{
+  const std::lock_guard lock(m_mutex);
+  invalidate_locked(path);
+}
+
+void fs_metadata_cache::invalidate(const fs_event& event)
+{
+  const std::lock_guard lock(m_mutex);
+  if (event.changes == FS_MODIFIED) {
+    // Items inside a modified directory are not affected
+    ++m_generation;
+    m_entries.erase(event.path);
+  }
+  else
+    invalidate_locked(event.path);
+
+  // The modification time of the parent directory changes too
+  if (event.changes & (FS_CREATED | FS_DELETED))
+    m_entries.erase(get_file_path(event.path));
+}
+
+void fs_metadata_cache::clear()
+{
+  const std::lock_guard lock(m_mutex);
+  m_entries.clear();
+  ++m_generation;
+}
+
+void fs_metadata_cache::invalidate_locked(const std::string& path)
+{
+  ++m_generation;
+
+  auto it = m_entries.find(path);
+  if (it != m_entries.end()) {
+    const bool directory = it->second.directory;
+    m_entries.erase(it);
+    if (!directory)
+      return;
+  }
+
+  // Items inside the path (if it's, or it was, a directory)
+  for (auto it = m_entries.begin(); it != m_entries.end();) {
+    if (is_inside(it->first, path))
+      it = m_entries.erase(it);
+    else
+      ++it;
+  }
+}
+
+} // namespace base
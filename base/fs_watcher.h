@@ -0,0 +1,159 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_FS_WATCHER_H_INCLUDED
+#define BASE_FS_WATCHER_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "base/time.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace base {
+
+class fs_metadata_cache;
+
+// Changes of a file (flags).
+enum fs_change : uint8_t {
+  FS_CREATED = 1,
+  FS_MODIFIED = 2,
+  FS_DELETED = 4,
+  // Some events were lost (e.g. the kernel queue overflowed), all
+  // files in "path" (a watched directory) must be read again.
+  FS_RESCAN = 8,
+};
+
+struct fs_event {
+  std::string path;
+  uint8_t changes; // fs_change flags
+};
+
+using fs_events = std::vector<fs_event>;
+
+// Watches directories for changes. On Linux it uses inotify, on
+// other platforms (or if inotify cannot be used) it compares
+// snapshots of the directories periodically.
+//
+// Events are coalesced: all events received in "latency" seconds are
+// delivered together to the callback (from a background thread), and
+// several changes to the same file are merged in one event (e.g.
+// FS_CREATED + FS_MODIFIED is just FS_CREATED, and FS_CREATED +
+// FS_DELETED is removed).
+//
+//   base::fs_watcher watcher([](const base::fs_events& events) {
+//     for (const auto& ev : events)
+//       ...
+//   });
+//   watcher.add_watch("assets", true);
+//
+class fs_watcher {
+public:
+  using callback_t = std::function<void(const fs_events&)>;
+
+  // If "usePolling" is true, directories are scanned each
+  // "pollInterval" seconds even when the system notifications are
+  // available (e.g. for network file systems, where inotify doesn't
+  // report changes made by other machines).
+  explicit fs_watcher(callback_t callback,
+                      double latency = 0.1,
+                      double pollInterval = 1.0,
+                      bool usePolling = false);
+  ~fs_watcher();
+
+  fs_watcher(const fs_watcher&) = delete;
+  fs_watcher& operator=(const fs_watcher&) = delete;
+
+  // Starts watching the items inside the given directory (and all its
+  // subdirectories if "recursive" is true). Returns false if the
+  // directory cannot be watched.
+  bool add_watch(const std::string& dir, bool recursive = false);
+  void remove_watch(const std::string& dir);
+
+  // Returns true if changes to this file are reported (i.e. it's
+  // inside a watched directory).
+  bool is_watched(const std::string& path) const;
+
+  // Returns true if the directories are scanned periodically instead
+  // of using system notifications.
+  bool uses_polling() const;
+
+private:
+  friend class fs_metadata_cache;
+  class impl;
+
+  void add_cache(fs_metadata_cache* cache);
+  void remove_cache(fs_metadata_cache* cache);
+
+  std::unique_ptr<impl> m_impl;
+};
+
+struct fs_metadata {
+  bool exists = false;
+  bool directory = false;
+  uint64_t size = 0;
+  Time modification_time;
+};
+
+// Caches is_file()/is_directory()/file_size()/get_modification_time()
+// results of files inside the directories watched by a fs_watcher.
+// Entries are invalidated as soon as the watcher receives an event
+// for them (before the coalesced events are delivered), so repeated
+// calls for unchanged files don't touch the file system. Files
+// outside the watched directories are not cached.
+//
+// Paths must use the same format as the ones given to
+// fs_watcher::add_watch() (e.g. both relative or both absolute).
+class fs_metadata_cache {
+public:
+  explicit fs_metadata_cache(fs_watcher& watcher);
+  ~fs_metadata_cache();
+
+  fs_metadata_cache(const fs_metadata_cache&) = delete;
+  fs_metadata_cache& operator=(const fs_metadata_cache&) = delete;
+
+  fs_metadata get(const std::string& path);
+
+  bool is_file(const std::string& path);
+  bool is_directory(const std::string& path);
+  uint64_t file_size(const std::string& path);
+  Time modification_time(const std::string& path);
+
+  // Removes the cached metadata of "path" (and the items inside it if
+  // it's a directory).
+  void invalidate(const std::string& path);
+
+  // Removes the cached metadata affected by the given event (called
+  // by the watcher).
+  void invalidate(const fs_event& event);
+
+  void clear();
+
+  // Statistics
+  size_t hits() const { return m_hits; }
+  size_t misses() const { return m_misses; }
+
+private:
+  void invalidate_locked(const std::string& path);
+
+  fs_watcher& m_watcher;
+  std::mutex m_mutex;
+  std::unordered_map<std::string, fs_metadata> m_entries;
+  // Incremented in each invalidation, so a result read from the file
+  // system is not cached if it was invalidated in the meantime.
+  uint64_t m_generation = 0;
+  size_t m_hits = 0;
+  size_t m_misses = 0;
+};
+
+} // namespace base
+
+#endif
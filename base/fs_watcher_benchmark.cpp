@@ -0,0 +1,91 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/fs_watcher.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace base;
+
+static void write_text(const std::string& fn, const char* text)
+{
+  write_file_content(fn, (const uint8_t*)text, std::strlen(text));
+}
+
+static void delete_tree(const std::string& path)
+{
+  const dir_entries entries = list_dir_recursive(path);
+  for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+    if (it->is_directory())
+      remove_directory(it->path());
+    else
+      delete_file(it->path());
+  }
+  remove_directory(path);
+}
+
+TEST(FSWatcher, Benchmark)
+{
+  const std::string dir = "_test_watch_bench_";
+  const int n = 1000;
+  make_directory(dir);
+  std::vector<std::string> files;
+  for (int i = 0; i < n; ++i) {
+    files.push_back(join_path(dir, std::to_string(i) + ".png"));
+    write_text(files.back(), "x");
+  }
+
+  fs_watcher watcher(nullptr);
+  fs_metadata_cache cache(watcher);
+  watcher.add_watch(dir);
+
+  // First refresh to fill the cache
+  for (const std::string& fn : files)
+    cache.get(fn);
+
+  const int refreshes = 20;
+  uint64_t total1 = 0, total2 = 0;
+  Chrono chrono;
+  for (int r = 0; r < refreshes; ++r) {
+    for (const std::string& fn : files) {
+      if (is_file(fn)) {
+        total1 += file_size(fn);
+        get_modification_time(fn);
+      }
+    }
+  }
+  const double t1 = chrono.elapsed();
+
+  chrono.reset();
+  for (int r = 0; r < refreshes; ++r) {
+    for (const std::string& fn : files) {
+      const fs_metadata md = cache.get(fn);
+      if (md.exists && !md.directory)
+        total2 += md.size;
+    }
+  }
+  const double t2 = chrono.elapsed();
+  EXPECT_EQ(total1, total2);
+
+  delete_tree(dir);
+
+  std::printf("stat() calls       %.2f ms/refresh\n", t1 * 1000.0 / refreshes);
+  std::printf("fs_metadata_cache  %.2f ms/refresh\n", t2 * 1000.0 / refreshes);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,237 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/fs_watcher.h"
+#include "base/thread.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+using namespace base;
+
+// Collects the events received from a watcher.
+class event_log {
+public:
+  fs_watcher::callback_t callback()
+  {
+    return [this](const fs_events& events) {
+      const std::lock_guard lock(m_mutex);
+      ++m_batches;
+      for (const fs_event& ev : events)
+        m_changes[ev.path] |= ev.changes;
+      m_cv.notify_all();
+    };
+  }
+
+  // Waits until "path" has the given changes (returns false after 5
+  // seconds).
+  bool wait(const std::string& path, const uint8_t changes)
+  {
+    std::unique_lock lock(m_mutex);
+    return m_cv.wait_for(lock, std::chrono::seconds(5), [&] {
+      auto it = m_changes.find(path);
+      return it != m_changes.end() && (it->second & changes) == changes;
+    });
+  }
+
+  uint8_t changes(const std::string& path)
+  {
+    const std::lock_guard lock(m_mutex);
+    auto it = m_changes.find(path);
+    return (it != m_changes.end() ? it->second : 0);
+  }
+
+  int batches()
+  {
+    const std::lock_guard lock(m_mutex);
+    return m_batches;
+  }
+
+  void clear()
+  {
+    const std::lock_guard lock(m_mutex);
+    m_changes.clear();
+    m_batches = 0;
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::map<std::string, uint8_t> m_changes;
+  int m_batches = 0;
+};
+
+static void write_text(const std::string& fn, const char* text)
+{
+  write_file_content(fn, (const uint8_t*)text, std::strlen(text));
+}
+
+static void delete_tree(const std::string& path)
+{
+  const dir_entries entries = list_dir_recursive(path);
+  for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+    if (it->is_directory())
+      remove_directory(it->path());
+    else
+      delete_file(it->path());
+  }
+  remove_directory(path);
+}
+
+static void test_watcher(const bool usePolling)
+{
+  const std::string dir = "_test_watch_";
+  const std::string a = join_path(dir, "a.txt");
+  const std::string b = join_path(dir, "b.txt");
+  const std::string sub = join_path(dir, "sub");
+  const std::string c = join_path(sub, "c.txt");
+
+  make_directory(dir);
+  write_text(b, "b");
+
+  event_log log;
+  {
+    fs_watcher watcher(log.callback(), 0.05, 0.05, usePolling);
+    EXPECT_EQ(usePolling, watcher.uses_polling());
+    EXPECT_FALSE(watcher.add_watch("non-existent-folder"));
+    ASSERT_TRUE(watcher.add_watch(dir, true));
+    EXPECT_TRUE(watcher.is_watched(a));
+    EXPECT_FALSE(watcher.is_watched("other.txt"));
+
+    // Created + modified = created
+    write_text(a, "a");
+    write_text(a, "aa");
+    EXPECT_TRUE(log.wait(a, FS_CREATED));
+    EXPECT_EQ(FS_CREATED, log.changes(a));
+
+    // Polling mode compares sizes and modification times
+    write_text(b, "bb");
+    EXPECT_TRUE(log.wait(b, FS_MODIFIED));
+
+    // Same size in the same second (polling mode compares nanoseconds)
+    log.clear();
+    write_text(b, "cc");
+    EXPECT_TRUE(log.wait(b, FS_MODIFIED));
+
+    // New subdirectories are watched too
+    make_directory(sub);
+    EXPECT_TRUE(log.wait(sub, FS_CREATED));
+    write_text(c, "c");
+    EXPECT_TRUE(log.wait(c, FS_CREATED));
+    EXPECT_TRUE(watcher.is_watched(c));
+
+    log.clear();
+    delete_file(a);
+    EXPECT_TRUE(log.wait(a, FS_DELETED));
+
+    // Created + deleted in the same batch = nothing
+    log.clear();
+    const std::string tmp = join_path(dir, "tmp.txt");
+    write_text(tmp, "tmp");
+    delete_file(tmp);
+    write_text(b, "bbb");
+    EXPECT_TRUE(log.wait(b, FS_MODIFIED));
+    EXPECT_EQ(0, log.changes(tmp));
+
+    watcher.remove_watch(dir);
+    EXPECT_FALSE(watcher.is_watched(b));
+  }
+
+  delete_tree(dir);
+}
+
+TEST(FSWatcher, Native)
+{
+#if LAF_LINUX
+  test_watcher(false);
+#endif
+}
+
+TEST(FSWatcher, Polling)
+{
+  test_watcher(true);
+}
+
+TEST(FSWatcher, Coalesce)
+{
+#if LAF_LINUX
+  const std::string dir = "_test_watch_";
+  make_directory(dir);
+
+  event_log log;
+  fs_watcher watcher(log.callback(), 0.2);
+  ASSERT_TRUE(watcher.add_watch(dir));
+
+  // Hundreds of inotify events in one or two batches
+  const std::string fn = join_path(dir, "a.txt");
+  for (int i = 0; i < 100; ++i)
+    write_text(fn, "abc");
+  EXPECT_TRUE(log.wait(fn, FS_CREATED));
+  EXPECT_LE(log.batches(), 2);
+
+  delete_tree(dir);
+#endif
+}
+
+TEST(FSWatcher, MetadataCache)
+{
+  const std::string dir = "_test_watch_";
+  const std::string a = join_path(dir, "a.txt");
+  make_directory(dir);
+  write_text(a, "abc");
+
+  event_log log;
+  fs_watcher watcher(log.callback(), 0.05, 0.05);
+  fs_metadata_cache cache(watcher);
+  ASSERT_TRUE(watcher.add_watch(dir));
+
+  EXPECT_TRUE(cache.is_file(a));
+  EXPECT_EQ(uint64_t(3), cache.file_size(a));
+  EXPECT_EQ(get_modification_time(a), cache.modification_time(a));
+  EXPECT_FALSE(cache.is_directory(a));
+  EXPECT_EQ(size_t(1), cache.misses());
+  EXPECT_EQ(size_t(3), cache.hits());
+
+  // Not existent files are cached too
+  const std::string b = join_path(dir, "b.txt");
+  EXPECT_FALSE(cache.get(b).exists);
+  EXPECT_FALSE(cache.is_file(b));
+  EXPECT_EQ(size_t(2), cache.misses());
+
+  // Files outside watched directories are not cached
+  EXPECT_FALSE(cache.is_file("non-existent.txt"));
+  EXPECT_FALSE(cache.is_file("non-existent.txt"));
+  EXPECT_EQ(size_t(2), cache.misses());
+  EXPECT_EQ(size_t(4), cache.hits());
+
+  // Changes invalidate the cache
+  write_text(a, "abcdef");
+  write_text(b, "b");
+  EXPECT_TRUE(log.wait(a, FS_MODIFIED));
+  EXPECT_TRUE(log.wait(b, FS_CREATED));
+  EXPECT_EQ(uint64_t(6), cache.file_size(a));
+  EXPECT_TRUE(cache.is_file(b));
+
+  delete_file(a);
+  EXPECT_TRUE(log.wait(a, FS_DELETED));
+  EXPECT_FALSE(cache.get(a).exists);
+
+  cache.invalidate(dir);
+  cache.clear();
+  delete_tree(dir);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
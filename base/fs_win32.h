@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2020-2025 Igara Studio S.A.
+// Copyright (c) 2020-2026 Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -8,11 +8,13 @@
 #include "base/fs.h"
 #include "base/paths.h"
 #include "base/string.h"
+#include "base/task.h"
 #include "base/time.h"
 #include "base/version.h"
 #include "base/win/win32_exception.h"
 
 #include <shlobj.h>
+#include <shlwapi.h>
 #include <stdexcept>
 #include <sys/stat.h>
 #include <windows.h>
@@ -56,6 +58,49 @@ void copy_file(const std::string& src, const std::string& dst, bool overwrite)
     throw Win32Exception("Error copying file");
 }
 
+static DWORD CALLBACK copy_file_progress(LARGE_INTEGER totalSize,
+                                         LARGE_INTEGER transferred,
+                                         LARGE_INTEGER,
+                                         LARGE_INTEGER,
+                                         DWORD,
+                                         DWORD,
+                                         HANDLE,
+                                         HANDLE,
+                                         LPVOID data)
+{
+  auto token = static_cast<task_token*>(data);
+  if (token->canceled())
+    return PROGRESS_CANCEL;
+  if (totalSize.QuadPart > 0)
+    token->set_progress(float(double(transferred.QuadPart) / double(totalSize.QuadPart)));
+  return PROGRESS_CONTINUE;
+}
+
+bool copy_file(const std::string& src,
+               const std::string& dst,
+               bool overwrite,
+               task_token* token,
+               CopyFileMethod)
+{
+  // CopyFileEx() already uses the fastest method (e.g. block cloning
+  // in ReFS), so the method is ignored.
+  BOOL cancel = FALSE;
+  BOOL result = ::CopyFileEx(from_utf8(src).c_str(),
+                             from_utf8(dst).c_str(),
+                             token ? copy_file_progress : nullptr,
+                             token,
+                             &cancel,
+                             overwrite ? 0 : COPY_FILE_FAIL_IF_EXISTS);
+  if (result == 0) {
+    if (GetLastError() == ERROR_REQUEST_ABORTED)
+      return false;
+    throw Win32Exception("Error copying file");
+  }
+  if (token)
+    token->set_progress(1.0f);
+  return true;
+}
+
 void delete_file(const std::string& path)
 {
   BOOL result = ::DeleteFile(from_utf8(path).c_str());
@@ -204,6 +249,80 @@ paths list_files(const std::string& path, ItemType filter, const std::string& ma
   return files;
 }
 
+dir_entries list_dir(const std::string& path, ItemType filter, const std::string& match)
+{
+  dir_entries entries;
+  WIN32_FIND_DATA fd;
+  HANDLE handle = FindFirstFileEx(
+    base::from_utf8(base::join_path(path, match)).c_str(),
+    FindExInfoBasic,
+    &fd,
+    (filter == ItemType::Directories) ? FindExSearchLimitToDirectories : FindExSearchNameMatch,
+    NULL,
+    FIND_FIRST_EX_LARGE_FETCH);
+
+  if (handle == INVALID_HANDLE_VALUE)
+    return entries;
+
+  // FindFirstFileEx() already gives us the size and the modification
+  // time, so load_dir_stats() doesn't need to do anything.
+  auto listing = std::make_shared<details::dir_listing>();
+  listing->path = path;
+
+  do {
+    uint8_t flags = 0;
+    if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+      if (filter == ItemType::Files)
+        continue;
+
+      if (lstrcmpW(fd.cFileName, L".") == 0 || lstrcmpW(fd.cFileName, L"..") == 0)
+        continue;
+
+      flags = details::dir_listing::kDirectory;
+    }
+    else if (filter == ItemType::Directories)
+      continue;
+
+    if (fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
+      flags |= details::dir_listing::kSymlink;
+
+    SYSTEMTIME utc, local;
+    FileTimeToSystemTime(&fd.ftLastWriteTime, &utc);
+    SystemTimeToTzSpecificLocalTime(NULL, &utc, &local);
+
+    listing->names.push_back(base::to_utf8(fd.cFileName));
+    listing->flags.push_back(flags);
+    listing->sizes.push_back((uint64_t(fd.nFileSizeHigh) << 32) | fd.nFileSizeLow);
+    listing->times.push_back(
+      Time(local.wYear, local.wMonth, local.wDay, local.wHour, local.wMinute, local.wSecond));
+
+    // FILETIME has 100ns intervals since 1601-01-01
+    constexpr uint64_t kUnixEpoch = 116444736000000000ull;
+    const uint64_t ft = (uint64_t(fd.ftLastWriteTime.dwHighDateTime) << 32) |
+                        fd.ftLastWriteTime.dwLowDateTime;
+    listing->timesNs.push_back(ft > kUnixEpoch ? (ft - kUnixEpoch) * 100 : 0);
+  } while (FindNextFile(handle, &fd));
+
+  FindClose(handle);
+
+  const size_t n = listing->names.size();
+  entries.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+    entries.emplace_back(listing, i);
+  return entries;
+}
+
+void details::load_dir_stats(dir_listing&)
+{
+  // Sizes and times are filled in list_dir()
+}
+
+bool details::match_dir_item(const std::string& name, const std::string& match)
+{
+  return (match == "*" ||
+          PathMatchSpecW(base::from_utf8(name).c_str(), base::from_utf8(match).c_str()));
+}
+
 Version get_file_version(const std::string& filename)
 {
   return get_file_version(from_utf8(filename).c_str());
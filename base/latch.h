@@ -0,0 +1,63 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_LATCH_H_INCLUDED
+#define BASE_LATCH_H_INCLUDED
+#pragma once
+
+#include "base/debug.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace base {
+
+// Single-use barrier (similar to C++20 std::latch): threads can wait
+// until a counter reaches zero. Useful to wait a specific group of
+// works of a thread_pool instead of using thread_pool::wait_all().
+class latch {
+public:
+  explicit latch(const ptrdiff_t count) : m_count(count) { ASSERT(count >= 0); }
+  latch(const latch&) = delete;
+  latch& operator=(const latch&) = delete;
+
+  void count_down(const ptrdiff_t n = 1)
+  {
+    const ptrdiff_t old = m_count.fetch_sub(n, std::memory_order_acq_rel);
+    ASSERT(old >= n);
+    if (old == n) {
+      const std::lock_guard lock(m_mutex);
+      m_cv.notify_all();
+    }
+  }
+
+  bool try_wait() const { return m_count.load(std::memory_order_acquire) == 0; }
+
+  void wait() const
+  {
+    if (try_wait())
+      return;
+    std::unique_lock lock(m_mutex);
+    m_cv.wait(lock, [this] { return try_wait(); });
+  }
+
+  void arrive_and_wait(const ptrdiff_t n = 1)
+  {
+    count_down(n);
+    wait();
+  }
+
+private:
+  std::atomic<ptrdiff_t> m_count;
+  mutable std::mutex m_mutex;
+  mutable std::condition_variable m_cv;
+};
+
+} // namespace base
+
+#endif
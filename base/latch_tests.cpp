@@ -0,0 +1,51 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/latch.h"
+#include "base/thread_pool.h"
+
+#include <atomic>
+
+using namespace base;
+
+TEST(Latch, Basic)
+{
+  latch l(2);
+  EXPECT_FALSE(l.try_wait());
+  l.count_down();
+  EXPECT_FALSE(l.try_wait());
+  l.count_down();
+  EXPECT_TRUE(l.try_wait());
+  l.wait();
+
+  latch zero(0);
+  EXPECT_TRUE(zero.try_wait());
+}
+
+TEST(Latch, WaitBatchOfWorks)
+{
+  thread_pool pool(4);
+  std::atomic<int> c(0);
+  for (int k = 0; k < 10; ++k) {
+    latch done(100);
+    for (int i = 0; i < 100; ++i) {
+      pool.execute([&] {
+        ++c;
+        done.count_down();
+      });
+    }
+    done.wait();
+    EXPECT_EQ(100 * (k + 1), c);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -10,22 +10,49 @@
 #endif
 
 #include "base/log.h"
+#include "base/log_record.h"
 
 #include "base/debug.h"
 #include "base/fstream_path.h"
+#include "base/string.h"
+#include "base/thread.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#if LAF_WINDOWS
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+
+#ifndef O_BINARY
+  #define O_BINARY 0
+#endif
+
 namespace {
 
+using base::LogOverflow;
+
 // Default log level is error, which means that we'll log regular
 // errors and fatal errors.
 std::atomic<LogLevel> log_level(LogLevel::ERROR);
@@ -34,10 +61,557 @@ std::ofstream log_stream;
 std::ostream* log_ostream = &std::cerr;
 std::string log_filename;
 
+// File descriptor used by flush_log_on_crash() to write in the log
+// file (or stderr). It's opened in advance because we cannot open
+// files (or allocate memory) from a signal handler.
+std::atomic<int> crash_fd(2);
+
+// Writes the text in the log stream (log_mutex must be locked).
+void write_log_locked(const char* buf, const size_t size)
+{
+  ASSERT(log_ostream);
+  log_ostream->write(buf, size);
+  log_ostream->flush();
+}
+
+// Opens (and truncates) the log file for flush_log_on_crash()
+// (log_mutex must be locked). Returns false if the file cannot be
+// opened.
+bool open_crash_fd_locked()
+{
+  const int old = crash_fd.exchange(2);
+  if (old > 2) {
+#if LAF_WINDOWS
+    _close(old);
+#else
+    close(old);
+#endif
+  }
+  if (log_filename.empty())
+    return true;
+
+#if LAF_WINDOWS
+  const int fd = _wopen(base::from_utf8(log_filename).c_str(),
+                        _O_WRONLY | _O_CREAT | _O_TRUNC | _O_APPEND | O_BINARY,
+                        _S_IREAD | _S_IWRITE);
+#else
+  const int fd = open(log_filename.c_str(),
+                      O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC,
+                      S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH);
+#endif
+  if (fd < 0)
+    return false;
+  crash_fd.store(fd);
+  return true;
+}
+
+// Writes from a crash handler using only async-signal-safe functions
+// (write(2)) and a static buffer.
+class crash_writer {
+public:
+  explicit crash_writer(const int fd) : m_fd(fd) {}
+  ~crash_writer() { flush(); }
+
+  void write(const char* data, size_t size)
+  {
+    if (m_used + size > sizeof(m_buffer)) {
+      flush();
+      if (size > sizeof(m_buffer)) {
+        write_fd(data, size);
+        return;
+      }
+    }
+    std::memcpy(m_buffer + m_used, data, size);
+    m_used += size;
+  }
+
+  void flush()
+  {
+    write_fd(m_buffer, m_used);
+    m_used = 0;
+  }
+
+private:
+  void write_fd(const char* data, size_t size)
+  {
+    while (size > 0) {
+#if LAF_WINDOWS
+      const int n = _write(m_fd, data, unsigned(std::min<size_t>(size, 0x7fffffff)));
+#else
+      const ssize_t n = ::write(m_fd, data, size);
+#endif
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return;
+      data += n;
+      size -= size_t(n);
+    }
+  }
+
+  // Only used by one thread at the same time (the one that locks
+  // m_drainMutex in async_logger::crash_flush())
+  static char m_buffer[4096];
+  const int m_fd;
+  size_t m_used = 0;
+};
+
+char crash_writer::m_buffer[4096];
+
+// Each message in a ring starts with a 32-bit header with its size,
+// the high bit indicates a binary record (see write_log_record()).
+constexpr uint32_t kRecordHeaderSize = 4;
+constexpr uint32_t kBinaryRecord = 0x80000000;
+
+// Converts a binary record to text.
+void decode_record(const uint8_t* record, const size_t size, std::string& out)
+{
+  base::log_record_decoder decoder;
+  ASSERT(size >= sizeof(decoder));
+  std::memcpy(&decoder, record, sizeof(decoder));
+  decoder(record + sizeof(decoder), size - sizeof(decoder), out);
+}
+
+// Converts the messages read from rings to text.
+void decode_messages(const std::string& raw, std::string& out)
+{
+  auto p = reinterpret_cast<const uint8_t*>(raw.data());
+  const uint8_t* end = p + raw.size();
+  while (p < end) {
+    uint32_t header;
+    std::memcpy(&header, p, kRecordHeaderSize);
+    p += kRecordHeaderSize;
+
+    const uint32_t size = (header & ~kBinaryRecord);
+    if (header & kBinaryRecord)
+      decode_record(p, size, out);
+    else
+      out.append(reinterpret_cast<const char*>(p), size);
+    p += size;
+  }
+}
+
+// Single-producer/single-consumer ring buffer of bytes. The owner
+// thread appends whole messages, and the background thread reads all
+// the available bytes at once.
+class log_ring {
+public:
+  explicit log_ring(const size_t capacity) : m_mask(capacity - 1), m_data(new char[capacity]) {}
+
+  size_t capacity() const { return m_mask + 1; }
+
+  size_t used() const
+  {
+    return m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_acquire);
+  }
+
+  bool try_write(const uint32_t header, const void* msg, const size_t size)
+  {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    const size_t tail = m_tail.load(std::memory_order_acquire);
+    if (capacity() - (head - tail) < kRecordHeaderSize + size)
+      return false;
+
+    copy_in(head, &header, kRecordHeaderSize);
+    copy_in(head + kRecordHeaderSize, msg, size);
+    m_head.store(head + kRecordHeaderSize + size, std::memory_order_release);
+    return true;
+  }
+
+  // Appends all the available bytes to "out".
+  void read(std::string& out)
+  {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    const size_t head = m_head.load(std::memory_order_acquire);
+    if (head == tail)
+      return;
+
+    const size_t i = (tail & m_mask);
+    const size_t size = head - tail;
+    const size_t n = std::min(size, capacity() - i);
+    out.append(&m_data[i], n);
+    out.append(&m_data[0], size - n);
+    m_tail.store(head, std::memory_order_release);
+  }
+
+  // Writes the available messages without allocating memory (to be
+  // used from a signal handler). Binary records are not decoded.
+  void read(crash_writer& out)
+  {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    const size_t head = m_head.load(std::memory_order_acquire);
+    while (tail != head) {
+      uint32_t header;
+      copy_out(tail, &header, kRecordHeaderSize);
+      tail += kRecordHeaderSize;
+
+      const uint32_t size = (header & ~kBinaryRecord);
+      if (header & kBinaryRecord) {
+        static constexpr char kNote[] = "[binary log record]\n";
+        out.write(kNote, sizeof(kNote) - 1);
+      }
+      else {
+        const size_t i = (tail & m_mask);
+        const size_t n = std::min<size_t>(size, capacity() - i);
+        out.write(&m_data[i], n);
+        out.write(&m_data[0], size - n);
+      }
+      tail += size;
+    }
+    m_tail.store(head, std::memory_order_release);
+  }
+
+  std::atomic<bool> writing = false; // The owner thread is writing a message
+  std::atomic<bool> orphan = false;  // The owner thread has finished
+
+private:
+  void copy_in(const size_t pos, const void* src, const size_t size)
+  {
+    const size_t i = (pos & m_mask);
+    const size_t n = std::min(size, capacity() - i);
+    std::memcpy(&m_data[i], src, n);
+    std::memcpy(&m_data[0], static_cast<const uint8_t*>(src) + n, size - n);
+  }
+
+  void copy_out(const size_t pos, void* dst, const size_t size) const
+  {
+    const size_t i = (pos & m_mask);
+    const size_t n = std::min(size, capacity() - i);
+    std::memcpy(dst, &m_data[i], n);
+    std::memcpy(static_cast<uint8_t*>(dst) + n, &m_data[0], size - n);
+  }
+
+  const size_t m_mask;
+  std::unique_ptr<char[]> m_data;
+  alignas(64) std::atomic<size_t> m_head = 0;
+  alignas(64) std::atomic<size_t> m_tail = 0;
+};
+
+class async_logger {
+public:
+  ~async_logger() { stop(); }
+
+  bool running() const { return m_running.load(); }
+  size_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+  void start(const size_t bufferSize, const LogOverflow overflow)
+  {
+    stop();
+
+    size_t capacity = 256;
+    while (capacity < bufferSize)
+      capacity <<= 1;
+    m_bufferSize.store(capacity, std::memory_order_relaxed);
+    m_overflow.store(overflow, std::memory_order_relaxed);
+    m_stopping = false;
+    m_running.store(true);
+    m_thread = std::thread([this] { flusher(); });
+  }
+
+  void stop()
+  {
+    if (!m_running.exchange(false))
+      return;
+
+    // Wait the threads that are writing a message right now (new
+    // messages will be written synchronously). m_ringsMutex cannot be
+    // locked while we wait, as a writer could be waiting drain().
+    std::vector<std::shared_ptr<log_ring>> rings;
+    {
+      const std::lock_guard lock(m_ringsMutex);
+      rings = m_rings;
+    }
+    for (const auto& ring : rings) {
+      while (ring->writing.load())
+        std::this_thread::yield();
+    }
+
+    // The background thread writes all pending messages before
+    // finishing.
+    {
+      const std::lock_guard lock(m_mutex);
+      m_stopping = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+  }
+
+  void flush()
+  {
+    if (!m_running.load())
+      return;
+
+    std::unique_lock lock(m_mutex);
+    const uint64_t request = ++m_flushRequest;
+    m_cv.notify_one();
+    m_cvFlushed.wait(lock, [this, request] { return m_flushDone >= request; });
+  }
+
+  // This can be called from a signal handler, so it cannot allocate
+  // memory or use the log stream. The raw messages are written
+  // directly to the file descriptor of the log file.
+  void crash_flush()
+  {
+    // Don't wait anything, if the crash happened when some thread had
+    // one of these mutexes locked, we cannot continue.
+    if (!m_drainMutex.try_lock())
+      return;
+    const std::lock_guard drainLock(m_drainMutex, std::adopt_lock);
+    if (!m_ringsMutex.try_lock())
+      return;
+    const std::lock_guard lock(m_ringsMutex, std::adopt_lock);
+    crash_writer out(crash_fd.load());
+    for (const auto& ring : m_rings)
+      ring->read(out);
+  }
+
+  // Returns false if the message must be written synchronously.
+  bool write(const void* msg, const size_t size, const uint32_t header)
+  {
+    if (!m_running.load(std::memory_order_acquire)) {
+      release_thread_ring();
+      return false;
+    }
+
+    log_ring* ring = thread_ring();
+    ring->writing.store(true);
+    if (!m_running.load()) {
+      ring->writing.store(false, std::memory_order_release);
+      release_thread_ring();
+      return false;
+    }
+
+    const LogOverflow overflow = m_overflow.load(std::memory_order_relaxed);
+    bool result = true;
+    if (kRecordHeaderSize + size > ring->capacity()) {
+      // Messages that don't fit in the buffer are written
+      // synchronously after the pending messages of this thread.
+      if (overflow == LogOverflow::BLOCK) {
+        drain();
+        result = false;
+      }
+      else {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    else if (!ring->try_write(header, msg, size)) {
+      if (overflow == LogOverflow::BLOCK) {
+        do {
+          if (!wait_space()) {
+            ring->writing.store(false, std::memory_order_release);
+            release_thread_ring();
+            return false;
+          }
+        } while (!ring->try_write(header, msg, size));
+      }
+      else {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    if (result && ring->used() > ring->capacity() / 2)
+      wakeup();
+
+    ring->writing.store(false, std::memory_order_release);
+    return result;
+  }
+
+private:
+  // Interval to write the pending messages when the buffers are not
+  // half full.
+  static constexpr auto kFlushInterval = std::chrono::milliseconds(20);
+
+  struct ring_ref {
+    std::shared_ptr<log_ring> ring;
+    ~ring_ref()
+    {
+      if (ring)
+        ring->orphan.store(true, std::memory_order_release);
+    }
+  };
+
+  static ring_ref& thread_ring_ref()
+  {
+    thread_local ring_ref ref;
+    return ref;
+  }
+
+  log_ring* thread_ring()
+  {
+    ring_ref& ref = thread_ring_ref();
+    if (!ref.ring) {
+      ref.ring = std::make_shared<log_ring>(m_bufferSize.load(std::memory_order_relaxed));
+      const std::lock_guard lock(m_ringsMutex);
+      m_rings.push_back(ref.ring);
+    }
+    return ref.ring.get();
+  }
+
+  void wakeup()
+  {
+    if (!m_wakeup.load(std::memory_order_relaxed) && !m_wakeup.exchange(true)) {
+      const std::lock_guard lock(m_mutex);
+      m_cv.notify_one();
+    }
+  }
+
+  // Used when the async mode is stopped, writes the pending messages
+  // of this thread (so the next message is written synchronously in
+  // the correct order) and releases its buffer.
+  void release_thread_ring()
+  {
+    ring_ref& ref = thread_ring_ref();
+    if (ref.ring) {
+      ref.ring->orphan.store(true, std::memory_order_release);
+      ref.ring.reset();
+      drain();
+    }
+  }
+
+  // Waits the background thread to read the buffers. Returns false
+  // if the async mode is being stopped.
+  bool wait_space()
+  {
+    if (!m_running.load())
+      return false;
+    wakeup();
+    std::this_thread::yield();
+    return true;
+  }
+
+  void flusher()
+  {
+    base::this_thread::set_name("log");
+
+    std::unique_lock lock(m_mutex);
+    for (;;) {
+      m_cv.wait_for(lock, kFlushInterval, [this] {
+        return m_wakeup.load() || m_flushRequest != m_flushDone || m_stopping;
+      });
+      m_wakeup.store(false);
+      const bool stopping = m_stopping;
+      const uint64_t request = m_flushRequest;
+      lock.unlock();
+
+      drain();
+
+      lock.lock();
+      if (m_flushDone != request) {
+        m_flushDone = request;
+        m_cvFlushed.notify_all();
+      }
+      if (stopping)
+        break;
+    }
+  }
+
+  // Writes the content of all buffers in one batch.
+  void drain()
+  {
+    const std::lock_guard drainLock(m_drainMutex);
+    {
+      const std::lock_guard lock(m_ringsMutex);
+      for (auto it = m_rings.begin(); it != m_rings.end();) {
+        log_ring* ring = it->get();
+        const bool orphan = ring->orphan.load(std::memory_order_acquire);
+        ring->read(m_raw);
+        if (orphan)
+          it = m_rings.erase(it);
+        else
+          ++it;
+      }
+    }
+
+    decode_messages(m_raw, m_batch);
+    m_raw.clear();
+
+    const size_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDrops) {
+      char note[64];
+      std::snprintf(note, sizeof(note), "[%zu log messages dropped]\n", dropped - m_reportedDrops);
+      m_batch += note;
+      m_reportedDrops = dropped;
+    }
+
+    if (!m_batch.empty()) {
+      const std::lock_guard lock(log_mutex);
+      write_log_locked(m_batch.data(), m_batch.size());
+      m_batch.clear();
+    }
+  }
+
+  std::atomic<bool> m_running = false;
+  std::atomic<size_t> m_bufferSize = 256;
+  std::atomic<LogOverflow> m_overflow = LogOverflow::BLOCK;
+  std::thread m_thread;
+  alignas(64) std::atomic<size_t> m_dropped = 0;
+  alignas(64) std::atomic<bool> m_wakeup = false;
+
+  // Used to wake up the background thread and wait flush requests
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::condition_variable m_cvFlushed;
+  bool m_stopping = false;
+  uint64_t m_flushRequest = 0;
+  uint64_t m_flushDone = 0;
+
+  // Buffers of all threads, the ones from finished threads are
+  // removed when they are empty.
+  std::mutex m_ringsMutex;
+  std::vector<std::shared_ptr<log_ring>> m_rings;
+
+  // Messages read from the buffers, and the batch of text to write
+  // (used by the thread that drains buffers)
+  std::mutex m_drainMutex;
+  std::string m_raw;
+  std::string m_batch;
+  size_t m_reportedDrops = 0;
+};
+
+// Defined after log_stream so it's destroyed before (and can write
+// its pending messages).
+async_logger async_log;
+
+// Serializes set_log_async() and flush_log() calls
+std::mutex async_log_control_mutex;
+
+const int crash_signals[] = {
+  SIGSEGV,
+  SIGABRT,
+  SIGFPE,
+  SIGILL,
+#ifdef SIGBUS
+  SIGBUS,
+#endif
+};
+using signal_handler = void (*)(int);
+signal_handler prev_crash_handlers[std::size(crash_signals)];
+
+void crash_signal_handler(const int sig)
+{
+  base::flush_log_on_crash();
+
+  // Restore the previous handler and raise the signal again
+  signal_handler prev = SIG_DFL;
+  for (size_t i = 0; i < std::size(crash_signals); ++i) {
+    if (crash_signals[i] == sig) {
+      prev = prev_crash_handlers[i];
+      break;
+    }
+  }
+  if (prev == SIG_IGN || prev == SIG_ERR)
+    prev = SIG_DFL;
+  std::signal(sig, prev);
+  std::raise(sig);
+}
+
 } // anonymous namespace
 
 void base::set_log_filename(const char* filename)
 {
+  flush_log();
+
+  const std::lock_guard lock(log_mutex);
   if (log_stream.is_open()) {
     log_stream.close();
     log_ostream = &std::cerr;
@@ -45,11 +619,17 @@ void base::set_log_filename(const char* filename)
 
   if (filename) {
     log_filename = filename;
-    log_stream.open(FSTREAM_PATH(log_filename));
+    // Both the log stream and the file descriptor used in case of a
+    // crash write at the end of the file.
+    if (open_crash_fd_locked())
+      log_stream.open(FSTREAM_PATH(log_filename), std::ios::out | std::ios::app);
+    else
+      log_stream.open(FSTREAM_PATH(log_filename));
     log_ostream = &log_stream;
   }
   else {
     log_filename = std::string();
+    open_crash_fd_locked();
   }
 }
 
@@ -63,29 +643,166 @@ LogLevel base::get_log_level()
   return log_level;
 }
 
+void base::set_log_async(const bool async, const size_t bufferSize, const LogOverflow overflow)
+{
+  const std::lock_guard lock(async_log_control_mutex);
+  if (async)
+    async_log.start(bufferSize, overflow);
+  else
+    async_log.stop();
+}
+
+bool base::is_log_async()
+{
+  return async_log.running();
+}
+
+void base::flush_log()
+{
+  const std::lock_guard lock(async_log_control_mutex);
+  async_log.flush();
+}
+
+size_t base::get_log_dropped_messages()
+{
+  return async_log.dropped();
+}
+
+void base::flush_log_on_crash()
+{
+  async_log.crash_flush();
+}
+
+void base::install_log_crash_handler()
+{
+  static std::once_flag once;
+  std::call_once(once, [] {
+    for (size_t i = 0; i < std::size(crash_signals); ++i)
+      prev_crash_handlers[i] = std::signal(crash_signals[i], crash_signal_handler);
+  });
+}
+
+void base::write_log(const char* text, const size_t size)
+{
+  if (!async_log.write(text, size, uint32_t(size))) {
+    const std::lock_guard lock(log_mutex);
+    write_log_locked(text, size);
+  }
+
+#ifdef _DEBUG
+  fwrite(text, 1, size, stderr);
+  fflush(stderr);
+#endif
+}
+
+void base::write_log_record(const void* record, const size_t size)
+{
+  if (async_log.write(record, size, uint32_t(size) | kBinaryRecord))
+    return;
+
+  std::string text;
+  decode_record(static_cast<const uint8_t*>(record), size, text);
+  write_log(text.data(), text.size());
+}
+
+void base::append_log_format(std::string& out, const char* format, ...)
+{
+  char buf[1024];
+  va_list ap, apTmp;
+  va_start(ap, format);
+  va_copy(apTmp, ap);
+  const int size = std::vsnprintf(buf, sizeof(buf), format, apTmp);
+  va_end(apTmp);
+  if (size > 0) {
+    if (size < int(sizeof(buf))) {
+      out.append(buf, size);
+    }
+    else {
+      const size_t pos = out.size();
+      out.resize(pos + size + 1);
+      std::vsnprintf(&out[pos], size + 1, format, ap);
+      out.resize(pos + size);
+    }
+  }
+  va_end(ap);
+}
+
+void base::details::append_log_field(std::string& out, const char* key, const char* value)
+{
+  const std::string_view str(value);
+  const bool quote = (str.empty() || str.find_first_of(" =\"\\\n\r\t") != std::string_view::npos);
+
+  out += ' ';
+  out += key;
+  out += '=';
+  if (!quote) {
+    out += str;
+    return;
+  }
+
+  out += '"';
+  for (const char c : str) {
+    switch (c) {
+      case '"':  out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      default:   out += c; break;
+    }
+  }
+  out += '"';
+}
+
+void base::details::append_log_field(std::string& out, const char* key, const bool value)
+{
+  append_log_format(out, " %s=%s", key, value ? "true" : "false");
+}
+
+void base::details::append_log_field(std::string& out, const char* key, const long long value)
+{
+  append_log_format(out, " %s=%lld", key, value);
+}
+
+void base::details::append_log_field(std::string& out,
+                                     const char* key,
+                                     const unsigned long long value)
+{
+  append_log_format(out, " %s=%llu", key, value);
+}
+
+void base::details::append_log_field(std::string& out, const char* key, const double value)
+{
+  append_log_format(out, " %s=%g", key, value);
+}
+
+void base::details::append_log_field(std::string& out, const char* key, const void* value)
+{
+  append_log_format(out, " %s=%p", key, value);
+}
+
 static void LOGva(const char* format, va_list ap)
 {
+  // Format the message in the stack if possible (most messages are
+  // small)
+  char stackBuf[1024];
+  std::vector<char> heapBuf;
+  char* buf = stackBuf;
+
   va_list apTmp;
   va_copy(apTmp, ap);
-  const int size = std::vsnprintf(nullptr, 0, format, apTmp);
+  const int size = std::vsnprintf(stackBuf, sizeof(stackBuf), format, apTmp);
   va_end(apTmp);
   if (size < 1)
     return; // Nothing to log
 
-  std::vector<char> buf(size + 1);
-  std::vsnprintf(buf.data(), buf.size(), format, ap);
-
-  {
-    const std::lock_guard lock(log_mutex);
-    ASSERT(log_ostream);
-    log_ostream->write(buf.data(), size);
-    log_ostream->flush();
+  if (size >= int(sizeof(stackBuf))) {
+    heapBuf.resize(size + 1);
+    std::vsnprintf(heapBuf.data(), heapBuf.size(), format, ap);
+    buf = heapBuf.data();
   }
 
-#ifdef _DEBUG
-  fputs(buf.data(), stderr);
-  fflush(stderr);
-#endif
+  base::write_log(buf, size);
 }
 
 void LOG(const char* format, ...)
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2020  Igara Studio S.A.
+// Copyright (c) 2020-2026  Igara Studio S.A.
 // Copyright (c) 2001-2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -28,6 +28,7 @@ enum LogLevel {
 };
 
   #ifdef __cplusplus
+    #include <cstddef>
     #include <iosfwd>
 
 namespace base {
@@ -36,6 +37,49 @@ void set_log_filename(const char* filename);
 void set_log_level(LogLevel level);
 LogLevel get_log_level();
 
+// What to do in async mode when the buffer of a thread is full.
+enum class LogOverflow {
+  DROP,  // The message is discarded (LOG() never waits)
+  BLOCK, // LOG() waits until the background thread writes the buffer
+};
+
+// In async mode LOG() only formats the message and copies it into a
+// lock-free ring buffer of the calling thread, and a background
+// thread writes all buffers to the log file in batches. Messages
+// from the same thread are kept in order, but messages from
+// different threads can be interleaved in a different order.
+//
+// "bufferSize" is the size (rounded up to a power of two) of the
+// buffer of each thread that logs messages (threads that already
+// have a buffer keep its old size). Disabling the async mode writes
+// all pending messages.
+void set_log_async(bool async,
+                   size_t bufferSize = 64 * 1024,
+                   LogOverflow overflow = LogOverflow::BLOCK);
+bool is_log_async();
+
+// Waits until all messages logged until now are written.
+void flush_log();
+
+// Writes a text (already formatted) in the log without checking the
+// log level.
+void write_log(const char* text, size_t size);
+
+// Returns the number of discarded messages with LogOverflow::DROP.
+size_t get_log_dropped_messages();
+
+// Writes the pending messages of the async mode without waiting the
+// background thread. It's a best effort function to be called from
+// a crash handler (so the last messages before the crash are not
+// lost), e.g. from a signal handler or an unhandled exception filter.
+// It doesn't allocate memory, the text messages are written with
+// write() in the log file (binary records are not formatted).
+void flush_log_on_crash();
+
+// Installs signal handlers for SIGSEGV/SIGABRT/SIGFPE/SIGILL/SIGBUS
+// that call flush_log_on_crash() and then the previous handler.
+void install_log_crash_handler();
+
 } // namespace base
 
 // E.g. LOG("text in information log level\n");
@@ -51,6 +95,23 @@ inline void LOG(int)
   // time.
 }
 
+    // Maximum log level compiled in the program, LAF_LOG*() calls with
+    // a greater level are removed at compile time (e.g. with
+    // -DLAF_LOG_MAX_LEVEL=2 only FATAL and ERROR messages are kept).
+    #ifndef LAF_LOG_MAX_LEVEL
+      #define LAF_LOG_MAX_LEVEL 5 // VERBOSE
+    #endif
+
+    // Like LOG(level, format, ...) but the arguments are evaluated only
+    // if the message is going to be logged.
+    #define LAF_LOG(level, ...)                                                                    \
+      do {                                                                                         \
+        if constexpr ((level) <= LAF_LOG_MAX_LEVEL) {                                              \
+          if (base::get_log_level() >= (level))                                                    \
+            LOG((level), __VA_ARGS__);                                                             \
+        }                                                                                          \
+      } while (0)
+
   #endif
 
 #endif
@@ -0,0 +1,96 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/fs.h"
+#include "base/log.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace base;
+
+static const char* fn = "_test_log_.tmp";
+
+static std::vector<std::string> read_lines()
+{
+  std::vector<std::string> lines;
+  std::ifstream f(fn);
+  std::string line;
+  while (std::getline(f, line))
+    lines.push_back(line);
+  return lines;
+}
+
+static void log_from_threads(const int nthreads, const int n)
+{
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nthreads; ++t) {
+    threads.emplace_back([t, n] {
+      for (int i = 0; i < n; ++i)
+        LOG(INFO, "T%d %d\n", t, i);
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+}
+
+// Checks that the messages of each thread are in order, and returns
+// the number of messages.
+static int check_lines(const int nthreads)
+{
+  std::vector<int> last(nthreads, -1);
+  int count = 0;
+  for (const auto& line : read_lines()) {
+    if (line[0] == '[') // "[N log messages dropped]"
+      continue;
+    int t, i;
+    EXPECT_EQ(2, std::sscanf(line.c_str(), "T%d %d", &t, &i)) << line;
+    EXPECT_LT(last[t], i);
+    last[t] = i;
+    ++count;
+  }
+  return count;
+}
+
+TEST(Log, Benchmark)
+{
+  const int n = 50000;
+  set_log_level(INFO);
+
+  for (const int nthreads : { 1, 4 }) {
+    for (const bool async : { false, true }) {
+      set_log_filename(fn);
+      set_log_async(async);
+
+      Chrono chrono;
+      log_from_threads(nthreads, n);
+      flush_log();
+      const double t = chrono.elapsed();
+
+      set_log_async(false);
+      set_log_filename(nullptr);
+
+      std::printf("%d thread(s) %-5s %.2f M messages/s\n",
+                  nthreads,
+                  async ? "async" : "sync",
+                  nthreads * n / t / 1000000.0);
+      EXPECT_EQ(nthreads * n, check_lines(nthreads));
+    }
+  }
+  delete_file(fn);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
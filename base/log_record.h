@@ -0,0 +1,294 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_LOG_RECORD_H_INCLUDED
+#define BASE_LOG_RECORD_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "base/log.h"
+#include "base/time.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Structured, rate-limited, and deferred logging. All these macros
+// are removed at compile time when the level is greater than
+// LAF_LOG_MAX_LEVEL, and the arguments are evaluated only if the
+// message is going to be logged.
+//
+//   // Key/value fields, writes: window resized w=640 h=480 title="My App"
+//   LAF_LOG_KV(INFO, "window resized", "w", w, "h", h, "title", title);
+//
+//   // Logs at most 5 messages per second from this line
+//   LAF_LOG_RATE(WARNING, 5, "Cannot load glyph %d\n", glyph);
+//
+//   // Copies the arguments in a binary record and formats the text in
+//   // the log thread (when set_log_async() is enabled)
+//   LAF_LOG_DEFERRED(VERBOSE, "Frame %d took %.2f ms\n", frame, ms);
+//
+// The arguments of LAF_LOG_KV() and LAF_LOG_DEFERRED() can be
+// integers, floating points, enums, pointers, or strings (const char*,
+// std::string, or std::string_view).
+
+#define LAF_LOG_KV(level, ...)                                                                     \
+  do {                                                                                             \
+    if constexpr ((level) <= LAF_LOG_MAX_LEVEL) {                                                  \
+      if (base::get_log_level() >= (level))                                                        \
+        base::log_fields(__VA_ARGS__);                                                             \
+    }                                                                                              \
+  } while (0)
+
+#define LAF_LOG_DEFERRED(level, ...)                                                               \
+  do {                                                                                             \
+    if constexpr ((level) <= LAF_LOG_MAX_LEVEL) {                                                  \
+      if (base::get_log_level() >= (level))                                                        \
+        base::log_deferred(__VA_ARGS__);                                                           \
+    }                                                                                              \
+  } while (0)
+
+#define LAF_LOG_RATE(level, maxPerSecond, ...)                                                     \
+  do {                                                                                             \
+    if constexpr ((level) <= LAF_LOG_MAX_LEVEL) {                                                  \
+      static base::log_rate_limiter laf_log_limiter_(maxPerSecond);                                \
+      size_t laf_log_suppressed_ = 0;                                                              \
+      if (base::get_log_level() >= (level) && laf_log_limiter_.allow(laf_log_suppressed_)) {       \
+        if (laf_log_suppressed_ > 0)                                                               \
+          LOG((level), "(%zu similar messages suppressed)\n", laf_log_suppressed_);                \
+        LOG((level), __VA_ARGS__);                                                                 \
+      }                                                                                            \
+    }                                                                                              \
+  } while (0)
+
+namespace base {
+
+// Converts the "data" of a binary record to text.
+using log_record_decoder = void (*)(const uint8_t* data, size_t size, std::string& out);
+
+// Writes a binary record in the log. The record starts with a
+// log_record_decoder pointer followed by its data. In async mode the
+// record is copied as it is and decoded in the log thread.
+void write_log_record(const void* record, size_t size);
+
+// Appends printf-style formatted text to "out".
+void append_log_format(std::string& out, const char* format, ...);
+
+// Limits the number of messages per second (used by LAF_LOG_RATE()).
+class log_rate_limiter {
+public:
+  explicit log_rate_limiter(const int maxPerSecond) : m_max(maxPerSecond) {}
+
+  // Returns true if the message can be logged, in that case
+  // "suppressed" is the number of messages discarded since the last
+  // allowed one.
+  bool allow(size_t& suppressed)
+  {
+    const int64_t second = int64_t(current_tick() / 1000);
+    int64_t current = m_second.load(std::memory_order_relaxed);
+    if (second != current && m_second.compare_exchange_strong(current, second))
+      m_count.store(0, std::memory_order_relaxed);
+
+    if (m_count.fetch_add(1, std::memory_order_relaxed) < m_max) {
+      suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+      return true;
+    }
+    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+private:
+  const int m_max;
+  std::atomic<int64_t> m_second = -1;
+  std::atomic<int> m_count = 0;
+  std::atomic<size_t> m_suppressed = 0;
+};
+
+namespace details {
+
+// Type used to encode an argument (arrays are encoded as pointers,
+// and char arrays/pointers as strings).
+template<typename T>
+using log_arg_type =
+  std::conditional_t<std::is_same_v<std::decay_t<T>, char*>, const char*, std::decay_t<T>>;
+
+template<typename T>
+constexpr bool is_log_string_v = std::is_same_v<T, const char*> ||
+                                 std::is_same_v<T, std::string> ||
+                                 std::is_same_v<T, std::string_view>;
+
+// Binary encoding of each kind of argument.
+template<typename T, typename = void>
+struct log_arg {
+  static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>,
+                "Unsupported log argument type");
+
+  using decoded_type = T;
+
+  static size_t size(const T&) { return sizeof(T); }
+
+  static void encode(uint8_t*& p, const T& value)
+  {
+    std::memcpy(p, &value, sizeof(T));
+    p += sizeof(T);
+  }
+
+  static T decode(const uint8_t*& p)
+  {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return value;
+  }
+};
+
+// Strings are copied with their length and a null terminator, so
+// they can be decoded as a const char* to the record data.
+template<typename T>
+struct log_arg<T, std::enable_if_t<is_log_string_v<T>>> {
+  using decoded_type = const char*;
+
+  static std::string_view view(const T& value)
+  {
+    if constexpr (std::is_pointer_v<T>)
+      return (value ? std::string_view(value) : std::string_view("(null)"));
+    else
+      return std::string_view(value);
+  }
+
+  static size_t size(const T& value) { return sizeof(uint32_t) + view(value).size() + 1; }
+
+  static void encode(uint8_t*& p, const T& value)
+  {
+    const std::string_view str = view(value);
+    const uint32_t len = uint32_t(str.size());
+    std::memcpy(p, &len, sizeof(len));
+    if (len > 0)
+      std::memcpy(p + sizeof(len), str.data(), len);
+    p[sizeof(len) + len] = 0;
+    p += sizeof(len) + len + 1;
+  }
+
+  static const char* decode(const uint8_t*& p)
+  {
+    uint32_t len;
+    std::memcpy(&len, p, sizeof(len));
+    auto str = reinterpret_cast<const char*>(p + sizeof(len));
+    p += sizeof(len) + len + 1;
+    return str;
+  }
+};
+
+template<typename... Args>
+using log_decoded_tuple = std::tuple<typename log_arg<Args>::decoded_type...>;
+
+template<typename... Args>
+log_decoded_tuple<Args...> decode_log_args(const uint8_t* p)
+{
+  // Elements in a braced-init-list are evaluated in order
+  return log_decoded_tuple<Args...>{ log_arg<Args>::decode(p)... };
+}
+
+template<typename... Args>
+void write_log_record(const log_record_decoder decoder, const Args&... args)
+{
+  const size_t size = sizeof(decoder) + (log_arg<log_arg_type<Args>>::size(args) + ... + 0);
+
+  // Most records fit in the stack
+  uint8_t stackBuf[512];
+  std::unique_ptr<uint8_t[]> heapBuf;
+  uint8_t* buf = stackBuf;
+  if (size > sizeof(stackBuf)) {
+    heapBuf.reset(new uint8_t[size]);
+    buf = heapBuf.get();
+  }
+
+  uint8_t* p = buf;
+  std::memcpy(p, &decoder, sizeof(decoder));
+  p += sizeof(decoder);
+  (log_arg<log_arg_type<Args>>::encode(p, args), ...);
+  base::write_log_record(buf, size);
+}
+
+// Appends " key=value" to "out" (strings are quoted when needed).
+void append_log_field(std::string& out, const char* key, const char* value);
+void append_log_field(std::string& out, const char* key, bool value);
+void append_log_field(std::string& out, const char* key, long long value);
+void append_log_field(std::string& out, const char* key, unsigned long long value);
+void append_log_field(std::string& out, const char* key, double value);
+void append_log_field(std::string& out, const char* key, const void* value);
+
+template<typename T>
+void append_log_field_value(std::string& out, const char* key, const T value)
+{
+  if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, bool>)
+    append_log_field(out, key, value);
+  else if constexpr (std::is_enum_v<T>)
+    append_log_field(out, key, (long long)value);
+  else if constexpr (std::is_floating_point_v<T>)
+    append_log_field(out, key, double(value));
+  else if constexpr (std::is_pointer_v<T>)
+    append_log_field(out, key, static_cast<const void*>(value));
+  else if constexpr (std::is_signed_v<T>)
+    append_log_field(out, key, (long long)value);
+  else
+    append_log_field(out, key, (unsigned long long)value);
+}
+
+template<typename... Args>
+void decode_format_record(const uint8_t* data, size_t, std::string& out)
+{
+  std::apply(
+    [&out](const char* format, const auto... args) { append_log_format(out, format, args...); },
+    decode_log_args<const char*, Args...>(data));
+}
+
+template<typename Tuple, size_t... I>
+void append_log_fields(std::string& out, const Tuple& fields, std::index_sequence<I...>)
+{
+  (append_log_field_value(out, std::get<1 + 2 * I>(fields), std::get<2 + 2 * I>(fields)), ...);
+}
+
+template<typename... Args>
+void decode_fields_record(const uint8_t* data, size_t, std::string& out)
+{
+  const auto fields = decode_log_args<const char*, Args...>(data);
+  out += std::get<0>(fields);
+  append_log_fields(out, fields, std::make_index_sequence<sizeof...(Args) / 2>());
+  out += '\n';
+}
+
+} // namespace details
+
+// Logs a message with key/value pairs (see LAF_LOG_KV()).
+template<typename... Args>
+void log_fields(const char* message, const Args&... keysAndValues)
+{
+  static_assert(sizeof...(Args) % 2 == 0, "Fields must be key/value pairs");
+  details::write_log_record(&details::decode_fields_record<details::log_arg_type<Args>...>,
+                            message,
+                            keysAndValues...);
+}
+
+// Logs a printf-style message formatting it later (see
+// LAF_LOG_DEFERRED()).
+template<typename... Args>
+void log_deferred(const char* format, const Args&... args)
+{
+  details::write_log_record(&details::decode_format_record<details::log_arg_type<Args>...>,
+                            format,
+                            args...);
+}
+
+} // namespace base
+
+#endif
@@ -0,0 +1,87 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/fs.h"
+#include "base/log_record.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace base;
+
+static const char* fn = "_test_log_record_.tmp";
+
+static std::vector<std::string> read_lines()
+{
+  std::vector<std::string> lines;
+  std::ifstream f(fn);
+  std::string line;
+  while (std::getline(f, line))
+    lines.push_back(line);
+  return lines;
+}
+
+TEST(LogRecord, Benchmark)
+{
+  const int n = 200000;
+  set_log_level(VERBOSE);
+  set_log_filename(fn);
+  // Big buffer to measure only the time spent in the caller thread
+  set_log_async(true, 64 * 1024 * 1024);
+
+  Chrono chrono;
+  for (int i = 0; i < n; ++i)
+    LOG(WARNING, "Frame %d took %.2f ms (%s)\n", i, i * 0.01, "render");
+  const double t0 = chrono.elapsed();
+  flush_log();
+
+  chrono.reset();
+  for (int i = 0; i < n; ++i)
+    LAF_LOG_DEFERRED(WARNING, "Frame %d took %.2f ms (%s)\n", i, i * 0.01, "render");
+  const double t1 = chrono.elapsed();
+  flush_log();
+
+  chrono.reset();
+  for (int i = 0; i < n; ++i)
+    LAF_LOG_KV(WARNING, "frame", "n", i, "ms", i * 0.01, "stage", "render");
+  const double t2 = chrono.elapsed();
+  flush_log();
+
+  set_log_async(false);
+  set_log_filename(nullptr);
+  EXPECT_EQ(3 * n, read_lines().size());
+  delete_file(fn);
+
+  // Disabled at runtime
+  set_log_level(ERROR);
+  std::string expensive(256, 'x');
+  chrono.reset();
+  for (int i = 0; i < n; ++i)
+    LOG(WARNING, "%s\n", (expensive + std::to_string(i)).c_str());
+  const double t3 = chrono.elapsed();
+
+  chrono.reset();
+  for (int i = 0; i < n; ++i)
+    LAF_LOG(WARNING, "%s\n", (expensive + std::to_string(i)).c_str());
+  const double t4 = chrono.elapsed();
+
+  std::printf("async LOG              %.2f M messages/s\n", n / t0 / 1000000.0);
+  std::printf("async LAF_LOG_DEFERRED %.2f M messages/s\n", n / t1 / 1000000.0);
+  std::printf("async LAF_LOG_KV       %.2f M messages/s\n", n / t2 / 1000000.0);
+  std::printf("disabled LOG           %.2f M messages/s\n", n / t3 / 1000000.0);
+  std::printf("disabled LAF_LOG       %.2f M messages/s\n", n / t4 / 1000000.0);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
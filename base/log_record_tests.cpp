@@ -0,0 +1,162 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+// Remove VERBOSE and INFO messages at compile time
+#define LAF_LOG_MAX_LEVEL 3
+
+#include <gtest/gtest.h>
+
+#include "base/fs.h"
+#include "base/log_record.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace base;
+
+static const char* fn = "_test_log_record_.tmp";
+
+static std::vector<std::string> read_lines()
+{
+  std::vector<std::string> lines;
+  std::ifstream f(fn);
+  std::string line;
+  while (std::getline(f, line))
+    lines.push_back(line);
+  return lines;
+}
+
+// Logs in the test file in sync and async modes.
+template<typename Func>
+static void test_both_modes(Func func)
+{
+  for (const bool async : { false, true }) {
+    set_log_level(VERBOSE);
+    set_log_filename(fn);
+    set_log_async(async);
+    func(async);
+    set_log_async(false);
+    set_log_filename(nullptr);
+    delete_file(fn);
+  }
+}
+
+enum class Color { Red, Green };
+
+TEST(LogRecord, CompileTimeLevel)
+{
+  int evaluated = 0;
+  auto arg = [&evaluated] { return ++evaluated; };
+
+  test_both_modes([&](bool) {
+    LAF_LOG(VERBOSE, "verbose %d\n", arg());
+    LAF_LOG(INFO, "info %d\n", arg());
+    LAF_LOG_KV(INFO, "info", "n", arg());
+    LAF_LOG_DEFERRED(INFO, "info %d\n", arg());
+    LAF_LOG_RATE(INFO, 10, "info %d\n", arg());
+    LAF_LOG(WARNING, "warning %d\n", arg());
+    flush_log();
+
+    const auto lines = read_lines();
+    ASSERT_EQ(1, lines.size());
+    EXPECT_EQ("warning " + std::to_string(evaluated), lines[0]);
+  });
+  EXPECT_EQ(2, evaluated);
+}
+
+TEST(LogRecord, RuntimeLevel)
+{
+  int evaluated = 0;
+  auto arg = [&evaluated] { return ++evaluated; };
+
+  set_log_level(ERROR);
+  LAF_LOG(WARNING, "warning %d\n", arg());
+  LAF_LOG_KV(WARNING, "warning", "n", arg());
+  LAF_LOG_DEFERRED(WARNING, "warning %d\n", arg());
+  EXPECT_EQ(0, evaluated);
+}
+
+TEST(LogRecord, Fields)
+{
+  test_both_modes([](bool) {
+    const std::string title = "My App";
+    const char* nullStr = nullptr;
+    LAF_LOG_KV(WARNING,
+               "window resized",
+               "w",
+               640,
+               "h",
+               480u,
+               "title",
+               title,
+               "name",
+               std::string_view("main"),
+               "visible",
+               true,
+               "scale",
+               1.5f,
+               "color",
+               Color::Green,
+               "null",
+               nullStr,
+               "empty",
+               "",
+               "quote",
+               "a\"b\\c\n");
+    LAF_LOG_KV(ERROR, "no fields");
+    flush_log();
+
+    const auto lines = read_lines();
+    ASSERT_EQ(2, lines.size());
+    EXPECT_EQ(
+      "window resized w=640 h=480 title=\"My App\" name=main visible=true scale=1.5 color=1 "
+      "null=(null) empty=\"\" quote=\"a\\\"b\\\\c\\n\"",
+      lines[0]);
+    EXPECT_EQ("no fields", lines[1]);
+  });
+}
+
+TEST(LogRecord, Deferred)
+{
+  test_both_modes([](bool) {
+    std::string str = "text";
+    LAF_LOG_DEFERRED(WARNING, "%d %u %lld %.2f %c %s %s\n", -1, 2u, 3ll, 4.5, 'x', "abc", str);
+    str = "changed"; // The record has a copy of the string
+    LAF_LOG_DEFERRED(WARNING, "no args\n");
+    LAF_LOG_DEFERRED(WARNING, "big %s\n", std::string(2000, 'x'));
+    flush_log();
+
+    const auto lines = read_lines();
+    ASSERT_EQ(3, lines.size());
+    EXPECT_EQ("-1 2 3 4.50 x abc text", lines[0]);
+    EXPECT_EQ("no args", lines[1]);
+    EXPECT_EQ("big " + std::string(2000, 'x'), lines[2]);
+  });
+}
+
+TEST(LogRecord, Rate)
+{
+  set_log_level(VERBOSE);
+  set_log_filename(fn);
+  for (int i = 0; i < 1000; ++i)
+    LAF_LOG_RATE(WARNING, 5, "message %d\n", i);
+  set_log_filename(nullptr);
+
+  // 5 messages, or 10 messages + the suppressed messages note if a
+  // new second started in the middle of the loop.
+  const auto lines = read_lines();
+  ASSERT_TRUE(lines.size() == 5 || lines.size() == 11) << lines.size();
+  EXPECT_EQ("message 0", lines[0]);
+  EXPECT_EQ("message 4", lines[4]);
+  delete_file(fn);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
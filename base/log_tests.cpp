@@ -0,0 +1,177 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/fs.h"
+#include "base/log.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace base;
+
+static const char* fn = "_test_log_.tmp";
+
+static std::vector<std::string> read_lines()
+{
+  std::vector<std::string> lines;
+  std::ifstream f(fn);
+  std::string line;
+  while (std::getline(f, line))
+    lines.push_back(line);
+  return lines;
+}
+
+static void log_from_threads(const int nthreads, const int n)
+{
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nthreads; ++t) {
+    threads.emplace_back([t, n] {
+      for (int i = 0; i < n; ++i)
+        LOG(INFO, "T%d %d\n", t, i);
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+}
+
+// Checks that the messages of each thread are in order, and returns
+// the number of messages.
+static int check_lines(const int nthreads)
+{
+  std::vector<int> last(nthreads, -1);
+  int count = 0;
+  for (const auto& line : read_lines()) {
+    if (line[0] == '[') // "[N log messages dropped]"
+      continue;
+    int t, i;
+    EXPECT_EQ(2, std::sscanf(line.c_str(), "T%d %d", &t, &i)) << line;
+    EXPECT_LT(last[t], i);
+    last[t] = i;
+    ++count;
+  }
+  return count;
+}
+
+TEST(Log, Async)
+{
+  set_log_level(INFO);
+  set_log_filename(fn);
+  set_log_async(true, 1024, LogOverflow::BLOCK);
+  EXPECT_TRUE(is_log_async());
+
+  log_from_threads(4, 10000);
+
+  set_log_async(false);
+  EXPECT_FALSE(is_log_async());
+  set_log_filename(nullptr);
+
+  EXPECT_EQ(4 * 10000, check_lines(4));
+  delete_file(fn);
+}
+
+TEST(Log, AsyncFlush)
+{
+  set_log_level(INFO);
+  set_log_filename(fn);
+  set_log_async(true);
+
+  LOG(INFO, "T0 1\n");
+  flush_log();
+  EXPECT_EQ(1, check_lines(1));
+
+  LOG(INFO, "T0 2\n");
+  flush_log_on_crash();
+  EXPECT_EQ(2, check_lines(1));
+
+  // Messages that wrap around the end of the buffer
+  set_log_async(true, 256);
+  for (int i = 3; i <= 100; ++i) {
+    LOG(INFO, "T0 %d\n", i);
+    if ((i % 7) == 0)
+      flush_log_on_crash();
+  }
+  flush_log();
+  EXPECT_EQ(100, check_lines(1));
+
+  set_log_async(false);
+  set_log_filename(nullptr);
+  delete_file(fn);
+}
+
+TEST(Log, AsyncDrop)
+{
+  const size_t dropped = get_log_dropped_messages();
+
+  set_log_level(INFO);
+  set_log_filename(fn);
+  set_log_async(true, 256, LogOverflow::DROP);
+  log_from_threads(2, 20000);
+  set_log_async(false);
+  set_log_filename(nullptr);
+
+  // Each message was written or dropped
+  const int written = check_lines(2);
+  EXPECT_EQ(2 * 20000, written + int(get_log_dropped_messages() - dropped));
+  std::printf("Written %d, dropped %d\n", written, int(get_log_dropped_messages() - dropped));
+  delete_file(fn);
+}
+
+TEST(Log, AsyncBigMessages)
+{
+  set_log_level(INFO);
+  set_log_filename(fn);
+  set_log_async(true, 256, LogOverflow::BLOCK);
+
+  const std::string big(2000, 'x');
+  for (int i = 0; i < 100; ++i) {
+    LOG(INFO, "T0 %d\n", 2 * i);
+    LOG(INFO, "T0 %d %s\n", 2 * i + 1, big.c_str());
+  }
+
+  set_log_async(false);
+  set_log_filename(nullptr);
+
+  EXPECT_EQ(200, check_lines(1));
+  delete_file(fn);
+}
+
+// Stopping the async mode while other threads are blocked waiting
+// space in their buffers.
+TEST(Log, AsyncToggleUnderPressure)
+{
+  set_log_level(INFO);
+  set_log_filename(fn);
+  set_log_async(true, 256, LogOverflow::BLOCK);
+
+  std::atomic<bool> done = false;
+  std::thread toggler([&done] {
+    while (!done) {
+      set_log_async(false);
+      set_log_async(true, 256, LogOverflow::BLOCK);
+    }
+  });
+  log_from_threads(8, 20000);
+  done = true;
+  toggler.join();
+
+  set_log_async(false);
+  set_log_filename(nullptr);
+
+  EXPECT_EQ(8 * 20000, check_lines(8));
+  delete_file(fn);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,209 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/mapped_file.h"
+
+#include "base/debug.h"
+#include "base/string.h"
+
+#include <algorithm>
+#include <utility>
+
+#if LAF_WINDOWS
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace base {
+
+mapped_file::mapped_file(const std::string& filename, mode m)
+{
+  open(filename, m);
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+  : m_data(std::exchange(other.m_data, nullptr))
+  , m_size(std::exchange(other.m_size, 0))
+  , m_mode(other.m_mode)
+  , m_open(std::exchange(other.m_open, false))
+{
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept
+{
+  if (this != &other) {
+    close();
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+    m_mode = other.m_mode;
+    m_open = std::exchange(other.m_open, false);
+  }
+  return *this;
+}
+
+mapped_file::~mapped_file()
+{
+  close();
+}
+
+uint8_t* mapped_file::mutable_data()
+{
+  // Pages in READ_ONLY mode cannot be modified
+  ASSERT(m_mode == mode::COPY_ON_WRITE || !m_data);
+  return m_data;
+}
+
+#if LAF_WINDOWS
+
+bool mapped_file::open(const std::string& filename, mode m)
+{
+  close();
+
+  HANDLE file = ::CreateFile(from_utf8(filename).c_str(),
+                             GENERIC_READ,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                             nullptr,
+                             OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL,
+                             nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER size;
+  if (!::GetFileSizeEx(file, &size) || uint64_t(size.QuadPart) > uint64_t(SIZE_MAX)) {
+    ::CloseHandle(file);
+    return false;
+  }
+
+  // Empty files cannot be mapped
+  if (size.QuadPart > 0) {
+    HANDLE mapping = ::CreateFileMapping(file,
+                                         nullptr,
+                                         (m == mode::READ_ONLY ? PAGE_READONLY : PAGE_WRITECOPY),
+                                         0,
+                                         0,
+                                         nullptr);
+    if (!mapping) {
+      ::CloseHandle(file);
+      return false;
+    }
+
+    // The view keeps a reference to the mapping, so we can close
+    // both handles.
+    void* view = ::MapViewOfFile(mapping,
+                                 (m == mode::READ_ONLY ? FILE_MAP_READ : FILE_MAP_COPY),
+                                 0,
+                                 0,
+                                 0);
+    ::CloseHandle(mapping);
+    if (!view) {
+      ::CloseHandle(file);
+      return false;
+    }
+    m_data = static_cast<uint8_t*>(view);
+    m_size = size_t(size.QuadPart);
+  }
+  ::CloseHandle(file);
+
+  m_mode = m;
+  m_open = true;
+  return true;
+}
+
+void mapped_file::close()
+{
+  if (m_data)
+    ::UnmapViewOfFile(m_data);
+  m_data = nullptr;
+  m_size = 0;
+  m_open = false;
+}
+
+void mapped_file::advise(advice, size_t, size_t) const
+{
+  // Windows doesn't have an equivalent to madvise()
+}
+
+#else
+
+bool mapped_file::open(const std::string& filename, mode m)
+{
+  close();
+
+  const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  struct stat sts;
+  if (::fstat(fd, &sts) != 0 || !S_ISREG(sts.st_mode) ||
+      uint64_t(sts.st_size) > uint64_t(SIZE_MAX)) {
+    ::close(fd);
+    return false;
+  }
+
+  // Empty files cannot be mapped
+  if (sts.st_size > 0) {
+    void* p = ::mmap(nullptr,
+                     size_t(sts.st_size),
+                     (m == mode::READ_ONLY ? PROT_READ : PROT_READ | PROT_WRITE),
+                     (m == mode::READ_ONLY ? MAP_SHARED : MAP_PRIVATE),
+                     fd,
+                     0);
+    if (p == MAP_FAILED) {
+      ::close(fd);
+      return false;
+    }
+    m_data = static_cast<uint8_t*>(p);
+    m_size = size_t(sts.st_size);
+  }
+  // The mapping is still valid after closing the file descriptor
+  ::close(fd);
+
+  m_mode = m;
+  m_open = true;
+  return true;
+}
+
+void mapped_file::close()
+{
+  if (m_data)
+    ::munmap(m_data, m_size);
+  m_data = nullptr;
+  m_size = 0;
+  m_open = false;
+}
+
+void mapped_file::advise(advice a, size_t offset, size_t length) const
+{
+  if (!m_data || offset >= m_size)
+    return;
+
+  // The address must be aligned to the page size
+  static const size_t pageSize = size_t(::sysconf(_SC_PAGESIZE));
+  const size_t begin = offset - (offset % pageSize);
+  length = std::min(length, m_size - offset) + (offset - begin);
+
+  int flag = MADV_NORMAL;
+  switch (a) {
+    case advice::NORMAL:     flag = MADV_NORMAL; break;
+    case advice::SEQUENTIAL: flag = MADV_SEQUENTIAL; break;
+    case advice::RANDOM:     flag = MADV_RANDOM; break;
+    case advice::WILL_NEED:  flag = MADV_WILLNEED; break;
+  }
+  ::madvise(m_data + begin, length, flag);
+}
+
+#endif
+
+} // namespace base
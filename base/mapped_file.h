@@ -0,0 +1,80 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_MAPPED_FILE_H_INCLUDED
+#define BASE_MAPPED_FILE_H_INCLUDED
+#pragma once
+
+#include "base/disable_copying.h"
+#include "base/ints.h"
+
+#include <cstddef>
+#include <string>
+
+namespace base {
+
+// Maps the content of a file in memory (mmap() on Unix-like systems,
+// MapViewOfFile() on Windows) so it can be accessed without reading
+// it (pages are loaded by the OS when they are accessed).
+//
+//   base::mapped_file file("big_file.png");
+//   if (file.is_open())
+//     process(file.data(), file.size());
+//
+class mapped_file {
+public:
+  enum class mode {
+    READ_ONLY,     // Pages are shared with the file (and read-only)
+    COPY_ON_WRITE, // Pages can be modified, but changes are not written in the file
+  };
+
+  // Hints about how the memory will be accessed (madvise())
+  enum class advice {
+    NORMAL,
+    SEQUENTIAL,
+    RANDOM,
+    WILL_NEED,
+  };
+
+  mapped_file() = default;
+  explicit mapped_file(const std::string& filename, mode m = mode::READ_ONLY);
+  mapped_file(mapped_file&& other) noexcept;
+  mapped_file& operator=(mapped_file&& other) noexcept;
+  ~mapped_file();
+
+  // Returns false if the file cannot be opened or mapped. Empty
+  // files can be opened (with size() == 0 and data() == nullptr).
+  bool open(const std::string& filename, mode m = mode::READ_ONLY);
+  void close();
+
+  bool is_open() const { return m_open; }
+  mode get_mode() const { return m_mode; }
+
+  const uint8_t* data() const { return m_data; }
+  // Can be used only in COPY_ON_WRITE mode.
+  uint8_t* mutable_data();
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  const uint8_t* begin() const { return m_data; }
+  const uint8_t* end() const { return m_data + m_size; }
+
+  // Gives a hint about the access pattern of the given range (or the
+  // whole file by default).
+  void advise(advice a, size_t offset = 0, size_t length = size_t(-1)) const;
+
+private:
+  uint8_t* m_data = nullptr;
+  size_t m_size = 0;
+  mode m_mode = mode::READ_ONLY;
+  bool m_open = false;
+
+  DISABLE_COPYING(mapped_file);
+};
+
+} // namespace base
+
+#endif
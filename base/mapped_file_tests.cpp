@@ -0,0 +1,108 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/mapped_file.h"
+#include "base/sha1.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace base;
+
+TEST(MappedFile, ReadOnly)
+{
+  const char* fn = "_test_mapped_.tmp";
+
+  for (size_t s : { 1, 30, 4096, 1024 * 64 * 3 + 4 }) {
+    buffer buf(s);
+    for (size_t i = 0; i < buf.size(); ++i)
+      buf[i] = i;
+    write_file_content(fn, buf);
+
+    mapped_file f(fn);
+    EXPECT_TRUE(f.is_open());
+    EXPECT_EQ(s, f.size());
+    EXPECT_TRUE(std::equal(f.begin(), f.end(), buf.begin(), buf.end()));
+
+    f.advise(mapped_file::advice::SEQUENTIAL);
+    f.advise(mapped_file::advice::WILL_NEED, 10, 100);
+  }
+  delete_file(fn);
+}
+
+TEST(MappedFile, CopyOnWrite)
+{
+  const char* fn = "_test_mapped_.tmp";
+  const buffer buf = { 1, 2, 3, 4 };
+  write_file_content(fn, buf);
+  {
+    mapped_file f(fn, mapped_file::mode::COPY_ON_WRITE);
+    EXPECT_TRUE(f.is_open());
+    f.mutable_data()[0] = 5;
+    EXPECT_EQ(5, f.data()[0]);
+
+    // The file is not modified
+    mapped_file g(fn);
+    EXPECT_EQ(1, g.data()[0]);
+  }
+  EXPECT_EQ(buf, read_file_content(fn));
+  delete_file(fn);
+}
+
+TEST(MappedFile, EmptyAndMissingFiles)
+{
+  const char* fn = "_test_mapped_.tmp";
+  write_file_content(fn, nullptr, 0);
+  {
+    mapped_file f(fn);
+    EXPECT_TRUE(f.is_open());
+    EXPECT_TRUE(f.empty());
+    EXPECT_EQ(nullptr, f.data());
+  }
+  delete_file(fn);
+
+  mapped_file f;
+  EXPECT_FALSE(f.open(fn));
+  EXPECT_FALSE(f.is_open());
+}
+
+TEST(MappedFile, Move)
+{
+  const char* fn = "_test_mapped_.tmp";
+  write_file_content(fn, buffer{ 1, 2, 3 });
+
+  mapped_file a(fn);
+  mapped_file b(std::move(a));
+  EXPECT_FALSE(a.is_open());
+  EXPECT_TRUE(b.is_open());
+  EXPECT_EQ(size_t(3), b.size());
+
+  a = std::move(b);
+  EXPECT_TRUE(a.is_open());
+  EXPECT_EQ(2, a.data()[1]);
+  a.close();
+  EXPECT_FALSE(a.is_open());
+  delete_file(fn);
+}
+
+TEST(MappedFile, Sha1)
+{
+  const char* fn = "_test_mapped_.tmp";
+  const std::string text = "The quick brown fox jumps over the lazy dog";
+  write_file_content(fn, (const uint8_t*)text.c_str(), text.size());
+  EXPECT_EQ(Sha1::calculateFromString(text), Sha1::calculateFromFile(fn));
+  delete_file(fn);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2023 Igara Studio S.A.
+// Copyright (c) 2023-2026 Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -8,18 +8,32 @@
 #define BASE_MASK_SHIFT_H_INCLUDED
 #pragma once
 
+#include "base/count_bits.h"
+
+#include <type_traits>
+
 namespace base {
 
+// Returns the position of the first bit set in the given mask (the
+// number of bits to shift a value to the right to align it with the
+// mask), or the number of bits of T if the mask is zero.
 template<typename T>
-int mask_shift(T mask)
+constexpr inline int mask_shift(const T mask)
 {
-  int shift = 0;
-  int bit = 1;
-  while (((mask & bit) == 0) && shift < 8 * sizeof(mask)) {
-    bit <<= 1;
-    ++shift;
-  }
-  return shift;
+  static_assert(std::is_integral_v<T> && sizeof(T) <= 8);
+  using U = std::make_unsigned_t<T>;
+  if (mask == 0)
+    return int(8 * sizeof(T));
+#if defined(__GNUC__) || defined(__clang__)
+  if constexpr (sizeof(U) <= sizeof(unsigned))
+    return __builtin_ctz(unsigned(U(mask)));
+  else
+    return __builtin_ctzll((unsigned long long)U(mask));
+#else
+  // Count the zeros below the lowest set bit
+  const U m = U(mask);
+  return int(count_bits(U((m & U(~m + 1)) - 1)));
+#endif
 }
 
 } // namespace base
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2023  Igara Studio S.A.
+// Copyright (c) 2023-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -9,6 +9,8 @@
 #include "base/ints.h"
 #include "base/mask_shift.h"
 
+#include <limits>
+
 using namespace base;
 
 TEST(MaskShift, Uint8)
@@ -44,6 +46,28 @@ TEST(MaskShift, Uint32)
   EXPECT_EQ(0xff, (0xff00 >> mask_shift<uint32_t>(0xff00)));
 }
 
+TEST(MaskShift, Uint64)
+{
+  EXPECT_EQ(0, mask_shift<uint64_t>(0xffffffffffffffffull));
+  EXPECT_EQ(31, mask_shift<uint64_t>(0x0000000080000000ull));
+  EXPECT_EQ(40, mask_shift<uint64_t>(0x0000ff0000000000ull));
+  EXPECT_EQ(63, mask_shift<uint64_t>(0x8000000000000000ull));
+  EXPECT_EQ(64, mask_shift<uint64_t>(0));
+}
+
+TEST(MaskShift, SignedTypes)
+{
+  EXPECT_EQ(7, mask_shift<int8_t>(-128));
+  EXPECT_EQ(31, mask_shift<int32_t>(std::numeric_limits<int32_t>::min()));
+}
+
+TEST(MaskShift, Constexpr)
+{
+  static_assert(mask_shift<uint8_t>(0b0100'0000) == 6);
+  static_assert(mask_shift<uint32_t>(0x3ff00000) == 20);
+  static_assert(mask_shift<uint32_t>(0) == 32);
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2022-2024 Igara Studio S.A.
+// Copyright (c) 2022-2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,9 +9,12 @@
   #include "config.h"
 #endif
 
+#include "base/config.h"
 #include "base/debug.h"
 
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -63,6 +66,8 @@ char* base_strdup(const char* string)
 
 typedef USHORT(WINAPI* RtlCaptureStackBackTraceType)(ULONG, ULONG, PVOID*, PULONG);
 static RtlCaptureStackBackTraceType pRtlCaptureStackBackTrace;
+  #elif HAVE_EXECINFO_H
+    #include <execinfo.h>
   #endif
 
 struct slot_t {
@@ -76,13 +81,20 @@ static bool memleak_status = false;
 static slot_t* headslot;
 static std::mutex g_mutex;
 
-void base_memleak_init()
+static void init_backtrace()
 {
   #ifdef _MSC_VER
-  pRtlCaptureStackBackTrace = (RtlCaptureStackBackTraceType)(::GetProcAddress(
-    ::LoadLibrary(L"kernel32.dll"),
-    "RtlCaptureStackBackTrace"));
+  if (!pRtlCaptureStackBackTrace) {
+    pRtlCaptureStackBackTrace = (RtlCaptureStackBackTraceType)(::GetProcAddress(
+      ::LoadLibrary(L"kernel32.dll"),
+      "RtlCaptureStackBackTrace"));
+  }
   #endif
+}
+
+void base_memleak_init()
+{
+  init_backtrace();
 
   assert(!memleak_status);
 
@@ -155,8 +167,359 @@ void base_memleak_exit()
   }
 }
 
+//////////////////////////////////////////////////////////////////////
+// Sampling allocation profiler
+//
+// Only 1 of each N allocations (on average) is sampled with its
+// backtrace, so the cost for the other allocations is just a
+// decrement of a thread-local counter (and checking one bucket in
+// a hash table of sampled pointers when memory is freed). Samples
+// are accumulated in a per-thread buffer, and then aggregated by
+// call site (hash of the backtrace) in a global table.
+
+  #define MEMPROF_FRAMES         12
+  #define MEMPROF_BUFFER         16
+  #define MEMPROF_SITE_BUCKETS   4096
+  #define MEMPROF_PTR_BUCKETS    4096
+  #define MEMPROF_PTR_SHARDS     64
+
+struct memprof_site {
+  uint64_t hash;
+  void* frames[MEMPROF_FRAMES];
+  int nframes;
+  uint64_t allocs; // Sampled allocations
+  uint64_t bytes;  // Sampled bytes
+  uint64_t live;   // Sampled bytes that are not yet freed (calculated in the dump)
+  memprof_site* next;
+};
+
+// Sampled allocation that is not yet freed
+struct memprof_ptr {
+  void* ptr;
+  uint64_t site;
+  size_t size;
+  memprof_ptr* next;
+};
+
+struct memprof_sample {
+  uint64_t site;
+  void* frames[MEMPROF_FRAMES];
+  int nframes;
+  size_t size;
+};
+
+// Zero-initialized thread-local data (without constructor/destructor
+// as it's used from operator new)
+struct memprof_thread {
+  size_t countdown; // 0 before the first allocation of the thread
+  uint32_t seed;
+  bool busy;        // To avoid sampling allocations from the profiler itself
+  bool exitHandler; // True if t_memprofExit was created for this thread
+  int n;
+  memprof_sample samples[MEMPROF_BUFFER];
+};
+
+static std::atomic<bool> memprof_status(false);
+static std::atomic<bool> memprof_started(false);
+static std::atomic<size_t> memprof_rate(1);
+static std::atomic<uint32_t> memprof_seed(1);
+
+static std::mutex memprof_sites_mutex;
+static memprof_site* memprof_sites[MEMPROF_SITE_BUCKETS];
+
+static std::mutex memprof_ptrs_mutex[MEMPROF_PTR_SHARDS];
+static memprof_ptr* memprof_ptrs[MEMPROF_PTR_BUCKETS];
+// One bit for each non-empty bucket of memprof_ptrs (a small bitmap
+// that can be checked without locking when memory is freed).
+static std::atomic<uint64_t> memprof_ptrs_used[MEMPROF_PTR_BUCKETS / 64];
+
+static thread_local memprof_thread t_memprof;
+
+static void memprof_flush(memprof_thread& t);
+
+// Flushes the samples that are still in the thread buffer when the
+// thread finishes (it's created with the first sample of the thread).
+struct memprof_thread_exit {
+  ~memprof_thread_exit()
+  {
+    memprof_thread& t = t_memprof;
+    if (t.n > 0) {
+      t.busy = true;
+      memprof_flush(t);
+      t.busy = false;
+    }
+  }
+};
+static thread_local memprof_thread_exit t_memprofExit;
+
+static int capture_backtrace(void** frames, int n)
+{
+  #if defined(_MSC_VER)
+  if (pRtlCaptureStackBackTrace)
+    return pRtlCaptureStackBackTrace(0, n, frames, NULL);
+  return 0;
+  #elif HAVE_EXECINFO_H
+  return backtrace(frames, n);
+  #else
+  frames[0] = __builtin_return_address(0);
+  return 1;
+  #endif
+}
+
+static uint64_t hash_frames(void* const* frames, const int n)
+{
+  // FNV-1a
+  uint64_t h = 14695981039346656037ull;
+  for (int i = 0; i < n; ++i) {
+    h ^= uint64_t(reinterpret_cast<uintptr_t>(frames[i]));
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+static size_t ptr_bucket(const void* ptr)
+{
+  uint64_t h = uint64_t(reinterpret_cast<uintptr_t>(ptr));
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  return size_t(h % MEMPROF_PTR_BUCKETS);
+}
+
+// Random number of allocations until the next sample (with an
+// average of memprof_rate) to avoid aliasing with periodic
+// allocation patterns.
+static size_t next_countdown(memprof_thread& t)
+{
+  const size_t rate = memprof_rate.load(std::memory_order_relaxed);
+  if (rate <= 1)
+    return 1;
+  if (t.seed == 0)
+    t.seed = memprof_seed.fetch_add(0x9e3779b9, std::memory_order_relaxed) | 1;
+  t.seed ^= t.seed << 13;
+  t.seed ^= t.seed >> 17;
+  t.seed ^= t.seed << 5;
+  return 1 + (t.seed % (2 * rate - 1));
+}
+
+// Moves the samples of the thread buffer to the global table of
+// call sites.
+static void memprof_flush(memprof_thread& t)
+{
+  const std::lock_guard lock(memprof_sites_mutex);
+  for (int i = 0; i < t.n; ++i) {
+    const memprof_sample& s = t.samples[i];
+    memprof_site*& head = memprof_sites[s.site % MEMPROF_SITE_BUCKETS];
+    memprof_site* site = head;
+    while (site && site->hash != s.site)
+      site = site->next;
+    if (!site) {
+      site = reinterpret_cast<memprof_site*>(calloc(1, sizeof(memprof_site)));
+      if (!site)
+        continue;
+      site->hash = s.site;
+      site->nframes = s.nframes;
+      memcpy(site->frames, s.frames, sizeof(void*) * s.nframes);
+      site->next = head;
+      head = site;
+    }
+    ++site->allocs;
+    site->bytes += s.size;
+  }
+  t.n = 0;
+}
+
+static void memprof_alloc(void* ptr, size_t size)
+{
+  if (!memprof_status.load(std::memory_order_relaxed))
+    return;
+
+  memprof_thread& t = t_memprof;
+  if (t.busy)
+    return;
+  // The first allocation of each thread is not always sampled
+  if (t.countdown == 0)
+    t.countdown = next_countdown(t);
+  if (t.countdown > 1) {
+    --t.countdown;
+    return;
+  }
+
+  t.busy = true;
+  t.countdown = next_countdown(t);
+  if (!t.exitHandler) {
+    t.exitHandler = true;
+    (void)&t_memprofExit;
+  }
+
+  memprof_sample& s = t.samples[t.n];
+  s.nframes = capture_backtrace(s.frames, MEMPROF_FRAMES);
+  s.site = hash_frames(s.frames, s.nframes);
+  s.size = size;
+
+  memprof_ptr* node = reinterpret_cast<memprof_ptr*>(malloc(sizeof(memprof_ptr)));
+  if (node) {
+    node->ptr = ptr;
+    node->site = s.site;
+    node->size = size;
+
+    const size_t b = ptr_bucket(ptr);
+    const std::lock_guard lock(memprof_ptrs_mutex[b % MEMPROF_PTR_SHARDS]);
+    node->next = memprof_ptrs[b];
+    memprof_ptrs[b] = node;
+    memprof_ptrs_used[b / 64].fetch_or(uint64_t(1) << (b % 64), std::memory_order_release);
+  }
+
+  if (++t.n == MEMPROF_BUFFER)
+    memprof_flush(t);
+  t.busy = false;
+}
+
+static void memprof_free(void* ptr)
+{
+  if (!memprof_started.load(std::memory_order_relaxed))
+    return;
+
+  // Fast path: no sampled pointer in this bucket
+  const size_t b = ptr_bucket(ptr);
+  const uint64_t bit = (uint64_t(1) << (b % 64));
+  if (!(memprof_ptrs_used[b / 64].load(std::memory_order_acquire) & bit))
+    return;
+
+  memprof_ptr* found = nullptr;
+  {
+    const std::lock_guard lock(memprof_ptrs_mutex[b % MEMPROF_PTR_SHARDS]);
+    memprof_ptr* prev = nullptr;
+    for (memprof_ptr* it = memprof_ptrs[b]; it; prev = it, it = it->next) {
+      if (it->ptr == ptr) {
+        if (prev)
+          prev->next = it->next;
+        else
+          memprof_ptrs[b] = it->next;
+        found = it;
+        break;
+      }
+    }
+    if (!memprof_ptrs[b])
+      memprof_ptrs_used[b / 64].fetch_and(~bit, std::memory_order_relaxed);
+  }
+  free(found);
+}
+
+static int compare_sites(const void* a, const void* b)
+{
+  const memprof_site* sa = *reinterpret_cast<memprof_site* const*>(a);
+  const memprof_site* sb = *reinterpret_cast<memprof_site* const*>(b);
+  if (sa->bytes != sb->bytes)
+    return (sa->bytes > sb->bytes ? -1 : 1);
+  return 0;
+}
+
+void base_memprof_start(size_t sampleRate)
+{
+  init_backtrace();
+
+  memprof_rate = (sampleRate > 0 ? sampleRate : 1);
+  memprof_started = true;
+  memprof_status = true;
+}
+
+void base_memprof_stop()
+{
+  memprof_status = false;
+}
+
+bool base_memprof_dump(const char* filename, int maxSites)
+{
+  if (!memprof_started)
+    return false;
+
+  memprof_thread& t = t_memprof;
+  const bool busy = t.busy;
+  t.busy = true;
+  if (t.n > 0)
+    memprof_flush(t);
+
+  FILE* f = fopen(filename, "wt");
+  if (!f) {
+    t.busy = busy;
+    return false;
+  }
+
+  const std::lock_guard lock(memprof_sites_mutex);
+  const uint64_t rate = memprof_rate;
+
+  // Calculate the live bytes of each call site
+  size_t nsites = 0;
+  for (memprof_site* head : memprof_sites) {
+    for (memprof_site* site = head; site; site = site->next) {
+      site->live = 0;
+      ++nsites;
+    }
+  }
+  uint64_t live = 0;
+  uint64_t unknownLive = 0; // Samples still in other thread buffers
+  for (size_t b = 0; b < MEMPROF_PTR_BUCKETS; ++b) {
+    const std::lock_guard ptrsLock(memprof_ptrs_mutex[b % MEMPROF_PTR_SHARDS]);
+    for (memprof_ptr* it = memprof_ptrs[b]; it; it = it->next) {
+      memprof_site* site = memprof_sites[it->site % MEMPROF_SITE_BUCKETS];
+      while (site && site->hash != it->site)
+        site = site->next;
+      if (site)
+        site->live += it->size;
+      else
+        unknownLive += it->size;
+      live += it->size;
+    }
+  }
+
+  // Sort call sites by allocated bytes
+  memprof_site** sorted = reinterpret_cast<memprof_site**>(malloc(sizeof(memprof_site*) *
+                                                                  (nsites + 1)));
+  if (sorted) {
+    size_t i = 0;
+    for (memprof_site* head : memprof_sites)
+      for (memprof_site* site = head; site; site = site->next)
+        sorted[i++] = site;
+    qsort(sorted, nsites, sizeof(memprof_site*), compare_sites);
+  }
+  else
+    nsites = 0;
+
+  // All values are estimated multiplying the sampled values by the
+  // sample rate.
+  fprintf(f, "Allocation profile (1 of each %llu allocations sampled)\n", (unsigned long long)rate);
+  fprintf(f, "Live bytes: %llu\n", (unsigned long long)(live * rate));
+  if (unknownLive)
+    fprintf(f, "Live bytes not yet aggregated: %llu\n", (unsigned long long)(unknownLive * rate));
+
+  for (size_t i = 0; i < nsites && int(i) < maxSites; ++i) {
+    const memprof_site* site = sorted[i];
+    fprintf(f,
+            "\n#%d allocs: %llu, bytes: %llu, live bytes: %llu\n",
+            int(i + 1),
+            (unsigned long long)(site->allocs * rate),
+            (unsigned long long)(site->bytes * rate),
+            (unsigned long long)(site->live * rate));
+  #if !defined(_MSC_VER) && HAVE_EXECINFO_H
+    fflush(f);
+    backtrace_symbols_fd(const_cast<void**>(site->frames), site->nframes, fileno(f));
+  #else
+    for (int c = 0; c < site->nframes; ++c)
+      fprintf(f, "%p\n", site->frames[c]);
+  #endif
+  }
+
+  free(sorted);
+  fclose(f);
+  t.busy = busy;
+  return true;
+}
+
 static void addslot(void* ptr, size_t size)
 {
+  memprof_alloc(ptr, size);
+
   if (!memleak_status)
     return;
 
@@ -191,6 +554,8 @@ static void addslot(void* ptr, size_t size)
 
 static void delslot(void* ptr)
 {
+  memprof_free(ptr);
+
   if (!memleak_status)
     return;
 
@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -43,6 +44,19 @@ void base_aligned_free(void* mem);
 #ifdef LAF_MEMLEAK
 void base_memleak_init();
 void base_memleak_exit();
+
+// Sampling allocation profiler: samples 1 of each "sampleRate"
+// allocations (on average) with its backtrace. It can be used
+// instead of base_memleak_init() to get statistics about the call
+// sites that allocate more memory without slowing down the program
+// (a rate of 4096 or more keeps the overhead under 5% even in code
+// that does nothing more than allocating memory).
+void base_memprof_start(std::size_t sampleRate);
+void base_memprof_stop();
+
+// Writes the "maxSites" call sites with more allocated bytes (and
+// the estimated live bytes) in the given file.
+bool base_memprof_dump(const char* filename, int maxSites);
 #endif
 
 #endif
@@ -0,0 +1,60 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_MEMORY_RESOURCE_H_INCLUDED
+#define BASE_MEMORY_RESOURCE_H_INCLUDED
+#pragma once
+
+#include "base/config.h"
+
+#include <cstddef>
+
+#if HAVE_MEMORY_RESOURCE
+  #include <memory_resource>
+#endif
+
+namespace base {
+
+#if HAVE_MEMORY_RESOURCE
+
+// Our memory resources (base::arena, base::object_pool) can be used
+// with std::pmr containers directly.
+using memory_resource = std::pmr::memory_resource;
+
+#else
+
+// Some standard libraries (e.g. libc++ for macOS < 14) don't include
+// <memory_resource>, in that case we offer the same interface so
+// the resources can be used in the same way (but without std::pmr
+// containers).
+class memory_resource {
+public:
+  virtual ~memory_resource() = default;
+
+  [[nodiscard]] void* allocate(const size_t bytes,
+                               const size_t alignment = alignof(std::max_align_t))
+  {
+    return do_allocate(bytes, alignment);
+  }
+
+  void deallocate(void* p, const size_t bytes, const size_t alignment = alignof(std::max_align_t))
+  {
+    do_deallocate(p, bytes, alignment);
+  }
+
+  bool is_equal(const memory_resource& other) const noexcept { return do_is_equal(other); }
+
+private:
+  virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+  virtual void do_deallocate(void* p, size_t bytes, size_t alignment) = 0;
+  virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+};
+
+#endif
+
+} // namespace base
+
+#endif
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2023  Igara Studio S.A.
+// Copyright (c) 2023-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -8,6 +8,16 @@
 
 #include "base/memory.h"
 
+#ifdef LAF_MEMLEAK
+  #include "base/file_content.h"
+  #include "base/fs.h"
+
+  #include <memory>
+  #include <string>
+  #include <thread>
+  #include <vector>
+#endif
+
 TEST(Memory, AlignedAlloc)
 {
   void* a = base_aligned_alloc(9, 8);
@@ -27,6 +37,52 @@ TEST(Memory, AlignedAlloc)
   base_aligned_free(e);
 }
 
+#ifdef LAF_MEMLEAK
+TEST(Memory, SamplingProfiler)
+{
+  base_memprof_start(16);
+
+  std::vector<std::unique_ptr<int>> live;
+  for (int i = 0; i < 10000; ++i) {
+    auto tmp = std::make_unique<std::string>(100, 'x');
+    live.push_back(std::make_unique<int>(i));
+  }
+
+  const std::string fn = base::join_path(base::get_temp_path(), "_laf_memprof.txt");
+  EXPECT_TRUE(base_memprof_dump(fn.c_str(), 10));
+  base_memprof_stop();
+
+  const auto buf = base::read_file_content(fn);
+  const std::string content(buf.begin(), buf.end());
+  EXPECT_NE(std::string::npos, content.find("Live bytes:"));
+  EXPECT_NE(std::string::npos, content.find("#1 allocs:"));
+  base::delete_file(fn);
+}
+
+// Samples of a thread are aggregated when the thread finishes
+TEST(Memory, SamplingProfilerThreadExit)
+{
+  base_memprof_start(1);
+
+  int* ptrs[3];
+  std::thread([&ptrs] {
+    for (int*& p : ptrs)
+      p = new int(0);
+  }).join();
+
+  const std::string fn = base::join_path(base::get_temp_path(), "_laf_memprof.txt");
+  EXPECT_TRUE(base_memprof_dump(fn.c_str(), 10));
+  base_memprof_stop();
+  for (int* p : ptrs)
+    delete p;
+
+  const auto buf = base::read_file_content(fn);
+  const std::string content(buf.begin(), buf.end());
+  EXPECT_EQ(std::string::npos, content.find("Live bytes not yet aggregated:"));
+  base::delete_file(fn);
+}
+#endif
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
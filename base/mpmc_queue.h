@@ -0,0 +1,439 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_MPMC_QUEUE_H_INCLUDED
+#define BASE_MPMC_QUEUE_H_INCLUDED
+#pragma once
+
+#include "base/debug.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace base {
+
+namespace details {
+
+// Used to block consumers until an element is pushed in the queue.
+// Producers only take the mutex when there are waiting consumers.
+class mpmc_waiter {
+public:
+  void notify()
+  {
+    // Publishing the element and reading m_waiters are sequentially
+    // consistent with the consumer incrementing m_waiters and
+    // checking the queue, so one of them sees the other.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_waiters.load(std::memory_order_relaxed) > 0) {
+      const std::lock_guard lock(m_mutex);
+      m_cv.notify_one();
+    }
+  }
+
+  template<typename Pred>
+  bool wait_for(Pred pred, const double timeout)
+  {
+    if (pred())
+      return true;
+
+    std::unique_lock lock(m_mutex);
+    m_waiters.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const bool result = m_cv.wait_for(lock, std::chrono::duration<double>(timeout), pred);
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    return result;
+  }
+
+private:
+  std::atomic<int> m_waiters = 0;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+};
+
+// Bounded multi-producer/multi-consumer ring buffer based on Dmitry
+// Vyukov's algorithm. Each cell has a sequence number that indicates
+// if it's ready to be written or read for the given position.
+//
+// Positions are never reused: the ring can be reset() starting from
+// a new base position, so a thread that still has a pointer to this
+// ring from a previous use will fail its CAS operations (this is
+// used by mpmc_queue to recycle segments). Consumers can also use
+// base() to pop only elements of a specific period of use. It can be
+// closed to avoid new pushes.
+template<typename T>
+class mpmc_ring {
+public:
+  static constexpr uint64_t kClosed = uint64_t(1) << 63;
+
+  explicit mpmc_ring(const size_t capacity)
+    : m_mask(capacity - 1)
+    , m_cells(new cell[capacity])
+  {
+    // The capacity must be a power of two
+    ASSERT(capacity >= 2 && (capacity & m_mask) == 0);
+    reset(0, false);
+  }
+
+  mpmc_ring(const mpmc_ring&) = delete;
+  mpmc_ring& operator=(const mpmc_ring&) = delete;
+
+  ~mpmc_ring() { destroy_elements(); }
+
+  size_t capacity() const { return size_t(m_mask + 1); }
+
+  // Approximated number of elements.
+  size_t size() const
+  {
+    const uint64_t e = m_enqueue.load(std::memory_order_relaxed) & ~kClosed;
+    const uint64_t d = m_dequeue.load(std::memory_order_relaxed);
+    return size_t(e > d ? e - d : 0);
+  }
+
+  template<typename U>
+  bool try_push(U&& value)
+  {
+    uint64_t pos = m_enqueue.load(std::memory_order_relaxed);
+    while (!(pos & kClosed)) {
+      cell& c = m_cells[pos & m_mask];
+      const uint64_t seq = c.seq.load(std::memory_order_acquire);
+      const int64_t dif = int64_t(seq - pos);
+      if (dif == 0) {
+        if (m_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          new (&c.storage) T(std::forward<U>(value));
+          c.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (dif < 0) {
+        return false; // Full
+      }
+      else {
+        pos = m_enqueue.load(std::memory_order_relaxed);
+      }
+    }
+    return false; // Closed
+  }
+
+  bool try_pop(T& value) { return try_pop_from(value, 0, false); }
+
+  // Pops an element only if the ring wasn't reset() since base() was
+  // "base" (i.e. only elements pushed in that period of use).
+  bool try_pop(T& value, const uint64_t base) { return try_pop_from(value, base, true); }
+
+  // First position of the current period of use of the ring.
+  uint64_t base() const { return m_base.load(std::memory_order_acquire); }
+
+  void close() { m_enqueue.fetch_or(kClosed, std::memory_order_acq_rel); }
+  void open() { m_enqueue.fetch_and(~kClosed, std::memory_order_acq_rel); }
+
+  // Returns true if the ring is closed and all its elements were
+  // popped (or are being popped right now).
+  bool drained() const
+  {
+    const uint64_t e = m_enqueue.load(std::memory_order_acquire);
+    return (e & kClosed) && (e & ~kClosed) == m_dequeue.load(std::memory_order_acquire);
+  }
+
+  // Waits the consumers that are still moving elements out of this
+  // drained ring, and then resets it to be reused. The new positions
+  // start after all the positions used until now.
+  void recycle()
+  {
+    ASSERT(drained());
+    const uint64_t cap = m_mask + 1;
+    for (uint64_t i = 0; i < cap; ++i) {
+      while ((m_cells[i].seq.load(std::memory_order_acquire) & m_mask) != i)
+        std::this_thread::yield();
+    }
+    const uint64_t end = (m_enqueue.load(std::memory_order_relaxed) & ~kClosed);
+    reset((end + 2 * cap) & ~m_mask, true);
+  }
+
+private:
+  struct cell {
+    std::atomic<uint64_t> seq;
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+    T* ptr() { return std::launder(reinterpret_cast<T*>(&storage)); }
+  };
+
+  bool try_pop_from(T& value, const uint64_t base, const bool checkBase)
+  {
+    uint64_t pos = m_dequeue.load(std::memory_order_relaxed);
+    for (;;) {
+      cell& c = m_cells[pos & m_mask];
+      const uint64_t seq = c.seq.load(std::memory_order_acquire);
+      const int64_t dif = int64_t(seq - (pos + 1));
+      if (dif == 0) {
+        // All "seq" values of a new period of use happen after the
+        // m_base change, so this detects if "pos" is from a newer
+        // period. If "pos" is from an older period, the CAS fails.
+        if (checkBase && m_base.load(std::memory_order_relaxed) != base)
+          return false;
+        if (m_dequeue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          T* ptr = c.ptr();
+          value = std::move(*ptr);
+          ptr->~T();
+          c.seq.store(pos + m_mask + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (dif < 0) {
+        return false; // Empty (or the producer is still writing the element)
+      }
+      else {
+        pos = m_dequeue.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void reset(const uint64_t base, const bool closed)
+  {
+    m_base.store(base, std::memory_order_relaxed);
+    for (uint64_t i = 0; i <= m_mask; ++i)
+      m_cells[i].seq.store(base + i, std::memory_order_release);
+    m_dequeue.store(base, std::memory_order_release);
+    m_enqueue.store(base | (closed ? kClosed : 0), std::memory_order_release);
+  }
+
+  void destroy_elements()
+  {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      const uint64_t e = m_enqueue.load(std::memory_order_relaxed) & ~kClosed;
+      for (uint64_t pos = m_dequeue.load(std::memory_order_relaxed); pos < e; ++pos) {
+        cell& c = m_cells[pos & m_mask];
+        if (c.seq.load(std::memory_order_relaxed) == pos + 1)
+          c.ptr()->~T();
+      }
+    }
+  }
+
+  const uint64_t m_mask;
+  std::unique_ptr<cell[]> m_cells;
+  std::atomic<uint64_t> m_base;
+  alignas(64) std::atomic<uint64_t> m_enqueue;
+  alignas(64) std::atomic<uint64_t> m_dequeue;
+};
+
+} // namespace details
+
+// Lock-free bounded multi-producer/multi-consumer queue. The capacity
+// must be a power of two. It has the same push/try_pop API as
+// base::concurrent_queue, but try_pop() doesn't fail when other
+// thread is accessing the queue.
+template<typename T>
+class bounded_mpmc_queue {
+public:
+  explicit bounded_mpmc_queue(const size_t capacity) : m_ring(capacity) {}
+  bounded_mpmc_queue(const bounded_mpmc_queue&) = delete;
+  bounded_mpmc_queue& operator=(const bounded_mpmc_queue&) = delete;
+
+  size_t capacity() const { return m_ring.capacity(); }
+  size_t size() const { return m_ring.size(); }
+  bool empty() const { return m_ring.size() == 0; }
+
+  // Returns false if the queue is full.
+  template<typename U>
+  bool try_push(U&& value)
+  {
+    if (!m_ring.try_push(std::forward<U>(value)))
+      return false;
+    m_waiter.notify();
+    return true;
+  }
+
+  // Waits until there is space in the queue.
+  void push(const T& value)
+  {
+    while (!m_ring.try_push(value))
+      std::this_thread::yield();
+    m_waiter.notify();
+  }
+
+  void push(T&& value)
+  {
+    while (!m_ring.try_push(std::move(value)))
+      std::this_thread::yield();
+    m_waiter.notify();
+  }
+
+  bool try_pop(T& value) { return m_ring.try_pop(value); }
+
+  // Waits up to "timeout" seconds for an element.
+  bool wait_pop(T& value, const double timeout)
+  {
+    return m_waiter.wait_for([this, &value] { return m_ring.try_pop(value); }, timeout);
+  }
+
+  void clear()
+  {
+    T value;
+    while (m_ring.try_pop(value)) {}
+  }
+
+private:
+  details::mpmc_ring<T> m_ring;
+  details::mpmc_waiter m_waiter;
+};
+
+// Lock-free unbounded multi-producer/multi-consumer queue made of a
+// linked list of bounded rings (segments). Pushing/popping elements
+// in a segment is lock-free, a mutex is used only to link a new
+// segment (when the last one is full) or to recycle the first one
+// (when all its elements were popped), i.e. once every SegmentSize
+// elements.
+template<typename T, size_t SegmentSize = 256>
+class mpmc_queue {
+public:
+  mpmc_queue()
+  {
+    segment* s = new_segment();
+    s->ring.open();
+    m_head.store(s, std::memory_order_relaxed);
+    m_tail.store(s, std::memory_order_relaxed);
+  }
+
+  mpmc_queue(const mpmc_queue&) = delete;
+  mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+  bool empty() const
+  {
+    const segment* h = m_head.load(std::memory_order_acquire);
+    return (h->ring.size() == 0 && !h->next.load(std::memory_order_acquire));
+  }
+
+  void push(const T& value) { push_impl(value); }
+  void push(T&& value) { push_impl(std::move(value)); }
+
+  bool try_pop(T& value)
+  {
+    for (;;) {
+      segment* h = m_head.load(std::memory_order_acquire);
+      // "h" can be recycled and reused as the tail at any moment, so
+      // we pop only elements pushed while "h" was the head (in other
+      // case we could pop a new element before older ones).
+      const uint64_t base = h->ring.base();
+      if (h != m_head.load(std::memory_order_acquire))
+        continue;
+      if (h->ring.try_pop(value, base))
+        return true;
+      if (h->ring.base() != base)
+        continue;
+
+      if (!h->next.load(std::memory_order_acquire)) {
+        // If "h" is not the head anymore, it was recycled in the
+        // meantime, try again with the new head.
+        if (h == m_head.load(std::memory_order_acquire))
+          return false;
+        continue;
+      }
+
+      // The first segment is closed, if it's empty we can continue
+      // with the next one.
+      if (!h->ring.drained())
+        return false; // A producer is still writing an element in "h"
+      pop_segment(h);
+    }
+  }
+
+  // Waits up to "timeout" seconds for an element.
+  bool wait_pop(T& value, const double timeout)
+  {
+    return m_waiter.wait_for([this, &value] { return try_pop(value); }, timeout);
+  }
+
+  void clear()
+  {
+    T value;
+    while (try_pop(value)) {}
+  }
+
+private:
+  struct segment {
+    details::mpmc_ring<T> ring;
+    std::atomic<segment*> next = nullptr;
+
+    segment() : ring(SegmentSize) {}
+  };
+
+  template<typename U>
+  void push_impl(U&& value)
+  {
+    for (;;) {
+      segment* t = m_tail.load(std::memory_order_acquire);
+      if (t->ring.try_push(std::forward<U>(value)))
+        break;
+      push_segment(t);
+    }
+    m_waiter.notify();
+  }
+
+  // Closes the full "t" segment and links a new one at the end.
+  void push_segment(segment* t)
+  {
+    const std::lock_guard lock(m_mutex);
+    if (m_tail.load(std::memory_order_relaxed) != t)
+      return;
+
+    t->ring.close();
+    segment* s;
+    if (!m_free.empty()) {
+      s = m_free.back();
+      m_free.pop_back();
+    }
+    else {
+      s = new_segment();
+    }
+    s->ring.open();
+    t->next.store(s, std::memory_order_release);
+    m_tail.store(s, std::memory_order_release);
+  }
+
+  // Removes the drained "h" segment from the beginning of the list.
+  void pop_segment(segment* h)
+  {
+    const std::lock_guard lock(m_mutex);
+    if (m_head.load(std::memory_order_relaxed) != h)
+      return;
+
+    m_head.store(h->next.load(std::memory_order_relaxed), std::memory_order_release);
+    h->next.store(nullptr, std::memory_order_relaxed);
+    h->ring.recycle();
+    m_free.push_back(h);
+  }
+
+  segment* new_segment()
+  {
+    m_segments.push_back(std::make_unique<segment>());
+    m_segments.back()->ring.close();
+    return m_segments.back().get();
+  }
+
+  static_assert(SegmentSize >= 2 && (SegmentSize & (SegmentSize - 1)) == 0,
+                "SegmentSize must be a power of two");
+
+  alignas(64) std::atomic<segment*> m_head;
+  alignas(64) std::atomic<segment*> m_tail;
+  std::mutex m_mutex;
+  // All segments are owned by the queue and never deleted until the
+  // queue is destroyed, so threads with old segment pointers can
+  // still access them safely.
+  std::vector<std::unique_ptr<segment>> m_segments;
+  std::vector<segment*> m_free;
+  details::mpmc_waiter m_waiter;
+};
+
+} // namespace base
+
+#endif
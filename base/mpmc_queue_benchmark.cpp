@@ -0,0 +1,93 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/concurrent_queue.h"
+#include "base/mpmc_queue.h"
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace base;
+
+template<typename Queue>
+static void stress(Queue& q, const int producers, const int consumers, const int values)
+{
+  std::atomic<int64_t> sum(0);
+  std::atomic<int> popped(0);
+  const int total = producers * values;
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&q, values] {
+      for (int i = 1; i <= values; ++i)
+        q.push(i);
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&q, &sum, &popped, total] {
+      int v;
+      while (popped.load() < total) {
+        if (q.try_pop(v)) {
+          sum += v;
+          ++popped;
+        }
+        else
+          std::this_thread::yield();
+      }
+    });
+  }
+  for (auto& t : threads)
+    t.join();
+
+  EXPECT_EQ(total, popped);
+  EXPECT_EQ(int64_t(producers) * values * (values + 1) / 2, sum);
+}
+
+TEST(MpmcQueue, Benchmark)
+{
+  const int kValues = 100000;
+
+  for (const int n : { 1, 2, 4 }) {
+    Chrono t;
+    {
+      concurrent_queue<int> q;
+      stress(q, n, n, kValues);
+    }
+    const double locked = t.elapsed();
+
+    t.reset();
+    {
+      bounded_mpmc_queue<int> q(1024);
+      stress(q, n, n, kValues);
+    }
+    const double bounded = t.elapsed();
+
+    t.reset();
+    {
+      mpmc_queue<int> q;
+      stress(q, n, n, kValues);
+    }
+    const double unbounded = t.elapsed();
+
+    std::printf("producers=consumers=%d concurrent_queue=%8.3f ms bounded=%8.3f ms "
+                "unbounded=%8.3f ms\n",
+                n,
+                locked * 1000.0,
+                bounded * 1000.0,
+                unbounded * 1000.0);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,244 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/mpmc_queue.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace base;
+
+TEST(BoundedMpmcQueue, Basic)
+{
+  bounded_mpmc_queue<int> q(4);
+  EXPECT_EQ(size_t(4), q.capacity());
+  EXPECT_TRUE(q.empty());
+
+  int v = 0;
+  EXPECT_FALSE(q.try_pop(v));
+  for (int i = 0; i < 4; ++i)
+    EXPECT_TRUE(q.try_push(i));
+  EXPECT_FALSE(q.try_push(4));
+  EXPECT_EQ(size_t(4), q.size());
+
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(q.try_pop(v));
+    EXPECT_EQ(i, v);
+  }
+  EXPECT_FALSE(q.try_pop(v));
+  EXPECT_TRUE(q.empty());
+
+  // Wrap around
+  for (int i = 0; i < 10; ++i) {
+    q.push(i);
+    EXPECT_TRUE(q.try_pop(v));
+    EXPECT_EQ(i, v);
+  }
+}
+
+TEST(MpmcQueue, Basic)
+{
+  mpmc_queue<int, 4> q;
+  EXPECT_TRUE(q.empty());
+
+  // Use several segments
+  for (int i = 0; i < 100; ++i)
+    q.push(i);
+  EXPECT_FALSE(q.empty());
+
+  int v = 0;
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(q.try_pop(v));
+    EXPECT_EQ(i, v);
+  }
+  EXPECT_FALSE(q.try_pop(v));
+  EXPECT_TRUE(q.empty());
+
+  // Recycled segments
+  for (int j = 0; j < 3; ++j) {
+    for (int i = 0; i < 50; ++i)
+      q.push(i);
+    for (int i = 0; i < 50; ++i) {
+      EXPECT_TRUE(q.try_pop(v));
+      EXPECT_EQ(i, v);
+    }
+  }
+
+  q.push(1);
+  q.push(2);
+  q.clear();
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(MpmcQueue, DestroyElements)
+{
+  auto value = std::make_shared<int>(0);
+  {
+    mpmc_queue<std::shared_ptr<int>, 4> q;
+    bounded_mpmc_queue<std::shared_ptr<int>> b(16);
+    for (int i = 0; i < 10; ++i) {
+      q.push(value);
+      b.push(value);
+    }
+    std::shared_ptr<int> v;
+    EXPECT_TRUE(q.try_pop(v));
+    EXPECT_TRUE(b.try_pop(v));
+    v.reset();
+    EXPECT_EQ(19, value.use_count());
+  }
+  EXPECT_EQ(1, value.use_count());
+}
+
+TEST(MpmcQueue, WaitPop)
+{
+  mpmc_queue<int> q;
+  int v = 0;
+
+  Chrono t;
+  EXPECT_FALSE(q.wait_pop(v, 0.05));
+  EXPECT_GE(t.elapsed(), 0.04);
+
+  std::thread producer([&q] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    q.push(5);
+  });
+  EXPECT_TRUE(q.wait_pop(v, 10.0));
+  EXPECT_EQ(5, v);
+  producer.join();
+}
+
+// Each producer pushes increasing values, a consumer must receive
+// the values of each producer in the same order.
+TEST(MpmcQueue, ProducersOrder)
+{
+  const int kProducers = 4;
+  const int kValues = 20000;
+  mpmc_queue<int, 16> q;
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&q, p] {
+      for (int i = 0; i < kValues; ++i)
+        q.push(p * kValues + i);
+    });
+  }
+
+  std::vector<int> last(kProducers, -1);
+  for (int n = 0; n < kProducers * kValues;) {
+    int v;
+    if (q.wait_pop(v, 1.0)) {
+      const int p = v / kValues;
+      EXPECT_LT(last[p], v % kValues);
+      last[p] = v % kValues;
+      ++n;
+    }
+  }
+  for (auto& t : producers)
+    t.join();
+  EXPECT_TRUE(q.empty());
+}
+
+// Several consumers with small segments (which are recycled all the
+// time): each consumer must receive the values of each producer in
+// the same order (a consumer with a pointer to a recycled head
+// segment must not pop values pushed after the values of the next
+// segments).
+TEST(MpmcQueue, ConsumersOrder)
+{
+  const int kProducers = 4;
+  const int kConsumers = 4;
+  const int kValues = 50000;
+  mpmc_queue<int, 2> q;
+  std::atomic<int> popped(0);
+  std::atomic<int> errors(0);
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < kProducers; ++p) {
+    threads.emplace_back([&q, p] {
+      for (int i = 0; i < kValues; ++i)
+        q.push(p * kValues + i);
+    });
+  }
+  for (int c = 0; c < kConsumers; ++c) {
+    threads.emplace_back([&q, &popped, &errors] {
+      std::vector<int> last(kProducers, -1);
+      int v;
+      while (popped.load() < kProducers * kValues) {
+        if (q.try_pop(v)) {
+          const int p = v / kValues;
+          if (last[p] >= v % kValues)
+            ++errors;
+          last[p] = v % kValues;
+          ++popped;
+        }
+        else
+          std::this_thread::yield();
+      }
+    });
+  }
+  for (auto& t : threads)
+    t.join();
+
+  EXPECT_EQ(0, errors);
+  EXPECT_EQ(kProducers * kValues, popped);
+  EXPECT_TRUE(q.empty());
+}
+
+template<typename Queue>
+static void stress(Queue& q, const int producers, const int consumers, const int values)
+{
+  std::atomic<int64_t> sum(0);
+  std::atomic<int> popped(0);
+  const int total = producers * values;
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&q, values] {
+      for (int i = 1; i <= values; ++i)
+        q.push(i);
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&q, &sum, &popped, total] {
+      int v;
+      while (popped.load() < total) {
+        if (q.try_pop(v)) {
+          sum += v;
+          ++popped;
+        }
+        else
+          std::this_thread::yield();
+      }
+    });
+  }
+  for (auto& t : threads)
+    t.join();
+
+  EXPECT_EQ(total, popped);
+  EXPECT_EQ(int64_t(producers) * values * (values + 1) / 2, sum);
+}
+
+TEST(MpmcQueue, Stress)
+{
+  bounded_mpmc_queue<int> b(64);
+  stress(b, 4, 4, 20000);
+  EXPECT_TRUE(b.empty());
+
+  mpmc_queue<int, 8> q;
+  stress(q, 4, 4, 20000);
+  EXPECT_TRUE(q.empty());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,101 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/object_pool.h"
+
+#include "base/memory.h"
+
+#include <algorithm>
+
+namespace base {
+
+object_pool::object_pool(const size_t objectSize,
+                         const size_t objectAlignment,
+                         const size_t objectsPerChunk)
+  : m_objectSize(objectSize)
+  , m_alignment(std::max(objectAlignment, alignof(free_node)))
+  , m_slotSize(base_align_size(std::max(objectSize, sizeof(free_node)), m_alignment))
+  , m_objectsPerChunk(std::max<size_t>(objectsPerChunk, 1))
+{
+  // The alignment must be a power of two
+  ASSERT(objectAlignment > 0 && (objectAlignment & (objectAlignment - 1)) == 0);
+}
+
+object_pool::~object_pool()
+{
+  // All objects should be deallocated before destroying the pool
+  ASSERT(m_size == 0);
+  release();
+}
+
+void object_pool::release()
+{
+  ASSERT(m_size == 0);
+  for (void* chunk : m_chunks)
+    base_aligned_free(chunk);
+  m_chunks.clear();
+  m_free = nullptr;
+  m_size = 0;
+}
+
+void* object_pool::do_allocate(const size_t bytes, const size_t alignment)
+{
+  if (!fits(bytes, alignment)) {
+    void* p = base_aligned_alloc(bytes, std::max(alignment, base_alignment));
+    if (!p)
+      throw std::bad_alloc();
+    return p;
+  }
+
+  if (!m_free)
+    add_chunk();
+
+  free_node* node = m_free;
+  m_free = node->next;
+  ++m_size;
+  return node;
+}
+
+void object_pool::do_deallocate(void* p, const size_t bytes, const size_t alignment)
+{
+  if (!fits(bytes, alignment)) {
+    base_aligned_free(p);
+    return;
+  }
+
+  ASSERT(m_size > 0);
+  auto node = static_cast<free_node*>(p);
+  node->next = m_free;
+  m_free = node;
+  --m_size;
+}
+
+bool object_pool::do_is_equal(const memory_resource& other) const noexcept
+{
+  return (this == &other);
+}
+
+void object_pool::add_chunk()
+{
+  char* chunk = static_cast<char*>(base_aligned_alloc(m_slotSize * m_objectsPerChunk, m_alignment));
+  if (!chunk)
+    throw std::bad_alloc();
+  m_chunks.push_back(chunk);
+
+  // Add the objects to the free list in order, so consecutive
+  // allocations are contiguous in memory.
+  for (size_t i = m_objectsPerChunk; i > 0; --i) {
+    auto node = reinterpret_cast<free_node*>(chunk + (i - 1) * m_slotSize);
+    node->next = m_free;
+    m_free = node;
+  }
+}
+
+} // namespace base
@@ -0,0 +1,101 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_OBJECT_POOL_H_INCLUDED
+#define BASE_OBJECT_POOL_H_INCLUDED
+#pragma once
+
+#include "base/debug.h"
+#include "base/disable_copying.h"
+#include "base/memory_resource.h"
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace base {
+
+// Pool of fixed-size memory blocks (objects). Blocks are allocated
+// in chunks of "objectsPerChunk" objects, and deallocated blocks are
+// kept in a free list to be reused by the next allocation. Chunks
+// are returned to the heap only when the pool is destroyed (or
+// release() is called).
+//
+// It can be used as a std::pmr memory resource for node-based
+// containers (e.g. std::pmr::list); allocations bigger than the
+// object size (or with a bigger alignment) go directly to the heap.
+//
+// It's not thread-safe.
+class object_pool : public memory_resource {
+public:
+  explicit object_pool(size_t objectSize,
+                       size_t objectAlignment = alignof(std::max_align_t),
+                       size_t objectsPerChunk = 64);
+  ~object_pool();
+
+  template<typename T, typename... Args>
+  T* make(Args&&... args)
+  {
+    static_assert(alignof(T) <= alignof(std::max_align_t));
+    ASSERT(sizeof(T) <= m_objectSize);
+    void* p = allocate(sizeof(T), alignof(T));
+    try {
+      return new (p) T(std::forward<Args>(args)...);
+    }
+    catch (...) {
+      deallocate(p, sizeof(T), alignof(T));
+      throw;
+    }
+  }
+
+  template<typename T>
+  void destroy(T* p)
+  {
+    if (p) {
+      p->~T();
+      deallocate(p, sizeof(T), alignof(T));
+    }
+  }
+
+  size_t object_size() const { return m_objectSize; }
+
+  // Number of objects allocated from the pool (not yet deallocated).
+  size_t size() const { return m_size; }
+
+  // Returns all chunks to the heap. All objects must be deallocated.
+  void release();
+
+private:
+  struct free_node {
+    free_node* next;
+  };
+
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const memory_resource& other) const noexcept override;
+
+  bool fits(size_t bytes, size_t alignment) const
+  {
+    return (bytes <= m_objectSize && alignment <= m_alignment);
+  }
+
+  void add_chunk();
+
+  const size_t m_objectSize;
+  const size_t m_alignment;
+  const size_t m_slotSize; // Object size rounded to the alignment
+  const size_t m_objectsPerChunk;
+  free_node* m_free = nullptr;
+  std::vector<void*> m_chunks;
+  size_t m_size = 0;
+
+  DISABLE_COPYING(object_pool);
+};
+
+} // namespace base
+
+#endif
@@ -0,0 +1,83 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/object_pool.h"
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+#if HAVE_MEMORY_RESOURCE
+  #include <list>
+#endif
+
+using namespace base;
+
+TEST(ObjectPool, Basic)
+{
+  object_pool pool(sizeof(std::string), alignof(std::string), 8);
+  EXPECT_EQ(0, pool.size());
+
+  std::vector<std::string*> v;
+  std::set<std::string*> addrs;
+  for (int i = 0; i < 20; ++i) {
+    v.push_back(pool.make<std::string>(std::to_string(i)));
+    addrs.insert(v.back());
+  }
+  EXPECT_EQ(20, pool.size());
+  EXPECT_EQ(20, addrs.size());
+  for (int i = 0; i < 20; ++i)
+    EXPECT_EQ(std::to_string(i), *v[i]);
+
+  // Deallocated objects are reused
+  std::string* last = v.back();
+  v.pop_back();
+  pool.destroy(last);
+  EXPECT_EQ(19, pool.size());
+  EXPECT_EQ(last, pool.make<std::string>("reused"));
+  EXPECT_EQ("reused", *last);
+  v.push_back(last);
+
+  for (auto* s : v)
+    pool.destroy(s);
+  EXPECT_EQ(0, pool.size());
+}
+
+TEST(ObjectPool, BigAllocations)
+{
+  object_pool pool(16, 16);
+  void* p = pool.allocate(16, 16);
+  void* q = pool.allocate(1000, 8);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) & 15);
+  EXPECT_EQ(1, pool.size()); // The big one is allocated from the heap
+  pool.deallocate(q, 1000, 8);
+  pool.deallocate(p, 16, 16);
+  EXPECT_EQ(0, pool.size());
+}
+
+#if HAVE_MEMORY_RESOURCE
+TEST(ObjectPool, PmrList)
+{
+  object_pool pool(64);
+  {
+    std::pmr::list<int> l(&pool);
+    for (int i = 0; i < 100; ++i)
+      l.push_back(i);
+    EXPECT_EQ(100, pool.size());
+    EXPECT_EQ(99, l.back());
+  }
+  EXPECT_EQ(0, pool.size());
+}
+#endif
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,252 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_PARALLEL_H_INCLUDED
+#define BASE_PARALLEL_H_INCLUDED
+#pragma once
+
+#include "base/latch.h"
+#include "base/task.h"
+#include "base/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace base {
+
+namespace details {
+
+// State shared between the calling thread and the helper works of
+// one parallel_for()/parallel_reduce() call. Helper works can start
+// after the call returns, so this is owned by a std::shared_ptr, and
+// the function/token are only accessed after claiming a chunk (the
+// call cannot return while there are claimed chunks not counted
+// down in the latch).
+template<typename Func>
+class parallel_state {
+public:
+  parallel_state(const size_t begin,
+                 const size_t end,
+                 const size_t grain,
+                 const size_t participants,
+                 Func& func,
+                 task_token* token)
+    : m_next(begin)
+    , m_end(end)
+    , m_grain(grain)
+    , m_participants(participants)
+    , m_pending(ptrdiff_t(end - begin))
+    , m_func(func)
+    , m_token(token)
+  {
+  }
+
+  // Processes chunks until there is nothing else to do.
+  void run(const size_t participant)
+  {
+    size_t b, e;
+    while (claim(b, e)) {
+      size_t done = e - b;
+      if (m_token && m_token->canceled()) {
+        done += cancel_rest();
+      }
+      else {
+        try {
+          m_func(participant, b, e);
+        }
+        catch (...) {
+          {
+            const std::lock_guard lock(m_mutex);
+            if (!m_error)
+              m_error = std::current_exception();
+          }
+          done += cancel_rest();
+        }
+      }
+      m_pending.count_down(ptrdiff_t(done));
+    }
+  }
+
+  void wait() { m_pending.wait(); }
+
+  // Re-throws the first exception thrown by the function (if any).
+  void rethrow_error()
+  {
+    if (m_error)
+      std::rethrow_exception(m_error);
+  }
+
+private:
+  // Claims the next chunk of elements [b, e). The size of each chunk
+  // is adaptive: big chunks at the beginning (to reduce the overhead
+  // of claiming chunks), smaller ones at the end (to balance the
+  // work between participants), and never smaller than the grain.
+  bool claim(size_t& b, size_t& e)
+  {
+    size_t cur = m_next.load(std::memory_order_relaxed);
+    while (cur < m_end) {
+      const size_t remaining = m_end - cur;
+      const size_t n = std::min(remaining, std::max(m_grain, remaining / (2 * m_participants)));
+      if (m_next.compare_exchange_weak(cur, cur + n, std::memory_order_relaxed)) {
+        b = cur;
+        e = cur + n;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Claims all the remaining elements (to skip them), returns the
+  // number of claimed elements.
+  size_t cancel_rest()
+  {
+    const size_t cur = m_next.exchange(m_end, std::memory_order_relaxed);
+    return (cur < m_end ? m_end - cur : 0);
+  }
+
+  std::atomic<size_t> m_next;
+  const size_t m_end;
+  const size_t m_grain;
+  const size_t m_participants;
+  latch m_pending; // Number of elements not yet processed
+  Func& m_func;
+  task_token* m_token;
+  std::mutex m_mutex;
+  std::exception_ptr m_error;
+};
+
+// Calls func(participant, b, e) for chunks of [begin, end) using the
+// calling thread (participant=0) and helper works in the pool
+// (participant=1...n-1) where n is the returned value of
+// parallel_participants().
+template<typename Func>
+void parallel_run(thread_pool& pool,
+                  const size_t begin,
+                  const size_t end,
+                  const size_t grain,
+                  const size_t participants,
+                  Func& func,
+                  task_token* token)
+{
+  if (begin >= end)
+    return;
+
+  if (participants <= 1) {
+    if (!token || !token->canceled())
+      func(size_t(0), begin, end);
+    return;
+  }
+
+  auto state = std::make_shared<parallel_state<Func>>(begin,
+                                                      end,
+                                                      grain,
+                                                      participants,
+                                                      func,
+                                                      token);
+  for (size_t i = 1; i < participants; ++i)
+    pool.execute([state, i] { state->run(i); });
+
+  state->run(0);
+  state->wait();
+  state->rethrow_error();
+}
+
+inline size_t parallel_participants(const thread_pool& pool,
+                                    const size_t begin,
+                                    const size_t end,
+                                    size_t& grain)
+{
+  if (grain == 0)
+    grain = 1;
+  const size_t n = (end > begin ? end - begin : 0);
+  const size_t chunks = (n + grain - 1) / grain;
+  return std::min(pool.size() + 1, chunks);
+}
+
+} // namespace details
+
+// Calls func(b, e) for consecutive sub-ranges [b, e) of [begin, end)
+// in parallel using the calling thread and the workers of the given
+// thread pool. Each sub-range has at least "grain" elements (except
+// the last one). Only waits for the works of this call (not all the
+// works of the pool), so it can be used from a worker of the same
+// pool. If the token is canceled, the rest of the range is skipped.
+// If func throws an exception, the rest of the range is skipped and
+// the exception is re-thrown in the calling thread.
+//
+// E.g. To process the rows of an image:
+//
+//   base::parallel_for(pool, 0, h, 16, [&](size_t y0, size_t y1) {
+//     for (size_t y = y0; y < y1; ++y)
+//       process_row(y);
+//   });
+//
+template<typename Func>
+void parallel_for(thread_pool& pool,
+                  const size_t begin,
+                  const size_t end,
+                  size_t grain,
+                  Func&& func,
+                  task_token* token = nullptr)
+{
+  const size_t participants = details::parallel_participants(pool, begin, end, grain);
+  auto f = [&func](size_t, size_t b, size_t e) { func(b, e); };
+  details::parallel_run(pool, begin, end, grain, participants, f, token);
+}
+
+// Reduces the range [begin, end) in parallel. Each participant
+// starts with a copy of "identity" and accumulates sub-ranges calling
+// "acc = func(b, e, acc)", then the partial results are merged with
+// "combine(a, b)" in the calling thread. As the sub-ranges processed
+// by each participant are not consecutive, "combine" must be
+// associative and commutative.
+//
+// E.g. To sum all elements of a vector:
+//
+//   int sum = base::parallel_reduce(pool, 0, v.size(), 1024, 0,
+//     [&](size_t b, size_t e, int acc) {
+//       for (size_t i = b; i < e; ++i)
+//         acc += v[i];
+//       return acc;
+//     },
+//     [](int a, int b) { return a + b; });
+//
+template<typename T, typename Func, typename Combine>
+T parallel_reduce(thread_pool& pool,
+                  const size_t begin,
+                  const size_t end,
+                  size_t grain,
+                  const T& identity,
+                  Func&& func,
+                  Combine&& combine,
+                  task_token* token = nullptr)
+{
+  const size_t participants = details::parallel_participants(pool, begin, end, grain);
+  // Each partial result in its own cache line to avoid false sharing
+  struct alignas(64) partial {
+    T value;
+  };
+  std::vector<partial> partials(std::max<size_t>(participants, 1), partial{ identity });
+  auto f = [&func, &partials](size_t p, size_t b, size_t e) {
+    partials[p].value = func(b, e, std::move(partials[p].value));
+  };
+  details::parallel_run(pool, begin, end, grain, participants, f, token);
+
+  T result = std::move(partials[0].value);
+  for (size_t i = 1; i < partials.size(); ++i)
+    result = combine(std::move(result), std::move(partials[i].value));
+  return result;
+}
+
+} // namespace base
+
+#endif
@@ -0,0 +1,145 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/parallel.h"
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace base;
+
+TEST(ParallelFor, VisitsEachElementOnce)
+{
+  thread_pool pool(4);
+  for (const size_t grain : { 1, 7, 100, 5000 }) {
+    std::vector<std::atomic<int>> v(1000);
+    for (auto& x : v)
+      x = 0;
+
+    parallel_for(pool, 0, v.size(), grain, [&](size_t b, size_t e) {
+      EXPECT_LT(b, e);
+      for (size_t i = b; i < e; ++i)
+        ++v[i];
+    });
+    for (auto& x : v)
+      EXPECT_EQ(1, x);
+  }
+}
+
+TEST(ParallelFor, EmptyRange)
+{
+  thread_pool pool(2);
+  int calls = 0;
+  parallel_for(pool, 10, 10, 1, [&](size_t, size_t) { ++calls; });
+  EXPECT_EQ(0, calls);
+}
+
+TEST(ParallelFor, Nested)
+{
+  // Nested calls from workers of the same pool must not deadlock
+  for (const auto mode : { thread_pool::mode::SHARED_QUEUE, thread_pool::mode::WORK_STEALING }) {
+    thread_pool pool(2, mode);
+    std::atomic<int> c(0);
+    parallel_for(pool, 0, 16, 1, [&](size_t b, size_t e) {
+      for (size_t i = b; i < e; ++i) {
+        parallel_for(pool, 0, 100, 10, [&](size_t b2, size_t e2) { c += int(e2 - b2); });
+      }
+    });
+    EXPECT_EQ(1600, c);
+  }
+}
+
+TEST(ParallelFor, Cancel)
+{
+  thread_pool pool(4);
+  task_token token;
+  std::atomic<size_t> c(0);
+  parallel_for(
+    pool,
+    0,
+    100000,
+    10,
+    [&](size_t b, size_t e) {
+      c += e - b;
+      if (c > 1000)
+        token.cancel();
+    },
+    &token);
+  EXPECT_TRUE(token.canceled());
+  EXPECT_LT(c, 100000);
+
+  // Already canceled
+  c = 0;
+  parallel_for(pool, 0, 100, 1, [&](size_t b, size_t e) { c += e - b; }, &token);
+  EXPECT_EQ(0, c);
+}
+
+TEST(ParallelFor, Exception)
+{
+  thread_pool pool(4);
+  EXPECT_THROW(parallel_for(pool,
+                            0,
+                            1000,
+                            1,
+                            [](size_t b, size_t e) {
+                              if (b <= 500 && 500 < e)
+                                throw std::runtime_error("error");
+                            }),
+               std::runtime_error);
+}
+
+TEST(ParallelReduce, Sum)
+{
+  thread_pool pool(4);
+  std::vector<int> v(100000);
+  std::iota(v.begin(), v.end(), 0);
+
+  for (const size_t grain : { 1, 64, 1000000 }) {
+    const int64_t sum = parallel_reduce(
+      pool,
+      0,
+      v.size(),
+      grain,
+      int64_t(0),
+      [&](size_t b, size_t e, int64_t acc) {
+        for (size_t i = b; i < e; ++i)
+          acc += v[i];
+        return acc;
+      },
+      [](int64_t a, int64_t b) { return a + b; });
+    EXPECT_EQ(int64_t(v.size()) * (v.size() - 1) / 2, sum);
+  }
+}
+
+TEST(ParallelReduce, Max)
+{
+  thread_pool pool(3);
+  std::vector<int> v(5000, 1);
+  v[4321] = 99;
+  const int result = parallel_reduce(
+    pool,
+    0,
+    v.size(),
+    16,
+    0,
+    [&](size_t b, size_t e, int acc) {
+      for (size_t i = b; i < e; ++i)
+        acc = std::max(acc, v[i]);
+      return acc;
+    },
+    [](int a, int b) { return std::max(a, b); });
+  EXPECT_EQ(99, result);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
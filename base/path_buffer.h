@@ -0,0 +1,165 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_PATH_BUFFER_H_INCLUDED
+#define BASE_PATH_BUFFER_H_INCLUDED
+#pragma once
+
+#include "base/debug.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace base {
+
+// String buffer to build paths without allocating memory. Paths of up
+// to kInlineCapacity characters are stored inside the object (e.g. in
+// the stack), longer paths use the heap. The content is always
+// null-terminated, so c_str() can be used with system functions.
+//
+//   base::path_buffer fn(dir);
+//   base::join_path(fn, name);
+//   FILE* f = std::fopen(fn.c_str(), "rb");
+//
+class path_buffer {
+public:
+  static constexpr size_t kInlineCapacity = 259;
+
+  path_buffer() { m_inline[0] = 0; }
+  path_buffer(const std::string_view str) : path_buffer() { append(str); }
+  path_buffer(const path_buffer& other) : path_buffer() { append(other.view()); }
+
+  path_buffer& operator=(const path_buffer& other)
+  {
+    if (this != &other)
+      assign(other.view());
+    return *this;
+  }
+
+  path_buffer& operator=(const std::string_view str)
+  {
+    assign(str);
+    return *this;
+  }
+
+  const char* c_str() const { return m_ptr; }
+  const char* data() const { return m_ptr; }
+  char* data() { return m_ptr; }
+  size_t size() const { return m_size; }
+  size_t capacity() const { return m_capacity; }
+  bool empty() const { return m_size == 0; }
+
+  // Returns true if the content is stored in the heap.
+  bool is_heap() const { return m_ptr != m_inline; }
+
+  char operator[](const size_t i) const { return m_ptr[i]; }
+  char back() const
+  {
+    ASSERT(m_size > 0);
+    return m_ptr[m_size - 1];
+  }
+
+  std::string_view view() const { return std::string_view(m_ptr, m_size); }
+  operator std::string_view() const { return view(); }
+  std::string str() const { return std::string(m_ptr, m_size); }
+
+  void clear() { resize(0); }
+
+  // Only to make the buffer smaller.
+  void resize(const size_t n)
+  {
+    ASSERT(n <= m_size);
+    m_size = n;
+    m_ptr[n] = 0;
+  }
+
+  void pop_back()
+  {
+    ASSERT(m_size > 0);
+    resize(m_size - 1);
+  }
+
+  void push_back(const char chr)
+  {
+    if (m_size == m_capacity)
+      grow(m_size + 1, std::string_view());
+    m_ptr[m_size++] = chr;
+    m_ptr[m_size] = 0;
+  }
+
+  // "str" can be a part of this same buffer.
+  void append(const std::string_view str)
+  {
+    if (m_size + str.size() > m_capacity) {
+      grow(m_size + str.size(), str);
+      return;
+    }
+    if (!str.empty())
+      std::memmove(m_ptr + m_size, str.data(), str.size());
+    m_size += str.size();
+    m_ptr[m_size] = 0;
+  }
+
+  void assign(const std::string_view str)
+  {
+    if (str.data() == m_ptr) {
+      resize(str.size());
+      return;
+    }
+    // If "str" is bigger than the capacity it cannot be inside this
+    // buffer, in other case memmove() handles the overlap.
+    if (str.size() > m_capacity) {
+      m_size = 0;
+      grow(str.size(), str);
+      return;
+    }
+    if (!str.empty())
+      std::memmove(m_ptr, str.data(), str.size());
+    m_size = str.size();
+    m_ptr[m_size] = 0;
+  }
+
+  void reserve(const size_t n)
+  {
+    if (n > m_capacity)
+      grow(n, std::string_view());
+  }
+
+  bool operator==(const std::string_view str) const { return view() == str; }
+  bool operator!=(const std::string_view str) const { return view() != str; }
+
+private:
+  // Moves the content to a bigger heap buffer and appends "str" to it
+  // (before releasing the old buffer, as "str" can be part of it).
+  void grow(const size_t n, const std::string_view str)
+  {
+    const size_t capacity = std::max(n, 2 * m_capacity);
+    std::unique_ptr<char[]> heap(new char[capacity + 1]);
+    std::memcpy(heap.get(), m_ptr, m_size);
+    if (!str.empty())
+      std::memcpy(heap.get() + m_size, str.data(), str.size());
+    m_size += str.size();
+    heap[m_size] = 0;
+
+    m_heap = std::move(heap);
+    m_ptr = m_heap.get();
+    m_capacity = capacity;
+  }
+
+  char* m_ptr = m_inline;
+  size_t m_size = 0;
+  size_t m_capacity = kInlineCapacity;
+  std::unique_ptr<char[]> m_heap;
+  char m_inline[kInlineCapacity + 1];
+};
+
+} // namespace base
+
+#endif
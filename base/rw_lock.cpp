@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2020-2025  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2016  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,9 +12,8 @@
 #include "base/rw_lock.h"
 
 #include "base/debug.h"
-#include "base/thread.h"
 
-#include <algorithm>
+#include <chrono>
 
 // Uncomment this line in case that you want TRACEARGS() lock/unlock
 // operations.
@@ -50,21 +49,18 @@ bool RWLock::canWriteLockFromRead() const
 
 RWLock::LockResult RWLock::lock(LockType lockType, int timeout)
 {
+  std::unique_lock lock(m_mutex);
+
   // Check for re-entrant write locks (multiple write-lock in the same
   // thread are allowed, even a read lock if we are writing in the
   // same thread).
-  // if (lockType == WriteLock) {
-  {
-    const std::lock_guard lock(m_mutex);
-    if (m_write_lock && m_write_thread == std::this_thread::get_id()) {
-      return LockResult::Reentrant;
-    }
+  if (m_write_lock && m_write_thread == std::this_thread::get_id()) {
+    return LockResult::Reentrant;
   }
 
-  while (timeout >= 0) {
-    {
-      const std::lock_guard lock(m_mutex);
-
+  if (timeout >= 0) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    while (true) {
       switch (lockType) {
         case ReadLock:
           // If no body is writing the object...
@@ -77,15 +73,8 @@ RWLock::LockResult RWLock::lock(LockType lockType, int timeout)
 
         case WriteLock:
           // Check that there is no weak lock
-          if (m_weak_lock) {
-            if (*m_weak_lock == WeakLocked)
-              *m_weak_lock = WeakUnlocking;
-
-            if (*m_weak_lock == WeakUnlocking)
-              goto go_wait;
-
-            ASSERT(*m_weak_lock == WeakUnlocked);
-          }
+          if (!releaseWeakLock())
+            break;
 
           // If no body is reading and writing...
           if (m_read_locks == 0 && !m_write_lock) {
@@ -99,18 +88,13 @@ RWLock::LockResult RWLock::lock(LockType lockType, int timeout)
           break;
       }
 
-    go_wait:;
-    }
-
-    if (timeout > 0) {
-      const int delay = std::min(100, timeout);
-      timeout -= delay;
+      // Wait until other thread unlocks the object (or the timeout)
+      if (timeout == 0 || std::chrono::steady_clock::now() >= deadline)
+        break;
 
-      LCK_TRACE("LCK: lock: wait 100 msecs for", this);
-      base::this_thread::sleep_for(double(delay) / 1000.0);
+      LCK_TRACE("LCK: lock: wait for", this);
+      m_cv.wait_until(lock, deadline);
     }
-    else
-      break;
   }
 
   LCK_TRACE("LCK: lock: Cannot lock",
@@ -130,14 +114,18 @@ void RWLock::downgradeToRead(LockResult lockResult)
   if (lockResult != LockResult::OK)
     return; // Do nothing for failed or reentrant locks
 
-  const std::lock_guard lock(m_mutex);
+  {
+    const std::lock_guard lock(m_mutex);
 
-  ASSERT(m_read_locks == 0);
-  ASSERT(m_write_lock);
+    ASSERT(m_read_locks == 0);
+    ASSERT(m_write_lock);
 
-  m_write_lock = false;
-  m_write_thread = std::thread::id();
-  m_read_locks = 1;
+    m_write_lock = false;
+    m_write_thread = std::thread::id();
+    m_read_locks = 1;
+  }
+  // Wake up readers
+  m_cv.notify_all();
 }
 
 void RWLock::unlock(LockResult lockResult)
@@ -145,18 +133,21 @@ void RWLock::unlock(LockResult lockResult)
   if (lockResult != LockResult::OK)
     return; // Do nothing for failed or reentrant locks
 
-  const std::lock_guard lock(m_mutex);
+  {
+    const std::lock_guard lock(m_mutex);
 
-  if (m_write_lock) {
-    m_write_lock = false;
-    m_write_thread = std::thread::id();
-  }
-  else if (m_read_locks > 0) {
-    --m_read_locks;
-  }
-  else {
-    ASSERT(false);
+    if (m_write_lock) {
+      m_write_lock = false;
+      m_write_thread = std::thread::id();
+    }
+    else if (m_read_locks > 0) {
+      --m_read_locks;
+    }
+    else {
+      ASSERT(false);
+    }
   }
+  m_cv.notify_all();
 }
 
 bool RWLock::weakLock(std::atomic<WeakLock>* weak_lock_flag)
@@ -173,47 +164,38 @@ bool RWLock::weakLock(std::atomic<WeakLock>* weak_lock_flag)
 
 void RWLock::weakUnlock()
 {
-  const std::lock_guard lock(m_mutex);
+  {
+    const std::lock_guard lock(m_mutex);
 
-  ASSERT(m_weak_lock);
-  ASSERT(*m_weak_lock != WeakLock::WeakUnlocked);
-  ASSERT(!m_write_lock);
+    ASSERT(m_weak_lock);
+    ASSERT(*m_weak_lock != WeakLock::WeakUnlocked);
+    ASSERT(!m_write_lock);
 
-  if (m_weak_lock) {
-    *m_weak_lock = WeakLock::WeakUnlocked;
-    m_weak_lock = nullptr;
+    if (m_weak_lock) {
+      *m_weak_lock = WeakLock::WeakUnlocked;
+      m_weak_lock = nullptr;
+    }
   }
+  // Wake up writers waiting the weak lock
+  m_cv.notify_all();
 }
 
 RWLock::LockResult RWLock::upgradeToWrite(int timeout)
 {
+  std::unique_lock lock(m_mutex);
+
   // Check for re-entrant upgrade to write (multiple write-lock in the
   // same thread are allowed).
-  {
-    const std::lock_guard lock(m_mutex);
-    if (m_write_lock && m_write_thread == std::this_thread::get_id()) {
-      return LockResult::Reentrant;
-    }
+  if (m_write_lock && m_write_thread == std::this_thread::get_id()) {
+    return LockResult::Reentrant;
   }
 
-  while (timeout >= 0) {
-    {
-      const std::lock_guard lock(m_mutex);
-
-      // Check that there is no weak lock
-      if (m_weak_lock) {
-        if (*m_weak_lock == WeakLocked)
-          *m_weak_lock = WeakUnlocking;
-
-        // Wait some time
-        if (*m_weak_lock == WeakUnlocking)
-          goto go_wait;
-
-        ASSERT(*m_weak_lock == WeakUnlocked);
-      }
-
-      // this only is possible if there are just one reader
-      if (m_read_locks == 1) {
+  if (timeout >= 0) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    while (true) {
+      // Check that there is no weak lock, and this only is possible
+      // if there are just one reader
+      if (releaseWeakLock() && m_read_locks == 1) {
         ASSERT(!m_write_lock);
         m_read_locks = 0;
         m_write_lock = true;
@@ -223,18 +205,13 @@ RWLock::LockResult RWLock::upgradeToWrite(int timeout)
         return LockResult::OK;
       }
 
-    go_wait:;
-    }
+      // Wait until other readers unlock the object (or the timeout)
+      if (timeout == 0 || std::chrono::steady_clock::now() >= deadline)
+        break;
 
-    if (timeout > 0) {
-      const int delay = std::min(100, timeout);
-      timeout -= delay;
-
-      LCK_TRACE("LCK: upgradeToWrite: wait 100 msecs for", this);
-      base::this_thread::sleep_for(double(delay) / 1000.0);
+      LCK_TRACE("LCK: upgradeToWrite: wait for", this);
+      m_cv.wait_until(lock, deadline);
     }
-    else
-      break;
   }
 
   LCK_TRACE("LCK: upgradeToWrite: Cannot lock",
@@ -247,6 +224,22 @@ RWLock::LockResult RWLock::upgradeToWrite(int timeout)
   return LockResult::Fail;
 }
 
+// Asks the owner of the weak lock (if any) to release it. Returns
+// true if there is no weak lock (so we can lock for writing).
+bool RWLock::releaseWeakLock()
+{
+  if (m_weak_lock) {
+    if (*m_weak_lock == WeakLocked)
+      *m_weak_lock = WeakUnlocking;
+
+    if (*m_weak_lock == WeakUnlocking)
+      return false;
+
+    ASSERT(*m_weak_lock == WeakUnlocked);
+  }
+  return true;
+}
+
 void RWLock::updateWriterThread()
 {
   const std::lock_guard lock(m_mutex);
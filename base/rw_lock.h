@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2020-2025  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2016  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,6 +12,7 @@
 #include "base/disable_copying.h"
 
 #include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <thread>
 
@@ -48,7 +49,8 @@ public:
   // Locks the object to read or write on it, returning OK if the
   // object can be accessed in the desired mode, ReentrantLock if
   // the mode is compatible with the thread that locked this object,
-  // or Failed if the mode is incompatible.
+  // or Failed if the mode is incompatible. If the object is locked,
+  // it waits up to "timeout" milliseconds until it's unlocked.
   LockResult lock(LockType lockType, int timeout);
 
   // If you've locked the object to read, using this method you can
@@ -78,9 +80,15 @@ public:
   void weakUnlock();
 
 private:
+  bool releaseWeakLock();
+
   // Mutex to modify the 'locked' flag.
   mutable std::mutex m_mutex;
 
+  // Notified each time the lock is released (or downgraded) so
+  // threads waiting in lock()/upgradeToWrite() can try again.
+  std::condition_variable m_cv;
+
   // True if some thread is writing the object.
   bool m_write_lock = false;
   std::thread::id m_write_thread = {};
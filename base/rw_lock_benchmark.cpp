@@ -0,0 +1,70 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/rw_lock.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace base;
+using LockResult = RWLock::LockResult;
+
+#define EXPECT_OK(a) EXPECT_EQ(LockResult::OK, a)
+
+// Measures the time between unlocking the "holdType" lock in one
+// thread and acquiring the "waitType" lock in other thread that was
+// waiting for it. Returns the median of several measures in seconds.
+static double handoff_latency(RWLock::LockType holdType, RWLock::LockType waitType)
+{
+  using clock = std::chrono::steady_clock;
+  RWLock a;
+  std::vector<double> times;
+  for (int i = 0; i < 20; ++i) {
+    LockResult res;
+    EXPECT_OK(res = a.lock(holdType, 0));
+
+    std::atomic<bool> waiting(false);
+    clock::time_point unlockTime;
+    std::thread t([&] {
+      waiting = true;
+      LockResult res2;
+      EXPECT_OK(res2 = a.lock(waitType, 1000));
+      times.push_back(std::chrono::duration<double>(clock::now() - unlockTime).count());
+      a.unlock(res2);
+    });
+    while (!waiting)
+      std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    unlockTime = clock::now();
+    a.unlock(res);
+    t.join();
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+// Wall-clock latencies depend on the machine load, so they are just reported.
+TEST(RWLock, HandoffLatencyBenchmark)
+{
+  std::printf("Write -> Read handoff: %.1f us\n",
+              handoff_latency(RWLock::WriteLock, RWLock::ReadLock) * 1e6);
+  std::printf("Read -> Write handoff: %.1f us\n",
+              handoff_latency(RWLock::ReadLock, RWLock::WriteLock) * 1e6);
+  std::printf("Write -> Write handoff: %.1f us\n",
+              handoff_latency(RWLock::WriteLock, RWLock::WriteLock) * 1e6);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
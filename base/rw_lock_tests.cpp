@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2020 Igara Studio S.A.
+// Copyright (c) 2020-2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,6 +9,8 @@
 
 #include "base/rw_lock.h"
 
+#include <atomic>
+#include <chrono>
 #include <thread>
 
 using namespace base;
@@ -105,6 +107,67 @@ TEST(RWLock, WeakLock)
   a.unlock(res[0]); // Unlock the write lock
 }
 
+TEST(RWLock, UpgradeHandoffLatency)
+{
+  using clock = std::chrono::steady_clock;
+  RWLock a;
+  LockResult res[2];
+  EXPECT_OK(res[0] = a.lock(RWLock::ReadLock, 0));
+  EXPECT_OK(res[1] = a.lock(RWLock::ReadLock, 0));
+
+  clock::time_point unlockTime;
+  std::thread t([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    unlockTime = clock::now();
+    a.unlock(res[1]);
+  });
+  EXPECT_OK(res[1] = a.upgradeToWrite(1000));
+  const double elapsed = std::chrono::duration<double>(clock::now() - unlockTime).count();
+  t.join();
+  EXPECT_LT(elapsed, 0.01);
+  a.unlock(res[1]);
+}
+
+TEST(RWLock, WeakUnlockWakesWriter)
+{
+  RWLock a;
+  std::atomic<RWLock::WeakLock> flag(RWLock::WeakUnlocked);
+  EXPECT_TRUE(a.weakLock(&flag));
+
+  // Background thread that releases the weak lock when it's requested
+  std::thread t([&] {
+    while (flag != RWLock::WeakUnlocking)
+      std::this_thread::yield();
+    a.weakUnlock();
+  });
+
+  const auto start = std::chrono::steady_clock::now();
+  LockResult res;
+  EXPECT_OK(res = a.lock(RWLock::WriteLock, 1000));
+  const double elapsed =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  t.join();
+  EXPECT_LT(elapsed, 0.05);
+  EXPECT_EQ(RWLock::WeakUnlocked, flag);
+  a.unlock(res);
+}
+
+TEST(RWLock, Timeout)
+{
+  RWLock a;
+  LockResult res;
+  EXPECT_OK(res = a.lock(RWLock::WriteLock, 0));
+  std::thread t([&a] {
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FAIL(a.lock(RWLock::ReadLock, 20));
+    const double elapsed =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_GE(elapsed, 0.019);
+  });
+  t.join();
+  a.unlock(res);
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
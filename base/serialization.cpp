@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -10,10 +11,182 @@
 
 #include "base/serialization.h"
 
+#include "base/cpu_features.h"
+#include "base/debug.h"
+#include "base/mapped_file.h"
+
 #include <iostream>
 
 namespace base { namespace serialization {
 
+//////////////////////////////////////////////////////////////////////
+// byteswap_copy
+
+template<typename T>
+static void byteswap_copy_scalar(uint8_t* dst, const uint8_t* src, const size_t n)
+{
+  for (size_t i = 0; i < n; ++i, dst += sizeof(T), src += sizeof(T)) {
+    T v;
+    std::memcpy(&v, src, sizeof(T));
+    v = byteswap(v);
+    std::memcpy(dst, &v, sizeof(T));
+  }
+}
+
+static void byteswap_copy_scalar(uint8_t* dst, const uint8_t* src, size_t elemSize, size_t n)
+{
+  switch (elemSize) {
+    case 2: byteswap_copy_scalar<uint16_t>(dst, src, n); break;
+    case 4: byteswap_copy_scalar<uint32_t>(dst, src, n); break;
+    case 8: byteswap_copy_scalar<uint64_t>(dst, src, n); break;
+  }
+}
+
+#if LAF_X86
+
+// Returns the shuffle mask (for pshufb) to reverse the bytes of
+// each element in a 16-byte lane.
+static const int8_t* byteswap_mask(const size_t elemSize)
+{
+  alignas(16) static const int8_t masks[3][16] = {
+    { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 },
+    { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 },
+    { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 },
+  };
+  return masks[elemSize == 2 ? 0 : (elemSize == 4 ? 1 : 2)];
+}
+
+LAF_TARGET("ssse3")
+static size_t byteswap_copy_ssse3(uint8_t* dst,
+                                  const uint8_t* src,
+                                  const size_t bytes,
+                                  const size_t elemSize)
+{
+  const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(byteswap_mask(elemSize)));
+  size_t i = 0;
+  for (; i + 16 <= bytes; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, mask));
+  }
+  return i;
+}
+
+LAF_TARGET("avx2")
+static size_t byteswap_copy_avx2(uint8_t* dst,
+                                 const uint8_t* src,
+                                 const size_t bytes,
+                                 const size_t elemSize)
+{
+  const __m256i mask = _mm256_broadcastsi128_si256(
+    _mm_load_si128(reinterpret_cast<const __m128i*>(byteswap_mask(elemSize))));
+  size_t i = 0;
+  for (; i + 32 <= bytes; i += 32) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(v, mask));
+  }
+  return i + byteswap_copy_ssse3(dst + i, src + i, bytes - i, elemSize);
+}
+
+using byteswap_copy_kernel = size_t (*)(uint8_t*, const uint8_t*, size_t, size_t);
+
+static byteswap_copy_kernel select_byteswap_kernel()
+{
+  const cpu_features& cpu = get_cpu_features();
+  if (cpu.avx2)
+    return byteswap_copy_avx2;
+  if (cpu.ssse3)
+    return byteswap_copy_ssse3;
+  return nullptr;
+}
+
+#endif // LAF_X86
+
+void byteswap_copy(void* dst, const void* src, const size_t elemSize, const size_t n)
+{
+  ASSERT(elemSize == 2 || elemSize == 4 || elemSize == 8);
+
+  auto d = static_cast<uint8_t*>(dst);
+  auto s = static_cast<const uint8_t*>(src);
+  size_t done = 0;
+
+#if LAF_X86
+  static const byteswap_copy_kernel kernel = select_byteswap_kernel();
+  if (kernel)
+    done = kernel(d, s, n * elemSize, elemSize);
+#endif
+
+  byteswap_copy_scalar(d + done, s + done, elemSize, n - done / elemSize);
+}
+
+//////////////////////////////////////////////////////////////////////
+// reader/writer
+
+reader::reader(const mapped_file& file, const endian e) : reader(file.data(), file.size(), e)
+{
+}
+
+uint64_t reader::read_varint()
+{
+  uint64_t v = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (m_ptr == m_end) {
+      fail();
+      return 0;
+    }
+    const uint8_t b = *m_ptr++;
+    v |= uint64_t(b & 0x7f) << shift;
+    if ((b & 0x80) == 0)
+      return v;
+  }
+  // Too many bytes for a 64-bit value
+  fail();
+  return 0;
+}
+
+void writer::write_varint(uint64_t v)
+{
+  uint8_t bytes[10];
+  size_t n = 0;
+  for (; v >= 0x80; v >>= 7)
+    bytes[n++] = uint8_t(v | 0x80);
+  bytes[n++] = uint8_t(v);
+  write_bytes(bytes, n);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Stream-based functions
+
+template<typename T>
+static std::ostream& write_value(std::ostream& os, const T value, const endian e)
+{
+  uint8_t bytes[sizeof(T)];
+  details::store<T>(bytes, value, e);
+  os.write(reinterpret_cast<const char*>(bytes), sizeof(T));
+  return os;
+}
+
+template<typename T>
+static T read_value(std::istream& is, const endian e)
+{
+  uint8_t bytes[sizeof(T)];
+  is.read(reinterpret_cast<char*>(bytes), sizeof(T));
+
+  // Values read past the end of the stream are the same as when each
+  // byte was read with is.get(): the EOF (-1) of the first missing
+  // byte sets all the bits from that byte to the most significant one
+  // (i.e. missing bytes are 0xff in little endian, and the whole value
+  // is 0xff... in big endian).
+  const size_t n = size_t(is.gcount());
+  if (n < sizeof(T)) {
+    if (e == endian::big)
+      std::memset(bytes, 0xff, sizeof(T));
+    else
+      std::memset(bytes + n, 0xff, sizeof(T) - n);
+  }
+
+  return details::load<T>(bytes, e);
+}
+
 std::ostream& write8(std::ostream& os, uint8_t byte)
 {
   os.put(byte);
@@ -27,232 +200,102 @@ uint8_t read8(std::istream& is)
 
 std::ostream& little_endian::write16(std::ostream& os, uint16_t word)
 {
-  os.put((int)((word & 0x00ff)));
-  os.put((int)((word & 0xff00) >> 8));
-  return os;
+  return write_value(os, word, endian::little);
 }
 
 std::ostream& little_endian::write32(std::ostream& os, uint32_t dword)
 {
-  os.put((int)((dword & 0x000000ffl)));
-  os.put((int)((dword & 0x0000ff00l) >> 8));
-  os.put((int)((dword & 0x00ff0000l) >> 16));
-  os.put((int)((dword & 0xff000000l) >> 24));
-  return os;
+  return write_value(os, dword, endian::little);
 }
 
 std::ostream& little_endian::write64(std::ostream& os, uint64_t qword)
 {
-  os.put((int)((qword & 0x00000000000000ffl)));
-  os.put((int)((qword & 0x000000000000ff00l) >> 8));
-  os.put((int)((qword & 0x0000000000ff0000l) >> 16));
-  os.put((int)((qword & 0x00000000ff000000l) >> 24));
-  os.put((int)((qword & 0x000000ff00000000l) >> 32));
-  os.put((int)((qword & 0x0000ff0000000000l) >> 40));
-  os.put((int)((qword & 0x00ff000000000000l) >> 48));
-  os.put((int)((qword & 0xff00000000000000l) >> 56));
-  return os;
+  return write_value(os, qword, endian::little);
 }
 
 std::ostream& little_endian::write_float(std::ostream& os, float value)
 {
-  const int b = *(reinterpret_cast<int*>(&value));
-  os.put((int)((b & 0x000000ffl)));
-  os.put((int)((b & 0x0000ff00l) >> 8));
-  os.put((int)((b & 0x00ff0000l) >> 16));
-  os.put((int)((b & 0xff000000l) >> 24));
-  return os;
+  return write_value(os, value, endian::little);
 }
 
 std::ostream& little_endian::write_double(std::ostream& os, double value)
 {
-  const long long b = *(reinterpret_cast<long long*>(&value));
-  os.put((int)((b & 0x00000000000000ffl)));
-  os.put((int)((b & 0x000000000000ff00l) >> 8));
-  os.put((int)((b & 0x0000000000ff0000l) >> 16));
-  os.put((int)((b & 0x00000000ff000000l) >> 24));
-  os.put((int)((b & 0x000000ff00000000l) >> 32));
-  os.put((int)((b & 0x0000ff0000000000l) >> 40));
-  os.put((int)((b & 0x00ff000000000000l) >> 48));
-  os.put((int)((b & 0xff00000000000000l) >> 56));
-  return os;
+  return write_value(os, value, endian::little);
 }
 
 uint16_t little_endian::read16(std::istream& is)
 {
-  int b1, b2;
-  b1 = is.get();
-  b2 = is.get();
-  return ((b2 << 8) | b1);
+  return read_value<uint16_t>(is, endian::little);
 }
 
 uint32_t little_endian::read32(std::istream& is)
 {
-  int b1, b2, b3, b4;
-  b1 = is.get();
-  b2 = is.get();
-  b3 = is.get();
-  b4 = is.get();
-  return ((b4 << 24) | (b3 << 16) | (b2 << 8) | b1);
+  return read_value<uint32_t>(is, endian::little);
 }
 
 uint64_t little_endian::read64(std::istream& is)
 {
-  int b1, b2, b3, b4, b5, b6, b7, b8;
-  b1 = is.get();
-  b2 = is.get();
-  b3 = is.get();
-  b4 = is.get();
-  b5 = is.get();
-  b6 = is.get();
-  b7 = is.get();
-  b8 = is.get();
-  return (((long long)b8 << 56) | ((long long)b7 << 48) | ((long long)b6 << 40) |
-          ((long long)b5 << 32) | ((long long)b4 << 24) | ((long long)b3 << 16) |
-          ((long long)b2 << 8) | (long long)b1);
+  return read_value<uint64_t>(is, endian::little);
 }
 
 float little_endian::read_float(std::istream& is)
 {
-  int b1, b2, b3, b4;
-  b1 = is.get();
-  b2 = is.get();
-  b3 = is.get();
-  b4 = is.get();
-  int v = ((b4 << 24) | (b3 << 16) | (b2 << 8) | b1);
-  return *reinterpret_cast<float*>(&v);
+  return read_value<float>(is, endian::little);
 }
 
 double little_endian::read_double(std::istream& is)
 {
-  int b1, b2, b3, b4, b5, b6, b7, b8;
-  b1 = is.get();
-  b2 = is.get();
-  b3 = is.get();
-  b4 = is.get();
-  b5 = is.get();
-  b6 = is.get();
-  b7 = is.get();
-  b8 = is.get();
-  int v = (((long long)b8 << 56) | ((long long)b7 << 48) | ((long long)b6 << 40) |
-           ((long long)b5 << 32) | ((long long)b4 << 24) | ((long long)b3 << 16) |
-           ((long long)b2 << 8) | (long long)b1);
-  return *reinterpret_cast<double*>(&v);
+  return read_value<double>(is, endian::little);
 }
 
 std::ostream& big_endian::write16(std::ostream& os, uint16_t word)
 {
-  os.put((int)((word & 0xff00) >> 8));
-  os.put((int)((word & 0x00ff)));
-  return os;
+  return write_value(os, word, endian::big);
 }
 
 std::ostream& big_endian::write32(std::ostream& os, uint32_t dword)
 {
-  os.put((int)((dword & 0xff000000l) >> 24));
-  os.put((int)((dword & 0x00ff0000l) >> 16));
-  os.put((int)((dword & 0x0000ff00l) >> 8));
-  os.put((int)((dword & 0x000000ffl)));
-  return os;
+  return write_value(os, dword, endian::big);
 }
 
 std::ostream& big_endian::write64(std::ostream& os, uint64_t qword)
 {
-  os.put((int)((qword & 0xff00000000000000l) >> 56));
-  os.put((int)((qword & 0x00ff000000000000l) >> 48));
-  os.put((int)((qword & 0x0000ff0000000000l) >> 40));
-  os.put((int)((qword & 0x000000ff00000000l) >> 32));
-  os.put((int)((qword & 0x00000000ff000000l) >> 24));
-  os.put((int)((qword & 0x0000000000ff0000l) >> 16));
-  os.put((int)((qword & 0x000000000000ff00l) >> 8));
-  os.put((int)((qword & 0x00000000000000ffl)));
-  return os;
+  return write_value(os, qword, endian::big);
 }
 
 std::ostream& big_endian::write_float(std::ostream& os, float value)
 {
-  const int b = *(reinterpret_cast<int*>(&value));
-  os.put((int)((b & 0xff000000l) >> 24));
-  os.put((int)((b & 0x00ff0000l) >> 16));
-  os.put((int)((b & 0x0000ff00l) >> 8));
-  os.put((int)((b & 0x000000ffl)));
-  return os;
+  return write_value(os, value, endian::big);
 }
 
 std::ostream& big_endian::write_double(std::ostream& os, double value)
 {
-  const long long b = *(reinterpret_cast<long long*>(&value));
-  os.put((int)((b & 0xff00000000000000l) >> 56));
-  os.put((int)((b & 0x00ff000000000000l) >> 48));
-  os.put((int)((b & 0x0000ff0000000000l) >> 40));
-  os.put((int)((b & 0x000000ff00000000l) >> 32));
-  os.put((int)((b & 0x00000000ff000000l) >> 24));
-  os.put((int)((b & 0x0000000000ff0000l) >> 16));
-  os.put((int)((b & 0x000000000000ff00l) >> 8));
-  os.put((int)((b & 0x00000000000000ffl)));
-  return os;
+  return write_value(os, value, endian::big);
 }
 
 uint16_t big_endian::read16(std::istream& is)
 {
-  int b1, b2;
-  b2 = is.get();
-  b1 = is.get();
-  return ((b2 << 8) | b1);
+  return read_value<uint16_t>(is, endian::big);
 }
 
 uint32_t big_endian::read32(std::istream& is)
 {
-  int b1, b2, b3, b4;
-  b4 = is.get();
-  b3 = is.get();
-  b2 = is.get();
-  b1 = is.get();
-  return ((b4 << 24) | (b3 << 16) | (b2 << 8) | b1);
+  return read_value<uint32_t>(is, endian::big);
 }
 
 uint64_t big_endian::read64(std::istream& is)
 {
-  int b1, b2, b3, b4, b5, b6, b7, b8;
-  b8 = is.get();
-  b7 = is.get();
-  b6 = is.get();
-  b5 = is.get();
-  b4 = is.get();
-  b3 = is.get();
-  b2 = is.get();
-  b1 = is.get();
-  return (((long long)b8 << 56) | ((long long)b7 << 48) | ((long long)b6 << 40) |
-          ((long long)b5 << 32) | ((long long)b4 << 24) | ((long long)b3 << 16) |
-          ((long long)b2 << 8) | (long long)b1);
+  return read_value<uint64_t>(is, endian::big);
 }
 
 float big_endian::read_float(std::istream& is)
 {
-  int b1, b2, b3, b4;
-  b4 = is.get();
-  b3 = is.get();
-  b2 = is.get();
-  b1 = is.get();
-  int v = ((b4 << 24) | (b3 << 16) | (b2 << 8) | b1);
-  return *reinterpret_cast<float*>(&v);
+  return read_value<float>(is, endian::big);
 }
 
 double big_endian::read_double(std::istream& is)
 {
-  int b1, b2, b3, b4, b5, b6, b7, b8;
-  b8 = is.get();
-  b7 = is.get();
-  b6 = is.get();
-  b5 = is.get();
-  b4 = is.get();
-  b3 = is.get();
-  b2 = is.get();
-  b1 = is.get();
-  int v = (((long long)b8 << 56) | ((long long)b7 << 48) | ((long long)b6 << 40) |
-           ((long long)b5 << 32) | ((long long)b4 << 24) | ((long long)b3 << 16) |
-           ((long long)b2 << 8) | (long long)b1);
-  return *reinterpret_cast<double*>(&v);
+  return read_value<double>(is, endian::big);
 }
 
 }} // namespace base::serialization
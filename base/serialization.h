@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -8,10 +9,295 @@
 #define BASE_SERIALIZATION_H_INCLUDED
 #pragma once
 
+#include "base/buffer.h"
+#include "base/config.h"
 #include "base/ints.h"
+
+#include <cstddef>
+#include <cstring>
 #include <iosfwd>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+  #include <stdlib.h>
+#endif
+
+namespace base {
+
+class mapped_file;
+
+namespace serialization {
+
+enum class endian {
+  little,
+  big,
+#ifdef LAF_BIG_ENDIAN
+  native = big
+#else
+  native = little
+#endif
+};
+
+inline uint16_t byteswap(const uint16_t v)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+  return _byteswap_ushort(v);
+#else
+  return __builtin_bswap16(v);
+#endif
+}
+
+inline uint32_t byteswap(const uint32_t v)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+  return _byteswap_ulong(v);
+#else
+  return __builtin_bswap32(v);
+#endif
+}
+
+inline uint64_t byteswap(const uint64_t v)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+  return _byteswap_uint64(v);
+#else
+  return __builtin_bswap64(v);
+#endif
+}
+
+// Copies "n" elements of "elemSize" bytes (2, 4, or 8) from "src" to
+// "dst" swapping the bytes of each element. Uses SSSE3/AVX2 when
+// available. "dst" can be equal to "src" to swap bytes in-place.
+void byteswap_copy(void* dst, const void* src, size_t elemSize, size_t n);
+
+namespace details {
+
+template<size_t Size>
+struct uint_of_size;
+template<>
+struct uint_of_size<1> {
+  using type = uint8_t;
+};
+template<>
+struct uint_of_size<2> {
+  using type = uint16_t;
+};
+template<>
+struct uint_of_size<4> {
+  using type = uint32_t;
+};
+template<>
+struct uint_of_size<8> {
+  using type = uint64_t;
+};
+
+template<typename T>
+inline T load(const uint8_t* p, const endian e)
+{
+  using U = typename uint_of_size<sizeof(T)>::type;
+  U u;
+  std::memcpy(&u, p, sizeof(U));
+  if constexpr (sizeof(U) > 1) {
+    if (e != endian::native)
+      u = byteswap(u);
+  }
+  T v;
+  std::memcpy(&v, &u, sizeof(T));
+  return v;
+}
+
+template<typename T>
+inline void store(uint8_t* p, const T v, const endian e)
+{
+  using U = typename uint_of_size<sizeof(T)>::type;
+  U u;
+  std::memcpy(&u, &v, sizeof(U));
+  if constexpr (sizeof(U) > 1) {
+    if (e != endian::native)
+      u = byteswap(u);
+  }
+  std::memcpy(p, &u, sizeof(U));
+}
+
+} // namespace details
+
+// Reads values from a span of bytes (e.g. a base::buffer or a
+// base::mapped_file) without copying it. Reading past the end of
+// the data returns zeros and turns ok() into false (like the fail
+// bit of std::istream).
+//
+//   base::serialization::reader r(buf, endian::big);
+//   uint32_t magic = r.read32();
+//   uint16_t count = r.read16();
+//   if (!r.ok())
+//     return false;
+//
+class reader {
+public:
+  reader(const void* data, const size_t size, const endian e = endian::little)
+    : m_begin(static_cast<const uint8_t*>(data))
+    , m_ptr(m_begin)
+    , m_end(m_begin + size)
+    , m_endian(e)
+  {
+  }
+
+  explicit reader(const buffer& buf, const endian e = endian::little)
+    : reader(buf.data(), buf.size(), e)
+  {
+  }
+
+  explicit reader(const mapped_file& file, endian e = endian::little);
+
+  bool ok() const { return m_ok; }
+  endian get_endian() const { return m_endian; }
+
+  const uint8_t* data() const { return m_ptr; }
+  size_t position() const { return m_ptr - m_begin; }
+  size_t size() const { return m_end - m_begin; }
+  size_t remaining() const { return m_end - m_ptr; }
+
+  bool seek(const size_t pos)
+  {
+    if (pos > size())
+      return fail();
+    m_ptr = m_begin + pos;
+    return true;
+  }
+
+  bool skip(const size_t n)
+  {
+    if (n > remaining())
+      return fail();
+    m_ptr += n;
+    return true;
+  }
+
+  uint8_t read8() { return read_value<uint8_t>(); }
+  uint16_t read16() { return read_value<uint16_t>(); }
+  uint32_t read32() { return read_value<uint32_t>(); }
+  uint64_t read64() { return read_value<uint64_t>(); }
+  float read_float() { return read_value<float>(); }
+  double read_double() { return read_value<double>(); }
+
+  // Variable-length integers (LEB128), signed values are zigzag
+  // encoded (small negative values use few bytes too).
+  uint64_t read_varint();
+  int64_t read_svarint()
+  {
+    const uint64_t v = read_varint();
+    return int64_t(v >> 1) ^ -int64_t(v & 1);
+  }
+
+  bool read_bytes(void* dst, const size_t n)
+  {
+    if (n > remaining())
+      return fail();
+    std::memcpy(dst, m_ptr, n);
+    m_ptr += n;
+    return true;
+  }
+
+  // Reads an array of integers/floats converting all of them from
+  // the reader endianness at once.
+  template<typename T>
+  bool read_array(T* dst, const size_t n)
+  {
+    static_assert(std::is_arithmetic_v<T>);
+    if (n > remaining() / sizeof(T))
+      return fail();
+    if (sizeof(T) == 1 || m_endian == endian::native)
+      std::memcpy(dst, m_ptr, n * sizeof(T));
+    else
+      byteswap_copy(dst, m_ptr, sizeof(T), n);
+    m_ptr += n * sizeof(T);
+    return true;
+  }
+
+private:
+  bool fail()
+  {
+    m_ok = false;
+    return false;
+  }
+
+  template<typename T>
+  T read_value()
+  {
+    if (remaining() < sizeof(T)) {
+      fail();
+      return T(0);
+    }
+    const T v = details::load<T>(m_ptr, m_endian);
+    m_ptr += sizeof(T);
+    return v;
+  }
+
+  const uint8_t* m_begin;
+  const uint8_t* m_ptr;
+  const uint8_t* m_end;
+  endian m_endian;
+  bool m_ok = true;
+};
+
+// Appends values at the end of a base::buffer.
+class writer {
+public:
+  explicit writer(buffer& buf, const endian e = endian::little) : m_buf(buf), m_endian(e) {}
+
+  buffer& get_buffer() { return m_buf; }
+  endian get_endian() const { return m_endian; }
+  size_t size() const { return m_buf.size(); }
+
+  void write8(const uint8_t v) { m_buf.push_back(v); }
+  void write16(const uint16_t v) { write_value(v); }
+  void write32(const uint32_t v) { write_value(v); }
+  void write64(const uint64_t v) { write_value(v); }
+  void write_float(const float v) { write_value(v); }
+  void write_double(const double v) { write_value(v); }
+
+  void write_varint(uint64_t v);
+  void write_svarint(const int64_t v) { write_varint((uint64_t(v) << 1) ^ uint64_t(v >> 63)); }
+
+  void write_bytes(const void* src, const size_t n)
+  {
+    if (n > 0)
+      std::memcpy(grow(n), src, n);
+  }
+
+  template<typename T>
+  void write_array(const T* src, const size_t n)
+  {
+    static_assert(std::is_arithmetic_v<T>);
+    if (n == 0)
+      return;
+    uint8_t* p = grow(n * sizeof(T));
+    if (sizeof(T) == 1 || m_endian == endian::native)
+      std::memcpy(p, src, n * sizeof(T));
+    else
+      byteswap_copy(p, src, sizeof(T), n);
+  }
+
+private:
+  uint8_t* grow(const size_t n)
+  {
+    const size_t pos = m_buf.size();
+    m_buf.resize(pos + n);
+    return m_buf.data() + pos;
+  }
+
+  template<typename T>
+  void write_value(const T v)
+  {
+    details::store<T>(grow(sizeof(T)), v, m_endian);
+  }
+
+  buffer& m_buf;
+  endian m_endian;
+};
 
-namespace base { namespace serialization {
+// Stream-based functions (they use the same encoding as the
+// reader/writer classes)
 
 std::ostream& write8(std::ostream& os, uint8_t byte);
 uint8_t read8(std::istream& is);
@@ -46,6 +332,7 @@ double read_double(std::istream& is);
 
 } // namespace big_endian
 
-}} // namespace base::serialization
+} // namespace serialization
+} // namespace base
 
 #endif
@@ -0,0 +1,66 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/serialization.h"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace base;
+using namespace base::serialization;
+
+TEST(Serialization, Benchmark)
+{
+  const size_t n = 4 * 1024 * 1024;
+  std::vector<uint32_t> values(n);
+  for (size_t i = 0; i < n; ++i)
+    values[i] = uint32_t(i);
+
+  buffer buf;
+  writer w(buf, endian::big);
+  w.write_array(values.data(), n);
+
+  Chrono chrono;
+  {
+    std::stringstream s(std::string((const char*)buf.data(), buf.size()));
+    for (size_t i = 0; i < n; ++i)
+      values[i] = big_endian::read32(s);
+  }
+  const double streamSecs = chrono.elapsed();
+
+  chrono.reset();
+  {
+    reader r(buf, endian::big);
+    for (size_t i = 0; i < n; ++i)
+      values[i] = r.read32();
+  }
+  const double readerSecs = chrono.elapsed();
+
+  chrono.reset();
+  {
+    reader r(buf, endian::big);
+    r.read_array(values.data(), n);
+  }
+  const double arraySecs = chrono.elapsed();
+  EXPECT_EQ(n - 1, values[n - 1]);
+
+  std::printf("Read %d MB: istream %.2f GB/s, reader %.2f GB/s, read_array %.2f GB/s\n",
+              int(buf.size() / 1024 / 1024),
+              buf.size() / streamSecs / 1e9,
+              buf.size() / readerSecs / 1e9,
+              buf.size() / arraySecs / 1e9);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,187 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/serialization.h"
+
+#include <limits>
+#include <sstream>
+#include <vector>
+
+using namespace base;
+using namespace base::serialization;
+
+TEST(Serialization, ReaderWriter)
+{
+  for (endian e : { endian::little, endian::big }) {
+    buffer buf;
+    writer w(buf, e);
+    w.write8(0x12);
+    w.write16(0x3456);
+    w.write32(0x789abcde);
+    w.write64(0x0123456789abcdefULL);
+    w.write_float(1.5f);
+    w.write_double(-2.25);
+    EXPECT_EQ(27, buf.size());
+    EXPECT_EQ(e == endian::little ? 0x56 : 0x34, buf[1]);
+
+    reader r(buf, e);
+    EXPECT_EQ(0x12, r.read8());
+    EXPECT_EQ(0x3456, r.read16());
+    EXPECT_EQ(0x789abcde, r.read32());
+    EXPECT_EQ(0x0123456789abcdefULL, r.read64());
+    EXPECT_EQ(1.5f, r.read_float());
+    EXPECT_EQ(-2.25, r.read_double());
+    EXPECT_TRUE(r.ok());
+    EXPECT_EQ(0, r.remaining());
+
+    // Read past the end
+    EXPECT_EQ(0, r.read32());
+    EXPECT_FALSE(r.ok());
+  }
+}
+
+TEST(Serialization, Bounds)
+{
+  const buffer buf = { 1, 2, 3 };
+  reader r(buf);
+  EXPECT_EQ(0, r.read32());
+  EXPECT_FALSE(r.ok());
+  EXPECT_EQ(0, r.position());
+
+  reader r2(buf);
+  EXPECT_TRUE(r2.skip(2));
+  EXPECT_FALSE(r2.skip(2));
+  EXPECT_TRUE(r2.seek(3));
+  EXPECT_FALSE(r2.seek(4));
+
+  uint16_t arr[2];
+  reader r3(buf);
+  EXPECT_FALSE(r3.read_array(arr, 2));
+  EXPECT_TRUE(r3.read_array(arr, 1));
+  EXPECT_EQ(0x0201, arr[0]);
+}
+
+TEST(Serialization, Varint)
+{
+  const std::vector<uint64_t> values = { 0, 1, 127, 128, 300, 1 << 20,
+                                         std::numeric_limits<uint64_t>::max() };
+  const std::vector<int64_t> svalues = { 0, -1, 1, -64, 64, -1000000,
+                                         std::numeric_limits<int64_t>::min(),
+                                         std::numeric_limits<int64_t>::max() };
+  buffer buf;
+  writer w(buf);
+  for (auto v : values)
+    w.write_varint(v);
+  for (auto v : svalues)
+    w.write_svarint(v);
+  EXPECT_EQ(0, buf[0]);
+  EXPECT_EQ(0x7f, buf[2]);
+  EXPECT_EQ(0x80, buf[3]);
+  EXPECT_EQ(0x01, buf[4]);
+
+  reader r(buf);
+  for (auto v : values)
+    EXPECT_EQ(v, r.read_varint());
+  for (auto v : svalues)
+    EXPECT_EQ(v, r.read_svarint());
+  EXPECT_TRUE(r.ok());
+  EXPECT_EQ(0, r.remaining());
+
+  // Truncated varint
+  const buffer bad = { 0x80, 0x80 };
+  reader r2(bad);
+  EXPECT_EQ(0, r2.read_varint());
+  EXPECT_FALSE(r2.ok());
+}
+
+template<typename T>
+static void test_array(const endian e)
+{
+  std::vector<T> values(77);
+  for (size_t i = 0; i < values.size(); ++i)
+    values[i] = T(i * 0x01020304050607ULL + i);
+
+  buffer buf;
+  writer w(buf, e);
+  w.write_array(values.data(), values.size());
+  EXPECT_EQ(values.size() * sizeof(T), buf.size());
+
+  reader r(buf, e);
+  for (size_t i = 0; i < 3; ++i) {
+    if constexpr (sizeof(T) == 2)
+      EXPECT_EQ(values[i], T(r.read16()));
+    else if constexpr (sizeof(T) == 4)
+      EXPECT_EQ(values[i], T(r.read32()));
+    else
+      EXPECT_EQ(values[i], T(r.read64()));
+  }
+
+  std::vector<T> result(values.size() - 3);
+  EXPECT_TRUE(r.read_array(result.data(), result.size()));
+  EXPECT_TRUE(std::equal(result.begin(), result.end(), values.begin() + 3));
+}
+
+TEST(Serialization, Arrays)
+{
+  for (endian e : { endian::little, endian::big }) {
+    test_array<uint16_t>(e);
+    test_array<uint32_t>(e);
+    test_array<uint64_t>(e);
+    test_array<int32_t>(e);
+  }
+
+  const float floats[] = { 1.0f, -2.5f, 3.25f };
+  buffer buf;
+  writer(buf, endian::big).write_array(floats, 3);
+  reader r(buf, endian::big);
+  EXPECT_EQ(-2.5f, (r.skip(4), r.read_float()));
+}
+
+TEST(Serialization, Streams)
+{
+  std::stringstream s;
+  little_endian::write16(s, 0x1234);
+  big_endian::write32(s, 0x56789abc);
+  little_endian::write_double(s, 1.0 / 3.0);
+  big_endian::write_double(s, -7.5);
+  little_endian::write_float(s, 0.25f);
+
+  // Stream functions and reader use the same format
+  const std::string str = s.str();
+  reader r(str.data(), str.size());
+  EXPECT_EQ(0x1234, r.read16());
+
+  EXPECT_EQ(0x1234, little_endian::read16(s));
+  EXPECT_EQ(0x56789abc, big_endian::read32(s));
+  EXPECT_EQ(1.0 / 3.0, little_endian::read_double(s));
+  EXPECT_EQ(-7.5, big_endian::read_double(s));
+  EXPECT_EQ(0.25f, little_endian::read_float(s));
+}
+
+// Reading past the end of the stream gives the same values as old
+// versions (which read byte by byte with std::istream::get()).
+TEST(Serialization, StreamsEof)
+{
+  std::stringstream s;
+  EXPECT_EQ(0xff, read8(s));
+  EXPECT_EQ(0xffff, little_endian::read16(s));
+  EXPECT_EQ(0xffffffff, big_endian::read32(s));
+
+  s = std::stringstream("\x12\x34");
+  EXPECT_EQ(0xffff3412, little_endian::read32(s));
+  s = std::stringstream("\x12\x34");
+  EXPECT_EQ(0xffffffff, big_endian::read32(s));
+  s = std::stringstream("\x12");
+  EXPECT_EQ(0xffffffffffffff12ull, little_endian::read64(s));
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
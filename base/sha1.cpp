@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -8,15 +9,282 @@
   #include "config.h"
 #endif
 
+#include "base/cpu_features.h"
 #include "base/debug.h"
 #include "base/fstream_path.h"
 #include "base/sha1.h"
-#include "base/sha1_rfc3174.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <fstream>
 
 namespace base {
 
+//////////////////////////////////////////////////////////////////////
+// SHA1 block functions (FIPS PUB 180-1)
+
+static inline uint32_t rol(const uint32_t x, const int n)
+{
+  return (x << n) | (x >> (32 - n));
+}
+
+static inline uint32_t load_be32(const uint8_t* p)
+{
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+static void process_blocks_scalar(uint32_t state[5], const uint8_t* data, size_t blocks)
+{
+  for (; blocks > 0; --blocks, data += 64) {
+    // Message schedule (a circular buffer of 16 words)
+    uint32_t w[16];
+    for (int i = 0; i < 16; ++i)
+      w[i] = load_be32(data + 4 * i);
+
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
+
+    auto round = [&](const int i, const uint32_t f, const uint32_t k) {
+      if (i >= 16)
+        w[i & 15] = rol(w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15], 1);
+      const uint32_t t = rol(a, 5) + f + e + k + w[i & 15];
+      e = d;
+      d = c;
+      c = rol(b, 30);
+      b = a;
+      a = t;
+    };
+
+    int i = 0;
+    for (; i < 20; ++i)
+      round(i, (b & c) | (~b & d), 0x5A827999);
+    for (; i < 40; ++i)
+      round(i, b ^ c ^ d, 0x6ED9EBA1);
+    for (; i < 60; ++i)
+      round(i, (b & c) | (b & d) | (c & d), 0x8F1BBCDC);
+    for (; i < 80; ++i)
+      round(i, b ^ c ^ d, 0xCA62C1D6);
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+  }
+}
+
+#if LAF_X86
+
+// Uses the Intel SHA extensions, based on the public domain code by
+// Jeffrey Walton (https://github.com/noloader/SHA-Intrinsics).
+LAF_TARGET("sha,sse4.1")
+static void process_blocks_shani(uint32_t state[5], const uint8_t* data, size_t blocks)
+{
+  const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+  __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)state), 0x1B);
+  __m128i e0 = _mm_set_epi32(int(state[4]), 0, 0, 0);
+  __m128i e1;
+  __m128i msg0, msg1, msg2, msg3;
+
+  // Each step calculates 4 rounds (with the "f" function) using the
+  // message words of "m0", and prepares the next message words.
+  #define SHA1_STEP(f, e, eNext, m0, m1, m2, m3)    \
+    e = _mm_sha1nexte_epu32(e, m0);                 \
+    eNext = abcd;                                   \
+    m1 = _mm_sha1msg2_epu32(m1, m0);                \
+    abcd = _mm_sha1rnds4_epu32(abcd, e, f);         \
+    m3 = _mm_sha1msg1_epu32(m3, m0);                \
+    m2 = _mm_xor_si128(m2, m0);
+
+  for (; blocks > 0; --blocks, data += 64) {
+    const __m128i abcdSave = abcd;
+    const __m128i e0Save = e0;
+
+    // Rounds 0-15
+    msg0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), mask);
+    e0 = _mm_add_epi32(e0, msg0);
+    e1 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+    msg1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), mask);
+    e1 = _mm_sha1nexte_epu32(e1, msg1);
+    e0 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+    msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+    msg2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), mask);
+    e0 = _mm_sha1nexte_epu32(e0, msg2);
+    e1 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+    msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+    msg0 = _mm_xor_si128(msg0, msg2);
+
+    msg3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), mask);
+    SHA1_STEP(0, e1, e0, msg3, msg0, msg1, msg2);
+
+    // Rounds 16-75
+    SHA1_STEP(0, e0, e1, msg0, msg1, msg2, msg3);
+    SHA1_STEP(1, e1, e0, msg1, msg2, msg3, msg0);
+    SHA1_STEP(1, e0, e1, msg2, msg3, msg0, msg1);
+    SHA1_STEP(1, e1, e0, msg3, msg0, msg1, msg2);
+    SHA1_STEP(1, e0, e1, msg0, msg1, msg2, msg3);
+    SHA1_STEP(1, e1, e0, msg1, msg2, msg3, msg0);
+    SHA1_STEP(2, e0, e1, msg2, msg3, msg0, msg1);
+    SHA1_STEP(2, e1, e0, msg3, msg0, msg1, msg2);
+    SHA1_STEP(2, e0, e1, msg0, msg1, msg2, msg3);
+    SHA1_STEP(2, e1, e0, msg1, msg2, msg3, msg0);
+    SHA1_STEP(2, e0, e1, msg2, msg3, msg0, msg1);
+    SHA1_STEP(3, e1, e0, msg3, msg0, msg1, msg2);
+    SHA1_STEP(3, e0, e1, msg0, msg1, msg2, msg3);
+    SHA1_STEP(3, e1, e0, msg1, msg2, msg3, msg0);
+    SHA1_STEP(3, e0, e1, msg2, msg3, msg0, msg1);
+
+    // Rounds 76-79
+    e1 = _mm_sha1nexte_epu32(e1, msg3);
+    e0 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+
+    e0 = _mm_sha1nexte_epu32(e0, e0Save);
+    abcd = _mm_add_epi32(abcd, abcdSave);
+  }
+
+  #undef SHA1_STEP
+
+  _mm_storeu_si128((__m128i*)state, _mm_shuffle_epi32(abcd, 0x1B));
+  state[4] = uint32_t(_mm_extract_epi32(e0, 3));
+}
+
+static bool cpu_supports_shani()
+{
+  const cpu_features& cpu = get_cpu_features();
+  return cpu.ssse3 && cpu.sse41 && cpu.sha;
+}
+
+#endif // LAF_X86
+
+using details::sha1_kernel;
+using process_blocks_func = void (*)(uint32_t state[5], const uint8_t* data, size_t blocks);
+
+// The function can be changed from tests with set_sha1_kernel()
+// while other threads are using it.
+static std::atomic<process_blocks_func>& process_blocks_ptr()
+{
+  static std::atomic<process_blocks_func> f =
+#if LAF_X86
+    cpu_supports_shani() ? process_blocks_shani :
+#endif
+                           process_blocks_scalar;
+  return f;
+}
+
+static void process_blocks(uint32_t state[5], const uint8_t* data, size_t blocks)
+{
+  process_blocks_ptr().load(std::memory_order_relaxed)(state, data, blocks);
+}
+
+sha1_kernel details::get_sha1_kernel()
+{
+#if LAF_X86
+  if (process_blocks_ptr().load() == process_blocks_shani)
+    return sha1_kernel::SHANI;
+#endif
+  return sha1_kernel::Scalar;
+}
+
+bool details::set_sha1_kernel(const sha1_kernel kernel)
+{
+  process_blocks_func f = process_blocks_scalar;
+  if (kernel == sha1_kernel::SHANI) {
+#if LAF_X86
+    if (!cpu_supports_shani())
+      return false;
+    f = process_blocks_shani;
+#else
+    return false;
+#endif
+  }
+  process_blocks_ptr().store(f, std::memory_order_relaxed);
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// sha1_hasher
+
+void sha1_hasher::reset()
+{
+  m_state[0] = 0x67452301;
+  m_state[1] = 0xEFCDAB89;
+  m_state[2] = 0x98BADCFE;
+  m_state[3] = 0x10325476;
+  m_state[4] = 0xC3D2E1F0;
+  m_length = 0;
+  m_blockSize = 0;
+}
+
+void sha1_hasher::update(const void* data, size_t size)
+{
+  if (size == 0)
+    return;
+
+  auto p = static_cast<const uint8_t*>(data);
+  m_length += size;
+
+  // Complete the pending block
+  if (m_blockSize > 0) {
+    const size_t n = std::min(size, sizeof(m_block) - m_blockSize);
+    std::memcpy(m_block + m_blockSize, p, n);
+    m_blockSize += n;
+    p += n;
+    size -= n;
+    if (m_blockSize < sizeof(m_block))
+      return;
+    process_blocks(m_state, m_block, 1);
+    m_blockSize = 0;
+  }
+
+  // Process complete blocks directly from the input
+  const size_t blocks = size / 64;
+  if (blocks > 0) {
+    process_blocks(m_state, p, blocks);
+    p += 64 * blocks;
+    size -= 64 * blocks;
+  }
+
+  std::memcpy(m_block, p, size);
+  m_blockSize = size;
+}
+
+Sha1 sha1_hasher::finalize()
+{
+  // Padding: 1 bit, zeros, and the message length in bits (64-bit
+  // big-endian) at the end of the last block.
+  const uint64_t bits = m_length * 8;
+  m_block[m_blockSize++] = 0x80;
+  if (m_blockSize > 56) {
+    std::fill(m_block + m_blockSize, m_block + 64, 0);
+    process_blocks(m_state, m_block, 1);
+    m_blockSize = 0;
+  }
+  std::fill(m_block + m_blockSize, m_block + 56, 0);
+  for (int i = 0; i < 8; ++i)
+    m_block[56 + i] = uint8_t(bits >> (56 - 8 * i));
+  process_blocks(m_state, m_block, 1);
+  m_blockSize = 0;
+
+  std::vector<uint8_t> digest(Sha1::HashSize);
+  for (int i = 0; i < Sha1::HashSize; ++i)
+    digest[i] = uint8_t(m_state[i / 4] >> (24 - 8 * (i % 4)));
+  return Sha1(digest);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Sha1
+
 Sha1::Sha1() : m_digest(20, 0)
 {
 }
@@ -35,34 +303,26 @@ Sha1 Sha1::calculateFromFile(const std::string& fileName)
   if (!file.good())
     return Sha1();
 
-  SHA1Context sha;
-  SHA1Reset(&sha);
-
-  unsigned char buf[1024];
+  sha1_hasher hasher;
+  char buf[16 * 1024];
   while (file.good()) {
-    file.read((char*)buf, 1024);
-    const unsigned int len = (unsigned int)file.gcount();
-    if (len > 0)
-      SHA1Input(&sha, buf, len);
+    file.read(buf, sizeof(buf));
+    hasher.update(buf, size_t(file.gcount()));
   }
-
-  vector<uint8_t> digest(HashSize);
-  SHA1Result(&sha, digest.data());
-
-  return Sha1(digest);
+  return hasher.finalize();
 }
 
 // Calculates the SHA1 of the given string.
 Sha1 Sha1::calculateFromString(const std::string& text)
 {
-  SHA1Context sha;
-  SHA1Reset(&sha);
-  SHA1Input(&sha, (uint8_t*)text.c_str(), (unsigned int)text.size());
-
-  std::vector<uint8_t> digest(HashSize);
-  SHA1Result(&sha, digest.data());
+  return calculateFromMemory(text.c_str(), text.size());
+}
 
-  return Sha1(digest);
+Sha1 Sha1::calculateFromMemory(const void* data, size_t size)
+{
+  sha1_hasher hasher;
+  hasher.update(data, size);
+  return hasher.finalize();
 }
 
 bool Sha1::operator==(const Sha1& other) const
@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -8,13 +9,12 @@
 #define BASE_SHA1_H_INCLUDED
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
 #include "base/ints.h"
 
-extern "C" struct SHA1Context;
-
 namespace base {
 
 class Sha1 {
@@ -24,9 +24,10 @@ public:
   Sha1();
   explicit Sha1(const std::vector<uint8_t>& digest);
 
-  // Calculates the SHA1 of the given file or string.
+  // Calculates the SHA1 of the given file, string, or memory block.
   static Sha1 calculateFromFile(const std::string& fileName);
   static Sha1 calculateFromString(const std::string& text);
+  static Sha1 calculateFromMemory(const void* data, size_t size);
 
   bool operator==(const Sha1& other) const;
   bool operator!=(const Sha1& other) const;
@@ -41,6 +42,50 @@ private:
   std::vector<uint8_t> m_digest;
 };
 
+// Calculates the SHA1 incrementally (e.g. when data is received in
+// chunks). It uses the SHA extensions of x86 CPUs when available.
+//
+//   base::sha1_hasher hasher;
+//   while (...)
+//     hasher.update(chunk, chunkSize);
+//   base::Sha1 sha1 = hasher.finalize();
+//
+class sha1_hasher {
+public:
+  sha1_hasher() { reset(); }
+
+  void reset();
+  void update(const void* data, size_t size);
+
+  // Returns the hash of all the data given to update(). The hasher
+  // must be reset() to be used again.
+  Sha1 finalize();
+
+private:
+  uint32_t m_state[5];
+  uint64_t m_length;
+  uint8_t m_block[64];
+  size_t m_blockSize;
+};
+
+namespace details {
+
+// Implementation used to process SHA1 blocks. By default the SHA
+// extensions are used if the CPU supports them.
+enum class sha1_kernel {
+  Scalar,
+  SHANI,
+};
+
+sha1_kernel get_sha1_kernel();
+
+// Only for tests and benchmarks, changes the implementation used by
+// all threads. Returns false if the given kernel is not supported by
+// this CPU.
+bool set_sha1_kernel(sha1_kernel kernel);
+
+} // namespace details
+
 } // namespace base
 
 #endif // BASE_SHA1_H_INCLUDED
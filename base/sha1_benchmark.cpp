@@ -0,0 +1,29 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/sha1.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace base;
+
+TEST(Sha1, Benchmark)
+{
+  const std::vector<uint8_t> data(64 * 1024 * 1024, 1);
+  Chrono chrono;
+  Sha1::calculateFromMemory(data.data(), data.size());
+  std::printf("SHA1: %.2f GB/s\n", data.size() / chrono.elapsed() / 1e9);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,113 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/convert_to.h"
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/sha1.h"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace base;
+using namespace base::details;
+
+static std::string sha1_string(const std::string& text)
+{
+  return convert_to<std::string>(Sha1::calculateFromString(text));
+}
+
+static std::vector<sha1_kernel> supported_kernels()
+{
+  std::vector<sha1_kernel> kernels;
+  const sha1_kernel old = get_sha1_kernel();
+  for (auto k : { sha1_kernel::Scalar, sha1_kernel::SHANI }) {
+    if (set_sha1_kernel(k))
+      kernels.push_back(k);
+  }
+  set_sha1_kernel(old);
+  return kernels;
+}
+
+TEST(Sha1, Vectors)
+{
+  const sha1_kernel old = get_sha1_kernel();
+  for (sha1_kernel k : supported_kernels()) {
+    SCOPED_TRACE(int(k));
+    set_sha1_kernel(k);
+    EXPECT_EQ("da39a3ee5e6b4b0d3255bfef95601890afd80709", sha1_string(""));
+    EXPECT_EQ("a9993e364706816aba3e25717850c26c9cd0d89d", sha1_string("abc"));
+    EXPECT_EQ("84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+              sha1_string("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"));
+    EXPECT_EQ("34aa973cd4c4daa4f61eeb2bdbad27316534016f",
+              sha1_string(std::string(1000000, 'a')));
+  }
+  set_sha1_kernel(old);
+}
+
+TEST(Sha1, Hasher)
+{
+  std::vector<uint8_t> data(1000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = uint8_t(i * 7);
+
+  // The expected hashes are calculated with the scalar version
+  std::vector<Sha1> expected;
+  const sha1_kernel old = get_sha1_kernel();
+  set_sha1_kernel(sha1_kernel::Scalar);
+  const size_t sizes[] = { 0, 1, 55, 56, 63, 64, 65, 128, 1000 };
+  for (size_t size : sizes)
+    expected.push_back(Sha1::calculateFromMemory(data.data(), size));
+
+  for (sha1_kernel k : supported_kernels()) {
+    set_sha1_kernel(k);
+    for (size_t j = 0; j < std::size(sizes); ++j) {
+      const size_t size = sizes[j];
+      for (size_t chunk : { 1, 3, 64, 100 }) {
+        sha1_hasher hasher;
+        for (size_t i = 0; i < size; i += chunk)
+          hasher.update(&data[i], std::min(chunk, size - i));
+        EXPECT_EQ(expected[j], hasher.finalize())
+          << "Kernel " << int(k) << " size " << size << " chunk " << chunk;
+      }
+    }
+  }
+  set_sha1_kernel(old);
+
+  // Reuse the hasher
+  sha1_hasher hasher;
+  hasher.update("abc", 3);
+  hasher.finalize();
+  hasher.reset();
+  hasher.update("abc", 3);
+  EXPECT_EQ("a9993e364706816aba3e25717850c26c9cd0d89d",
+            convert_to<std::string>(hasher.finalize()));
+}
+
+TEST(Sha1, File)
+{
+  const char* fn = "_test_sha1_.tmp";
+
+  write_file_content(fn, nullptr, 0);
+  EXPECT_EQ(Sha1::calculateFromString(""), Sha1::calculateFromFile(fn));
+
+  const std::string text(100000, 'x');
+  write_file_content(fn, (const uint8_t*)text.c_str(), text.size());
+  EXPECT_EQ(Sha1::calculateFromString(text), Sha1::calculateFromFile(fn));
+
+  delete_file(fn);
+  EXPECT_EQ(Sha1(), Sha1::calculateFromFile(fn));
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,175 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_SMALL_FUNCTION_H_INCLUDED
+#define BASE_SMALL_FUNCTION_H_INCLUDED
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace base {
+
+template<typename Signature, size_t Capacity = 64>
+class small_function;
+
+// Move-only replacement of std::function that stores callables of up
+// to Capacity bytes inside the object itself (without allocating
+// memory). Bigger callables are stored in the heap.
+template<typename R, typename... Args, size_t Capacity>
+class small_function<R(Args...), Capacity> {
+public:
+  static constexpr size_t capacity = Capacity;
+
+  // Returns true if the given callable type will be stored inside
+  // the small_function without allocating memory.
+  template<typename F>
+  static constexpr bool fits_inline()
+  {
+    return (sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) &&
+            std::is_nothrow_move_constructible_v<F>);
+  }
+
+  small_function() noexcept = default;
+  small_function(std::nullptr_t) noexcept {}
+
+  template<typename F,
+           typename FD = std::decay_t<F>,
+           typename = std::enable_if_t<!std::is_same_v<FD, small_function> &&
+                                       std::is_invocable_r_v<R, FD&, Args...>>>
+  small_function(F&& f)
+  {
+    // Null pointers and empty std::functions are converted to an empty
+    // small_function (a function reference cannot be null)
+    if constexpr (!std::is_function_v<std::remove_reference_t<F>> &&
+                  (std::is_pointer_v<FD> || std::is_member_pointer_v<FD> ||
+                   std::is_same_v<FD, std::function<R(Args...)>>)) {
+      if (!f)
+        return;
+    }
+
+    if constexpr (fits_inline<FD>()) {
+      new (&m_storage) FD(std::forward<F>(f));
+      m_ops = &inline_ops<FD>::ops;
+    }
+    else {
+      *reinterpret_cast<FD**>(&m_storage) = new FD(std::forward<F>(f));
+      m_ops = &heap_ops<FD>::ops;
+    }
+  }
+
+  small_function(small_function&& other) noexcept { move_from(other); }
+
+  small_function& operator=(small_function&& other) noexcept
+  {
+    if (this != &other) {
+      reset();
+      move_from(other);
+    }
+    return *this;
+  }
+
+  small_function& operator=(std::nullptr_t) noexcept
+  {
+    reset();
+    return *this;
+  }
+
+  template<typename F,
+           typename FD = std::decay_t<F>,
+           typename = std::enable_if_t<!std::is_same_v<FD, small_function> &&
+                                       std::is_invocable_r_v<R, FD&, Args...>>>
+  small_function& operator=(F&& f)
+  {
+    small_function tmp(std::forward<F>(f));
+    reset();
+    move_from(tmp);
+    return *this;
+  }
+
+  small_function(const small_function&) = delete;
+  small_function& operator=(const small_function&) = delete;
+
+  ~small_function() { reset(); }
+
+  explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+  R operator()(Args... args) const
+  {
+    if (!m_ops)
+      throw std::bad_function_call();
+    return m_ops->invoke(const_cast<storage_t*>(&m_storage), std::forward<Args>(args)...);
+  }
+
+private:
+  using storage_t = std::aligned_storage_t<Capacity, alignof(std::max_align_t)>;
+
+  struct ops_t {
+    R (*invoke)(storage_t* s, Args&&... args);
+    // Moves the callable from src to dst and destroys the src
+    void (*relocate)(storage_t* dst, storage_t* src) noexcept;
+    void (*destroy)(storage_t* s) noexcept;
+  };
+
+  template<typename F>
+  struct inline_ops {
+    static F* get(storage_t* s) { return std::launder(reinterpret_cast<F*>(s)); }
+    static R invoke(storage_t* s, Args&&... args)
+    {
+      return std::invoke(*get(s), std::forward<Args>(args)...);
+    }
+    static void relocate(storage_t* dst, storage_t* src) noexcept
+    {
+      new (dst) F(std::move(*get(src)));
+      get(src)->~F();
+    }
+    static void destroy(storage_t* s) noexcept { get(s)->~F(); }
+    static constexpr ops_t ops = { &invoke, &relocate, &destroy };
+  };
+
+  template<typename F>
+  struct heap_ops {
+    static F*& get(storage_t* s) { return *reinterpret_cast<F**>(s); }
+    static R invoke(storage_t* s, Args&&... args)
+    {
+      return std::invoke(*get(s), std::forward<Args>(args)...);
+    }
+    static void relocate(storage_t* dst, storage_t* src) noexcept
+    {
+      *reinterpret_cast<F**>(dst) = get(src);
+    }
+    static void destroy(storage_t* s) noexcept { delete get(s); }
+    static constexpr ops_t ops = { &invoke, &relocate, &destroy };
+  };
+
+  void move_from(small_function& other) noexcept
+  {
+    if (other.m_ops) {
+      other.m_ops->relocate(&m_storage, &other.m_storage);
+      m_ops = other.m_ops;
+      other.m_ops = nullptr;
+    }
+  }
+
+  void reset() noexcept
+  {
+    if (m_ops) {
+      const ops_t* ops = m_ops;
+      m_ops = nullptr;
+      ops->destroy(&m_storage);
+    }
+  }
+
+  storage_t m_storage;
+  const ops_t* m_ops = nullptr;
+};
+
+} // namespace base
+
+#endif
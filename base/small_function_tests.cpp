@@ -0,0 +1,105 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/small_function.h"
+
+#include <array>
+#include <memory>
+
+using namespace base;
+
+static int twice(int x)
+{
+  return 2 * x;
+}
+
+TEST(SmallFunction, Empty)
+{
+  small_function<void()> f;
+  EXPECT_FALSE(f);
+  EXPECT_THROW(f(), std::bad_function_call);
+
+  small_function<int(int)> g(nullptr);
+  EXPECT_FALSE(g);
+
+  int (*ptr)(int) = nullptr;
+  g = ptr;
+  EXPECT_FALSE(g);
+
+  g = std::function<int(int)>();
+  EXPECT_FALSE(g);
+}
+
+TEST(SmallFunction, Call)
+{
+  small_function<int(int)> f = twice;
+  EXPECT_TRUE(f);
+  EXPECT_EQ(4, f(2));
+
+  int k = 3;
+  f = [k](int x) { return k * x; };
+  EXPECT_EQ(6, f(2));
+
+  f = nullptr;
+  EXPECT_FALSE(f);
+}
+
+TEST(SmallFunction, FitsInline)
+{
+  using func = small_function<void(), 32>;
+  auto small = [a = std::array<char, 32>()] { (void)a; };
+  auto big = [a = std::array<char, 33>()] { (void)a; };
+  EXPECT_TRUE(func::fits_inline<decltype(small)>());
+  EXPECT_FALSE(func::fits_inline<decltype(big)>());
+
+  std::array<char, 100> data;
+  data.fill(5);
+  small_function<int(), 32> f = [data] { return int(data[99]); };
+  EXPECT_EQ(5, f());
+}
+
+TEST(SmallFunction, MoveAndDestroy)
+{
+  auto counter = std::make_shared<int>(0);
+  std::weak_ptr<int> weak = counter;
+  {
+    small_function<void()> f = [counter] { ++*counter; };
+    counter.reset();
+    f();
+
+    small_function<void()> g = std::move(f);
+    EXPECT_FALSE(f);
+    EXPECT_TRUE(g);
+    g();
+    EXPECT_EQ(2, *weak.lock());
+
+    // Heap stored callable
+    std::array<char, 128> data;
+    small_function<void(), 16> h = [c = weak.lock(), data] { ++*c; };
+    small_function<void(), 16> h2 = std::move(h);
+    h2();
+    EXPECT_EQ(3, *weak.lock());
+
+    g = nullptr;
+    EXPECT_FALSE(weak.expired());
+  }
+  EXPECT_TRUE(weak.expired());
+}
+
+TEST(SmallFunction, MoveOnlyCallable)
+{
+  auto ptr = std::make_unique<int>(5);
+  small_function<int()> f = [p = std::move(ptr)] { return *p; };
+  EXPECT_EQ(5, f());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -8,6 +9,8 @@
 #define BASE_SPLIT_STRING_H_INCLUDED
 #pragma once
 
+#include "base/tok.h"
+
 #include <string>
 #include <string_view>
 #include <vector>
@@ -20,6 +23,17 @@ void split_string(const std::string& string,
 void split_string(const std::string_view& string,
                   std::vector<std::string_view>& parts,
                   const std::string_view& separators);
+
+// Like split_string() but returns a range of std::string_view
+// (without allocating a vector), e.g.
+//
+//   for (std::string_view part : base::split_string_view(line, ",;"))
+//     ...
+//
+inline auto split_string_view(const std::string_view string, const std::string_view separators)
+{
+  return tok::csv_view(string, tok::any_of(separators));
+}
 } // namespace base
 
 #endif
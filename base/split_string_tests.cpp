@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -86,6 +87,23 @@ TEST(SplitStringView, MultipleSeparators)
   EXPECT_EQ("ld", result[2]);
 }
 
+TEST(SplitStringView, Range)
+{
+  const char* cases[] = { "", ",", "a", "a,b", ",a;b,", "ab,,cd;;;e", "no separators" };
+  for (const char* str : cases) {
+    std::vector<std::string> expected;
+    base::split_string(str, expected, ",;");
+
+    std::vector<std::string_view> result;
+    for (std::string_view part : base::split_string_view(str, ",;"))
+      result.push_back(part);
+
+    ASSERT_EQ(expected.size(), result.size()) << str;
+    for (size_t i = 0; i < expected.size(); ++i)
+      EXPECT_EQ(expected[i], result[i]);
+  }
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
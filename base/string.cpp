@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2020-2024 Igara Studio S.A.
+// Copyright (c) 2020-2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,9 +11,12 @@
 
 #include "base/debug.h"
 #include "base/string.h"
+#include "base/utf8.h"
 #include "base/utf8_decode.h"
 
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <vector>
 
 #ifdef LAF_WINDOWS
@@ -175,25 +178,37 @@ std::wstring from_utf8(const std::string& src)
 
 std::string to_utf8(const wchar_t* src, const size_t n)
 {
-  // Get required size to reserve a string so string::push_back()
-  // doesn't need to reallocate its data.
-  std::size_t required_size = 0;
-  const auto* p = src;
-  for (size_t i = 0; i < n; ++i, ++p)
-    required_size += insert_utf8_char(*p);
-  if (!required_size)
-    return "";
-
   std::string result;
-  result.reserve(++required_size);
-  p = src;
-  for (int i = 0; i < n; ++i, ++p)
-    insert_utf8_char(*p, &result);
+  result.reserve(n);
+
+  // Convert chunks of wchar_t to code points (wchar_t is 32-bit on
+  // Unix-like systems) and then to UTF-8 with utf32_to_utf8().
+  constexpr size_t kChunk = 256;
+  codepoint_t chunk[kChunk];
+  char utf8[4 * kChunk];
+  for (size_t i = 0; i < n; i += kChunk) {
+    const size_t m = std::min(kChunk, n - i);
+    for (size_t j = 0; j < m; ++j)
+      chunk[j] = codepoint_t(src[i + j]);
+    result.append(utf8, utf32_to_utf8(chunk, m, utf8));
+  }
   return result;
 }
 
 std::wstring from_utf8(const std::string& src)
 {
+  // Fast path for valid UTF-8, we stop at the first null char (like
+  // utf8_decode does).
+  const char* s = src.c_str();
+  size_t n = src.size();
+  if (const void* nul = std::memchr(s, 0, n))
+    n = static_cast<const char*>(nul) - s;
+  if (utf8_validate(s, n)) {
+    std::vector<codepoint_t> buf(n);
+    const size_t len = utf8_to_utf32(s, n, buf.data());
+    return std::wstring(buf.begin(), buf.begin() + len);
+  }
+
   int required_size = utf8_length(src);
   std::vector<wchar_t> buf(++required_size);
   std::vector<wchar_t>::iterator buf_it = buf.begin();
@@ -215,6 +230,12 @@ std::wstring from_utf8(const std::string& src)
 
 int utf8_length(const std::string& utf8string)
 {
+  // Fast path for valid UTF-8 strings without null chars
+  const char* s = utf8string.c_str();
+  const size_t n = utf8string.size();
+  if (!std::memchr(s, 0, n) && utf8_validate(s, n))
+    return int(utf8_count(s, n));
+
   utf8_decode decode(utf8string);
   int c = 0;
 
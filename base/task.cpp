@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -33,13 +33,21 @@ task_token& task::start(thread_pool& pool)
   m_state = state::ENQUEUED;
   m_token.reset();
 
-  m_token.m_work = pool.execute([this] { in_worker_thread(); });
+  m_token.m_work = pool.execute([this] { in_worker_thread(); }, m_token.m_workGeneration);
   return m_token;
 }
 
 bool task::try_pop(thread_pool& pool)
 {
-  bool popped = pool.try_pop(m_token.m_work);
+  // The work pointer is only valid while the task is enqueued (the
+  // pool can reuse it for other works)
+  if (m_state != state::ENQUEUED)
+    return false;
+
+  // The task can start running just after the previous check, and the
+  // work can be reused by other task, so we use the generation of the
+  // work to avoid canceling a work of other task.
+  bool popped = pool.try_pop(m_token.m_work, m_token.m_workGeneration);
   if (popped) {
     m_token.m_canceled = true;
     // The task is not waiting for execution any more, we can safely execute the
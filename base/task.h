@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -17,10 +17,12 @@
 namespace base {
 
 class task;
+class task_graph;
 class thread_pool;
 
 class task_token {
   friend class task;
+  friend class task_graph;
 
 public:
   task_token() : m_canceled(false), m_progress(0.0f), m_progress_min(0.0f), m_progress_max(1.0f) {}
@@ -48,6 +50,7 @@ private:
     m_progress_min = token.m_progress_min;
     m_progress_max = token.m_progress_max;
     m_work = token.m_work;
+    m_workGeneration = token.m_workGeneration;
   }
 
   void reset()
@@ -60,6 +63,7 @@ private:
   std::atomic<float> m_progress;
   float m_progress_min, m_progress_max;
   const thread_pool::work* m_work = nullptr;
+  uint64_t m_workGeneration = 0;
 };
 
 class task {
@@ -0,0 +1,234 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/task_graph.h"
+
+#include "base/debug.h"
+#include "base/log.h"
+#include "base/thread_pool.h"
+
+#include <stdexcept>
+
+namespace base {
+
+struct task_graph::node {
+  func_t func;
+  float weight;
+  std::vector<node_id> successors;
+  int predecessors = 0;
+  std::atomic<int> remaining = 0; // Predecessors that are not finished yet
+  std::atomic<bool> done = false;
+  task_token token;
+};
+
+task_graph::task_graph() : m_pending(0), m_canceled(false), m_running(false), m_started(false)
+{
+}
+
+task_graph::~task_graph()
+{
+  // The graph must not be running when we are destroying it.
+  ASSERT(!m_running);
+}
+
+task_graph::node_id task_graph::add(func_t&& f, float weight)
+{
+  ASSERT(!m_running);
+  ASSERT(weight >= 0.0f);
+
+  auto n = std::make_unique<node>();
+  n->func = std::move(f);
+  n->weight = weight;
+  m_nodes.push_back(std::move(n));
+  m_validated = false;
+  return m_nodes.size() - 1;
+}
+
+void task_graph::precede(node_id before, node_id after)
+{
+  ASSERT(!m_running);
+  ASSERT(before < m_nodes.size());
+  ASSERT(after < m_nodes.size());
+  ASSERT(before != after);
+
+  m_nodes[before]->successors.push_back(after);
+  ++m_nodes[after]->predecessors;
+  m_validated = false;
+}
+
+void task_graph::start(thread_pool& pool)
+{
+  // Cannot start the graph if it's already running
+  ASSERT(!m_running);
+
+  if (!m_validated)
+    validate();
+
+  m_pool = &pool;
+  m_canceled = false;
+  m_started = true;
+  for (auto& n : m_nodes) {
+    n->remaining = n->predecessors;
+    n->done = false;
+    n->token.reset();
+  }
+
+  if (m_nodes.empty()) {
+    finish();
+    return;
+  }
+
+  m_pending = m_nodes.size();
+  m_running = true;
+  for (node_id id : m_roots)
+    pool.execute([this, id] { run_node(id); });
+}
+
+void task_graph::wait()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cv.wait(lock, [this]() -> bool { return !m_running; });
+}
+
+void task_graph::cancel()
+{
+  m_canceled = true;
+  for (auto& n : m_nodes)
+    n->token.cancel();
+}
+
+bool task_graph::canceled(node_id id) const
+{
+  ASSERT(id < m_nodes.size());
+  return m_nodes[id]->token.canceled();
+}
+
+float task_graph::progress() const
+{
+  if (m_nodes.empty() || m_totalWeight <= 0.0f)
+    return (completed() ? 1.0f : 0.0f);
+
+  float progress = 0.0f;
+  for (const auto& n : m_nodes)
+    progress += n->weight * (n->done ? 1.0f : n->token.progress());
+  return progress / m_totalWeight;
+}
+
+// Checks that there are no cycles (Kahn's algorithm) and calculates
+// the list of nodes without predecessors.
+void task_graph::validate()
+{
+  m_roots.clear();
+  m_totalWeight = 0.0f;
+
+  std::vector<int> remaining(m_nodes.size());
+  std::vector<node_id> ready;
+  for (node_id id = 0; id < m_nodes.size(); ++id) {
+    remaining[id] = m_nodes[id]->predecessors;
+    m_totalWeight += m_nodes[id]->weight;
+    if (remaining[id] == 0) {
+      m_roots.push_back(id);
+      ready.push_back(id);
+    }
+  }
+
+  size_t visited = 0;
+  while (!ready.empty()) {
+    const node_id id = ready.back();
+    ready.pop_back();
+    ++visited;
+    for (node_id s : m_nodes[id]->successors) {
+      if (--remaining[s] == 0)
+        ready.push_back(s);
+    }
+  }
+
+  if (visited != m_nodes.size())
+    throw std::runtime_error("The task graph contains a cycle");
+
+  m_validated = true;
+}
+
+void task_graph::run_node(node_id id)
+{
+  while (true) {
+    node& n = *m_nodes[id];
+
+    if (!n.token.canceled()) {
+      try {
+        n.func(n.token);
+      }
+      catch (const std::exception& ex) {
+        LOG(FATAL, "Exception running task graph node: %s\n", ex.what());
+        n.token.cancel();
+      }
+      catch (...) {
+        LOG(FATAL, "Unknown exception running task graph node\n");
+        n.token.cancel();
+      }
+    }
+    n.done = true;
+
+    // Enqueue the successors that are ready, but continue with the
+    // first one in this same thread.
+    const bool canceled = n.token.canceled();
+    bool hasNext = false;
+    node_id next = 0;
+    for (node_id s : n.successors) {
+      node& succ = *m_nodes[s];
+      // Nodes that depend on a canceled node are skipped
+      if (canceled)
+        succ.token.cancel();
+
+      if (--succ.remaining == 0) {
+        if (!hasNext) {
+          hasNext = true;
+          next = s;
+        }
+        else
+          m_pool->execute([this, s] { run_node(s); });
+      }
+    }
+
+    // After the last node is finished the graph can be destroyed by
+    // other thread, so no member can be used after this decrement
+    // (except to finish the graph when we are the last one).
+    if (--m_pending == 0) {
+      ASSERT(!hasNext);
+      finish();
+      return;
+    }
+    if (!hasNext)
+      return;
+    id = next;
+  }
+}
+
+void task_graph::finish()
+{
+  if (m_finished) {
+    try {
+      m_finished(*this);
+    }
+    catch (const std::exception& ex) {
+      LOG(ERROR, "Exception executing 'finished' callback: %s\n", ex.what());
+    }
+    catch (...) {
+      LOG(ERROR, "Unknown exception executing 'finished' callback\n");
+    }
+  }
+
+  // The graph can be destroyed by other thread after this.
+  const std::lock_guard lock(m_mutex);
+  m_running = false;
+  m_cv.notify_all();
+}
+
+} // namespace base
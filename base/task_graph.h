@@ -0,0 +1,111 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_TASK_GRAPH_H_INCLUDED
+#define BASE_TASK_GRAPH_H_INCLUDED
+#pragma once
+
+#include "base/disable_copying.h"
+#include "base/task.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace base {
+
+class thread_pool;
+
+// A set of tasks with dependencies between them (a directed acyclic
+// graph). A node is executed in the thread pool when all its
+// predecessors are finished. E.g.
+//
+//   base::task_graph g;
+//   auto decode = g.add([](base::task_token& t) { ... });
+//   auto convert = g.add([](base::task_token& t) { ... });
+//   auto upload = g.add([](base::task_token& t) { ... });
+//   g.precede(decode, convert);
+//   g.precede(convert, upload);
+//   g.start(pool);
+//   g.wait();
+//
+// The same graph can be started again after it's completed (e.g. for
+// a per-frame pipeline) without allocating memory.
+class task_graph {
+public:
+  typedef size_t node_id;
+  typedef task::func_t func_t;
+  // Called when all nodes are finished (or skipped because the graph
+  // was canceled). The graph cannot be destroyed inside this callback.
+  typedef std::function<void(const task_graph&)> finfunc_t;
+
+  task_graph();
+  ~task_graph();
+
+  // Adds a new node. The weight is used to calculate the progress of
+  // the whole graph.
+  node_id add(func_t&& f, float weight = 1.0f);
+
+  // Indicates that the "before" node must be finished before the
+  // "after" node is started.
+  void precede(node_id before, node_id after);
+
+  void on_finished(finfunc_t&& f) { m_finished = std::move(f); }
+
+  size_t size() const { return m_nodes.size(); }
+
+  // Starts the graph execution enqueueing the nodes without
+  // predecessors in the given pool. Throws an exception if there is
+  // a cycle in the graph.
+  void start(thread_pool& pool);
+
+  // Waits until all nodes are finished.
+  void wait();
+
+  // Cancels the graph: the tokens of all nodes are canceled, and
+  // nodes that are not running yet will be skipped.
+  void cancel();
+
+  bool canceled() const { return m_canceled; }
+  bool running() const { return m_running; }
+  bool completed() const { return !m_running && m_started; }
+
+  // Returns true if the given node was skipped or canceled, useful
+  // after the graph is completed.
+  bool canceled(node_id id) const;
+
+  // Weighted average of the progress of all nodes.
+  float progress() const;
+
+private:
+  struct node;
+
+  void validate();
+  void run_node(node_id id);
+  void finish();
+
+  std::vector<std::unique_ptr<node>> m_nodes;
+  std::vector<node_id> m_roots;
+  bool m_validated = false;
+  float m_totalWeight = 0.0f;
+  thread_pool* m_pool = nullptr;
+  std::atomic<size_t> m_pending;
+  std::atomic<bool> m_canceled;
+  std::atomic<bool> m_running;
+  std::atomic<bool> m_started;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  finfunc_t m_finished = nullptr;
+
+  DISABLE_COPYING(task_graph);
+};
+
+} // namespace base
+
+#endif
@@ -0,0 +1,184 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/task_graph.h"
+#include "base/thread_pool.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace base;
+
+TEST(TaskGraph, Chain)
+{
+  thread_pool p(4);
+  task_graph g;
+  std::mutex m;
+  std::vector<int> order;
+  std::vector<task_graph::node_id> ids;
+  for (int i = 0; i < 5; ++i) {
+    ids.push_back(g.add([&m, &order, i](task_token&) {
+      const std::lock_guard lock(m);
+      order.push_back(i);
+    }));
+  }
+  for (int i = 0; i < 4; ++i)
+    g.precede(ids[i], ids[i + 1]);
+
+  g.start(p);
+  g.wait();
+  EXPECT_TRUE(g.completed());
+  EXPECT_EQ((std::vector<int>{ 0, 1, 2, 3, 4 }), order);
+}
+
+TEST(TaskGraph, Diamond)
+{
+  thread_pool p(4);
+  task_graph g;
+  std::atomic<int> a(0), b(0), c(0), d(0);
+  auto na = g.add([&](task_token&) { a = 1; });
+  auto nb = g.add([&](task_token&) { b = a + 1; });
+  auto nc = g.add([&](task_token&) { c = a + 2; });
+  auto nd = g.add([&](task_token&) { d = b + c; });
+  g.precede(na, nb);
+  g.precede(na, nc);
+  g.precede(nb, nd);
+  g.precede(nc, nd);
+
+  bool finished = false;
+  g.on_finished([&finished](const task_graph& g) { finished = !g.canceled(); });
+  g.start(p);
+  g.wait();
+  EXPECT_TRUE(finished);
+  EXPECT_EQ(5, d);
+  EXPECT_EQ(1.0f, g.progress());
+}
+
+TEST(TaskGraph, RunAgain)
+{
+  thread_pool p(3);
+  task_graph g;
+  std::atomic<int> c(0);
+  auto first = g.add([&](task_token&) { c = 0; });
+  for (int i = 0; i < 10; ++i)
+    g.precede(first, g.add([&](task_token&) { ++c; }));
+
+  for (int frame = 0; frame < 100; ++frame) {
+    g.start(p);
+    g.wait();
+    EXPECT_EQ(10, c);
+  }
+}
+
+TEST(TaskGraph, CancelPropagatesToSuccessors)
+{
+  thread_pool p(2);
+  task_graph g;
+  std::atomic<int> c(0);
+  auto a = g.add([&](task_token& t) {
+    ++c;
+    t.cancel();
+  });
+  auto b = g.add([&](task_token&) { ++c; });
+  auto other = g.add([&](task_token&) { ++c; });
+  g.precede(a, b);
+
+  g.start(p);
+  g.wait();
+  EXPECT_EQ(2, c);
+  EXPECT_TRUE(g.canceled(a));
+  EXPECT_TRUE(g.canceled(b));
+  EXPECT_FALSE(g.canceled(other));
+}
+
+TEST(TaskGraph, Exceptions)
+{
+  thread_pool p(2);
+  task_graph g;
+  std::atomic<int> c(0);
+  auto a = g.add([&](task_token&) { throw std::runtime_error("error"); });
+  auto b = g.add([&](task_token&) { throw 5; });
+  auto d = g.add([&](task_token&) { ++c; });
+  auto e = g.add([&](task_token&) { ++c; });
+  g.precede(a, d);
+  g.precede(b, e);
+
+  // The nodes that throw are canceled (and their successors)
+  g.start(p);
+  g.wait();
+  EXPECT_EQ(0, c);
+  EXPECT_TRUE(g.canceled(a));
+  EXPECT_TRUE(g.canceled(b));
+  EXPECT_TRUE(g.canceled(d));
+  EXPECT_TRUE(g.canceled(e));
+
+  // Exceptions from the finished callback don't prevent finishing
+  // the graph
+  g.on_finished([](const task_graph&) { throw 5; });
+  g.start(p);
+  g.wait();
+}
+
+TEST(TaskGraph, CancelGraph)
+{
+  thread_pool p(1);
+  task_graph g;
+  std::atomic<bool> started(false);
+  std::atomic<int> c(0);
+  auto a = g.add([&](task_token& t) {
+    started = true;
+    while (!t.canceled())
+      std::this_thread::yield();
+  });
+  for (int i = 0; i < 5; ++i)
+    g.precede(a, g.add([&](task_token&) { ++c; }));
+
+  g.start(p);
+  while (!started)
+    std::this_thread::yield();
+  g.cancel();
+  g.wait();
+  EXPECT_TRUE(g.canceled());
+  EXPECT_EQ(0, c);
+
+  // It can be started again after a cancellation
+  g.on_finished(nullptr);
+  g.start(p);
+  g.cancel();
+  g.wait();
+  EXPECT_EQ(0, c);
+}
+
+TEST(TaskGraph, Cycle)
+{
+  thread_pool p(1);
+  task_graph g;
+  auto a = g.add([](task_token&) {});
+  auto b = g.add([](task_token&) {});
+  g.precede(a, b);
+  g.precede(b, a);
+  EXPECT_THROW(g.start(p), std::runtime_error);
+  EXPECT_FALSE(g.running());
+}
+
+TEST(TaskGraph, Empty)
+{
+  thread_pool p(1);
+  task_graph g;
+  g.start(p);
+  g.wait();
+  EXPECT_TRUE(g.completed());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -11,49 +11,200 @@
 #include "base/debug.h"
 #include "base/log.h"
 #include "base/thread_pool.h"
+#include "base/work_stealing_deque.h"
+
+#include <algorithm>
 
 namespace base {
 
-thread_pool::thread_pool(const size_t n) : m_running(true), m_threads(n), m_doingWork(0)
+namespace {
+
+// Max number of works that a worker moves from the queue of submitted
+// works to its own deque each time it takes works from it.
+constexpr size_t kMaxInjectedBatch = 32;
+
+// Max number of recycled works in the free list of each worker, the
+// rest are moved to the shared free list (m_externalFree).
+constexpr size_t kMaxLocalFreeWorks = 256;
+
+// Executes the function of a work catching all exceptions.
+void call_func(thread_pool::func_t& func)
+{
+  try {
+    if (func)
+      func();
+  }
+  // TODO handle exceptions in a better way
+  catch (const std::exception& e) {
+    LOG(FATAL, "Exception from worker: %s", e.what());
+    ASSERT(false);
+  }
+  catch (...) {
+    LOG(FATAL, "Exception from worker\n");
+    ASSERT(false);
+  }
+}
+
+} // anonymous namespace
+
+struct thread_pool::worker_data {
+  size_t index;
+  work_stealing_deque<work*> deque;
+  work* freeWorks = nullptr;
+  size_t freeCount = 0;
+  // Works created by this worker that were executed (and recycled) by
+  // other workers that stole them.
+  std::atomic<work*> returnedWorks = nullptr;
+  uint32_t seed;
+
+  explicit worker_data(size_t index) : index(index), seed(uint32_t(index * 2654435761u + 1)) {}
+
+  // Xorshift to select the victim when we steal
+  uint32_t random()
+  {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+  }
+};
+
+// Pool and worker index of the current thread (WORK_STEALING mode only)
+static thread_local thread_pool* t_pool = nullptr;
+static thread_local size_t t_index = 0;
+
+thread_pool::thread_pool(const size_t n, const mode m)
+  : m_mode(m)
+  , m_running(true)
+  , m_threads(n)
+  , m_doingWork(0)
 {
+  if (m_mode == mode::WORK_STEALING) {
+    m_workers.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+      m_workers.push_back(std::make_unique<worker_data>(i));
+  }
+
   const std::unique_lock lock(m_mutex);
-  for (size_t i = 0; i < n; ++i)
-    m_threads[i] = std::thread([this] { worker(); });
+  for (size_t i = 0; i < n; ++i) {
+    if (m_mode == mode::WORK_STEALING)
+      m_threads[i] = std::thread([this, i] { worker_stealing(*m_workers[i]); });
+    else
+      m_threads[i] = std::thread([this] { worker(); });
+  }
 }
 
 thread_pool::~thread_pool()
 {
   join_all();
+
+  work* w = m_allWorks.load();
+  while (w) {
+    work* next = w->m_allNext;
+    delete w;
+    w = next;
+  }
 }
 
-const thread_pool::work* thread_pool::execute(std::function<void()>&& func)
+const thread_pool::work* thread_pool::execute(func_t&& func)
+{
+  uint64_t generation;
+  return execute(std::move(func), generation);
+}
+
+const thread_pool::work* thread_pool::execute(func_t&& func, uint64_t& generation)
 {
-  thread_pool::work_ptr work = std::make_unique<thread_pool::work>(std::move(func));
-  const thread_pool::work* result = work.get();
-  const std::unique_lock lock(m_mutex);
   ASSERT(m_running);
-  m_work.push_back(std::move(work));
+  work* w;
+
+  // The generation is read before the work is enqueued (as it can be
+  // executed and reused by other thread just after that).
+  if (m_mode == mode::WORK_STEALING) {
+    if (t_pool == this) {
+      // Works submitted from our own workers go to their deques
+      worker_data& me = *m_workers[t_index];
+      w = new_work(me, std::move(func));
+      generation = work::get_generation(w->m_state);
+      ++m_active;
+      me.deque.push(w);
+    }
+    else {
+      const std::unique_lock lock(m_mutex);
+      w = new_work_locked(std::move(func));
+      generation = work::get_generation(w->m_state);
+      ++m_active;
+      push_back_locked(w);
+    }
+    ++m_pending;
+    notify_new_work();
+    return w;
+  }
+
+  const std::unique_lock lock(m_mutex);
+  w = new_work_locked(std::move(func));
+  generation = work::get_generation(w->m_state);
+  push_back_locked(w);
   m_cv.notify_one();
-  return result;
+  return w;
 }
 
-bool thread_pool::try_pop(const work* w)
+bool thread_pool::try_pop(const work* w, const uint64_t generation)
 {
-  std::unique_lock<std::mutex> lock(m_mutex);
-  for (auto it = m_work.begin(); it != m_work.end(); ++it) {
-    if (w == it->get()) {
-      m_work.erase(it);
-      return true;
+  if (!w)
+    return false;
+
+  if (m_mode == mode::WORK_STEALING) {
+    // The work remains in the deque/queue of works, the worker that
+    // takes it will recycle it. The generation is compared in the same
+    // CAS operation, so we cannot cancel a reused work.
+    auto* ww = const_cast<work*>(w);
+    uint64_t expected = work::make_state(generation, work::state::PENDING);
+    if (!ww->m_state.compare_exchange_strong(expected,
+                                             work::make_state(generation, work::state::CANCELED)))
+      return false;
+
+    --m_pending;
+    notify_finished_work();
+    return true;
+  }
+
+  work* removed = nullptr;
+  {
+    const std::unique_lock lock(m_mutex);
+    for (work *prev = nullptr, *it = m_first; it; prev = it, it = it->m_next) {
+      if (w == it && work::get_generation(it->m_state) == generation) {
+        if (prev)
+          prev->m_next = it->m_next;
+        else
+          m_first = it->m_next;
+        if (m_last == it)
+          m_last = prev;
+        --m_count;
+        removed = it;
+        break;
+      }
     }
   }
-  return false;
+  if (!removed)
+    return false;
+
+  // Destroy the function outside the lock
+  removed->m_func = nullptr;
+
+  const std::unique_lock lock(m_mutex);
+  removed->m_next = m_free;
+  m_free = removed;
+  return true;
 }
 
 void thread_pool::wait_all()
 {
   std::unique_lock<std::mutex> lock(m_mutex);
-  m_cvWait.wait(lock,
-                [this]() -> bool { return !m_running || (m_work.empty() && m_doingWork == 0); });
+  if (m_mode == mode::WORK_STEALING) {
+    m_cvWait.wait(lock, [this]() -> bool { return !m_running || m_active == 0; });
+    return;
+  }
+  m_cvWait.wait(lock, [this]() -> bool { return !m_running || (!m_first && m_doingWork == 0); });
 }
 
 void thread_pool::join_all()
@@ -82,44 +233,227 @@ void thread_pool::join_all()
 
 void thread_pool::worker()
 {
-  bool running;
-  {
-    const std::unique_lock lock(m_mutex);
-    running = m_running;
-  }
+  bool running = m_running;
   while (running) {
-    std::function<void()> func;
+    work* w = nullptr;
     {
       std::unique_lock<std::mutex> lock(m_mutex);
-      m_cv.wait(lock, [this]() -> bool { return !m_running || !m_work.empty(); });
+      m_cv.wait(lock, [this]() -> bool { return !m_running || m_first; });
       running = m_running;
-      if (m_running && !m_work.empty()) {
-        func = std::move(m_work.front()->m_func);
+      if (m_running && m_first) {
+        w = pop_front_locked();
         ++m_doingWork;
-        m_work.pop_front();
       }
     }
-    try {
-      if (func)
-        func();
-    }
-    // TODO handle exceptions in a better way
-    catch (const std::exception& e) {
-      LOG(FATAL, "Exception from worker: %s", e.what());
-      ASSERT(false);
-    }
-    catch (...) {
-      LOG(FATAL, "Exception from worker\n");
-      ASSERT(false);
-    }
+    if (!w)
+      continue;
 
-    // Decrement m_doingWork only if we've incremented it
-    if (func) {
+    call_func(w->m_func);
+
+    // Destroy the function outside the lock
+    w->m_func = nullptr;
+    {
       const std::unique_lock lock(m_mutex);
+      w->m_next = m_free;
+      m_free = w;
       --m_doingWork;
       m_cvWait.notify_all();
     }
   }
 }
 
+void thread_pool::push_back_locked(work* w)
+{
+  w->m_next = nullptr;
+  if (m_last)
+    m_last->m_next = w;
+  else
+    m_first = w;
+  m_last = w;
+  ++m_count;
+}
+
+thread_pool::work* thread_pool::pop_front_locked()
+{
+  work* w = m_first;
+  if (w) {
+    m_first = w->m_next;
+    if (!m_first)
+      m_last = nullptr;
+    w->m_next = nullptr;
+    --m_count;
+  }
+  return w;
+}
+
+thread_pool::work* thread_pool::new_work_locked(func_t&& func)
+{
+  // Take all the works recycled by workers
+  if (!m_free)
+    m_free = m_externalFree.exchange(nullptr);
+
+  work* w = m_free;
+  if (w) {
+    m_free = w->m_next;
+    w->m_next = nullptr;
+    w->m_func = std::move(func);
+    w->m_state = work::make_state(work::get_generation(w->m_state) + 1, work::state::PENDING);
+  }
+  else {
+    w = new work(std::move(func));
+    w->m_external = true;
+    w->m_allNext = m_allWorks.load();
+    while (!m_allWorks.compare_exchange_weak(w->m_allNext, w)) {}
+  }
+  return w;
+}
+
+void thread_pool::worker_stealing(worker_data& me)
+{
+  t_pool = this;
+  t_index = me.index;
+
+  while (m_running) {
+    if (work* w = find_work(me)) {
+      run_work(me, w);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    // m_sleeping and m_pending are sequentially consistent, so if we
+    // see m_pending == 0 here, the thread calling execute() will see
+    // m_sleeping > 0 and will wake us up.
+    ++m_sleeping;
+    m_cv.wait(lock, [this]() -> bool { return !m_running || m_pending > 0; });
+    --m_sleeping;
+  }
+
+  t_pool = nullptr;
+}
+
+thread_pool::work* thread_pool::find_work(worker_data& me)
+{
+  work* w = nullptr;
+
+  // 1. Our own deque (LIFO)
+  if (me.deque.pop(w))
+    return w;
+
+  // 2. Works submitted from other threads, we move a batch of them
+  // to our deque so other workers can steal them from us.
+  if (m_count > 0) {
+    const std::unique_lock lock(m_mutex);
+    if (m_first) {
+      w = pop_front_locked();
+
+      const size_t n = std::min(kMaxInjectedBatch, m_count / m_workers.size());
+      for (size_t i = 0; i < n; ++i)
+        me.deque.push(pop_front_locked());
+      return w;
+    }
+  }
+
+  // 3. Steal from other workers (FIFO) starting from a random victim
+  const size_t n = m_workers.size();
+  for (int retry = 0; retry < 2; ++retry) {
+    const size_t start = me.random() % n;
+    for (size_t i = 0; i < n; ++i) {
+      worker_data& victim = *m_workers[(start + i) % n];
+      if (&victim != &me && victim.deque.steal(w))
+        return w;
+    }
+  }
+  return nullptr;
+}
+
+void thread_pool::run_work(worker_data& me, work* w)
+{
+  // The work could be canceled with try_pop() in the meantime
+  const uint64_t generation = work::get_generation(w->m_state);
+  uint64_t expected = work::make_state(generation, work::state::PENDING);
+  if (!w->m_state.compare_exchange_strong(expected,
+                                          work::make_state(generation, work::state::RUNNING))) {
+    recycle_work(me, w);
+    return;
+  }
+  --m_pending;
+
+  call_func(w->m_func);
+
+  recycle_work(me, w);
+  notify_finished_work();
+}
+
+thread_pool::work* thread_pool::new_work(worker_data& me, func_t&& func)
+{
+  // Take all our works returned by other workers
+  if (!me.freeWorks) {
+    me.freeWorks = me.returnedWorks.exchange(nullptr);
+    for (work* w = me.freeWorks; w; w = w->m_next)
+      ++me.freeCount;
+  }
+
+  work* w = me.freeWorks;
+  if (w) {
+    me.freeWorks = w->m_next;
+    --me.freeCount;
+    w->m_next = nullptr;
+    w->m_func = std::move(func);
+    w->m_state = work::make_state(work::get_generation(w->m_state) + 1, work::state::PENDING);
+  }
+  else {
+    w = new work(std::move(func));
+    w->m_owner = me.index;
+    w->m_allNext = m_allWorks.load();
+    while (!m_allWorks.compare_exchange_weak(w->m_allNext, w)) {}
+  }
+  return w;
+}
+
+void thread_pool::recycle_work(worker_data& me, work* w)
+{
+  w->m_func = nullptr;
+  w->m_state = work::make_state(work::get_generation(w->m_state), work::state::FREE);
+
+  // Works created from non-worker threads are given back to them,
+  // and works created from workers are given back to the worker that
+  // created it (so a worker whose works are stolen doesn't need to
+  // allocate new ones).
+  if (!w->m_external) {
+    if (w->m_owner != me.index) {
+      std::atomic<work*>& returned = m_workers[w->m_owner]->returnedWorks;
+      w->m_next = returned.load();
+      while (!returned.compare_exchange_weak(w->m_next, w)) {}
+      return;
+    }
+    if (me.freeCount < kMaxLocalFreeWorks) {
+      w->m_next = me.freeWorks;
+      me.freeWorks = w;
+      ++me.freeCount;
+      return;
+    }
+    // Too many free works in this worker, the work is moved to the
+    // shared free list
+    w->m_external = true;
+  }
+  w->m_next = m_externalFree.load();
+  while (!m_externalFree.compare_exchange_weak(w->m_next, w)) {}
+}
+
+void thread_pool::notify_new_work()
+{
+  if (m_sleeping > 0) {
+    const std::unique_lock lock(m_mutex);
+    m_cv.notify_one();
+  }
+}
+
+void thread_pool::notify_finished_work()
+{
+  if (--m_active == 0) {
+    const std::unique_lock lock(m_mutex);
+    m_cvWait.notify_all();
+  }
+}
+
 } // namespace base
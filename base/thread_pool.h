@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -8,9 +8,12 @@
 #define BASE_THREAD_POOL_H_INCLUDED
 #pragma once
 
+#include "base/ints.h"
+#include "base/small_function.h"
+
+#include <atomic>
 #include <condition_variable>
-#include <deque>
-#include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -19,44 +22,127 @@ namespace base {
 
 class thread_pool {
 public:
+  enum class mode {
+    // All workers take works from one queue protected by a mutex.
+    SHARED_QUEUE,
+    // Each worker has its own deque, works submitted from a worker
+    // thread go to its deque, and idle workers steal works from
+    // others. Useful with a lot of workers and a lot of small works.
+    WORK_STEALING,
+  };
+
+  // Function executed by a work. Callables of up to 64 bytes are
+  // stored inline, so execute() doesn't need to allocate memory.
+  typedef small_function<void(), 64> func_t;
+
   class work {
     friend class thread_pool;
 
   public:
-    work(std::function<void()>&& func) { m_func = std::move(func); }
+    work(func_t&& func) { m_func = std::move(func); }
 
   private:
-    std::function<void()> m_func = nullptr;
+    // Used in WORK_STEALING mode to know who owns the work
+    enum class state { PENDING, RUNNING, CANCELED, FREE };
+
+    // The state is stored in the 2 lowest bits of m_state, and the
+    // rest of bits are the generation of the work (incremented each
+    // time the work is reused).
+    static uint64_t make_state(const uint64_t generation, const state s)
+    {
+      return (generation << 2) | uint64_t(s);
+    }
+    static state get_state(const uint64_t s) { return state(s & 3); }
+    static uint64_t get_generation(const uint64_t s) { return s >> 2; }
+
+    func_t m_func = nullptr;
+    std::atomic<uint64_t> m_state = make_state(0, state::PENDING);
+    bool m_external = false;   // Created from a non-worker thread
+    size_t m_owner = 0;        // Worker that created the work (if !m_external)
+    work* m_next = nullptr;    // Next work in the queue or in a free list
+    work* m_allNext = nullptr; // Next work in m_allWorks list
   };
 
+  // Kept for compatibility, works are owned by the pool.
   typedef std::unique_ptr<work> work_ptr;
 
-  thread_pool(const size_t n);
+  thread_pool(const size_t n, const mode m = mode::SHARED_QUEUE);
   ~thread_pool();
 
-  const work* execute(std::function<void()>&& func);
+  mode get_mode() const { return m_mode; }
+
+  // Returns the number of worker threads.
+  size_t size() const { return m_threads.size(); }
 
-  // Removes the specified work from the queue if possible. Returns true if it
-  // was able to do so, or false otherwise.
-  bool try_pop(const work* w);
+  const work* execute(func_t&& func);
+
+  // Works are reused after they are executed, so the same work
+  // pointer can be returned for a different function later. The
+  // returned "generation" identifies this specific execution for
+  // try_pop().
+  const work* execute(func_t&& func, uint64_t& generation);
+
+  // Removes the specified work from the queue if possible (only if it
+  // wasn't reused for other execution). Returns true if it was able to
+  // do so, or false otherwise.
+  bool try_pop(const work* w, uint64_t generation);
 
   // Waits until the queue is empty.
   void wait_all();
 
 private:
+  struct worker_data;
+
   // Joins all threads without waiting the queue to be processed.
   void join_all();
 
   // Called for each worker thread.
   void worker();
 
-  bool m_running;
+  // Queue of works and free list protected by m_mutex
+  void push_back_locked(work* w);
+  work* pop_front_locked();
+  work* new_work_locked(func_t&& func);
+
+  // WORK_STEALING mode functions
+  void worker_stealing(worker_data& me);
+  work* find_work(worker_data& me);
+  void run_work(worker_data& me, work* w);
+  work* new_work(worker_data& me, func_t&& func);
+  void recycle_work(worker_data& me, work* w);
+  void notify_new_work();
+  void notify_finished_work();
+
+  mode m_mode;
+  std::atomic<bool> m_running;
   std::vector<std::thread> m_threads;
   std::mutex m_mutex;
   std::condition_variable m_cv;
   std::condition_variable m_cvWait;
-  std::deque<work_ptr> m_work;
   int m_doingWork;
+
+  // All works are owned by the pool (they are in the m_allWorks
+  // list) and are recycled after they're executed/canceled, so we
+  // don't allocate memory each time we execute() a new work, and in
+  // WORK_STEALING mode try_pop() can access any work pointer returned
+  // by execute() safely.
+  std::atomic<work*> m_allWorks = nullptr;
+
+  // Works to be executed (SHARED_QUEUE), or works submitted from
+  // non-worker threads (WORK_STEALING), protected by m_mutex.
+  work* m_first = nullptr;
+  work* m_last = nullptr;
+  std::atomic<size_t> m_count = 0;
+
+  // Recycled works to be used from execute() (uses m_mutex).
+  work* m_free = nullptr;
+
+  // Used in WORK_STEALING mode.
+  std::vector<std::unique_ptr<worker_data>> m_workers;
+  std::atomic<work*> m_externalFree = nullptr; // Recycled works with m_external=true
+  std::atomic<int> m_pending = 0;              // Number of enqueued works
+  std::atomic<int> m_active = 0;               // Number of enqueued + running works
+  std::atomic<int> m_sleeping = 0;
 };
 
 } // namespace base
@@ -0,0 +1,59 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/thread_pool.h"
+
+#include <atomic>
+#include <cstdio>
+
+using namespace base;
+
+// Compares the throughput of both modes with small works submitted
+// from the main thread (flat) and from the workers (nested).
+TEST(ThreadPool, Benchmark)
+{
+  const int kWorks = 20000;
+  const int kNested = 100;
+
+  for (const size_t n : { 1, 4, 16, 64 }) {
+    for (const auto mode : { thread_pool::mode::SHARED_QUEUE, thread_pool::mode::WORK_STEALING }) {
+      thread_pool p(n, mode);
+      std::atomic<int> c(0);
+
+      Chrono t;
+      for (int i = 0; i < kWorks; ++i)
+        p.execute([&c] { ++c; });
+      p.wait_all();
+      const double flat = t.elapsed();
+
+      t.reset();
+      for (int i = 0; i < kWorks / kNested; ++i) {
+        p.execute([&p, &c] {
+          for (int j = 0; j < kNested; ++j)
+            p.execute([&c] { ++c; });
+        });
+      }
+      p.wait_all();
+      const double nested = t.elapsed();
+
+      EXPECT_EQ(2 * kWorks, c);
+      std::printf("%-14s threads=%-3d flat=%8.3f ms nested=%8.3f ms\n",
+                  (mode == thread_pool::mode::SHARED_QUEUE ? "shared_queue" : "work_stealing"),
+                  int(n),
+                  flat * 1000.0,
+                  nested * 1000.0);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -8,13 +8,43 @@
 
 #include "base/thread_pool.h"
 
+#include <array>
 #include <atomic>
+#include <cstdlib>
+#include <new>
 
 using namespace base;
 
-TEST(ThreadPool, Basic)
+// Counts all memory allocations of the program to test that execute()
+// doesn't allocate memory (base/memory.cpp replaces these operators
+// when LAF_MEMLEAK is enabled).
+#ifndef LAF_MEMLEAK
+static std::atomic<size_t> g_allocs(0);
+
+void* operator new(std::size_t size)
+{
+  ++g_allocs;
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
 {
-  thread_pool p(10);
+  std::free(p);
+}
+#endif
+
+class ThreadPoolModes : public testing::TestWithParam<thread_pool::mode> {};
+
+TEST_P(ThreadPoolModes, Basic)
+{
+  thread_pool p(10, GetParam());
   std::atomic<int> c(0);
   for (int i = 0; i < 10000; ++i)
     p.execute([&c] { ++c; });
@@ -23,6 +53,169 @@ TEST(ThreadPool, Basic)
   EXPECT_EQ(10000, c);
 }
 
+TEST_P(ThreadPoolModes, ExecuteFromWorkers)
+{
+  thread_pool p(8, GetParam());
+  std::atomic<int> c(0);
+  for (int i = 0; i < 100; ++i) {
+    p.execute([&p, &c] {
+      for (int j = 0; j < 100; ++j)
+        p.execute([&c] { ++c; });
+    });
+  }
+  p.wait_all();
+
+  EXPECT_EQ(10000, c);
+}
+
+TEST_P(ThreadPoolModes, TryPop)
+{
+  thread_pool p(1, GetParam());
+  std::atomic<bool> block(true);
+  std::atomic<int> c(0);
+
+  // Block the only worker so the next works remain enqueued
+  p.execute([&block] {
+    while (block)
+      std::this_thread::yield();
+  });
+
+  std::vector<const thread_pool::work*> works;
+  std::vector<uint64_t> generations;
+  for (int i = 0; i < 10; ++i) {
+    uint64_t generation;
+    works.push_back(p.execute([&c] { ++c; }, generation));
+    generations.push_back(generation);
+  }
+
+  for (int i = 0; i < 10; i += 2)
+    EXPECT_TRUE(p.try_pop(works[i], generations[i]));
+  EXPECT_FALSE(p.try_pop(works[0], generations[0]));
+
+  block = false;
+  p.wait_all();
+  EXPECT_EQ(5, c);
+}
+
+// Works are reused after they are executed, try_pop() with the
+// generation of a previous execution must not cancel the new work.
+TEST_P(ThreadPoolModes, TryPopReusedWork)
+{
+  thread_pool p(1, GetParam());
+  std::atomic<bool> block(true);
+  std::atomic<int> c(0);
+  auto blocker = [&block] {
+    while (block)
+      std::this_thread::yield();
+  };
+
+  uint64_t genA, genB;
+  const thread_pool::work* a = p.execute(blocker, genA);
+  const thread_pool::work* b = p.execute([&c] { ++c; }, genB);
+  block = false;
+  p.wait_all();
+
+  // Block the only worker again, the pending work reuses "a" or "b"
+  block = true;
+  p.execute(blocker);
+  uint64_t gen;
+  const thread_pool::work* w = p.execute([&c] { ++c; }, gen);
+  EXPECT_TRUE(w == a || w == b);
+
+  const uint64_t oldGen = (w == a ? genA : genB);
+  EXPECT_NE(oldGen, gen);
+  EXPECT_FALSE(p.try_pop(w, oldGen));
+  EXPECT_TRUE(p.try_pop(w, gen));
+  EXPECT_FALSE(p.try_pop(w, gen));
+
+  block = false;
+  p.wait_all();
+  EXPECT_EQ(1, c);
+}
+
+TEST_P(ThreadPoolModes, WaitAllTwice)
+{
+  thread_pool p(4, GetParam());
+  std::atomic<int> c(0);
+  for (int k = 1; k <= 2; ++k) {
+    for (int i = 0; i < 1000; ++i)
+      p.execute([&c] { ++c; });
+    p.wait_all();
+    EXPECT_EQ(1000 * k, c);
+  }
+}
+
+#ifndef LAF_MEMLEAK
+TEST_P(ThreadPoolModes, ExecuteWithoutAllocations)
+{
+  const int kWorks = 1000;
+  thread_pool p(4, GetParam());
+  std::atomic<bool> gate;
+  std::atomic<int> c(0);
+
+  // A capture of 64 bytes
+  std::array<char, 64 - sizeof(void*) * 2> data;
+  data.fill(1);
+
+  auto submit = [&]() -> size_t {
+    gate = false;
+    const size_t before = g_allocs;
+    for (int i = 0; i < kWorks; ++i) {
+      p.execute([&gate, &c, data] {
+        while (!gate)
+          std::this_thread::yield();
+        c += data[0];
+      });
+    }
+    const size_t allocs = g_allocs - before;
+    gate = true;
+    p.wait_all();
+    return allocs;
+  };
+
+  // The first time we need to create the works, then they are recycled
+  EXPECT_LT(size_t(0), submit());
+  EXPECT_EQ(size_t(0), submit());
+  EXPECT_EQ(size_t(0), submit());
+  EXPECT_EQ(3 * kWorks, c);
+}
+
+// Works submitted from workers are recycled by the worker that
+// created them (even if other workers steal and execute them), so
+// each worker allocates its works only once.
+TEST_P(ThreadPoolModes, ExecuteFromWorkersWithoutAllocations)
+{
+  const int kWorkers = 4;
+  const int kWorks = 200;
+  const int kRounds = 20;
+  thread_pool p(kWorkers, GetParam());
+  std::atomic<size_t> allocs(0);
+  std::atomic<int> c(0);
+
+  for (int round = 0; round < kRounds; ++round) {
+    p.execute([&p, &allocs, &c] {
+      const size_t before = g_allocs;
+      for (int i = 0; i < kWorks; ++i) {
+        p.execute([&c] {
+          std::this_thread::yield();
+          ++c;
+        });
+      }
+      allocs += g_allocs - before;
+    });
+    p.wait_all();
+  }
+
+  EXPECT_LE(allocs, size_t(kWorkers * kWorks));
+  EXPECT_EQ(kRounds * kWorks, c);
+}
+#endif
+
+INSTANTIATE_TEST_SUITE_P(ThreadPool,
+                         ThreadPoolModes,
+                         testing::Values(thread_pool::mode::SHARED_QUEUE,
+                                         thread_pool::mode::WORK_STEALING));
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
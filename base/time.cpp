@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2021-2022 Igara Studio S.A.
+// Copyright (c) 2021-2026 Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,6 +11,8 @@
 
 #include "base/time.h"
 
+#include "base/clock.h"
+
 #if LAF_WINDOWS
   #include <windows.h>
 #else
@@ -71,10 +73,7 @@ tick_t current_tick()
   return tick_t(double(mach_absolute_time()) * double(timebase.numer) / double(timebase.denom) /
                 1.0e6);
 #else
-  // TODO use clock_gettime(CLOCK_MONOTONIC, &now); if it's possible
-  struct timeval now;
-  gettimeofday(&now, nullptr);
-  return now.tv_sec * 1000 + now.tv_usec / 1000;
+  return tick_t(now_ns() / 1000000);
 #endif
 }
 
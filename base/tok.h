@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2024 Igara Studio S.A.
+// Copyright (c) 2024-2026 Igara Studio S.A.
 // Copyright (c) 2020 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,8 +11,14 @@
 #define BASE_TOK_H_INCLUDED
 #pragma once
 
+#include "base/ints.h"
+
+#include <cstddef>
 #include <iterator>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace base { namespace tok {
 
@@ -104,6 +110,225 @@ token_range<T, include_empties> csv(const T& str, typename T::value_type chr = '
   return token_range<T, include_empties>(str, chr);
 }
 
+//////////////////////////////////////////////////////////////////////
+// string_view tokenizers
+//
+// These variants return std::string_view tokens pointing to the
+// original string (so they don't allocate memory), and the
+// delimiter can be a char, a multi-character string, a set of chars
+// (any_of), or a predicate.
+//
+//   for (std::string_view line : split_tokens_view(text, "\r\n")) {
+//     for (std::string_view field : csv_view(line, ';'))
+//       ...
+//   }
+
+// Matches any of the given chars (like std::string::find_first_of()
+// but using a lookup table).
+class any_of {
+public:
+  explicit any_of(const std::string_view chars)
+  {
+    for (const char c : chars)
+      m_table[uint8_t(c) >> 6] |= (uint64_t(1) << (uint8_t(c) & 63));
+  }
+
+  bool operator()(const char c) const
+  {
+    return (m_table[uint8_t(c) >> 6] & (uint64_t(1) << (uint8_t(c) & 63))) != 0;
+  }
+
+private:
+  uint64_t m_table[4] = { 0, 0, 0, 0 };
+};
+
+namespace details {
+
+// Each delimiter returns the position and length of the next
+// delimiter found from "pos" (or npos if there is no more
+// delimiters).
+using delimiter_match = std::pair<std::size_t, std::size_t>;
+
+struct char_delimiter {
+  char chr;
+
+  delimiter_match find(const std::string_view str, const std::size_t pos) const
+  {
+    return { str.find(chr, pos), 1 };
+  }
+};
+
+struct string_delimiter {
+  std::string_view seq;
+
+  delimiter_match find(const std::string_view str, const std::size_t pos) const
+  {
+    // An empty delimiter doesn't split the string
+    if (seq.empty())
+      return { std::string_view::npos, 0 };
+    return { str.find(seq, pos), seq.size() };
+  }
+};
+
+template<typename Pred>
+struct predicate_delimiter {
+  Pred pred;
+
+  delimiter_match find(const std::string_view str, std::size_t pos) const
+  {
+    for (; pos < str.size(); ++pos) {
+      if (pred(str[pos]))
+        return { pos, 1 };
+    }
+    return { std::string_view::npos, 1 };
+  }
+};
+
+inline char_delimiter make_delimiter(const char chr)
+{
+  return char_delimiter{ chr };
+}
+
+inline string_delimiter make_delimiter(const std::string_view seq)
+{
+  return string_delimiter{ seq };
+}
+
+inline string_delimiter make_delimiter(const char* seq)
+{
+  return string_delimiter{ seq };
+}
+
+template<typename Pred, typename = std::enable_if_t<std::is_invocable_r_v<bool, Pred, char>>>
+inline predicate_delimiter<Pred> make_delimiter(Pred pred)
+{
+  return predicate_delimiter<Pred>{ std::move(pred) };
+}
+
+} // namespace details
+
+template<typename Delim, typename EmptyPolicy>
+class view_token_iterator {
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = std::string_view;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const std::string_view*;
+  using reference = std::string_view;
+
+  // Creates the end iterator
+  view_token_iterator(const std::string_view str, const Delim& delim) : m_str(str), m_delim(delim)
+  {
+  }
+
+  // Creates the iterator pointing to the first token
+  view_token_iterator(const std::string_view str, const Delim& delim, std::size_t next)
+    : m_str(str)
+    , m_delim(delim)
+    , m_next(next)
+  {
+    operator++();
+  }
+
+  view_token_iterator& operator++()
+  {
+    std::size_t pos = m_next;
+    if (pos == npos) {
+      m_token = npos; // No more tokens
+      return *this;
+    }
+
+    details::delimiter_match match;
+    while (true) {
+      match = m_delim.find(m_str, pos);
+      if constexpr (!EmptyPolicy::allow_empty) {
+        if (match.first == pos && match.second > 0) {
+          pos += match.second;
+          continue;
+        }
+        if (pos == m_str.size()) {
+          m_token = m_next = npos;
+          return *this;
+        }
+      }
+      break;
+    }
+
+    m_token = pos;
+    if (match.first == npos) {
+      m_tokenEnd = m_str.size();
+      m_next = npos;
+    }
+    else {
+      m_tokenEnd = match.first;
+      m_next = match.first + match.second;
+    }
+    return *this;
+  }
+
+  view_token_iterator operator++(int)
+  {
+    view_token_iterator old(*this);
+    operator++();
+    return old;
+  }
+
+  std::string_view operator*() const { return m_str.substr(m_token, m_tokenEnd - m_token); }
+
+  bool operator==(const view_token_iterator& that) const { return m_token == that.m_token; }
+  bool operator!=(const view_token_iterator& that) const { return m_token != that.m_token; }
+
+private:
+  static constexpr std::size_t npos = std::string_view::npos;
+
+  std::string_view m_str;
+  Delim m_delim;
+  std::size_t m_token = npos; // Start of the current token (npos = end)
+  std::size_t m_tokenEnd = npos;
+  std::size_t m_next = npos; // Start of the next token
+};
+
+template<typename Delim, typename Empties>
+class view_token_range {
+public:
+  using iterator = view_token_iterator<Delim, Empties>;
+
+  view_token_range(const std::string_view str, Delim delim) : m_str(str), m_delim(std::move(delim))
+  {
+  }
+
+  iterator begin() const { return iterator(m_str, m_delim, 0); }
+  iterator end() const { return iterator(m_str, m_delim); }
+
+private:
+  std::string_view m_str;
+  Delim m_delim;
+};
+
+// Splits the string ignoring empty tokens (e.g. "a  b" -> "a", "b").
+//
+// String delimiters are not copied, so they must outlive the
+// returned range (temporary std::string delimiters are not allowed).
+template<typename D>
+auto split_tokens_view(const std::string_view str, const D& delim)
+{
+  using Delim = decltype(details::make_delimiter(delim));
+  return view_token_range<Delim, ignore_empties>(str, details::make_delimiter(delim));
+}
+
+void split_tokens_view(std::string_view str, std::string&& delim) = delete;
+
+// Splits the string including empty fields, N delimiters always
+// generate N+1 fields (e.g. ",a," -> "", "a", "").
+template<typename D = char>
+auto csv_view(const std::string_view str, const D& delim = ',')
+{
+  using Delim = decltype(details::make_delimiter(delim));
+  return view_token_range<Delim, include_empties>(str, details::make_delimiter(delim));
+}
+
+void csv_view(std::string_view str, std::string&& delim) = delete;
+
 }} // namespace base::tok
 
 #endif
@@ -0,0 +1,45 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/tok.h"
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+TEST(Tok, Benchmark)
+{
+  std::string text;
+  for (int i = 0; i < 200000; ++i)
+    text += "field" + std::to_string(i) + ",12.5,,some longer text value\n";
+
+  base::Chrono chrono;
+  size_t n = 0;
+  for (const auto& line : base::tok::split_tokens(text, '\n'))
+    for (const auto& field : base::tok::csv(line, ','))
+      n += field.size();
+  const double t0 = chrono.elapsed();
+
+  chrono.reset();
+  size_t m = 0;
+  for (std::string_view line : base::tok::split_tokens_view(text, '\n'))
+    for (std::string_view field : base::tok::csv_view(line, ','))
+      m += field.size();
+  const double t1 = chrono.elapsed();
+
+  EXPECT_EQ(n, m);
+  const double mb = text.size() / 1024.0 / 1024.0;
+  std::printf("csv      %.2f MB/s\ncsv_view %.2f MB/s\n", mb / t0, mb / t1);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2024 Igara Studio S.A.
+// Copyright (c) 2024-2026 Igara Studio S.A.
 // Copyright (c) 2020 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,12 +9,38 @@
 
 #include <gtest/gtest.h>
 
+#include <cctype>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "base/tok.h"
 
+template<typename Range>
+static std::vector<std::string> to_vector(const Range& range)
+{
+  std::vector<std::string> result;
+  for (std::string_view tok : range)
+    result.emplace_back(tok);
+  return result;
+}
+
+using strings = std::vector<std::string>;
+
+// Checks if a temporary delimiter of type D can be used.
+template<typename D, typename = void>
+struct accepts_temporary_delimiter : std::false_type {};
+
+template<typename D>
+struct accepts_temporary_delimiter<
+  D,
+  std::void_t<decltype(base::tok::split_tokens_view(std::string_view(), std::declval<D>())),
+              decltype(base::tok::csv_view(std::string_view(), std::declval<D>()))>>
+  : std::true_type {};
+
 TEST(Tok, SplitTokens)
 {
   int i = 0;
@@ -39,6 +65,62 @@ TEST(Tok, Csv)
   }
 }
 
+TEST(Tok, SplitTokensView)
+{
+  using base::tok::split_tokens_view;
+
+  EXPECT_EQ(strings({ "This", "is", "a", "phrase." }),
+            to_vector(split_tokens_view("  This is  a phrase. ", ' ')));
+  EXPECT_EQ(strings(), to_vector(split_tokens_view("", ' ')));
+  EXPECT_EQ(strings(), to_vector(split_tokens_view("   ", ' ')));
+  EXPECT_EQ(strings({ "abc" }), to_vector(split_tokens_view("abc", ' ')));
+
+  // Multi-character delimiters
+  EXPECT_EQ(strings({ "a", "b", "c:d" }), to_vector(split_tokens_view("::a::::b::c:d::", "::")));
+  EXPECT_EQ(strings({ "line1", "line2" }), to_vector(split_tokens_view("line1\r\nline2", "\r\n")));
+  EXPECT_EQ(strings({ "a b" }), to_vector(split_tokens_view("a b", "")));
+
+  // The range references the std::string delimiter (so it cannot be
+  // a temporary)
+  const std::string delim = "::";
+  const auto range = split_tokens_view("a::b", delim);
+  EXPECT_EQ(strings({ "a", "b" }), to_vector(range));
+  static_assert(!accepts_temporary_delimiter<std::string>::value);
+  static_assert(accepts_temporary_delimiter<const char*>::value);
+  static_assert(accepts_temporary_delimiter<std::string_view>::value);
+
+  // Predicates
+  EXPECT_EQ(strings({ "a", "b", "c" }),
+            to_vector(split_tokens_view(" a\t\nb  c\n", [](char c) { return std::isspace(c); })));
+  EXPECT_EQ(strings({ "key", "value", "x" }),
+            to_vector(split_tokens_view("key= value;x", base::tok::any_of("=; "))));
+}
+
+TEST(Tok, CsvView)
+{
+  using base::tok::csv_view;
+
+  EXPECT_EQ(strings({ "In comma", "separated", "", "values", "", "", "empties are included" }),
+            to_vector(csv_view("In comma,separated,,values,,,empties are included")));
+  EXPECT_EQ(strings({ "" }), to_vector(csv_view("")));
+  EXPECT_EQ(strings({ "", "" }), to_vector(csv_view(",")));
+  EXPECT_EQ(strings({ "", "a", "" }), to_vector(csv_view(",a,")));
+  EXPECT_EQ(strings({ "a", "", "b" }), to_vector(csv_view("a;;b", ';')));
+  EXPECT_EQ(strings({ "a", "b", "" }), to_vector(csv_view("a<>b<>", "<>")));
+  EXPECT_EQ(strings({ "a", "b", "", "c" }), to_vector(csv_view("a,b;,c", base::tok::any_of(",;"))));
+
+  const std::string delim = "<>";
+  const auto range = csv_view("a<>b", delim);
+  EXPECT_EQ(strings({ "a", "b" }), to_vector(range));
+
+  // Tokens point to the original string
+  const std::string_view str = "abc,def";
+  auto it = csv_view(str).begin();
+  EXPECT_EQ(str.data(), (*it).data());
+  ++it;
+  EXPECT_EQ(str.data() + 4, (*it).data());
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,521 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/trace.h"
+
+#include "base/clock.h"
+#include "base/debug.h"
+#include "base/fstream_path.h"
+#include "base/serialization.h"
+#include "base/thread.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace base { namespace trace {
+
+namespace details {
+std::atomic<bool> enabled = false;
+}
+
+namespace {
+
+enum class event_type : uint8_t { Zone, Counter, Instant };
+
+struct event {
+  const char* name;
+  uint64_t time;
+  union {
+    uint64_t duration; // Zone
+    double value;      // Counter
+  };
+  event_type type;
+};
+
+// Events are stored in a linked list of chunks. Only the owner thread
+// adds events and chunks, other threads can read the "count" events
+// of each chunk at any time.
+struct chunk {
+  static constexpr size_t kSize = 1024;
+
+  event events[kSize];
+  std::atomic<size_t> count = 0;
+  std::atomic<chunk*> next = nullptr;
+};
+
+struct thread_buffer {
+  uint32_t tid;
+  std::string name; // Protected by buffers_mutex
+  std::unique_ptr<chunk> head;
+  chunk* tail = nullptr;
+  size_t total = 0;
+  std::atomic<bool> writing = false; // The owner thread is recording an event
+  std::atomic<bool> orphan = false;  // The owner thread has finished
+
+  ~thread_buffer()
+  {
+    // Delete the list iteratively
+    chunk* c = head->next.load();
+    while (c) {
+      chunk* next = c->next.load();
+      delete c;
+      c = next;
+    }
+  }
+
+  void reset()
+  {
+    chunk* c = head->next.exchange(nullptr);
+    while (c) {
+      chunk* next = c->next.load();
+      delete c;
+      c = next;
+    }
+    head->count = 0;
+    tail = head.get();
+    total = 0;
+  }
+};
+
+std::atomic<size_t> max_events = 0;
+std::atomic<size_t> dropped = 0;
+std::atomic<uint64_t> start_time = 0;
+
+std::mutex buffers_mutex;
+std::vector<std::shared_ptr<thread_buffer>> buffers;
+uint32_t next_tid = 1;
+
+thread_buffer* this_thread_buffer()
+{
+  struct buffer_ref {
+    std::shared_ptr<thread_buffer> buf;
+    ~buffer_ref()
+    {
+      if (buf)
+        buf->orphan.store(true);
+    }
+  };
+  thread_local buffer_ref ref;
+
+  if (!ref.buf) {
+    auto buf = std::make_shared<thread_buffer>();
+    buf->name = base::this_thread::get_name();
+    buf->head = std::make_unique<chunk>();
+    buf->tail = buf->head.get();
+    {
+      const std::lock_guard lock(buffers_mutex);
+      buf->tid = next_tid++;
+      buffers.push_back(buf);
+    }
+    ref.buf = std::move(buf);
+  }
+  return ref.buf.get();
+}
+
+void record(const event& ev)
+{
+  thread_buffer* buf = this_thread_buffer();
+  buf->writing.store(true);
+  if (details::enabled.load()) {
+    if (buf->total < max_events.load(std::memory_order_relaxed)) {
+      chunk* c = buf->tail;
+      size_t n = c->count.load(std::memory_order_relaxed);
+      if (n == chunk::kSize) {
+        auto newChunk = new chunk;
+        c->next.store(newChunk, std::memory_order_release);
+        buf->tail = c = newChunk;
+        n = 0;
+      }
+      c->events[n] = ev;
+      c->count.store(n + 1, std::memory_order_release);
+      ++buf->total;
+    }
+    else {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  buf->writing.store(false, std::memory_order_release);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Snapshot of the recorded events used to export them
+
+struct snapshot_event {
+  event_type type;
+  uint32_t name; // Index in snapshot::names
+  uint64_t time; // Relative to the start time
+  uint64_t duration = 0;
+  double value = 0.0;
+};
+
+struct snapshot_thread {
+  uint32_t tid;
+  std::string name;
+  std::vector<snapshot_event> events;
+};
+
+struct snapshot {
+  std::vector<std::string> names;
+  std::vector<snapshot_thread> threads;
+};
+
+void take_snapshot(snapshot& snap)
+{
+  const uint64_t t0 = start_time.load();
+  std::unordered_map<const char*, uint32_t> nameIndexes;
+
+  const std::lock_guard lock(buffers_mutex);
+  for (const auto& buf : buffers) {
+    snapshot_thread& thread = snap.threads.emplace_back();
+    thread.tid = buf->tid;
+    thread.name = buf->name;
+
+    for (const chunk* c = buf->head.get(); c; c = c->next.load(std::memory_order_acquire)) {
+      const size_t n = c->count.load(std::memory_order_acquire);
+      for (size_t i = 0; i < n; ++i) {
+        const event& ev = c->events[i];
+        auto it = nameIndexes.find(ev.name);
+        if (it == nameIndexes.end()) {
+          it = nameIndexes.insert({ ev.name, uint32_t(snap.names.size()) }).first;
+          snap.names.push_back(ev.name);
+        }
+
+        snapshot_event& sev = thread.events.emplace_back();
+        sev.type = ev.type;
+        sev.name = it->second;
+        sev.time = (ev.time > t0 ? ev.time - t0 : 0);
+        if (ev.type == event_type::Zone)
+          sev.duration = ev.duration;
+        else if (ev.type == event_type::Counter)
+          sev.value = ev.value;
+      }
+    }
+  }
+}
+
+void write_json_string(std::ostream& os, const std::string& str)
+{
+  os.put('"');
+  for (const char c : str) {
+    switch (c) {
+      case '"':  os << "\\\""; break;
+      case '\\': os << "\\\\"; break;
+      case '\n': os << "\\n"; break;
+      case '\r': os << "\\r"; break;
+      case '\t': os << "\\t"; break;
+      default:
+        if (uint8_t(c) < 0x20) {
+          char buf[8];
+          std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+          os << buf;
+        }
+        else
+          os.put(c);
+        break;
+    }
+  }
+  os.put('"');
+}
+
+// Writes a time in microseconds (the unit used by Chrome) keeping
+// the nanoseconds precision.
+void write_json_time(std::ostream& os, const uint64_t ns)
+{
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%" PRIu64 ".%03u", ns / 1000, unsigned(ns % 1000));
+  os << buf;
+}
+
+void write_json(const snapshot& snap, std::ostream& os)
+{
+  os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  auto begin_event = [&os, &first](const uint32_t tid) {
+    os << (first ? "\n" : ",\n") << "{\"pid\":1,\"tid\":" << tid;
+    first = false;
+  };
+
+  for (const auto& thread : snap.threads) {
+    if (!thread.name.empty()) {
+      begin_event(thread.tid);
+      os << ",\"ph\":\"M\",\"name\":\"thread_name\",\"args\":{\"name\":";
+      write_json_string(os, thread.name);
+      os << "}}";
+    }
+
+    for (const auto& ev : thread.events) {
+      begin_event(thread.tid);
+      os << ",\"name\":";
+      write_json_string(os, snap.names[ev.name]);
+      os << ",\"ts\":";
+      write_json_time(os, ev.time);
+      switch (ev.type) {
+        case event_type::Zone:
+          os << ",\"ph\":\"X\",\"dur\":";
+          write_json_time(os, ev.duration);
+          break;
+        case event_type::Counter: {
+          char buf[32];
+          std::snprintf(buf, sizeof(buf), "%.17g", ev.value);
+          os << ",\"ph\":\"C\",\"args\":{\"value\":" << buf << "}";
+          break;
+        }
+        case event_type::Instant: os << ",\"ph\":\"i\",\"s\":\"t\""; break;
+      }
+      os << "}";
+    }
+  }
+  os << "\n]}\n";
+}
+
+//////////////////////////////////////////////////////////////////////
+// Binary format
+//
+// "LAFT" version(u8)
+// names: count(varint) { length(varint) bytes }
+// threads: count(varint) { tid(varint) name(varint+bytes) count(varint)
+//   { type(u8) name(varint) time-delta(svarint)
+//     [duration(varint) for zones | value(double) for counters] } }
+
+const uint8_t kMagic[4] = { 'L', 'A', 'F', 'T' };
+const uint8_t kVersion = 1;
+
+void write_string(serialization::writer& w, const std::string& str)
+{
+  w.write_varint(str.size());
+  w.write_bytes(str.data(), str.size());
+}
+
+bool read_string(serialization::reader& r, std::string& str)
+{
+  const uint64_t size = r.read_varint();
+  if (!r.ok() || size > r.remaining())
+    return false;
+  str.assign(reinterpret_cast<const char*>(r.data()), size_t(size));
+  return r.skip(size_t(size));
+}
+
+void write_binary(const snapshot& snap, buffer& buf)
+{
+  serialization::writer w(buf, serialization::endian::little);
+  w.write_bytes(kMagic, sizeof(kMagic));
+  w.write8(kVersion);
+
+  w.write_varint(snap.names.size());
+  for (const auto& name : snap.names)
+    write_string(w, name);
+
+  w.write_varint(snap.threads.size());
+  for (const auto& thread : snap.threads) {
+    w.write_varint(thread.tid);
+    write_string(w, thread.name);
+    w.write_varint(thread.events.size());
+
+    uint64_t time = 0;
+    for (const auto& ev : thread.events) {
+      w.write8(uint8_t(ev.type));
+      w.write_varint(ev.name);
+      w.write_svarint(int64_t(ev.time - time));
+      time = ev.time;
+      if (ev.type == event_type::Zone)
+        w.write_varint(ev.duration);
+      else if (ev.type == event_type::Counter)
+        w.write_double(ev.value);
+    }
+  }
+}
+
+bool read_binary(const void* data, const size_t size, snapshot& snap)
+{
+  serialization::reader r(data, size, serialization::endian::little);
+  uint8_t magic[4];
+  if (!r.read_bytes(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+      r.read8() != kVersion) {
+    return false;
+  }
+
+  const uint64_t nnames = r.read_varint();
+  if (!r.ok() || nnames > r.remaining())
+    return false;
+  snap.names.resize(size_t(nnames));
+  for (auto& name : snap.names) {
+    if (!read_string(r, name))
+      return false;
+  }
+
+  const uint64_t nthreads = r.read_varint();
+  if (!r.ok() || nthreads > r.remaining())
+    return false;
+  snap.threads.resize(size_t(nthreads));
+  for (auto& thread : snap.threads) {
+    thread.tid = uint32_t(r.read_varint());
+    if (!read_string(r, thread.name))
+      return false;
+
+    const uint64_t nevents = r.read_varint();
+    if (!r.ok() || nevents > r.remaining())
+      return false;
+    thread.events.resize(size_t(nevents));
+
+    uint64_t time = 0;
+    for (auto& ev : thread.events) {
+      const uint8_t type = r.read8();
+      if (type > uint8_t(event_type::Instant))
+        return false;
+      ev.type = event_type(type);
+      ev.name = uint32_t(r.read_varint());
+      if (ev.name >= snap.names.size())
+        return false;
+      time += uint64_t(r.read_svarint());
+      ev.time = time;
+      if (ev.type == event_type::Zone)
+        ev.duration = r.read_varint();
+      else if (ev.type == event_type::Counter)
+        ev.value = r.read_double();
+    }
+  }
+  return r.ok();
+}
+
+} // anonymous namespace
+
+void details::record_zone(const char* name, const uint64_t start, const uint64_t end)
+{
+  event ev;
+  ev.name = name;
+  ev.time = start;
+  ev.duration = end - start;
+  ev.type = event_type::Zone;
+  record(ev);
+}
+
+void start(const size_t maxEventsPerThread)
+{
+  max_events = maxEventsPerThread;
+  if (start_time == 0)
+    start_time = now();
+  details::enabled.store(true);
+}
+
+void stop()
+{
+  details::enabled.store(false);
+
+  // Wait the threads that are recording an event
+  const std::lock_guard lock(buffers_mutex);
+  for (const auto& buf : buffers) {
+    while (buf->writing.load())
+      std::this_thread::yield();
+  }
+}
+
+void clear()
+{
+  ASSERT(!is_enabled());
+
+  const std::lock_guard lock(buffers_mutex);
+  for (auto it = buffers.begin(); it != buffers.end();) {
+    if ((*it)->orphan) {
+      it = buffers.erase(it);
+    }
+    else {
+      (*it)->reset();
+      ++it;
+    }
+  }
+  dropped = 0;
+  start_time = 0;
+}
+
+size_t dropped_events()
+{
+  return dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t now()
+{
+  return now_ns();
+}
+
+void counter(const char* name, const double value)
+{
+  if (!is_enabled())
+    return;
+
+  event ev;
+  ev.name = name;
+  ev.time = now();
+  ev.value = value;
+  ev.type = event_type::Counter;
+  record(ev);
+}
+
+void instant(const char* name)
+{
+  if (!is_enabled())
+    return;
+
+  event ev;
+  ev.name = name;
+  ev.time = now();
+  ev.duration = 0;
+  ev.type = event_type::Instant;
+  record(ev);
+}
+
+void set_thread_name(const std::string& name)
+{
+  thread_buffer* buf = this_thread_buffer();
+  const std::lock_guard lock(buffers_mutex);
+  buf->name = name;
+}
+
+void write_chrome_json(std::ostream& os)
+{
+  snapshot snap;
+  take_snapshot(snap);
+  write_json(snap, os);
+}
+
+bool save_chrome_json(const std::string& filename)
+{
+  std::ofstream f(FSTREAM_PATH(filename), std::ios::binary);
+  if (!f)
+    return false;
+  write_chrome_json(f);
+  return bool(f);
+}
+
+void write_binary(buffer& buf)
+{
+  snapshot snap;
+  take_snapshot(snap);
+  write_binary(snap, buf);
+}
+
+bool binary_to_chrome_json(const void* data, const size_t size, std::ostream& os)
+{
+  snapshot snap;
+  if (!read_binary(data, size, snap))
+    return false;
+  write_json(snap, os);
+  return true;
+}
+
+}} // namespace base::trace
@@ -0,0 +1,118 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_TRACE_H_INCLUDED
+#define BASE_TRACE_H_INCLUDED
+#pragma once
+
+#include "base/buffer.h"
+#include "base/ints.h"
+
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+// Records the time spent from this line to the end of the current
+// scope. When tracing is disabled it only checks an atomic flag.
+//
+//   void Window::paint()
+//   {
+//     LAF_TRACE_ZONE("Window::paint");
+//     ...
+//   }
+//
+#define LAF_TRACE_ZONE(name) base::trace::zone LAF_TRACE_CONCAT_(laf_trace_zone_, __LINE__)(name)
+#define LAF_TRACE_FUNCTION() LAF_TRACE_ZONE(__func__)
+#define LAF_TRACE_CONCAT_(a, b) LAF_TRACE_CONCAT2_(a, b)
+#define LAF_TRACE_CONCAT2_(a, b) a##b
+
+namespace base { namespace trace {
+
+// Each thread records its events in its own buffer (without locks),
+// and all buffers can be exported to the Chrome trace event format
+// (chrome://tracing or https://ui.perfetto.dev) or to a compact
+// binary format.
+//
+// Event names are not copied, they must be string literals (or
+// strings that live until the trace is exported).
+
+// Starts recording events. Each thread can record up to
+// "maxEventsPerThread" events, the rest are dropped.
+void start(size_t maxEventsPerThread = 1024 * 1024);
+
+// Stops recording (waits the threads that are recording an event
+// right now).
+void stop();
+
+// Removes all recorded events. Must be called when the tracing is
+// stopped.
+void clear();
+
+// Number of events that were dropped because a buffer was full.
+size_t dropped_events();
+
+namespace details {
+extern std::atomic<bool> enabled;
+void record_zone(const char* name, uint64_t start, uint64_t end);
+} // namespace details
+
+inline bool is_enabled()
+{
+  return details::enabled.load(std::memory_order_relaxed);
+}
+
+// Returns the time used in events (in nanoseconds).
+uint64_t now();
+
+// Adds a new value of the given counter (shown as a graph).
+void counter(const char* name, double value);
+
+// Adds an event without duration.
+void instant(const char* name);
+
+// Changes the name of the current thread in the trace. By default
+// threads use the base::this_thread::get_name() name.
+void set_thread_name(const std::string& name);
+
+// Records the time between its construction and destruction.
+class zone {
+public:
+  explicit zone(const char* name)
+    : m_name(is_enabled() ? name : nullptr)
+    , m_start(m_name ? now() : 0)
+  {
+  }
+
+  ~zone()
+  {
+    if (m_name)
+      details::record_zone(m_name, m_start, now());
+  }
+
+  zone(const zone&) = delete;
+  zone& operator=(const zone&) = delete;
+
+private:
+  const char* m_name;
+  uint64_t m_start;
+};
+
+// Exports all recorded events in the Chrome trace event JSON format.
+void write_chrome_json(std::ostream& os);
+bool save_chrome_json(const std::string& filename);
+
+// Exports all recorded events in a compact binary format (names are
+// stored once, and times as variable-length integers).
+void write_binary(buffer& buf);
+
+// Converts a trace exported with write_binary() to the Chrome JSON
+// format. Returns false if the data is not valid.
+bool binary_to_chrome_json(const void* data, size_t size, std::ostream& os);
+
+}} // namespace base::trace
+
+#endif
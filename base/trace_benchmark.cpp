@@ -0,0 +1,53 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/trace.h"
+
+#include <cstdio>
+
+using namespace base;
+
+static void zones(const int n)
+{
+  for (int i = 0; i < n; ++i) {
+    LAF_TRACE_ZONE("zone");
+  }
+}
+
+TEST(Trace, Benchmark)
+{
+  const int n = 1000000;
+  trace::clear();
+
+  Chrono chrono;
+  zones(n);
+  const double t0 = chrono.elapsed();
+
+  trace::start(n);
+  chrono.reset();
+  zones(n);
+  const double t1 = chrono.elapsed();
+  trace::stop();
+
+  chrono.reset();
+  buffer buf;
+  trace::write_binary(buf);
+  const double t2 = chrono.elapsed();
+
+  std::printf("Disabled zone %.2f ns\n", t0 * 1e9 / n);
+  std::printf("Enabled zone  %.2f ns\n", t1 * 1e9 / n);
+  std::printf("Binary export %.2f MB (%.2f ms)\n", buf.size() / 1024.0 / 1024.0, t2 * 1000.0);
+  trace::clear();
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
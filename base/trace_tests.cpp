@@ -0,0 +1,132 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/trace.h"
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace base;
+
+static int count(const std::string& str, const std::string& substr)
+{
+  int n = 0;
+  for (size_t i = str.find(substr); i != std::string::npos; i = str.find(substr, i + 1))
+    ++n;
+  return n;
+}
+
+static std::string chrome_json()
+{
+  std::ostringstream os;
+  trace::write_chrome_json(os);
+  return os.str();
+}
+
+TEST(Trace, Disabled)
+{
+  trace::clear();
+  {
+    LAF_TRACE_ZONE("disabled");
+    trace::counter("disabled", 1);
+    trace::instant("disabled");
+  }
+  EXPECT_EQ(0, count(chrome_json(), "disabled"));
+}
+
+TEST(Trace, Events)
+{
+  trace::clear();
+  trace::start();
+  trace::set_thread_name("Main");
+  {
+    LAF_TRACE_ZONE("outer");
+    {
+      LAF_TRACE_ZONE("inner \"quoted\"");
+    }
+    trace::counter("memory", 1024.5);
+    trace::instant("click");
+  }
+
+  std::thread thread([] {
+    trace::set_thread_name("Worker");
+    for (int i = 0; i < 3000; ++i) {
+      LAF_TRACE_ZONE("work");
+    }
+  });
+  thread.join();
+  trace::stop();
+
+  // Events after stop() are ignored
+  {
+    LAF_TRACE_ZONE("after stop");
+  }
+
+  const std::string json = chrome_json();
+  EXPECT_EQ(0, json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+  EXPECT_EQ(1, count(json, "\"name\":\"outer\""));
+  EXPECT_EQ(1, count(json, "\"name\":\"inner \\\"quoted\\\"\""));
+  EXPECT_EQ(3000, count(json, "\"name\":\"work\""));
+  EXPECT_EQ(3002, count(json, "\"ph\":\"X\""));
+  EXPECT_EQ(1, count(json, "\"ph\":\"C\",\"args\":{\"value\":1024.5}"));
+  EXPECT_EQ(1, count(json, "\"name\":\"click\",\"ts\":"));
+  EXPECT_EQ(1, count(json, "\"args\":{\"name\":\"Main\"}"));
+  EXPECT_EQ(1, count(json, "\"args\":{\"name\":\"Worker\"}"));
+  EXPECT_EQ(0, count(json, "after stop"));
+  EXPECT_EQ(0, trace::dropped_events());
+
+  trace::clear();
+  EXPECT_EQ(0, count(chrome_json(), "\"ph\":\"X\""));
+}
+
+TEST(Trace, Binary)
+{
+  trace::clear();
+  trace::start();
+  for (int i = 0; i < 100; ++i) {
+    LAF_TRACE_ZONE("zone");
+    trace::counter("i", i);
+  }
+  trace::instant("end");
+  trace::stop();
+
+  buffer buf;
+  trace::write_binary(buf);
+  const std::string json = chrome_json();
+  EXPECT_LT(buf.size(), json.size() / 4);
+
+  std::ostringstream os;
+  EXPECT_TRUE(trace::binary_to_chrome_json(buf.data(), buf.size(), os));
+  EXPECT_EQ(json, os.str());
+
+  // Invalid data
+  EXPECT_FALSE(trace::binary_to_chrome_json(buf.data(), buf.size() / 2, os));
+  buf[0] = 'X';
+  EXPECT_FALSE(trace::binary_to_chrome_json(buf.data(), buf.size(), os));
+  trace::clear();
+}
+
+TEST(Trace, Dropped)
+{
+  trace::clear();
+  trace::start(10);
+  for (int i = 0; i < 25; ++i) {
+    LAF_TRACE_ZONE("zone");
+  }
+  trace::stop();
+  EXPECT_EQ(10, count(chrome_json(), "\"ph\":\"X\""));
+  EXPECT_EQ(15, trace::dropped_events());
+  trace::clear();
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
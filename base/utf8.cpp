@@ -0,0 +1,478 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/utf8.h"
+
+#include "base/cpu_features.h"
+
+#include <cstring>
+
+// SSE2 is used without checking the CPU (it's in all x86-64 CPUs)
+#if LAF_X86 && (defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || \
+                (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+  #define UTF8_SSE2 1
+#endif
+
+namespace base {
+
+#if UTF8_SSE2
+static inline int ctz(const unsigned int mask)
+{
+  #if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long i;
+  _BitScanForward(&i, mask);
+  return int(i);
+  #else
+  return __builtin_ctz(mask);
+  #endif
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// Scalar functions
+
+static inline bool is_cont(const uint8_t c)
+{
+  return (c & 0xC0) == 0x80;
+}
+
+// Decodes the valid UTF-8 sequence at "p", returns its length.
+static inline int decode_seq(const uint8_t* p, const uint8_t* end, codepoint_t& chr)
+{
+  const uint8_t c = p[0];
+  if (c < 0x80) {
+    chr = c;
+    return 1;
+  }
+  // Avoid reading past the end with invalid input
+  if (c < 0xE0 || end - p < 3) {
+    chr = ((c & 0x1F) << 6) | (end - p >= 2 ? (p[1] & 0x3F) : 0);
+    return (end - p >= 2 ? 2 : 1);
+  }
+  if (c < 0xF0 || end - p < 4) {
+    chr = ((c & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+    return 3;
+  }
+  chr = ((c & 0x07) << 18) | ((p[1] & 0x3F) << 12) | ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+  return 4;
+}
+
+static inline int encode_seq(codepoint_t chr, uint8_t* out)
+{
+  if (chr < 0x80) {
+    out[0] = uint8_t(chr);
+    return 1;
+  }
+  if (chr < 0x800) {
+    out[0] = uint8_t(0xC0 | (chr >> 6));
+    out[1] = uint8_t(0x80 | (chr & 0x3F));
+    return 2;
+  }
+  if (chr > 0x10FFFF)
+    chr = 0xFFFD;
+  if (chr < 0x10000) {
+    out[0] = uint8_t(0xE0 | (chr >> 12));
+    out[1] = uint8_t(0x80 | ((chr >> 6) & 0x3F));
+    out[2] = uint8_t(0x80 | (chr & 0x3F));
+    return 3;
+  }
+  out[0] = uint8_t(0xF0 | (chr >> 18));
+  out[1] = uint8_t(0x80 | ((chr >> 12) & 0x3F));
+  out[2] = uint8_t(0x80 | ((chr >> 6) & 0x3F));
+  out[3] = uint8_t(0x80 | (chr & 0x3F));
+  return 4;
+}
+
+static bool validate_scalar(const uint8_t* p, const uint8_t* end)
+{
+  while (p < end) {
+    const uint8_t c = *p;
+    if (c < 0x80) {
+      ++p;
+      continue;
+    }
+
+    int n;
+    uint8_t lo = 0x80, hi = 0xBF; // Valid range for the second byte
+    if (c < 0xC2)
+      return false; // Continuation or overlong 2-byte sequence
+    else if (c < 0xE0)
+      n = 2;
+    else if (c < 0xF0) {
+      n = 3;
+      if (c == 0xE0)
+        lo = 0xA0; // Overlong
+      else if (c == 0xED)
+        hi = 0x9F; // Surrogates
+    }
+    else if (c < 0xF5) {
+      n = 4;
+      if (c == 0xF0)
+        lo = 0x90; // Overlong
+      else if (c == 0xF4)
+        hi = 0x8F; // > U+10FFFF
+    }
+    else
+      return false;
+
+    if (end - p < n || p[1] < lo || p[1] > hi)
+      return false;
+    for (int i = 2; i < n; ++i) {
+      if (!is_cont(p[i]))
+        return false;
+    }
+    p += n;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// SSSE3 validation
+//
+// Algorithm from John Keiser and Daniel Lemire, "Validating UTF-8 In
+// Less Than One Instruction Per Byte" (Software: Practice and
+// Experience, 2021). Each error is detected looking up the high/low
+// nibbles of the previous byte and the high nibble of the current
+// byte in three tables, the result of the AND of the three lookups
+// must be zero (except for the 0x80 bit, which is used to check that
+// 3rd/4th bytes are continuation bytes).
+
+#if UTF8_SSE2
+
+enum : uint8_t {
+  TOO_SHORT = 1 << 0,  // 11______ 0_______ or 11______ 11______
+  TOO_LONG = 1 << 1,   // 0_______ 10______
+  OVERLONG_3 = 1 << 2, // 11100000 100_____
+  TOO_LARGE = 1 << 3,  // 11110100 1001____, 11110100 101_____, ...
+  SURROGATE = 1 << 4,  // 11101101 101_____
+  OVERLONG_2 = 1 << 5, // 1100000_ 10______
+  TOO_LARGE_1000 = 1 << 6,
+  OVERLONG_4 = 1 << 6, // 11110000 1000____
+  TWO_CONTS = 1 << 7,  // 10______ 10______
+  CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS,
+};
+
+// clang-format off
+
+alignas(16) static const uint8_t byte1HighLut[16] = {
+  // 0_______ ________ (ASCII)
+  TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+  // 10______ ________ (continuation)
+  TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+  // 1100____ ________ (2-byte lead)
+  TOO_SHORT | OVERLONG_2,
+  // 1101____ ________ (2-byte lead)
+  TOO_SHORT,
+  // 1110____ ________ (3-byte lead)
+  TOO_SHORT | OVERLONG_3 | SURROGATE,
+  // 1111____ ________ (4-byte lead)
+  TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+};
+
+alignas(16) static const uint8_t byte1LowLut[16] = {
+  // ____0000 ________
+  CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+  // ____0001 ________
+  CARRY | OVERLONG_2,
+  // ____001_ ________
+  CARRY,
+  CARRY,
+  // ____0100 ________
+  CARRY | TOO_LARGE,
+  // ____0101 ________
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  // ____011_ ________
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  // ____1___ ________
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  // ____1101 ________
+  CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000
+};
+
+alignas(16) static const uint8_t byte2HighLut[16] = {
+  // ________ 0_______ (ASCII)
+  TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+  // ________ 1000____
+  TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+  // ________ 1001____
+  TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+  // ________ 101_____
+  TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+  TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+  // ________ 11______ (lead)
+  TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+};
+
+// Used to detect incomplete sequences at the end of a block
+alignas(16) static const uint8_t incompleteLut[16] = {
+  255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+};
+
+// clang-format on
+
+struct ssse3_validator {
+  __m128i error = _mm_setzero_si128();
+  __m128i prev = _mm_setzero_si128();
+  __m128i prevIncomplete = _mm_setzero_si128();
+
+  LAF_TARGET("ssse3")
+  void check(const __m128i input)
+  {
+    if (_mm_movemask_epi8(input) == 0) {
+      // ASCII block, only check that the previous block is complete
+      error = _mm_or_si128(error, prevIncomplete);
+      prevIncomplete = _mm_setzero_si128();
+      prev = input;
+      return;
+    }
+
+    const __m128i lowNibble = _mm_set1_epi8(0x0f);
+    const __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+    const __m128i prev1High = _mm_and_si128(_mm_srli_epi16(prev1, 4), lowNibble);
+    const __m128i prev1Low = _mm_and_si128(prev1, lowNibble);
+    const __m128i inputHigh = _mm_and_si128(_mm_srli_epi16(input, 4), lowNibble);
+
+    const __m128i b1h = _mm_shuffle_epi8(_mm_load_si128((const __m128i*)byte1HighLut), prev1High);
+    const __m128i b1l = _mm_shuffle_epi8(_mm_load_si128((const __m128i*)byte1LowLut), prev1Low);
+    const __m128i b2h = _mm_shuffle_epi8(_mm_load_si128((const __m128i*)byte2HighLut), inputHigh);
+    const __m128i special = _mm_and_si128(_mm_and_si128(b1h, b1l), b2h);
+
+    // 3rd and 4th bytes of sequences must be continuation bytes
+    const __m128i prev2 = _mm_alignr_epi8(input, prev, 14);
+    const __m128i prev3 = _mm_alignr_epi8(input, prev, 13);
+    const __m128i isThird = _mm_subs_epu8(prev2, _mm_set1_epi8(char(0xE0 - 0x80)));
+    const __m128i isFourth = _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xF0 - 0x80)));
+    const __m128i must23 = _mm_and_si128(_mm_or_si128(isThird, isFourth),
+                                         _mm_set1_epi8(char(0x80)));
+
+    error = _mm_or_si128(error, _mm_xor_si128(must23, special));
+    prevIncomplete = _mm_subs_epu8(input, _mm_load_si128((const __m128i*)incompleteLut));
+    prev = input;
+  }
+
+  LAF_TARGET("ssse3")
+  bool finish()
+  {
+    error = _mm_or_si128(error, prevIncomplete);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+  }
+};
+
+LAF_TARGET("ssse3")
+static bool validate_ssse3(const uint8_t* p, const size_t n)
+{
+  ssse3_validator v;
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    v.check(_mm_loadu_si128((const __m128i*)(p + i)));
+
+  if (i < n) {
+    // Last incomplete block padded with zeros
+    alignas(16) uint8_t tail[16] = {};
+    std::memcpy(tail, p + i, n - i);
+    v.check(_mm_load_si128((const __m128i*)tail));
+  }
+  return v.finish();
+}
+
+#endif // UTF8_SSE2
+
+//////////////////////////////////////////////////////////////////////
+// Public API
+
+size_t utf8_ascii_prefix(const char* s, const size_t n)
+{
+  size_t i = 0;
+#if UTF8_SSE2
+  for (; i + 16 <= n; i += 16) {
+    const int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(s + i)));
+    if (mask)
+      return i + ctz(mask);
+  }
+#endif
+  for (; i < n; ++i) {
+    if (uint8_t(s[i]) >= 0x80)
+      break;
+  }
+  return i;
+}
+
+bool utf8_validate(const char* s, const size_t n)
+{
+  auto p = reinterpret_cast<const uint8_t*>(s);
+#if UTF8_SSE2
+  static const bool ssse3 = get_cpu_features().ssse3;
+  if (ssse3)
+    return validate_ssse3(p, n);
+#endif
+  const size_t ascii = utf8_ascii_prefix(s, n);
+  return validate_scalar(p + ascii, p + n);
+}
+
+size_t utf8_count(const char* s, const size_t n)
+{
+  size_t count = 0;
+  size_t i = 0;
+#if UTF8_SSE2
+  // Count bytes that are not continuation bytes (0x80-0xBF, or
+  // -128 to -65 as signed bytes), accumulating 1 per byte in 8-bit
+  // counters that are summed every 255 iterations.
+  const __m128i minNonCont = _mm_set1_epi8(-65);
+  while (i + 16 <= n) {
+    __m128i acc = _mm_setzero_si128();
+    for (int j = 0; j < 255 && i + 16 <= n; ++j, i += 16) {
+      const __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+      acc = _mm_sub_epi8(acc, _mm_cmpgt_epi8(v, minNonCont));
+    }
+    const __m128i sums = _mm_sad_epu8(acc, _mm_setzero_si128());
+    count += size_t(_mm_cvtsi128_si32(sums)) + size_t(_mm_extract_epi16(sums, 4));
+  }
+#endif
+  for (; i < n; ++i) {
+    if (!is_cont(uint8_t(s[i])))
+      ++count;
+  }
+  return count;
+}
+
+size_t utf8_to_utf32(const char* s, const size_t n, codepoint_t* out)
+{
+  auto p = reinterpret_cast<const uint8_t*>(s);
+  const uint8_t* end = p + n;
+  codepoint_t* const outBegin = out;
+
+  while (p < end) {
+#if UTF8_SSE2
+    if (end - p >= 16) {
+      const __m128i v = _mm_loadu_si128((const __m128i*)p);
+      if (_mm_movemask_epi8(v) == 0) {
+        // 16 ASCII chars to 16 code points
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i lo = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_si128((__m128i*)(out + 0), _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128((__m128i*)(out + 4), _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128((__m128i*)(out + 8), _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128((__m128i*)(out + 12), _mm_unpackhi_epi16(hi, zero));
+        p += 16;
+        out += 16;
+        continue;
+      }
+    }
+#endif
+    // Decode the next 16 bytes one code point at a time
+    const uint8_t* blockEnd = (end - p > 16 ? p + 16 : end);
+    while (p < blockEnd)
+      p += decode_seq(p, end, *out++);
+  }
+  return out - outBegin;
+}
+
+size_t utf8_to_utf16(const char* s, const size_t n, uint16_t* out)
+{
+  auto p = reinterpret_cast<const uint8_t*>(s);
+  const uint8_t* end = p + n;
+  uint16_t* const outBegin = out;
+
+  while (p < end) {
+#if UTF8_SSE2
+    if (end - p >= 16) {
+      const __m128i v = _mm_loadu_si128((const __m128i*)p);
+      if (_mm_movemask_epi8(v) == 0) {
+        const __m128i zero = _mm_setzero_si128();
+        _mm_storeu_si128((__m128i*)(out + 0), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128((__m128i*)(out + 8), _mm_unpackhi_epi8(v, zero));
+        p += 16;
+        out += 16;
+        continue;
+      }
+    }
+#endif
+    const uint8_t* blockEnd = (end - p > 16 ? p + 16 : end);
+    while (p < blockEnd) {
+      codepoint_t chr;
+      p += decode_seq(p, end, chr);
+      if (chr >= 0x10000) {
+        chr -= 0x10000;
+        *out++ = uint16_t(0xD800 | (chr >> 10));
+        *out++ = uint16_t(0xDC00 | (chr & 0x3FF));
+      }
+      else
+        *out++ = uint16_t(chr);
+    }
+  }
+  return out - outBegin;
+}
+
+size_t utf32_to_utf8(const codepoint_t* s, const size_t n, char* out)
+{
+  auto o = reinterpret_cast<uint8_t*>(out);
+  size_t i = 0;
+  while (i < n) {
+#if UTF8_SSE2
+    if (n - i >= 8) {
+      const __m128i a = _mm_loadu_si128((const __m128i*)(s + i));
+      const __m128i b = _mm_loadu_si128((const __m128i*)(s + i + 4));
+      const __m128i nonAscii = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi32(~0x7F));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi32(nonAscii, _mm_setzero_si128())) == 0xFFFF) {
+        // 8 code points < 0x80 to 8 bytes
+        const __m128i words = _mm_packs_epi32(a, b);
+        _mm_storel_epi64((__m128i*)o, _mm_packus_epi16(words, words));
+        i += 8;
+        o += 8;
+        continue;
+      }
+    }
+#endif
+    const size_t blockEnd = (n - i > 8 ? i + 8 : n);
+    for (; i < blockEnd; ++i)
+      o += encode_seq(s[i], o);
+  }
+  return o - reinterpret_cast<uint8_t*>(out);
+}
+
+size_t utf16_to_utf8(const uint16_t* s, const size_t n, char* out)
+{
+  auto o = reinterpret_cast<uint8_t*>(out);
+  size_t i = 0;
+  while (i < n) {
+#if UTF8_SSE2
+    if (n - i >= 8) {
+      const __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+      const __m128i nonAscii = _mm_and_si128(v, _mm_set1_epi16(~0x7F));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, _mm_setzero_si128())) == 0xFFFF) {
+        _mm_storel_epi64((__m128i*)o, _mm_packus_epi16(v, v));
+        i += 8;
+        o += 8;
+        continue;
+      }
+    }
+#endif
+    const size_t blockEnd = (n - i > 8 ? i + 8 : n);
+    while (i < blockEnd) {
+      codepoint_t chr = s[i++];
+      // Surrogate pair (the low surrogate can be in the next block)
+      if (chr >= 0xD800 && chr <= 0xDBFF && i < n && s[i] >= 0xDC00 && s[i] <= 0xDFFF)
+        chr = 0x10000 + ((chr - 0xD800) << 10) + (s[i++] - 0xDC00);
+      o += encode_seq(chr, o);
+    }
+  }
+  return o - reinterpret_cast<uint8_t*>(out);
+}
+
+} // namespace base
@@ -0,0 +1,52 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_UTF8_H_INCLUDED
+#define BASE_UTF8_H_INCLUDED
+#pragma once
+
+#include "base/codepoint.h"
+#include "base/ints.h"
+
+#include <cstddef>
+
+namespace base {
+
+// Functions to validate/count/transcode whole blocks of UTF-8 text.
+// They process 16 bytes at once with SSE2/SSSE3 on x86 CPUs (with a
+// fast path for ASCII text) and fallback to scalar code on other
+// platforms.
+//
+// The transcoding functions expect valid input (use utf8_validate()
+// first), they never read/write out of bounds with invalid input
+// but the result is unspecified.
+
+// Returns the number of ASCII chars at the beginning of the string.
+size_t utf8_ascii_prefix(const char* s, size_t n);
+
+// Returns true if the string is valid UTF-8 (RFC 3629), i.e. without
+// truncated/overlong sequences, surrogates, or code points greater
+// than U+10FFFF.
+bool utf8_validate(const char* s, size_t n);
+
+// Returns the number of code points in a valid UTF-8 string.
+size_t utf8_count(const char* s, size_t n);
+
+// Converts valid UTF-8 to UTF-32/UTF-16. The output must have space
+// for "n" elements. Returns the number of written elements.
+size_t utf8_to_utf32(const char* s, size_t n, codepoint_t* out);
+size_t utf8_to_utf16(const char* s, size_t n, uint16_t* out);
+
+// Converts UTF-32/UTF-16 to UTF-8. The output must have space for
+// 4*n bytes (UTF-32) or 3*n bytes (UTF-16). Returns the number of
+// written bytes. Code points greater than U+10FFFF are replaced with
+// U+FFFD, and unpaired surrogates are encoded as 3-byte sequences.
+size_t utf32_to_utf8(const codepoint_t* s, size_t n, char* out);
+size_t utf16_to_utf8(const uint16_t* s, size_t n, char* out);
+
+} // namespace base
+
+#endif
@@ -0,0 +1,81 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/string.h"
+#include "base/utf8.h"
+#include "base/utf8_decode.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace base;
+
+static std::string random_text(std::mt19937& gen, const size_t codepoints)
+{
+  // Mixed scripts: ASCII, Latin-1, Cyrillic, CJK, and emoji
+  const codepoint_t ranges[][2] = {
+    { 0x20, 0x7E }, { 0xA0, 0xFF }, { 0x400, 0x4FF }, { 0x4E00, 0x9FFF }, { 0x1F600, 0x1F64F },
+  };
+  std::uniform_int_distribution<int> script(0, 4);
+  std::string s;
+  for (size_t i = 0; i < codepoints; ++i) {
+    const auto& r = ranges[script(gen)];
+    s += codepoint_to_utf8(std::uniform_int_distribution<codepoint_t>(r[0], r[1])(gen));
+  }
+  return s;
+}
+
+TEST(Utf8, Benchmark)
+{
+  std::mt19937 gen(5);
+  const std::string ascii(8 * 1024 * 1024, 'a');
+  const std::string mixed = random_text(gen, 4 * 1024 * 1024);
+
+  for (const std::string* text : { &ascii, &mixed }) {
+    Chrono chrono;
+    int oldCount = 0;
+    utf8_decode decode(*text);
+    while (decode.next())
+      ++oldCount;
+    const double oldSecs = chrono.elapsed();
+
+    chrono.reset();
+    const bool valid = utf8_validate(text->c_str(), text->size());
+    const double validateSecs = chrono.elapsed();
+
+    chrono.reset();
+    const size_t count = utf8_count(text->c_str(), text->size());
+    const double countSecs = chrono.elapsed();
+
+    std::vector<codepoint_t> utf32(text->size());
+    chrono.reset();
+    utf8_to_utf32(text->c_str(), text->size(), utf32.data());
+    const double transcodeSecs = chrono.elapsed();
+
+    EXPECT_TRUE(valid);
+    EXPECT_EQ(oldCount, count);
+
+    const double mb = text->size() / 1e9;
+    std::printf("%s: utf8_decode %.2f GB/s, validate %.2f GB/s, count %.2f GB/s, "
+                "to_utf32 %.2f GB/s\n",
+                (text == &ascii ? "ASCII" : "Mixed"),
+                mb / oldSecs,
+                mb / validateSecs,
+                mb / countSecs,
+                mb / transcodeSecs);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
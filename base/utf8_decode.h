@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2022-2024 Igara Studio S.A.
+// Copyright (c) 2022-2026 Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -8,9 +8,12 @@
 #define BASE_UTF8_DECODE_H_INCLUDED
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 
 #include "base/codepoint.h"
+#include "base/utf8.h"
 
 namespace base {
 
@@ -37,61 +40,109 @@ public:
     if (m_it == m_end)
       return 0;
 
-    codepoint_t c = *m_it;
+    codepoint_t c = uint8_t(*m_it);
     ++m_it;
 
-    // UTF-8 escape bit 0x80 to encode larger code points
-    if (c & 0b1000'0000) {
-      // Get the number of bits following the first one 0b1xxx'xxxx,
-      // which indicates the number of extra bytes in the input
-      // string following this one, and that will be part of the
-      // final Unicode code point.
-      //
-      // This is like "number of leading ones", similar to a
-      // __builtin_clz(~x)-24 (for 8 bits), anyway doing some tests,
-      // the CLZ intrinsic is not faster than this code in x86_64.
-      int n = 0;
-      int f = 0b0100'0000;
-      while (c & f) {
-        ++n;
-        f >>= 1;
-      }
+    // Fast path for ASCII chars (the most common case)
+    if (c < 0b1000'0000)
+      return c;
+
+    // UTF-8 escape bit 0x80 to encode larger code points. Get the
+    // number of bits following the first one 0b1xxx'xxxx, which
+    // indicates the number of extra bytes in the input string
+    // following this one, and that will be part of the final Unicode
+    // code point.
+    //
+    // This is like "number of leading ones", similar to a
+    // __builtin_clz(~x)-24 (for 8 bits), anyway doing some tests,
+    // the CLZ intrinsic is not faster than this code in x86_64.
+    int n = 0;
+    int f = 0b0100'0000;
+    while (c & f) {
+      ++n;
+      f >>= 1;
+    }
+
+    if (n == 0) {
+      // Invalid UTF-8: 0b10xx'xxxx alone, i.e. not inside a
+      // escaped sequence (e.g. after 0b110xx'xxx
+      m_valid = false;
+      return 0;
+    }
 
-      if (n == 0) {
-        // Invalid UTF-8: 0b10xx'xxxx alone, i.e. not inside a
-        // escaped sequence (e.g. after 0b110xx'xxx
+    // Keep only the few initial data bits from the first byte (6
+    // first bits if we have only one extra char, then for each
+    // extra char we have less useful data in this first byte).
+    c &= (0b0001'1111 >> (n - 1));
+
+    while (n--) {
+      if (m_it == m_end) {
+        // Invalid UTF-8: missing 0b10xx'xxxx bytes
         m_valid = false;
         return 0;
       }
-
-      // Keep only the few initial data bits from the first byte (6
-      // first bits if we have only one extra char, then for each
-      // extra char we have less useful data in this first byte).
-      c &= (0b0001'1111 >> (n - 1));
-
-      while (n--) {
-        if (m_it == m_end) {
-          // Invalid UTF-8: missing 0b10xx'xxxx bytes
-          m_valid = false;
-          return 0;
-        }
-        const int chr = *m_it;
-        ++m_it;
-        if ((chr & 0b1100'0000) != 0b1000'0000) {
-          // Invalid UTF-8: Extra byte doesn't contain 0b10xx'xxxx
-          m_valid = false;
-          return 0;
-        }
-        // Each extra byte in the encoded string adds 6 bits of
-        // information for the final Unicode code point.
-        c = (c << 6) | (chr & 0b0011'1111);
+      const int chr = uint8_t(*m_it);
+      ++m_it;
+      if ((chr & 0b1100'0000) != 0b1000'0000) {
+        // Invalid UTF-8: Extra byte doesn't contain 0b10xx'xxxx
+        m_valid = false;
+        return 0;
       }
+      // Each extra byte in the encoded string adds 6 bits of
+      // information for the final Unicode code point.
+      c = (c << 6) | (chr & 0b0011'1111);
     }
 
     return c;
   }
 
+  // Decodes up to "max" code points at once, returns the number of
+  // decoded code points (0 at the end of the string or if it's
+  // invalid, like next()). Long runs of valid UTF-8 are validated and
+  // decoded with base::utf8_to_utf32(), which is faster than calling
+  // next() for each code point.
+  size_t next_run(codepoint_t* out, const size_t max)
+  {
+    size_t n = 0;
+    const size_t avail = m_end - m_it;
+    if (avail >= kMinRun && max >= kMinRun) {
+      const char* p = &*m_it;
+
+      // Each code point uses at least one byte, and we stop at the
+      // first null char (like next()).
+      size_t len = std::min(avail, max);
+      if (const void* nul = std::memchr(p, 0, len))
+        len = static_cast<const char*>(nul) - p;
+
+      // Don't split a sequence at the end of the run
+      while (len > 0 && len < avail && (p[len] & 0b1100'0000) == 0b1000'0000)
+        --len;
+
+      if (len >= kMinRun && utf8_validate(p, len)) {
+        n = utf8_to_utf32(p, len, out);
+        m_it += len;
+        return n;
+      }
+    }
+
+    for (; n < max; ++n) {
+      const iterator it = m_it;
+      const codepoint_t c = next();
+      if (!c) {
+        // Return 0 in the next call too
+        if (n > 0)
+          m_it = it;
+        break;
+      }
+      out[n] = c;
+    }
+    return n;
+  }
+
 private:
+  // Minimum number of bytes to use the utf8_to_utf32() path
+  static constexpr size_t kMinRun = 16;
+
   iterator m_it;
   iterator m_end;
   bool m_valid = true;
@@ -0,0 +1,191 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/string.h"
+#include "base/utf8.h"
+#include "base/utf8_decode.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace base;
+
+// Reference validator: decodes each sequence and checks the
+// resulting code point.
+static bool is_valid_utf8(const std::string& s)
+{
+  for (size_t i = 0; i < s.size();) {
+    const uint8_t c = s[i];
+    int n = (c < 0x80 ? 1 : c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 0);
+    if (n == 0 || c > 0xF4 || i + n > s.size())
+      return false;
+    codepoint_t chr = (n == 1 ? c : c & (0x7F >> n));
+    for (int j = 1; j < n; ++j) {
+      const uint8_t d = s[i + j];
+      if ((d & 0xC0) != 0x80)
+        return false;
+      chr = (chr << 6) | (d & 0x3F);
+    }
+    const codepoint_t minChr[] = { 0, 0, 0x80, 0x800, 0x10000 };
+    if (chr < minChr[n] || chr > 0x10FFFF || (chr >= 0xD800 && chr <= 0xDFFF))
+      return false;
+    i += n;
+  }
+  return true;
+}
+
+static std::string random_text(std::mt19937& gen, const size_t codepoints)
+{
+  // Mixed scripts: ASCII, Latin-1, Cyrillic, CJK, and emoji
+  const codepoint_t ranges[][2] = {
+    { 0x20, 0x7E }, { 0xA0, 0xFF }, { 0x400, 0x4FF }, { 0x4E00, 0x9FFF }, { 0x1F600, 0x1F64F },
+  };
+  std::uniform_int_distribution<int> script(0, 4);
+  std::string s;
+  for (size_t i = 0; i < codepoints; ++i) {
+    const auto& r = ranges[script(gen)];
+    s += codepoint_to_utf8(std::uniform_int_distribution<codepoint_t>(r[0], r[1])(gen));
+  }
+  return s;
+}
+
+TEST(Utf8, Validate)
+{
+  EXPECT_TRUE(utf8_validate("", 0));
+  EXPECT_TRUE(utf8_validate("abc", 3));
+
+  const char* invalid[] = {
+    "\x80",             // Continuation byte alone
+    "\xC0\x80",         // Overlong
+    "\xE0\x80\x80",     // Overlong
+    "\xF0\x80\x80\x80", // Overlong
+    "\xED\xA0\x80",     // Surrogate
+    "\xF4\x90\x80\x80", // > U+10FFFF
+    "\xF8\x88\x80\x80", // 5-byte sequence
+    "\xE6\x97",         // Truncated
+    "\xE6\x97\x41",     // Missing continuation
+  };
+  for (const char* s : invalid) {
+    std::string str(s);
+    EXPECT_FALSE(utf8_validate(str.c_str(), str.size())) << str;
+
+    // Same error in the middle/end of long strings
+    for (size_t pos : { 0, 10, 14, 15, 16, 31, 40 }) {
+      std::string big(48, 'a');
+      big.replace(pos, str.size(), str);
+      EXPECT_FALSE(utf8_validate(big.c_str(), big.size())) << pos;
+    }
+  }
+
+  // Random mutations of valid strings
+  std::mt19937 gen(1);
+  for (int i = 0; i < 2000; ++i) {
+    std::string s = random_text(gen, 1 + i % 40);
+    EXPECT_TRUE(utf8_validate(s.c_str(), s.size()));
+
+    std::uniform_int_distribution<size_t> pos(0, s.size() - 1);
+    for (int j = 0; j < 1 + i % 3; ++j)
+      s[pos(gen)] = char(std::uniform_int_distribution<int>(0, 255)(gen));
+    if (i % 5 == 0)
+      s.resize(pos(gen));
+    EXPECT_EQ(is_valid_utf8(s), utf8_validate(s.c_str(), s.size()));
+  }
+}
+
+TEST(Utf8, AsciiPrefixAndCount)
+{
+  std::string s(40, 'x');
+  EXPECT_EQ(40, utf8_ascii_prefix(s.c_str(), s.size()));
+  s[33] = '\xC3';
+  EXPECT_EQ(33, utf8_ascii_prefix(s.c_str(), s.size()));
+
+  std::mt19937 gen(2);
+  for (size_t n : { 0, 1, 15, 16, 17, 1000, 5000 }) {
+    const std::string text = random_text(gen, n);
+    EXPECT_EQ(n, utf8_count(text.c_str(), text.size()));
+    EXPECT_EQ(n, utf8_length(text));
+  }
+}
+
+TEST(Utf8, Transcode)
+{
+  std::mt19937 gen(3);
+  for (size_t n : { 0, 1, 7, 8, 9, 16, 33, 1000 }) {
+    const std::string text = random_text(gen, n) + std::string(n % 20, 'a');
+
+    std::vector<codepoint_t> expected;
+    utf8_decode decode(text);
+    while (const codepoint_t chr = decode.next())
+      expected.push_back(chr);
+
+    std::vector<codepoint_t> utf32(text.size());
+    utf32.resize(utf8_to_utf32(text.c_str(), text.size(), utf32.data()));
+    EXPECT_EQ(expected, utf32);
+
+    std::string utf8(4 * utf32.size(), 0);
+    utf8.resize(utf32_to_utf8(utf32.data(), utf32.size(), utf8.data()));
+    EXPECT_EQ(text, utf8);
+
+    std::vector<uint16_t> utf16(text.size());
+    utf16.resize(utf8_to_utf16(text.c_str(), text.size(), utf16.data()));
+    utf8.assign(3 * utf16.size(), 0);
+    utf8.resize(utf16_to_utf8(utf16.data(), utf16.size(), utf8.data()));
+    EXPECT_EQ(text, utf8);
+
+    EXPECT_EQ(text, to_utf8(from_utf8(text)));
+  }
+
+  const uint16_t pair[] = { 0xD83D, 0xDE00 }; // U+1F600
+  char out[6];
+  EXPECT_EQ(4, utf16_to_utf8(pair, 2, out));
+  EXPECT_EQ("\xF0\x9F\x98\x80", std::string(out, 4));
+
+  const codepoint_t tooLarge = 0x110000;
+  EXPECT_EQ(3, utf32_to_utf8(&tooLarge, 1, out));
+  EXPECT_EQ("\xEF\xBF\xBD", std::string(out, 3)); // U+FFFD
+}
+
+TEST(Utf8, DecodeRun)
+{
+  std::mt19937 gen(4);
+  std::string text = random_text(gen, 500);
+  text += '\0';
+  text += "ignored";
+
+  for (size_t max : { 1, 16, 50, 1000 }) {
+    utf8_decode decode(text);
+    std::vector<codepoint_t> result;
+    std::vector<codepoint_t> buf(max);
+    while (size_t n = decode.next_run(buf.data(), max))
+      result.insert(result.end(), buf.begin(), buf.begin() + n);
+
+    utf8_decode decode2(text);
+    std::vector<codepoint_t> expected;
+    while (const codepoint_t chr = decode2.next())
+      expected.push_back(chr);
+    EXPECT_EQ(expected, result);
+    EXPECT_TRUE(decode.is_valid());
+  }
+
+  // Invalid UTF-8 stops the decoding
+  std::string bad = std::string(20, 'a') + "\xE6\x97" + std::string(20, 'b');
+  utf8_decode decode(bad);
+  codepoint_t buf[100];
+  size_t total = 0;
+  while (size_t n = decode.next_run(buf, 100))
+    total += n;
+  EXPECT_EQ(20, total);
+  EXPECT_FALSE(decode.is_valid());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,166 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_WORK_STEALING_DEQUE_H_INCLUDED
+#define BASE_WORK_STEALING_DEQUE_H_INCLUDED
+#pragma once
+
+#include "base/debug.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace base {
+
+// Chase-Lev work-stealing deque. Only the owner thread can call
+// push() and pop() (LIFO end), any other thread can call steal()
+// (FIFO end). T must be a trivially copyable type (e.g. a pointer).
+//
+// Implementation based on "Correct and Efficient Work-Stealing for
+// Weak Memory Models" (Lê, Pop, Cohen, Zappa Nardelli, PPoPP 2013).
+template<typename T>
+class work_stealing_deque {
+public:
+  explicit work_stealing_deque(const int64_t capacity = 256)
+    : m_top(0)
+    , m_bottom(0)
+    , m_array(new array(capacity))
+  {
+    m_garbage.emplace_back(m_array.load(std::memory_order_relaxed));
+  }
+
+  work_stealing_deque(const work_stealing_deque&) = delete;
+  work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+  bool empty() const
+  {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed);
+    const int64_t t = m_top.load(std::memory_order_relaxed);
+    return b <= t;
+  }
+
+  size_t size() const
+  {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed);
+    const int64_t t = m_top.load(std::memory_order_relaxed);
+    return size_t(b >= t ? b - t : 0);
+  }
+
+  // Owner only.
+  void push(const T value)
+  {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed);
+    const int64_t t = m_top.load(std::memory_order_acquire);
+    array* a = m_array.load(std::memory_order_relaxed);
+    if (b - t > a->capacity() - 1)
+      a = grow(a, b, t);
+    a->put(b, value);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  // Owner only. Returns false if the deque is empty.
+  bool pop(T& value)
+  {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+    array* a = m_array.load(std::memory_order_relaxed);
+    m_bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = m_top.load(std::memory_order_relaxed);
+
+    if (t <= b) {
+      value = a->get(b);
+      if (t == b) {
+        // Last element, race against thieves
+        const bool won = m_top.compare_exchange_strong(t,
+                                                       t + 1,
+                                                       std::memory_order_seq_cst,
+                                                       std::memory_order_relaxed);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+      }
+      return true;
+    }
+
+    m_bottom.store(b + 1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // Any thread. Returns false if the deque is empty or if we lost a
+  // race against the owner or other thief.
+  bool steal(T& value)
+  {
+    int64_t t = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = m_bottom.load(std::memory_order_acquire);
+
+    if (t < b) {
+      array* a = m_array.load(std::memory_order_acquire);
+      const T v = a->get(t);
+      if (!m_top.compare_exchange_strong(t,
+                                         t + 1,
+                                         std::memory_order_seq_cst,
+                                         std::memory_order_relaxed))
+        return false;
+      value = v;
+      return true;
+    }
+    return false;
+  }
+
+private:
+  class array {
+  public:
+    explicit array(const int64_t capacity)
+      : m_capacity(capacity)
+      , m_mask(capacity - 1)
+      , m_items(new std::atomic<T>[size_t(capacity)])
+    {
+      static_assert(std::is_trivially_copyable_v<T>);
+      // The capacity must be a power of two
+      ASSERT(capacity > 0 && (capacity & m_mask) == 0);
+    }
+
+    int64_t capacity() const { return m_capacity; }
+
+    T get(const int64_t i) const { return m_items[i & m_mask].load(std::memory_order_relaxed); }
+    void put(const int64_t i, const T v)
+    {
+      m_items[i & m_mask].store(v, std::memory_order_relaxed);
+    }
+
+  private:
+    int64_t m_capacity;
+    int64_t m_mask;
+    std::unique_ptr<std::atomic<T>[]> m_items;
+  };
+
+  array* grow(array* a, const int64_t b, const int64_t t)
+  {
+    auto newArray = std::make_unique<array>(a->capacity() * 2);
+    for (int64_t i = t; i < b; ++i)
+      newArray->put(i, a->get(i));
+
+    // Thieves could still be reading the old array, so we keep it
+    // alive until the deque is destroyed.
+    a = newArray.get();
+    m_garbage.push_back(std::move(newArray));
+    m_array.store(a, std::memory_order_release);
+    return a;
+  }
+
+  alignas(64) std::atomic<int64_t> m_top;
+  alignas(64) std::atomic<int64_t> m_bottom;
+  std::atomic<array*> m_array;
+  std::vector<std::unique_ptr<array>> m_garbage;
+};
+
+} // namespace base
+
+#endif
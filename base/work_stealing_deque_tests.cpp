@@ -0,0 +1,91 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/work_stealing_deque.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace base;
+
+TEST(WorkStealingDeque, OwnerIsLifo)
+{
+  work_stealing_deque<int> d(4);
+  EXPECT_TRUE(d.empty());
+  for (int i = 0; i < 10; ++i) // Grow the deque
+    d.push(i);
+  EXPECT_EQ(10, d.size());
+
+  int v;
+  for (int i = 9; i >= 0; --i) {
+    EXPECT_TRUE(d.pop(v));
+    EXPECT_EQ(i, v);
+  }
+  EXPECT_FALSE(d.pop(v));
+  EXPECT_TRUE(d.empty());
+}
+
+TEST(WorkStealingDeque, ThiefIsFifo)
+{
+  work_stealing_deque<int> d;
+  for (int i = 0; i < 10; ++i)
+    d.push(i);
+
+  int v;
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(d.steal(v));
+    EXPECT_EQ(i, v);
+  }
+  EXPECT_FALSE(d.steal(v));
+}
+
+TEST(WorkStealingDeque, ConcurrentSteal)
+{
+  const int kItems = 100000;
+  const int kThieves = 4;
+  work_stealing_deque<int> d(16);
+  std::atomic<bool> done(false);
+  std::vector<std::atomic<int>> seen(kItems);
+  for (auto& s : seen)
+    s = 0;
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < kThieves; ++i) {
+    thieves.emplace_back([&] {
+      int v;
+      while (!done || !d.empty()) {
+        if (d.steal(v))
+          ++seen[v];
+      }
+    });
+  }
+
+  int v;
+  for (int i = 0; i < kItems; ++i) {
+    d.push(i);
+    if ((i % 3) == 0 && d.pop(v))
+      ++seen[v];
+  }
+  while (d.pop(v))
+    ++seen[v];
+  done = true;
+
+  for (auto& t : thieves)
+    t.join();
+
+  // Each item must be taken exactly once
+  for (int i = 0; i < kItems; ++i)
+    EXPECT_EQ(1, seen[i]) << "item " << i;
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,187 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/xxhash.h"
+
+#include "base/config.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace base {
+
+static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+static constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rol64(const uint64_t x, const int n)
+{
+  return (x << n) | (x >> (64 - n));
+}
+
+// XXH64 reads the input in little-endian order
+static inline uint64_t load_le64(const uint8_t* p)
+{
+#ifdef LAF_LITTLE_ENDIAN
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+  return v;
+#else
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; --i)
+    v = (v << 8) | p[i];
+  return v;
+#endif
+}
+
+static inline uint32_t load_le32(const uint8_t* p)
+{
+#ifdef LAF_LITTLE_ENDIAN
+  uint32_t v;
+  std::memcpy(&v, p, 4);
+  return v;
+#else
+  return (uint32_t(p[3]) << 24) | (uint32_t(p[2]) << 16) | (uint32_t(p[1]) << 8) | p[0];
+#endif
+}
+
+static inline uint64_t acc_round(uint64_t acc, const uint64_t input)
+{
+  acc += input * kPrime2;
+  acc = rol64(acc, 31);
+  return acc * kPrime1;
+}
+
+static inline uint64_t merge_round(uint64_t acc, const uint64_t value)
+{
+  acc ^= acc_round(0, value);
+  return acc * kPrime1 + kPrime4;
+}
+
+// Processes stripes of 32 bytes, returns the processed bytes.
+static size_t process_stripes(uint64_t acc[4], const uint8_t* p, const size_t size)
+{
+  uint64_t a0 = acc[0], a1 = acc[1], a2 = acc[2], a3 = acc[3];
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32, p += 32) {
+    a0 = acc_round(a0, load_le64(p));
+    a1 = acc_round(a1, load_le64(p + 8));
+    a2 = acc_round(a2, load_le64(p + 16));
+    a3 = acc_round(a3, load_le64(p + 24));
+  }
+  acc[0] = a0;
+  acc[1] = a1;
+  acc[2] = a2;
+  acc[3] = a3;
+  return i;
+}
+
+static void init_acc(uint64_t acc[4], const uint64_t seed)
+{
+  acc[0] = seed + kPrime1 + kPrime2;
+  acc[1] = seed + kPrime2;
+  acc[2] = seed;
+  acc[3] = seed - kPrime1;
+}
+
+// Mixes the accumulators with the last bytes of the input (less than
+// 32 bytes) and the total length.
+static uint64_t finish(const uint64_t acc[4],
+                       const uint64_t seed,
+                       const uint64_t length,
+                       const uint8_t* p,
+                       size_t size)
+{
+  uint64_t h;
+  if (length >= 32) {
+    h = rol64(acc[0], 1) + rol64(acc[1], 7) + rol64(acc[2], 12) + rol64(acc[3], 18);
+    for (int i = 0; i < 4; ++i)
+      h = merge_round(h, acc[i]);
+  }
+  else
+    h = seed + kPrime5;
+
+  h += length;
+
+  for (; size >= 8; size -= 8, p += 8) {
+    h ^= acc_round(0, load_le64(p));
+    h = rol64(h, 27) * kPrime1 + kPrime4;
+  }
+  if (size >= 4) {
+    h ^= uint64_t(load_le32(p)) * kPrime1;
+    h = rol64(h, 23) * kPrime2 + kPrime3;
+    size -= 4;
+    p += 4;
+  }
+  for (; size > 0; --size, ++p) {
+    h ^= (*p) * kPrime5;
+    h = rol64(h, 11) * kPrime1;
+  }
+
+  // Avalanche
+  h ^= h >> 33;
+  h *= kPrime2;
+  h ^= h >> 29;
+  h *= kPrime3;
+  h ^= h >> 32;
+  return h;
+}
+
+uint64_t xxhash64(const void* data, const size_t size, const uint64_t seed)
+{
+  auto p = static_cast<const uint8_t*>(data);
+  uint64_t acc[4];
+  init_acc(acc, seed);
+  const size_t done = process_stripes(acc, p, size);
+  return finish(acc, seed, size, p + done, size - done);
+}
+
+void xxhash64_hasher::reset(const uint64_t seed)
+{
+  init_acc(m_acc, seed);
+  m_seed = seed;
+  m_length = 0;
+  m_stripeSize = 0;
+}
+
+void xxhash64_hasher::update(const void* data, size_t size)
+{
+  if (size == 0)
+    return;
+
+  auto p = static_cast<const uint8_t*>(data);
+  m_length += size;
+
+  // Complete the pending stripe
+  if (m_stripeSize > 0) {
+    const size_t n = std::min(size, sizeof(m_stripe) - m_stripeSize);
+    std::memcpy(m_stripe + m_stripeSize, p, n);
+    m_stripeSize += n;
+    p += n;
+    size -= n;
+    if (m_stripeSize < sizeof(m_stripe))
+      return;
+    process_stripes(m_acc, m_stripe, sizeof(m_stripe));
+    m_stripeSize = 0;
+  }
+
+  const size_t done = process_stripes(m_acc, p, size);
+  std::memcpy(m_stripe, p + done, size - done);
+  m_stripeSize = size - done;
+}
+
+uint64_t xxhash64_hasher::finalize() const
+{
+  return finish(m_acc, m_seed, m_length, m_stripe, m_stripeSize);
+}
+
+} // namespace base
@@ -0,0 +1,57 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_XXHASH_H_INCLUDED
+#define BASE_XXHASH_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+
+#include <cstddef>
+#include <string>
+
+namespace base {
+
+// Fast non-cryptographic 64-bit hash (XXH64 algorithm by Yann
+// Collet, https://github.com/Cyan4973/xxHash). Useful to create
+// cache keys or to detect changes in big blocks of data, never to
+// verify the integrity of untrusted data (use Sha1 in that case).
+uint64_t xxhash64(const void* data, size_t size, uint64_t seed = 0);
+
+inline uint64_t xxhash64(const std::string& text, uint64_t seed = 0)
+{
+  return xxhash64(text.c_str(), text.size(), seed);
+}
+
+// Calculates the same hash as xxhash64() incrementally.
+//
+//   base::xxhash64_hasher hasher;
+//   while (...)
+//     hasher.update(chunk, chunkSize);
+//   uint64_t hash = hasher.finalize();
+//
+class xxhash64_hasher {
+public:
+  explicit xxhash64_hasher(uint64_t seed = 0) { reset(seed); }
+
+  void reset(uint64_t seed = 0);
+  void update(const void* data, size_t size);
+
+  // Returns the hash of all the data given to update(). More data can
+  // be added after calling finalize().
+  uint64_t finalize() const;
+
+private:
+  uint64_t m_acc[4];
+  uint64_t m_seed;
+  uint64_t m_length;
+  uint8_t m_stripe[32];
+  size_t m_stripeSize;
+};
+
+} // namespace base
+
+#endif
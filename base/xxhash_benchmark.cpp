@@ -0,0 +1,31 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/xxhash.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace base;
+
+TEST(XXHash, Benchmark)
+{
+  const std::vector<uint8_t> data(64 * 1024 * 1024, 1);
+  Chrono chrono;
+  const uint64_t hash = xxhash64(data.data(), data.size());
+  std::printf("XXH64: %.2f GB/s (%llx)\n",
+              data.size() / chrono.elapsed() / 1e9,
+              (unsigned long long)hash);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,47 @@
+// LAF Base Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/xxhash.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace base;
+
+TEST(XXHash, Vectors)
+{
+  EXPECT_EQ(0xEF46DB3751D8E999ULL, xxhash64(""));
+  EXPECT_EQ(0xD24EC4F1A98C6E5BULL, xxhash64("a"));
+  EXPECT_EQ(0x44BC2CF5AD770999ULL, xxhash64("abc"));
+  EXPECT_EQ(0xFBCEA83C8A378BF1ULL, xxhash64("Nobody inspects the spammish repetition"));
+  EXPECT_NE(xxhash64("abc"), xxhash64("abc", 1));
+}
+
+TEST(XXHash, Hasher)
+{
+  std::vector<uint8_t> data(1000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = uint8_t(i * 7);
+  EXPECT_EQ(0x7C56BDF2C5D636FEULL, xxhash64(data.data(), data.size(), 5));
+
+  for (size_t size : { 0, 1, 4, 8, 31, 32, 33, 64, 100, 1000 }) {
+    const uint64_t expected = xxhash64(data.data(), size, 5);
+    for (size_t chunk : { 1, 3, 32, 100 }) {
+      xxhash64_hasher hasher(5);
+      for (size_t i = 0; i < size; i += chunk)
+        hasher.update(&data[i], std::min(chunk, size - i));
+      EXPECT_EQ(expected, hasher.finalize()) << "Size " << size << " chunk " << chunk;
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,4 +1,4 @@
-# Copyright (C) 2019  Igara Studio S.A.
+# Copyright (C) 2019-2026  Igara Studio S.A.
 # Copyright (C) 2016  David Capello
 # Find tests and add rules to compile them and run them
 
@@ -31,3 +31,28 @@ function(laf_find_tests dir dependencies)
     endif()
   endforeach()
 endfunction()
+
+# Benchmarks (*_benchmark.cpp files) are compiled as independent
+# programs which are not executed by ctest, they must be run manually.
+add_custom_target(laf-benchmarks)
+
+function(laf_find_benchmarks dir dependencies)
+  file(GLOB benchmarks ${CMAKE_CURRENT_SOURCE_DIR}/${dir}/*_benchmark.cpp)
+  list(REMOVE_AT ARGV 0)
+
+  include_directories(${LAF_ROOT_DIR}/third_party/googletest/googletest/include)
+
+  foreach(benchmarksourcefile ${benchmarks})
+    get_filename_component(benchmarkname ${benchmarksourcefile} NAME_WE)
+
+    add_executable(${benchmarkname} ${benchmarksourcefile})
+    add_dependencies(laf-benchmarks ${benchmarkname})
+
+    if(MSVC)
+      set_target_properties(${benchmarkname}
+        PROPERTIES LINK_FLAGS -ENTRY:"mainCRTStartup")
+    endif()
+
+    target_link_libraries(${benchmarkname} gtest ${ARGV} ${LAF_OS_PLATFORM_LIBS})
+  endforeach()
+endfunction()
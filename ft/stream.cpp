@@ -1,5 +1,5 @@
 // LAF FreeType Wrapper
-// Copyright (c) 2020-present Igara Studio S.A.
+// Copyright (c) 2020-2026 Igara Studio S.A.
 // Copyright (c) 2016-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,10 +9,12 @@
 
 #include "base/file_handle.h"
 #include "base/log.h"
+#include "base/mapped_file.h"
 
 #include <ft2build.h>
 
-#define STREAM_FILE(stream) ((FILE*)(stream)->descriptor.pointer)
+#define STREAM_FILE(stream)   ((FILE*)(stream)->descriptor.pointer)
+#define STREAM_MAPPED(stream) ((base::mapped_file*)(stream)->descriptor.pointer)
 
 namespace ft {
 
@@ -22,6 +24,12 @@ static void ft_stream_close(FT_Stream stream)
   free(stream);
 }
 
+static void ft_mapped_stream_close(FT_Stream stream)
+{
+  delete STREAM_MAPPED(stream);
+  free(stream);
+}
+
 static unsigned long ft_stream_io(FT_Stream stream,
                                   unsigned long offset,
                                   unsigned char* buffer,
@@ -47,6 +55,22 @@ FT_Stream open_stream(const std::string& utf8Filename)
 
   LOG(VERBOSE, "FT: Loading font '%s'...", utf8Filename.c_str());
 
+  // Try to map the whole file in memory, so FreeType can access the
+  // font data directly (a memory-based stream) without reading it.
+  auto mapped = new base::mapped_file(utf8Filename);
+  if (!mapped->empty()) {
+    stream->descriptor.pointer = mapped;
+    stream->base = const_cast<unsigned char*>(mapped->data());
+    stream->size = (unsigned long)mapped->size();
+    stream->pos = 0;
+    stream->read = nullptr;
+    stream->close = ft_mapped_stream_close;
+
+    LOG(VERBOSE, "OK (mapped)\n");
+    return stream;
+  }
+  delete mapped;
+
   FILE* file = base::open_file_raw(utf8Filename, "rb");
   if (!file) {
     free(stream);
@@ -1,5 +1,5 @@
 // LAF Gfx Library
-// Copyright (C) 2019-2023  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2014 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,9 +11,17 @@
 
 #include "gfx/packing_rects.h"
 
+#include "base/parallel.h"
+#include "base/trace.h"
+#include "gfx/point.h"
 #include "gfx/region.h"
 #include "gfx/size.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
 namespace gfx {
 
 void PackingRects::add(const Size& sz)
@@ -80,8 +88,89 @@ static bool by_area(const Rect* a, const Rect* b)
   return a->w * a->h > b->w * b->h;
 }
 
+// Returns the area that "rc" (plus the shape padding) occupies at
+// position (u, v) relative to the "bounds".
+static gfx::Rect possible_rect(const gfx::Rect& bounds,
+                               const gfx::Rect& rc,
+                               const int shapePadding,
+                               const int u,
+                               const int v)
+{
+  // It's necessary to consider the <shapePadding> as an
+  // integral part of the image size; otherwise, the region
+  // subtraction process may be incorrect, resulting in
+  // overlapping of shape padding between adjacent sprites.
+  // This fix resolves the special cases of exporting with
+  // sheet type 'Packed' + 'Trim Cels' true +
+  // 'Shape padding' > 0 + series of particular image sizes.
+  const int hShapePadding = (v == (bounds.h - rc.h) ? 0 : shapePadding);
+  const int wShapePadding = (u == (bounds.w - rc.w) ? 0 : shapePadding);
+  return gfx::Rect(bounds.x + u, bounds.y + v, rc.w + wShapePadding, rc.h + hShapePadding);
+}
+
+bool PackingRects::findPosition(const gfx::Region& rgn,
+                                const gfx::Rect& rc,
+                                base::task_token& token,
+                                gfx::Point& pos) const
+{
+  const int rows = m_bounds.h - rc.h + 1;
+  const int cols = m_bounds.w - rc.w + 1;
+  if (rows <= 0 || cols <= 0)
+    return false;
+
+  // Search the rows in parallel, each row is scanned from left
+  // to right, and we keep the first position found (in row-major
+  // order) so the result is the same as the sequential search.
+  if (m_pool && rows > 1) {
+    std::atomic<int64_t> first(std::numeric_limits<int64_t>::max());
+    base::parallel_for(
+      *m_pool,
+      0,
+      size_t(rows),
+      1,
+      [&](size_t b, size_t e) {
+        for (int v = int(b); v < int(e); ++v) {
+          if (int64_t(v) * cols >= first)
+            return;
+
+          for (int u = 0; u < cols; ++u) {
+            if (token.canceled())
+              return;
+            if (rgn.contains(possible_rect(m_bounds, rc, m_shapePadding, u, v)) == Region::In) {
+              const int64_t i = int64_t(v) * cols + u;
+              int64_t old = first;
+              while (i < old && !first.compare_exchange_weak(old, i)) {}
+              return;
+            }
+          }
+        }
+      },
+      &token);
+
+    const int64_t i = first;
+    if (token.canceled() || i == std::numeric_limits<int64_t>::max())
+      return false;
+
+    pos = gfx::Point(int(i % cols), int(i / cols));
+    return true;
+  }
+
+  for (int v = 0; v < rows; ++v) {
+    for (int u = 0; u < cols; ++u) {
+      if (token.canceled())
+        return false;
+      if (rgn.contains(possible_rect(m_bounds, rc, m_shapePadding, u, v)) == Region::In) {
+        pos = gfx::Point(u, v);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 bool PackingRects::pack(const Size& size, base::task_token& token)
 {
+  LAF_TRACE_ZONE("PackingRects::pack");
   m_bounds = Rect(size).shrink(m_borderPadding);
 
   // We cannot sort m_rects because we want to
@@ -102,35 +191,13 @@ bool PackingRects::pack(const Size& size, base::task_token& token)
 
     // The rectangles are treated as its original size +
     // conditional extra border of <shapePadding> during placement.
-    for (int v = 0; v <= m_bounds.h - rc.h; ++v) {
-      const int hShapePadding = (v == (m_bounds.h - rc.h) ? 0 : m_shapePadding);
-      for (int u = 0; u <= m_bounds.w - rc.w; ++u) {
-        if (token.canceled())
-          return false;
-
-        // It's necessary to consider the <shapePadding> as an
-        // integral part of the image size; otherwise, the region
-        // subtraction process may be incorrect, resulting in
-        // overlapping of shape padding between adjacent sprites.
-        // This fix resolves the special cases of exporting with
-        // sheet type 'Packed' + 'Trim Cels' true +
-        // 'Shape padding' > 0 + series of particular image sizes.
-        const int wShapePadding = (u == (m_bounds.w - rc.w) ? 0 : m_shapePadding);
-        const gfx::Rect possible(m_bounds.x + u,
-                                 m_bounds.y + v,
-                                 rc.w + wShapePadding,
-                                 rc.h + hShapePadding);
-
-        const Region::Overlap overlap = rgn.contains(possible);
-        if (overlap == Region::In) {
-          rc = Rect(m_bounds.x + u, m_bounds.y + v, rc.w, rc.h);
-          rgn.createSubtraction(rgn, gfx::Region(Rect(possible)));
-          goto next_rc;
-        }
-      }
-    }
-    return false; // There is not enough room for "rc"
-  next_rc:;
+    gfx::Point pos;
+    if (!findPosition(rgn, rc, token, pos))
+      return false; // There is not enough room for "rc" (or canceled)
+
+    const gfx::Rect possible = possible_rect(m_bounds, rc, m_shapePadding, pos.x, pos.y);
+    rc = Rect(m_bounds.x + pos.x, m_bounds.y + pos.y, rc.w, rc.h);
+    rgn.createSubtraction(rgn, gfx::Region(Rect(possible)));
     ++i;
   }
 
@@ -1,5 +1,5 @@
 // LAF Gfx Library
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2015  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -51,9 +51,19 @@ public:
   // Returns the bounds of the packed area.
   const Rect& bounds() const { return m_bounds; }
 
+  // Uses the given thread pool to search the position of each
+  // rectangle in parallel (nullptr to use only the calling thread).
+  void setThreadPool(base::thread_pool* pool) { m_pool = pool; }
+
 private:
+  bool findPosition(const gfx::Region& rgn,
+                    const gfx::Rect& rc,
+                    base::task_token& token,
+                    gfx::Point& pos) const;
+
   int m_borderPadding;
   int m_shapePadding;
+  base::thread_pool* m_pool = nullptr;
 
   Rect m_bounds;
   Rects m_rects;
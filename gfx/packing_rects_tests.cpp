@@ -1,5 +1,5 @@
 // LAF Gfx Library
-// Copyright (C) 2019-2021  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2014 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -16,6 +16,7 @@
   #include "gfx/packing_rects.h"
   #include "gfx/rect_io.h"
   #include "gfx/size.h"
+  #include "gfx/size_io.h"
 
 using namespace gfx;
 
@@ -120,6 +121,26 @@ TEST(PackingRects, BorderAndShapePadding)
   EXPECT_EQ(Rect(10, 216, 200, 100), pr[2]);
 }
 
+TEST(PackingRects, ThreadPoolGivesSameResult)
+{
+  base::task_token token;
+  base::thread_pool pool(4);
+
+  PackingRects a(2, 1), b(2, 1);
+  for (int i = 1; i <= 40; ++i) {
+    const Size sz(3 + (i * 7) % 23, 2 + (i * 11) % 17);
+    a.add(sz);
+    b.add(sz);
+  }
+  b.setThreadPool(&pool);
+
+  const Size sa = a.bestFit(token);
+  const Size sb = b.bestFit(token);
+  EXPECT_EQ(sa, sb);
+  for (size_t i = 0; i < a.size(); ++i)
+    EXPECT_EQ(a[i], b[i]);
+}
+
 #endif // LAF_WITH_REGION
 
 int main(int argc, char** argv)
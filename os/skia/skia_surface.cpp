@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (c) 2018-2025  Igara Studio S.A.
+// Copyright (c) 2018-2026  Igara Studio S.A.
 // Copyright (c) 2016-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,6 +12,7 @@
 #include "os/skia/skia_surface.h"
 
 #include "base/file_handle.h"
+#include "base/trace.h"
 #include "gfx/path.h"
 #include "gfx/region.h"
 #include "os/skia/skia_helpers.h"
@@ -455,11 +456,13 @@ void SkiaSurface::drawLine(const float x0,
                            const float y1,
                            const Paint& paint)
 {
+  LAF_TRACE_ZONE("SkiaSurface::drawLine");
   m_canvas->drawLine(x0, y0, x1, y1, paint.skPaint());
 }
 
 void SkiaSurface::drawRect(const gfx::RectF& rc, const Paint& paint)
 {
+  LAF_TRACE_ZONE("SkiaSurface::drawRect");
   if (rc.isEmpty())
     return;
 
@@ -471,11 +474,13 @@ void SkiaSurface::drawRect(const gfx::RectF& rc, const Paint& paint)
 
 void SkiaSurface::drawCircle(const float cx, const float cy, const float radius, const Paint& paint)
 {
+  LAF_TRACE_ZONE("SkiaSurface::drawCircle");
   m_canvas->drawCircle(cx, cy, radius, paint.skPaint());
 }
 
 void SkiaSurface::drawPath(const gfx::Path& path, const Paint& paint)
 {
+  LAF_TRACE_ZONE("SkiaSurface::drawPath");
   m_canvas->drawPath(path.skPath(), paint.skPaint());
 }
 
@@ -487,6 +492,7 @@ void SkiaSurface::blitTo(Surface* _dst,
                          int width,
                          int height) const
 {
+  LAF_TRACE_ZONE("SkiaSurface::blitTo");
   auto dst = static_cast<SkiaSurface*>(_dst);
 
   SkRect srcRect = SkRect::MakeXYWH(srcx, srcy, width, height);
@@ -529,6 +535,7 @@ void SkiaSurface::blitTo(Surface* _dst,
 
 void SkiaSurface::scrollTo(const gfx::Rect& rc, int dx, int dy)
 {
+  LAF_TRACE_ZONE("SkiaSurface::scrollTo");
   int w = width();
   int h = height();
   gfx::Clip clip(rc.x + dx, rc.y + dy, rc);
@@ -571,6 +578,7 @@ void SkiaSurface::scrollTo(const gfx::Rect& rc, int dx, int dy)
 
 void SkiaSurface::drawSurface(const Surface* src, int dstx, int dsty)
 {
+  LAF_TRACE_ZONE("SkiaSurface::drawSurface");
   gfx::Clip clip(dstx, dsty, 0, 0, src->width(), src->height());
   // Don't call clip.clip() and left the clipping to the Skia library
   // (mainly because Skia knows how to handle clipping even when a
@@ -587,6 +595,7 @@ void SkiaSurface::drawSurface(const Surface* src,
                               const Sampling& sampling,
                               const os::Paint* paint)
 {
+  LAF_TRACE_ZONE("SkiaSurface::drawSurface");
   SkPaint skSrcPaint;
   skSrcPaint.setBlendMode(SkBlendMode::kSrc);
 
@@ -603,6 +612,7 @@ void SkiaSurface::drawSurface(const Surface* src,
 
 void SkiaSurface::drawRgbaSurface(const Surface* src, int dstx, int dsty)
 {
+  LAF_TRACE_ZONE("SkiaSurface::drawRgbaSurface");
   gfx::Clip clip(dstx, dsty, 0, 0, src->width(), src->height());
 
   SkPaint paint;
@@ -618,6 +628,7 @@ void SkiaSurface::drawRgbaSurface(const Surface* src,
                                   int w,
                                   int h)
 {
+  LAF_TRACE_ZONE("SkiaSurface::drawRgbaSurface");
   gfx::Clip clip(dstx, dsty, srcx, srcy, w, h);
 
   SkPaint paint;
@@ -630,6 +641,7 @@ void SkiaSurface::drawColoredRgbaSurface(const Surface* src,
                                          gfx::Color bg,
                                          const gfx::Clip& clipbase)
 {
+  LAF_TRACE_ZONE("SkiaSurface::drawColoredRgbaSurface");
   gfx::Clip clip(clipbase);
 
   SkRect srcRect = SkRect::Make(
@@ -665,6 +677,7 @@ void SkiaSurface::drawSurfaceNine(os::Surface* surface,
                                   const bool drawCenter,
                                   const os::Paint* paint)
 {
+  LAF_TRACE_ZONE("SkiaSurface::drawSurfaceNine");
   SkIRect srcRect = SkIRect::MakeXYWH(src.x, src.y, src.w, src.h);
   SkRect dstRect = SkRect::Make(SkIRect::MakeXYWH(dst.x, dst.y, dst.w, dst.h));
 
@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2020-2022  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2016-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,6 +11,7 @@
 
 #include "os/skia/skia_window_x11.h"
 
+#include "base/trace.h"
 #include "gfx/size.h"
 #include "os/event.h"
 #include "os/event_queue.h"
@@ -57,6 +58,7 @@ SkiaWindowX11::SkiaWindowX11(const WindowSpec& spec) : Base(X11::instance()->dis
 
 void SkiaWindowX11::onPaint(const gfx::Rect& rc)
 {
+  LAF_TRACE_ZONE("SkiaWindowX11::onPaint");
 #if SK_SUPPORT_GPU
   if (backend() == Backend::GL)
     return;
@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2016-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,6 +12,7 @@
 #include "os/x11/event_queue.h"
 
 #include "base/thread.h"
+#include "base/trace.h"
 #include "os/x11/window.h"
 
 #include <X11/Xlib.h>
@@ -91,6 +92,7 @@ void EventQueueX11::queueEvent(const Event& ev)
 
 void EventQueueX11::getEvent(Event& ev, double timeout)
 {
+  LAF_TRACE_ZONE("EventQueueX11::getEvent");
   base::tick_t startTime = base::current_tick();
 
   ev.setWindow(nullptr);
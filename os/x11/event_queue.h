@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2021-2022  Igara Studio S.A.
+// Copyright (C) 2021-2026  Igara Studio S.A.
 // Copyright (C) 2016-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,7 +9,7 @@
 #define OS_X11_EVENT_QUEUE_INCLUDED
 #pragma once
 
-#include "base/concurrent_queue.h"
+#include "base/mpmc_queue.h"
 #include "os/event.h"
 #include "os/event_queue.h"
 #include "os/x11/x11.h"
@@ -29,7 +29,9 @@ public:
 private:
   void processX11Event(XEvent& event);
 
-  base::concurrent_queue<Event> m_events;
+  // Lock-free queue so getEvent() doesn't miss events when other
+  // thread is queueing events at the same time.
+  base::mpmc_queue<Event> m_events;
 };
 
 using EventQueueImpl = EventQueueX11;
@@ -1,5 +1,5 @@
 // LAF Text Library
-// Copyright (c) 2024-2025  Igara Studio S.A.
+// Copyright (c) 2024-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 
 namespace text {
 
@@ -59,9 +60,12 @@ float SpriteSheetFont::defaultSize() const
 float SpriteSheetFont::textLength(const std::string& str) const
 {
   base::utf8_decode decode(str);
+  base::codepoint_t chrs[256];
   int x = 0;
-  while (int chr = decode.next())
-    x += getCharBounds(chr).w;
+  while (const size_t n = decode.next_run(chrs, std::size(chrs))) {
+    for (size_t i = 0; i < n; ++i)
+      x += getCharBounds(chrs[i]).w;
+  }
   return x;
 }
 
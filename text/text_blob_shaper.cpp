@@ -1,5 +1,5 @@
 // LAF Text Library
-// Copyright (c) 2024  Igara Studio S.A.
+// Copyright (c) 2024-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -10,6 +10,7 @@
 
 #include "text/text_blob.h"
 
+#include "base/trace.h"
 #include "text/font.h"
 #include "text/sprite_text_blob.h"
 
@@ -25,6 +26,7 @@ TextBlobRef TextBlob::MakeWithShaper(const FontMgrRef& fontMgr,
                                      TextBlob::RunHandler* handler,
                                      const ShaperFeatures features)
 {
+  LAF_TRACE_ZONE("TextBlob::MakeWithShaper");
   ASSERT(font);
   switch (font->type()) {
     case FontType::SpriteSheet: return SpriteTextBlob::MakeWithShaper(fontMgr, font, text, handler);